@@ -24,6 +24,7 @@ from __future__ import unicode_literals
 from __future__ import print_function
 from array import array as _array
 import sys
+import time
 import unittest
 
 
@@ -223,10 +224,103 @@ class TestSolve(unittest.TestCase):
         res, solution = self.solver.solve()
         self.assertEqual(res, False)
 
+    def test_add_clauses_buffer_SAT(self):
+        cls = memoryview(array('i', [1, 2, 0, -1, 0]))
+        self.solver.add_clauses(cls)
+        res, solution = self.solver.solve()
+        self.assertEqual(res, True)
+        self.assertEqual(solution, (None, False, True))
+
+    def test_add_clauses_buffer_UNSAT(self):
+        cls = memoryview(array('q', [-1, 0, 1, 0]))
+        self.solver.add_clauses(cls)
+        res, solution = self.solver.solve()
+        self.assertEqual(res, False)
+
+    def test_add_clauses_buffer_wrong_format(self):
+        cls = memoryview(array('d', [1.0, 0.0]))
+        self.assertRaises(ValueError, self.solver.add_clauses, cls)
+
     def test_add_clauses_array_unterminated(self):
         cls = array('i', [1, 2, 0, 1, 2])
         self.assertRaises(ValueError, self.solver.add_clause, cls)
 
+    def test_freeze(self):
+        self.solver.add_clause([1, 2])
+        self.solver.freeze(1)
+        self.solver.freeze(1)
+        self.solver.melt(1)
+        self.assertTrue(self.solver.is_frozen(1))
+        self.solver.melt(1)
+        self.assertFalse(self.solver.is_frozen(1))
+        self.assertRaises(ValueError, self.solver.melt, 1)
+        self.assertRaises(ValueError, self.solver.freeze, 3)
+
+    def test_msolve_selected(self):
+        self.solver.add_clause([1, 2])
+        self.solver.add_clause([-3, 4])
+        sols = self.solver.msolve_selected(20, [1, 2, 3, 4])
+        self.assertEqual(len(sols), 9)
+        self.assertEqual(len(set(sols)), 9)
+
+    def test_msolve_selected_projected(self):
+        self.solver.add_clause([1, 2])
+        self.solver.add_clause([-3, 4])
+        self.assertEqual(len(self.solver.msolve_selected(2, [1, 2])), 2)
+        sols = self.solver.msolve_selected(20, [1, 2], raw=False)
+        self.assertEqual(len(sols), 2)
+        self.assertEqual(len(set((s[1], s[2]) for s in sols)), 2)
+
+    def test_solve_async(self):
+        for cl in clauses3:
+            self.solver.add_clause(cl)
+        results = []
+        self.solver.solve_async(callback=results.append)
+        self.assertTrue(self.solver.async_wait())
+        self.assertTrue(self.solver.async_done())
+        res, solution = self.solver.async_result()
+        self.assertEqual(res, True)
+        self.assertEqual(results, [True])
+        self.assertTrue(check_solution(clauses3, solution))
+        self.assertEqual(self.solver.solve()[0], True)
+
+    def test_solve_async_add_after_done(self):
+        for cl in clauses3:
+            self.solver.add_clause(cl)
+        results = []
+
+        def slow_callback(res):
+            time.sleep(0.2)
+            results.append(res)
+
+        # The callback is still running when async_done() turns True
+        self.solver.solve_async(callback=slow_callback)
+        while not self.solver.async_done():
+            time.sleep(0.001)
+        self.solver.add_clause([-2])
+        self.assertEqual(results, [True])
+        self.assertEqual(self.solver.solve()[0], True)
+
+    def test_solve_async_cancel(self):
+        # 10 pigeons, 9 holes
+        def var(p, h):
+            return p*9 + h + 1
+        for p in range(10):
+            self.solver.add_clause([var(p, h) for h in range(9)])
+        for h in range(9):
+            for p1 in range(10):
+                for p2 in range(p1+1, 10):
+                    self.solver.add_clause([-var(p1, h), -var(p2, h)])
+
+        self.solver.solve_async()
+        self.assertFalse(self.solver.async_wait(0.2))
+        self.assertRaises(RuntimeError, self.solver.add_clause, [1])
+        self.assertRaises(RuntimeError, self.solver.solve)
+        self.assertGreater(self.solver.live_progress()["conflicts"], 0)
+        self.solver.async_cancel()
+        self.assertEqual(self.solver.async_result(), (None, None))
+        self.solver.add_clause([1])
+
     def test_bad_iter(self):
         class Liar:
 
@@ -70,12 +70,20 @@ extern "C" {
     fn cmsat_free(this: *mut SATSolver);
     fn cmsat_nvars(this: *const SATSolver) -> u32;
     fn cmsat_add_clause(this: *mut SATSolver, lits: *const Lit, num_lits: size_t) -> bool;
+    fn cmsat_add_clauses(this: *mut SATSolver,
+                         lits: *const Lit,
+                         offsets: *const u32,
+                         num_clauses: size_t)
+                         -> bool;
     fn cmsat_add_xor_clause(this: *mut SATSolver,
                             vars: *const u32,
                             num_vars: size_t,
                             rhs: bool)
                             -> bool;
     fn cmsat_new_vars(this: *mut SATSolver, n: size_t);
+    fn cmsat_freeze(this: *mut SATSolver, var: u32);
+    fn cmsat_melt(this: *mut SATSolver, var: u32);
+    fn cmsat_is_frozen(this: *const SATSolver, var: u32) -> bool;
     fn cmsat_solve(this: *mut SATSolver) -> Lbool;
     fn cmsat_solve_with_assumptions(this: *mut SATSolver,
                                     assumptions: *const Lit,
@@ -105,6 +113,16 @@ impl Solver {
     pub fn add_clause(&mut self, lits: &[Lit]) -> bool {
         unsafe { cmsat_add_clause(self.0, lits.as_ptr(), lits.len()) }
     }
+    /// Add many clauses in one call. Clause i is lits[offsets[i]..offsets[i+1]],
+    /// so offsets has one more element than there are clauses. The literals are not copied.
+    pub fn add_clauses(&mut self, lits: &[Lit], offsets: &[u32]) -> bool {
+        if offsets.is_empty() {
+            return true;
+        }
+        assert!(offsets.windows(2).all(|w| w[0] <= w[1]), "offsets must not decrease");
+        assert!(offsets[offsets.len() - 1] as usize <= lits.len(), "offsets point past lits");
+        unsafe { cmsat_add_clauses(self.0, lits.as_ptr(), offsets.as_ptr(), offsets.len() - 1) }
+    }
     /// Add a xor clause, which enforces that the xor of the unnegated variables equals rhs.
     /// It is generally more convienent to use add_xor_literal_clause() instead.
     pub fn add_xor_clause(&mut self, vars: &[u32], rhs: bool) -> bool {
@@ -114,6 +132,19 @@ impl Solver {
     pub fn new_vars(&mut self, n: size_t) {
         unsafe { cmsat_new_vars(self.0, n) }
     }
+    /// Keep var from being removed by simplification, so it stays cheap to use in later
+    /// clauses and assumptions. Every freeze() must be undone by its own melt().
+    pub fn freeze(&mut self, var: u32) {
+        unsafe { cmsat_freeze(self.0, var) }
+    }
+    /// Undo one freeze() of var.
+    pub fn melt(&mut self, var: u32) {
+        unsafe { cmsat_melt(self.0, var) }
+    }
+    /// True if var has been frozen more times than melted.
+    pub fn is_frozen(&self, var: u32) -> bool {
+        unsafe { cmsat_is_frozen(self.0, var) }
+    }
     /// Solve and return Lbool::True if a solution was found.
     pub fn solve(&mut self) -> Lbool {
         unsafe { cmsat_solve(self.0) }
@@ -42,6 +42,23 @@ fn readme_code() {
     assert!(solver.get_model()[2] == Lbool::True);
 }
 
+#[test]
+fn add_clauses_flat() {
+    let mut s = Solver::new();
+    s.new_vars(3);
+    let lits = [new_lit(0, false),
+                new_lit(1, true),
+                new_lit(0, true), new_lit(1, false), new_lit(2, false)];
+    assert!(s.add_clauses(&lits, &[0, 1, 2, 5]));
+    assert!(s.solve() == Lbool::True);
+    assert!(s.get_model()[0] == Lbool::True);
+    assert!(s.get_model()[1] == Lbool::False);
+    assert!(s.get_model()[2] == Lbool::True);
+
+    assert!(!s.add_clauses(&[new_lit(2, true)], &[0, 1]));
+    assert!(s.solve() == Lbool::False);
+}
+
 #[test]
 fn xor_4_long() {
     let mut s = Solver::new();
@@ -111,6 +111,22 @@ EGaussian::~EGaussian() {
     }
 }
 
+size_t EGaussian::mem_used() const
+{
+    size_t mem = 0;
+    mem += clause_state.mem_used();
+    mem += matrix.matrix.mem_used();
+    mem += matrix.nb_rows.capacity()*sizeof(uint32_t);
+    mem += matrix.col_to_var.capacity()*sizeof(uint32_t);
+    mem += var_to_col.capacity()*sizeof(uint32_t);
+    mem += GasVar_state.capacity()*sizeof(bool);
+    mem += tmp_clause.capacity()*sizeof(Lit);
+    mem += xorclauses.capacity()*sizeof(Xor);
+    mem += clauses_toclear.capacity()*sizeof(pair<ClOffset, uint32_t>);
+
+    return mem;
+}
+
 void EGaussian::canceling(const uint32_t sublevel) {
     uint32_t a = 0;
     for (int i = clauses_toclear.size() - 1; i >= 0 && clauses_toclear[i].second > sublevel; i--) {
@@ -634,6 +650,7 @@ bool EGaussian::find_truths2(const GaussWatched* i, GaussWatched*& j, uint32_t p
                         #ifdef STATS_NEEDED
                         , solver->clauseID++
                         #endif
+                        , ClRegion::red_tier2
                     );
                     cla->set_gauss_temp_cl();
                     const ClOffset offs = solver->cl_alloc.get_offset(cla);
@@ -824,6 +841,7 @@ void EGaussian::eliminate_col2(uint32_t p, GaussQData& gqd) {
                                     #ifdef STATS_NEEDED
                                     , solver->clauseID++
                                     #endif
+                                    , ClRegion::red_tier2
                                 );
                                 cla->set_gauss_temp_cl();
                                 const ClOffset offs = solver->cl_alloc.get_offset(cla);
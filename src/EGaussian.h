@@ -134,6 +134,7 @@ class EGaussian {
     );
 
     void Debug_funtion(); // used to debug
+    size_t mem_used() const;
 };
 
 }
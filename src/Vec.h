@@ -74,6 +74,9 @@ private:
         assert(0);
     }
 
+    //Frees the memory, only specialised for Watched
+    void free_mem();
+
     // Helpers for calculating next capacity:
     static inline uint32_t  imax   (int32_t x, int32_t y)
     {
@@ -237,6 +240,11 @@ public:
 };
 
 
+//vec<Watched> allocates through WatchPool, see watchpool.cpp
+template<> void vec<Watched>::capacity(int32_t min_cap);
+template<> void vec<Watched>::free_mem();
+template<> void vec<Watched>::shrink_to_fit();
+
 template<class T>
 void vec<T>::capacity(int32_t min_cap)
 {
@@ -303,7 +311,7 @@ inline void vec<Watched>::clear(bool dealloc)
     if (data != NULL) {
         sz = 0;
         if (dealloc) {
-            free(data), data = NULL, cap = 0;
+            free_mem();
         }
     }
 }
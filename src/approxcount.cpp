@@ -0,0 +1,274 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "approxcount.h"
+#include "solver.h"
+#include "time_mem.h"
+
+#include <cmath>
+#include <algorithm>
+#include <iomanip>
+
+using namespace CMSat;
+
+ApproxCounter::ApproxCounter(
+    Solver* _solver
+    , const vector<uint32_t>& _sampling_set
+    , const double epsilon
+    , const double delta
+    , const uint32_t seed
+    , const unsigned _verbosity
+) :
+    solver(_solver)
+    , sampling_set(_sampling_set)
+    , mtrand(seed)
+    , verbosity(_verbosity)
+{
+    //The constants of ApproxMC
+    threshold = std::ceil(1.0 + 9.84
+        * (1.0 + epsilon/(1.0 + epsilon))
+        * (1.0 + 1.0/epsilon) * (1.0 + 1.0/epsilon));
+    rounds = std::ceil(17.0 * std::log2(3.0/delta));
+}
+
+Lit ApproxCounter::new_lit()
+{
+    solver->new_external_var();
+    return Lit(solver->nVarsOutside()-1, false);
+}
+
+uint64_t ApproxCounter::bounded_count(
+    const uint64_t max_sols
+    , const uint32_t num_hashes
+) {
+    assert(num_hashes <= hash_acts.size());
+    const Lit sel = new_lit();
+    assumps.clear();
+    for(uint32_t i = 0; i < num_hashes; i++) {
+        assumps.push_back(~hash_acts[i]);
+    }
+    assumps.push_back(sel);
+
+    uint64_t num = 0;
+    EnumerateParams params;
+    params.callback = [&num](const vector<lbool>&) {
+        num++;
+        return true;
+    };
+    params.max_solutions = max_sols;
+    params.projection = &sampling_set;
+    params.ban_guard = ~sel;
+    const lbool ret = solver->enumerate_solutions(&assumps, true, params);
+    if (ret == l_Undef) {
+        interrupted = true;
+    }
+
+    //The bans are only for this cell
+    tmp_cl.clear();
+    tmp_cl.push_back(~sel);
+    solver->add_clause_outer(tmp_cl);
+
+    return num;
+}
+
+void ApproxCounter::add_hash()
+{
+    const Lit act = new_lit();
+    xor_vars.clear();
+    for(const uint32_t var: sampling_set) {
+        if (mtrand.randInt(1)) {
+            xor_vars.push_back(var);
+        }
+    }
+    xor_vars.push_back(act.var());
+    solver->add_xor_clause_outer(xor_vars, mtrand.randInt(1));
+    hash_acts.push_back(act);
+}
+
+void ApproxCounter::new_round()
+{
+    //The activation vars of the old XORs are free from now on, so the old
+    //XORs can always be satisfied. They still cost propagation until
+    //simplification eliminates them
+    if (!hash_acts.empty()) {
+        solver->simplify_with_assumptions();
+    }
+    hash_acts.clear();
+    cells.clear();
+}
+
+uint64_t ApproxCounter::cell_size(const uint32_t num_hashes)
+{
+    map<uint32_t, uint64_t>::const_iterator it = cells.find(num_hashes);
+    if (it != cells.end()) {
+        return it->second;
+    }
+
+    while(hash_acts.size() < num_hashes) {
+        add_hash();
+    }
+    const uint64_t num = bounded_count(threshold+1, num_hashes);
+    if (!interrupted) {
+        cells[num_hashes] = num;
+    }
+    return num;
+}
+
+bool ApproxCounter::cell_too_big(const uint32_t num_hashes)
+{
+    if (num_hashes == 0) {
+        //Checked before the first round
+        return true;
+    }
+    return cell_size(num_hashes) > threshold;
+}
+
+//Finds the smallest number of XORs that makes the cell small. Returns false
+//if even all possible ones don't, or when interrupted
+bool ApproxCounter::find_num_hashes(uint32_t start, uint32_t& num_hashes)
+{
+    const uint32_t max_hashes = sampling_set.size();
+    start = std::max<uint32_t>(1, std::min(start, max_hashes));
+
+    //Gallop from start until cell(lo) is too big and cell(hi) is small
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t step = 1;
+    if (cell_too_big(start)) {
+        lo = start;
+        while(true) {
+            if (interrupted || lo == max_hashes) {
+                return false;
+            }
+            hi = std::min(max_hashes, lo + step);
+            if (!cell_too_big(hi)) {
+                break;
+            }
+            lo = hi;
+            step *= 2;
+        }
+    } else {
+        hi = start;
+        while(true) {
+            lo = hi > step ? hi - step : 0;
+            if (cell_too_big(lo)) {
+                break;
+            }
+            hi = lo;
+            step *= 2;
+        }
+    }
+
+    while(hi - lo > 1) {
+        const uint32_t mid = lo + (hi - lo)/2;
+        if (cell_too_big(mid)) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    num_hashes = hi;
+    return !interrupted;
+}
+
+static long double approx_count_value(const ApproxCount& c)
+{
+    return std::ldexp((long double)c.cell_count, c.hash_count);
+}
+
+lbool ApproxCounter::count(ApproxCount& result)
+{
+    const double start_time = cpuTime();
+    if (verbosity) {
+        cout << "c [approx] sampling set size: " << sampling_set.size()
+        << " threshold: " << threshold
+        << " rounds: " << rounds
+        << endl;
+    }
+
+    //Few enough to count exactly
+    const uint64_t num = bounded_count(threshold+1, 0);
+    if (interrupted) {
+        return l_Undef;
+    }
+    if (num == 0) {
+        return l_False;
+    }
+    if (num <= threshold) {
+        result.cell_count = num;
+        result.hash_count = 0;
+        if (verbosity) {
+            cout << "c [approx] exact count: " << num
+            << " T: " << std::fixed << std::setprecision(2)
+            << (cpuTime() - start_time)
+            << endl;
+        }
+        return l_True;
+    }
+
+    vector<ApproxCount> estimates;
+    uint32_t num_hashes = 1;
+    for(uint32_t round = 0; round < rounds; round++) {
+        new_round();
+        if (!find_num_hashes(num_hashes, num_hashes)) {
+            if (interrupted) {
+                return l_Undef;
+            }
+            continue;
+        }
+
+        ApproxCount estimate;
+        estimate.cell_count = cells[num_hashes];
+        estimate.hash_count = num_hashes;
+        estimates.push_back(estimate);
+        if (verbosity >= 2) {
+            cout << "c [approx] round " << std::setw(3) << round
+            << " hashes: " << std::setw(4) << num_hashes
+            << " cell: " << std::setw(5) << estimate.cell_count
+            << " cells counted: " << std::setw(3) << cells.size()
+            << " T: " << std::fixed << std::setprecision(2)
+            << (cpuTime() - start_time)
+            << endl;
+        }
+    }
+    if (estimates.empty()) {
+        return l_Undef;
+    }
+
+    std::sort(estimates.begin(), estimates.end(),
+        [](const ApproxCount& a, const ApproxCount& b) {
+            return approx_count_value(a) < approx_count_value(b);
+        }
+    );
+    result = estimates[estimates.size()/2];
+    if (verbosity) {
+        cout << "c [approx] count: " << result.cell_count
+        << "*2^" << result.hash_count
+        << " confl: " << solver->sumConflicts
+        << " T: " << std::fixed << std::setprecision(2)
+        << (cpuTime() - start_time)
+        << endl;
+    }
+    return l_True;
+}
@@ -0,0 +1,103 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef __APPROXCOUNT_H__
+#define __APPROXCOUNT_H__
+
+#include <vector>
+#include <map>
+#include "solvertypes.h"
+#include "MersenneTwister.h"
+
+namespace CMSat {
+
+using std::vector;
+using std::map;
+
+class Solver;
+
+/**
+@brief Hashing-based approximate model counting, as in ApproxMC
+
+The solutions, projected on the sampling set, are split into cells by random
+XOR constraints. A cell is small if it has at most "threshold" solutions, and
+each round looks for the smallest number of XORs, m, that makes the cell small.
+The round's estimate is (solutions in the cell)*2^m, and the result is the
+median of the rounds.
+
+Everything is done in one solver, so learnt clauses carry over from cell to
+cell and round to round:
+- each XOR has an activation var of its own, that is in no other clause. The
+  XOR is in force only while its activation var is assumed false. Once its
+  round is over the activation var is left free, and simplification removes
+  the XOR. With USE_GAUSS, the XORs go to Gaussian elimination
+- the solutions of a cell are enumerated by searching on from each one found.
+  The bans are guarded by a fresh selector var, that is set false once the
+  cell is counted
+- the XORs of a round are nested, the cell of m+1 XORs is inside that of m.
+  The search for m starts from where the previous round ended, and gallops
+  from there before it bisects, so only a few cells are counted per round
+
+All vars are in outside numbering.
+*/
+class ApproxCounter
+{
+public:
+    ApproxCounter(
+        Solver* solver
+        , const vector<uint32_t>& sampling_set
+        , double epsilon
+        , double delta
+        , uint32_t seed
+        , unsigned verbosity
+    );
+    lbool count(ApproxCount& result);
+
+private:
+    Solver* solver;
+    const vector<uint32_t>& sampling_set;
+    MTRand mtrand;
+    unsigned verbosity;
+    uint64_t threshold;
+    uint32_t rounds;
+
+    //Current round
+    vector<Lit> hash_acts; ///<Activation lit of each XOR, the XOR is on while it's false
+    map<uint32_t, uint64_t> cells; ///<Number of XORs -> cell size, capped at threshold+1
+    bool interrupted = false;
+    void new_round();
+    void add_hash();
+    uint64_t cell_size(const uint32_t num_hashes);
+    bool cell_too_big(const uint32_t num_hashes);
+    bool find_num_hashes(uint32_t start, uint32_t& num_hashes);
+
+    uint64_t bounded_count(const uint64_t max_sols, const uint32_t num_hashes);
+    Lit new_lit();
+    vector<Lit> assumps;
+    vector<Lit> tmp_cl;
+    vector<uint32_t> xor_vars;
+};
+
+}
+
+#endif //__APPROXCOUNT_H__
@@ -0,0 +1,208 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "bigmem.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <string.h>
+#include <new>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sched.h>
+#endif
+
+using namespace CMSat;
+using std::vector;
+using std::string;
+
+static const size_t huge_page_size = 2ULL*1024ULL*1024ULL;
+
+size_t CMSat::big_round(const size_t bytes, const BigMem backing)
+{
+    #ifdef __linux__
+    if (backing != BigMem::malloc_backed) {
+        return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+    #endif
+
+    return bytes;
+}
+
+#ifdef __linux__
+static void* map_pages(const size_t bytes, const BigMem backing)
+{
+    void* ptr = MAP_FAILED;
+    #ifdef MAP_HUGETLB
+    if (backing == BigMem::hugetlb) {
+        ptr = mmap(NULL, bytes, PROT_READ | PROT_WRITE
+            , MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    #endif
+
+    if (ptr == MAP_FAILED) {
+        ptr = mmap(NULL, bytes, PROT_READ | PROT_WRITE
+            , MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        #ifdef MADV_HUGEPAGE
+        madvise(ptr, bytes, MADV_HUGEPAGE);
+        #endif
+    }
+
+    return ptr;
+}
+#endif
+
+void* CMSat::big_alloc(const size_t bytes, const BigMem backing)
+{
+    #ifdef __linux__
+    if (backing != BigMem::malloc_backed) {
+        return map_pages(big_round(bytes, backing), backing);
+    }
+    #endif
+
+    void* ptr = malloc(bytes);
+    if (ptr == NULL) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* CMSat::big_realloc(
+    void* ptr
+    , const size_t old_bytes
+    , const size_t new_bytes
+    , const BigMem backing
+) {
+    #ifdef __linux__
+    if (backing != BigMem::malloc_backed) {
+        if (ptr == NULL) {
+            return big_alloc(new_bytes, backing);
+        }
+
+        const size_t old_size = big_round(old_bytes, backing);
+        const size_t new_size = big_round(new_bytes, backing);
+        if (old_size == new_size) {
+            return ptr;
+        }
+
+        //Explicit huge pages can't always be remapped
+        if (backing == BigMem::thp) {
+            void* new_ptr = mremap(ptr, old_size, new_size, MREMAP_MAYMOVE);
+            if (new_ptr == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            #ifdef MADV_HUGEPAGE
+            madvise(new_ptr, new_size, MADV_HUGEPAGE);
+            #endif
+            return new_ptr;
+        }
+
+        void* new_ptr = map_pages(new_size, backing);
+        memcpy(new_ptr, ptr, std::min(old_bytes, new_bytes));
+        munmap(ptr, old_size);
+        return new_ptr;
+    }
+    #endif
+
+    void* new_ptr = realloc(ptr, new_bytes);
+    if (new_ptr == NULL && new_bytes > 0) {
+        throw std::bad_alloc();
+    }
+    return new_ptr;
+}
+
+void CMSat::big_free(void* ptr, const size_t bytes, const BigMem backing)
+{
+    #ifdef __linux__
+    if (backing != BigMem::malloc_backed) {
+        if (ptr != NULL) {
+            munmap(ptr, big_round(bytes, backing));
+        }
+        return;
+    }
+    #endif
+
+    free(ptr);
+}
+
+#ifdef __linux__
+//Parses e.g. "0-15,32-47"
+static void add_cpus(const string& list, cpu_set_t& set)
+{
+    std::stringstream ss(list);
+    string range;
+    while(std::getline(ss, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        const int from = std::stoi(range.substr(0, dash));
+        const int to = (dash == string::npos) ? from : std::stoi(range.substr(dash+1));
+        for(int cpu = from; cpu <= to && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, &set);
+        }
+    }
+}
+#endif
+
+bool CMSat::bind_thread_to_numa_node(const unsigned thread_num)
+{
+    #ifdef __linux__
+    vector<string> cpulists;
+    while(true) {
+        std::ifstream f("/sys/devices/system/node/node"
+            + std::to_string(cpulists.size()) + "/cpulist");
+        string list;
+        if (!f || !std::getline(f, list)) {
+            break;
+        }
+        cpulists.push_back(list);
+    }
+    if (cpulists.size() < 2) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    try {
+        add_cpus(cpulists[thread_num % cpulists.size()], set);
+    } catch (std::exception&) {
+        return false;
+    }
+    if (CPU_COUNT(&set) == 0) {
+        return false;
+    }
+
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+    #else
+    (void)thread_num;
+    return false;
+    #endif
+}
@@ -0,0 +1,53 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef __BIGMEM_H__
+#define __BIGMEM_H__
+
+#include <cstddef>
+
+namespace CMSat {
+
+///How large, long-lived blocks of memory (clause arena, watch slabs) are backed
+enum class BigMem {
+    malloc_backed = 0 ///<malloc/realloc
+    , thp = 1 ///<mmap, with transparent huge pages requested via madvise
+    , hugetlb = 2 ///<mmap of explicit huge pages, falls back to thp if there are none
+};
+
+//'bytes' must always be the size the block was last (re)allocated with
+void* big_alloc(const size_t bytes, const BigMem backing);
+void* big_realloc(void* ptr, const size_t old_bytes, const size_t new_bytes, const BigMem backing);
+void big_free(void* ptr, const size_t bytes, const BigMem backing);
+
+///Bytes actually reserved for a request of 'bytes'
+size_t big_round(const size_t bytes, const BigMem backing);
+
+///Restricts the calling thread to the CPUs of NUMA node thread_num%nodes, so
+///the memory it touches first is allocated there. False if there is only one
+///node or the topology can't be read.
+bool bind_thread_to_numa_node(const unsigned thread_num);
+
+}
+
+#endif //__BIGMEM_H__
@@ -70,6 +70,7 @@ bool BVA::bounded_var_addition()
         const Lit lit = Lit::toLit(i);
         if (solver->value(lit) != l_Undef
             || solver->varData[lit.var()].removed != Removed::none
+            || solver->var_frozen(lit.var())
         ) {
             continue;
         }
@@ -212,6 +212,7 @@ public:
     uint16_t _used_in_xor:1;
     uint16_t _gauss_temp_cl:1; ///Used ONLY by Gaussian elimination to incicate where a proagation is coming from
     uint16_t reloced:1;
+    uint16_t occur_sub_str_done:1; ///<Used as subsumer against all occur-linked clauses, and unchanged since
 
 
     Lit* getData()
@@ -254,6 +255,7 @@ public:
         _used_in_xor = false;
         _gauss_temp_cl = false;
         reloced = false;
+        occur_sub_str_done = false;
 
         for (uint32_t i = 0; i < ps.size(); i++) {
             getData()[i] = ps[i];
@@ -323,6 +325,7 @@ public:
     void setStrenghtened()
     {
         must_recalc_abst = true;
+        occur_sub_str_done = false;
     }
 
     void recalc_abst_if_needed()
@@ -434,6 +437,16 @@ public:
         return is_distilled;
     }
 
+    void set_occur_sub_str_done(bool done)
+    {
+        occur_sub_str_done = done;
+    }
+
+    bool get_occur_sub_str_done() const
+    {
+        return occur_sub_str_done;
+    }
+
     bool getOccurLinked() const
     {
         return occurLinked;
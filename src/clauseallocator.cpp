@@ -61,13 +61,24 @@ using std::endl;
 
 #define MAXSIZE ((1ULL << (EFFECTIVELY_USEABLE_BITS))-1)
 
-ClauseAllocator::ClauseAllocator() :
-    dataStart(NULL)
-    , size(0)
-    , capacity(0)
-    , currentlyUsedSize(0)
+static const char* region_names[] = {"irred", "red tier0", "red tier1", "red tier2"};
+
+ClauseAllocator::ClauseAllocator()
 {
     assert(MIN_LIST_SIZE < MAXSIZE);
+    assert(((uint64_t)num_slots << slot_bits) - 1 <= MAXSIZE);
+
+    const double compact_below[num_regions] = {0.8, 0.5, 0.8, 1.0};
+    for(uint32_t i = 0; i < num_regions; i++) {
+        regions[i].compact_below = compact_below[i];
+    }
+
+    //All slots are free, the lowest ones are handed out first
+    for(uint32_t i = 0; i < num_slots; i++) {
+        slot_start[i] = NULL;
+        slot_region[i] = num_regions;
+        free_slots[num_free_slots++] = num_slots - 1 - i;
+    }
 }
 
 /**
@@ -75,76 +86,191 @@ ClauseAllocator::ClauseAllocator() :
 */
 ClauseAllocator::~ClauseAllocator()
 {
-    free(dataStart);
+    for(Region& r: regions) {
+        big_free(r.dataStart, r.capacity*sizeof(BASE_DATA_TYPE), backing);
+    }
+}
+
+void ClauseAllocator::set_backing(const BigMem _backing)
+{
+    for(const Region& r: regions) {
+        assert(r.dataStart == NULL);
+    }
+    backing = _backing;
+}
+
+void ClauseAllocator::testing_limit_slots(const uint32_t num)
+{
+    for(const Region& r: regions) {
+        assert(r.num_owned == 0);
+    }
+    num_free_slots = std::min(num_free_slots, num);
+}
+
+void ClauseAllocator::update_slot_start(const uint32_t region)
+{
+    const Region& r = regions[region];
+    for(uint32_t i = 0; i < r.num_owned; i++) {
+        slot_start[r.owned[i]] = r.dataStart + ((uint64_t)i << slot_bits);
+    }
+}
+
+//Takes free slots until they cover the capacity of the region
+void ClauseAllocator::take_slots(Region& r, const uint32_t region)
+{
+    while(((uint64_t)r.num_owned << slot_bits) < r.capacity) {
+        assert(num_free_slots > 0);
+        const uint32_t slot = free_slots[--num_free_slots];
+        slot_region[slot] = region;
+        r.owned[r.num_owned++] = slot;
+    }
+}
+
+//Gives back the slots beyond the capacity of the region
+void ClauseAllocator::release_slots(Region& r)
+{
+    while(r.num_owned > 0
+        && ((uint64_t)(r.num_owned-1) << slot_bits) >= r.capacity
+    ) {
+        const uint32_t slot = r.owned[--r.num_owned];
+        slot_region[slot] = num_regions;
+        slot_start[slot] = NULL;
+        free_slots[num_free_slots++] = slot;
+    }
+}
+
+bool ClauseAllocator::Region::fragmented() const
+{
+    return currentlyUsedSize < size
+        && float_div(currentlyUsedSize, size) <= compact_below
+        && size >= (100ULL*1000ULL);
+}
+
+//The region the clause should live in, given its current tier
+uint32_t ClauseAllocator::proper_region(const Clause* cl)
+{
+    if (!cl->red()) {
+        return (uint32_t)ClRegion::irred;
+    }
+    return (uint32_t)ClRegion::red_tier0 + cl->stats.which_red_array;
+}
+
+//The region the clause actually lives in
+uint32_t ClauseAllocator::region_of(const Clause* cl) const
+{
+    const BASE_DATA_TYPE* p = (const BASE_DATA_TYPE*)cl;
+    for(uint32_t i = 0; i < num_regions; i++) {
+        const Region& r = regions[i];
+        if (p >= r.dataStart && p < r.dataStart + r.size) {
+            return i;
+        }
+    }
+    assert(false);
+    return std::numeric_limits<uint32_t>::max();
+}
+
+/**
+@brief Makes space for 'needed' more datapieces in the region
+
+Returns false if there are not enough free slots for it. The stack may move,
+and may get new slots.
+*/
+bool ClauseAllocator::reserve(Region& r, const uint32_t region, const uint64_t needed)
+{
+    if (r.size + needed <= r.capacity) {
+        return true;
+    }
+    if (r.size + needed > max_size(r)) {
+        return false;
+    }
+
+    //Grow by default, but don't go under or over the limits
+    uint64_t newcapacity = r.capacity * ALLOC_GROW_MULT;
+    newcapacity = std::max<size_t>(newcapacity, MIN_LIST_SIZE);
+    while (newcapacity < r.size+needed) {
+        newcapacity *= ALLOC_GROW_MULT;
+    }
+    assert(newcapacity >= r.size+needed);
+    newcapacity = std::min<size_t>(newcapacity, max_size(r));
+
+    //Use all of the pages we get
+    newcapacity = std::min<size_t>(
+        big_round(newcapacity*sizeof(BASE_DATA_TYPE), backing)/sizeof(BASE_DATA_TYPE)
+        , max_size(r));
+
+    //Reallocate data
+    BASE_DATA_TYPE* new_dataStart;
+    try {
+        new_dataStart = (BASE_DATA_TYPE*)big_realloc(
+            r.dataStart
+            , r.capacity*sizeof(BASE_DATA_TYPE)
+            , newcapacity*sizeof(BASE_DATA_TYPE)
+            , backing
+        );
+    } catch (std::bad_alloc&) {
+        std::cerr
+        << "ERROR: while reallocating clause space"
+        << endl;
+
+        throw;
+    }
+    r.dataStart = new_dataStart;
+
+    //Update capacity to reflect the update
+    r.capacity = newcapacity;
+    take_slots(r, region);
+
+    return true;
 }
 
 void* ClauseAllocator::allocEnough(
-    uint32_t num_lits
+    const uint32_t num_lits
+    , const uint32_t region
 ) {
     //Try to quickly find a place at the end of a dataStart
     uint64_t neededbytes = sizeof(Clause) + sizeof(Lit)*num_lits;
     uint64_t needed
         = neededbytes/sizeof(BASE_DATA_TYPE) + (bool)(neededbytes % sizeof(BASE_DATA_TYPE));
 
-    if (size + needed > capacity) {
-        //Grow by default, but don't go under or over the limits
-        uint64_t newcapacity = capacity * ALLOC_GROW_MULT;
-        newcapacity = std::max<size_t>(newcapacity, MIN_LIST_SIZE);
-        while (newcapacity < size+needed) {
-            newcapacity *= ALLOC_GROW_MULT;
-        }
-        assert(newcapacity >= size+needed);
-        newcapacity = std::min<size_t>(newcapacity, MAXSIZE);
-
-        //Oops, not enough space anyway
-        if (newcapacity < size + needed) {
-            std::cerr
-            << "ERROR: memory manager can't handle the load."
+    Region& r = regions[region];
+    const uint64_t old_capacity = r.capacity;
+    if (!reserve(r, region, needed)) {
+        //Not enough space: all slots are taken
+        const uint64_t total_mb = (((uint64_t)num_slots << slot_bits)*sizeof(BASE_DATA_TYPE))
+            /(1024ULL*1024ULL);
+        std::cerr
+        << "ERROR: memory manager can't handle the load."
+        << " All clauses together can take at most " << total_mb << " MB."
 #ifndef LARGE_OFFSETS
-            << " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**"
+        << " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**"
 #endif
-            << " size: " << size
-            << " needed: " << needed
-            << " newcapacity: " << newcapacity
-            << endl;
-            std::cout
-            << "ERROR: memory manager can't handle the load."
+        << " region: " << region_names[region]
+        << " size: " << r.size
+        << " needed: " << needed
+        << " capacity: " << r.capacity
+        << endl;
+        std::cout
+        << "ERROR: memory manager can't handle the load."
+        << " All clauses together can take at most " << total_mb << " MB."
 #ifndef LARGE_OFFSETS
-            << " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**"
+        << " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**"
 #endif
-            << " size: " << size
-            << " needed: " << needed
-            << " newcapacity: " << newcapacity
-            << endl;
-
-            throw std::bad_alloc();
-        }
-
-        //Reallocate data
-        BASE_DATA_TYPE* new_dataStart;
-        new_dataStart = (BASE_DATA_TYPE*)realloc(
-            dataStart
-            , newcapacity*sizeof(BASE_DATA_TYPE)
-        );
-
-        //Realloc failed?
-        if (new_dataStart == NULL) {
-            std::cerr
-            << "ERROR: while reallocating clause space"
-            << endl;
-
-            throw std::bad_alloc();
-        }
-        dataStart = new_dataStart;
+        << " region: " << region_names[region]
+        << " size: " << r.size
+        << " needed: " << needed
+        << " capacity: " << r.capacity
+        << endl;
 
-        //Update capacity to reflect the update
-        capacity = newcapacity;
+        throw std::bad_alloc();
     }
 
     //Add clause to the set
-    Clause* pointer = (Clause*)(dataStart + size);
-    size += needed;
-    currentlyUsedSize += needed;
+    if (r.capacity != old_capacity) {
+        update_slot_start(region);
+    }
+    Clause* pointer = (Clause*)(r.dataStart + r.size);
+    r.size += needed;
+    r.currentlyUsedSize += needed;
 
     return pointer;
 }
@@ -152,12 +278,13 @@ void* ClauseAllocator::allocEnough(
 /**
 @brief Given the pointer of the clause it finds a 32-bit offset for it
 
-Calculates the stack frame and the position of the pointer in the stack, and
-rerturns a 32-bit value that is a concatenation of these two
+Finds the region of the pointer, and its position in the stack of the region.
+The slot that covers that position gives the top bits.
 */
 ClOffset ClauseAllocator::get_offset(const Clause* ptr) const
 {
-    return ((BASE_DATA_TYPE*)ptr - dataStart);
+    const Region& r = regions[region_of(ptr)];
+    return offset_at(r, (BASE_DATA_TYPE*)ptr - r.dataStart);
 }
 
 /**
@@ -176,6 +303,7 @@ of the clause. Therefore, the "currentlyUsedSizes" is an overestimation!!
 void ClauseAllocator::clauseFree(Clause* cl)
 {
     assert(!cl->freed());
+    Region& r = regions[region_of(cl)];
 
     bool quick_freed = false;
     #ifdef USE_GAUSS
@@ -184,9 +312,9 @@ void ClauseAllocator::clauseFree(Clause* cl)
         uint64_t needed
             = neededbytes/sizeof(BASE_DATA_TYPE) + (bool)(neededbytes % sizeof(BASE_DATA_TYPE));
 
-        if (((BASE_DATA_TYPE*)cl + needed) == (dataStart + size)) {
-            size -= needed;
-            currentlyUsedSize -= needed;
+        if (((BASE_DATA_TYPE*)cl + needed) == (r.dataStart + r.size)) {
+            r.size -= needed;
+            r.currentlyUsedSize -= needed;
             quick_freed = true;
         }
     }
@@ -198,7 +326,7 @@ void ClauseAllocator::clauseFree(Clause* cl)
         est_num_cl = std::max(est_num_cl, (uint64_t)3); //we sometimes allow gauss to allocate 3-long clauses
         uint64_t bytes_freed = sizeof(Clause) + est_num_cl*sizeof(Lit);
         uint64_t elems_freed = bytes_freed/sizeof(BASE_DATA_TYPE) + (bool)(bytes_freed % sizeof(BASE_DATA_TYPE));
-        currentlyUsedSize -= elems_freed;
+        r.currentlyUsedSize -= elems_freed;
     }
 
     #ifdef VALGRIND_MAKE_MEM_UNDEFINED
@@ -212,33 +340,76 @@ void ClauseAllocator::clauseFree(ClOffset offset)
     clauseFree(cl);
 }
 
+/**
+@brief Copies the clause to the region of its tier, or to the new stack of
+its own region. Leaves the new offset in the old copy.
+
+Regions being compacted get a new stack in new_regions, the others are
+appended to.
+*/
 ClOffset ClauseAllocator::move_cl(
-    ClOffset* newDataStart
-    , ClOffset*& new_ptr
+    Region* new_regions
+    , const bool* compact
     , Clause* old
-) const {
+) {
     uint64_t bytesNeeded = sizeof(Clause) + old->size()*sizeof(Lit);
     uint64_t sizeNeeded = bytesNeeded/sizeof(BASE_DATA_TYPE) + (bool)(bytesNeeded % sizeof(BASE_DATA_TYPE));
+
+    const uint32_t from = region_of(old);
+    assert(compact[from]);
+    uint32_t to = old->gauss_temp_cl() ? from : proper_region(old);
+    Region* dest = compact[to] ? &new_regions[to] : &regions[to];
+    if (to != from) {
+        const uint64_t old_capacity = dest->capacity;
+        if (!reserve(*dest, to, sizeNeeded)) {
+            to = from;
+            dest = &new_regions[from];
+        } else if (!compact[to] && dest->capacity != old_capacity) {
+            update_slot_start(to);
+        }
+    }
+    if (to == from) {
+        //It fit into the slots of the old stack
+        const bool ok = reserve(*dest, from, sizeNeeded);
+        assert(ok);
+    } else {
+        regions[to].moved_in++;
+    }
+
+    BASE_DATA_TYPE* new_ptr = dest->dataStart + dest->size;
     memcpy(new_ptr, old, sizeNeeded*sizeof(BASE_DATA_TYPE));
+    const ClOffset new_offset = offset_at(*dest, dest->size);
+    dest->size += sizeNeeded;
+    dest->currentlyUsedSize += sizeNeeded;
 
-    ClOffset new_offset = new_ptr-newDataStart;
     (*old)[0] = Lit::toLit(new_offset & 0xFFFFFFFF);
     #ifdef LARGE_OFFSETS
     (*old)[1] = Lit::toLit((new_offset>>32) & 0xFFFFFFFF);
     #endif
     old->reloced = true;
 
-    new_ptr += sizeNeeded;
+    return new_offset;
+}
+
+ClOffset ClauseAllocator::relocated_offset(const Clause* old) const
+{
+    assert(old->reloced);
+    ClOffset new_offset = (*old)[0].toInt();
+    #ifdef LARGE_OFFSETS
+    new_offset += ((uint64_t)(*old)[1].toInt())<<32;
+    #endif
+
     return new_offset;
 }
 
 /**
 @brief If needed, compacts stacks, removing unused clauses
 
-Firstly, the algorithm determines if the number of useless slots is large or
-small compared to the problem size. If it is small, it does nothing. If it is
-large, then it allocates new stacks, copies the non-freed clauses to these new
-stacks, updates all pointers and offsets, and frees the original stacks.
+Firstly, the algorithm determines for each region if the number of useless
+slots is large or small compared to its size. Only the regions where it is
+large are compacted: their live clauses are copied to new stacks, or to the
+region of their current tier. Then all offsets to them are updated and the
+original stacks are freed. Clauses in other regions are not touched.
 */
 void ClauseAllocator::consolidate(
     Solver* solver
@@ -249,10 +420,15 @@ void ClauseAllocator::consolidate(
     //Neccesities:
     //1) There is too much memory allocated. Re-allocation will save space
     //   Avoiding segfault (max is 16 outerOffsets, more than 10 is near)
-    //2) There is too much empty, unused space (>30%)
-    if (!force
-        && (float_div(currentlyUsedSize, size) > 0.8 || currentlyUsedSize < (100ULL*1000ULL))
-    ) {
+    //2) There is too much empty, unused space (>20%) in the region
+    bool compact[num_regions];
+    bool any = false;
+    for(uint32_t i = 0; i < num_regions; i++) {
+        const Region& r = regions[i];
+        compact[i] = r.size > 0 && (force || r.fragmented());
+        any |= compact[i];
+    }
+    if (!any) {
         if (solver->conf.verbosity >= 3
             || (lower_verb && solver->conf.verbosity)
         ) {
@@ -262,25 +438,36 @@ void ClauseAllocator::consolidate(
     }
     const double myTime = cpuTime();
 
-    //Pointers that will be moved along
-    BASE_DATA_TYPE * const newDataStart = (BASE_DATA_TYPE*)malloc(currentlyUsedSize*sizeof(BASE_DATA_TYPE));
-    BASE_DATA_TYPE * new_ptr = newDataStart;
+    //New stacks, the used size is a good estimate of what's needed. They
+    //reuse the slots of the old ones: old offsets are only read through
+    //the old stacks, and slot_start is only changed once all are moved
+    Region new_regions[num_regions];
+    uint64_t old_size[num_regions];
+    for(uint32_t i = 0; i < num_regions; i++) {
+        old_size[i] = regions[i].size;
+        if (compact[i]) {
+            new_regions[i].num_owned = regions[i].num_owned;
+            std::copy(regions[i].owned, regions[i].owned + regions[i].num_owned
+                , new_regions[i].owned);
+            const uint64_t cap = std::max<uint64_t>(
+                std::min(regions[i].currentlyUsedSize, regions[i].size), 1);
+            new_regions[i].dataStart = (BASE_DATA_TYPE*)big_alloc(
+                cap*sizeof(BASE_DATA_TYPE), backing);
+            new_regions[i].capacity = cap;
+        }
+    }
 
     assert(sizeof(BASE_DATA_TYPE) % sizeof(Lit) == 0);
     for(auto& ws: solver->watches) {
         for(Watched& w: ws) {
-            if (w.isClause()) {
+            if (w.isClause() && compact[region_of(w.get_offset())]) {
                 Clause* old = ptr(w.get_offset());
                 assert(!old->freed());
                 Lit blocked = w.getBlockedLit();
                 if (old->reloced) {
-                    ClOffset new_offset = (*old)[0].toInt();
-                    #ifdef LARGE_OFFSETS
-                    new_offset += ((uint64_t)(*old)[1].toInt())<<32;
-                    #endif
-                    w = Watched(new_offset, blocked);
+                    w = Watched(relocated_offset(old), blocked);
                 } else {
-                    ClOffset new_offset = move_cl(newDataStart, new_ptr, old);
+                    ClOffset new_offset = move_cl(new_regions, compact, old);
                     w = Watched(new_offset, blocked);
                 }
             }
@@ -290,15 +477,14 @@ void ClauseAllocator::consolidate(
     #ifdef USE_GAUSS
     for (EGaussian* gauss : solver->gmatrixes) {
         for(auto& gcl: gauss->clauses_toclear) {
+            if (!compact[region_of(gcl.first)]) {
+                continue;
+            }
             Clause* old = ptr(gcl.first);
             if (old->reloced) {
-                ClOffset new_offset = (*old)[0].toInt();
-                #ifdef LARGE_OFFSETS
-                new_offset += ((uint64_t)(*old)[1].toInt())<<32;
-                #endif
-                gcl.first = new_offset;
+                gcl.first = relocated_offset(old);
             } else {
-                ClOffset new_offset = move_cl(newDataStart, new_ptr, old);
+                ClOffset new_offset = move_cl(new_regions, compact, old);
                 gcl.first = new_offset;
             }
             assert(!old->freed());
@@ -306,9 +492,9 @@ void ClauseAllocator::consolidate(
     }
     #endif //USE_GAUSS
 
-    update_offsets(solver->longIrredCls);
+    update_offsets(solver->longIrredCls, compact);
     for(auto& lredcls: solver->longRedCls) {
-        update_offsets(lredcls);
+        update_offsets(lredcls, compact);
     }
 
     //Fix up propBy
@@ -320,36 +506,55 @@ void ClauseAllocator::consolidate(
                 && vdata.level != 0
                 && solver->value(i) != l_Undef
             ) {
-                Clause* old = ptr(vdata.reason.get_offset());
-                assert(!old->freed());
-                ClOffset new_offset = (*old)[0].toInt();
-                #ifdef LARGE_OFFSETS
-                new_offset += ((uint64_t)(*old)[1].toInt())<<32;
-                #endif
-                vdata.reason = PropBy(new_offset);
+                if (compact[region_of(vdata.reason.get_offset())]) {
+                    Clause* old = ptr(vdata.reason.get_offset());
+                    assert(!old->freed());
+                    vdata.reason = PropBy(relocated_offset(old));
+                }
             } else {
                 vdata.reason = PropBy();
             }
         }
     }
 
-    //Update sizes
-    const uint64_t old_size = size;
-    size = new_ptr-newDataStart;
-    capacity = currentlyUsedSize;
-    currentlyUsedSize = size;
-    free(dataStart);
-    dataStart = newDataStart;
+    //Swap in the new stacks
+    for(uint32_t i = 0; i < num_regions; i++) {
+        if (!compact[i]) {
+            continue;
+        }
+        Region& r = regions[i];
+        const Region& n = new_regions[i];
+        big_free(r.dataStart, r.capacity*sizeof(BASE_DATA_TYPE), backing);
+        r.reclaimed += old_size[i] > n.size ? old_size[i] - n.size : 0;
+        r.dataStart = n.dataStart;
+        r.size = n.size;
+        r.capacity = n.capacity;
+        r.currentlyUsedSize = n.size;
+        r.num_compact++;
+        r.num_owned = n.num_owned;
+        std::copy(n.owned, n.owned + n.num_owned, r.owned);
+        release_slots(r);
+        update_slot_start(i);
+    }
 
     const double time_used = cpuTime() - myTime;
+    num_consolidate++;
+    consolidate_time += time_used;
+    max_pause = std::max(max_pause, time_used);
     if (solver->conf.verbosity >= 2
         || (lower_verb && solver->conf.verbosity)
     ) {
-        cout << "c [mem] consolidate ";
-        cout << " old-sz: "; print_value_kilo_mega(old_size*sizeof(BASE_DATA_TYPE));
-        cout << " new-sz: "; print_value_kilo_mega(size*sizeof(BASE_DATA_TYPE));
-        cout << " new bits offs: " << std::fixed << std::setprecision(2) << std::log2(size);
-        cout << solver->conf.print_times(time_used)
+        for(uint32_t i = 0; i < num_regions; i++) {
+            if (!compact[i]) {
+                continue;
+            }
+            cout << "c [mem] consolidate " << region_names[i];
+            cout << " old-sz: "; print_value_kilo_mega(old_size[i]*sizeof(BASE_DATA_TYPE));
+            cout << " new-sz: "; print_value_kilo_mega(regions[i].size*sizeof(BASE_DATA_TYPE));
+            cout << endl;
+        }
+        cout << "c [mem] consolidate pause"
+        << solver->conf.print_times(time_used)
         << endl;
     }
     if (solver->sqlStats) {
@@ -363,22 +568,63 @@ void ClauseAllocator::consolidate(
 
 void ClauseAllocator::update_offsets(
     vector<ClOffset>& offsets
+    , const bool* compact
 ) {
 
     for(ClOffset& offs: offsets) {
-        Clause* old = ptr(offs);
-        assert(old->reloced);
-        offs = (*old)[0].toInt();
-        #ifdef LARGE_OFFSETS
-        offs += ((uint64_t)(*old)[1].toInt())<<32;
-        #endif
+        if (compact[region_of(offs)]) {
+            offs = relocated_offset(ptr(offs));
+        }
     }
 }
 
 size_t ClauseAllocator::mem_used() const
 {
     uint64_t mem = 0;
-    mem += capacity*sizeof(BASE_DATA_TYPE);
+    for(const Region& r: regions) {
+        mem += r.capacity*sizeof(BASE_DATA_TYPE);
+    }
 
     return mem;
 }
+
+void ClauseAllocator::print_mem_stats(const size_t totalMem) const
+{
+    for(uint32_t i = 0; i < num_regions; i++) {
+        const Region& r = regions[i];
+        const uint64_t mem = r.capacity*sizeof(BASE_DATA_TYPE);
+        print_stats_line(string("c Mem for ") + region_names[i]
+            , mem/(1024UL*1024UL)
+            , "MB"
+            , stats_line_percent(mem, totalMem)
+            , "%"
+        );
+        print_stats_line("c   fragmentation"
+            , stats_line_percent(r.size - std::min(r.size, r.currentlyUsedSize), r.size)
+            , "%"
+        );
+        print_stats_line("c   compactions"
+            , r.num_compact
+            , r.reclaimed*sizeof(BASE_DATA_TYPE)/(1024UL*1024UL)
+            , "MB reclaimed"
+        );
+        print_stats_line("c   moved in on tier change"
+            , r.moved_in
+        );
+        print_stats_line("c   offset slots"
+            , r.num_owned
+            , (((uint64_t)r.num_owned << slot_bits)*sizeof(BASE_DATA_TYPE))/(1024UL*1024UL)
+            , "MB"
+        );
+    }
+
+    print_stats_line("c consolidate pauses"
+        , num_consolidate
+        , float_div(consolidate_time, num_consolidate)
+        , "s avg"
+    );
+    print_stats_line("c consolidate max pause"
+        , max_pause
+        , "s"
+    );
+}
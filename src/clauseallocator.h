@@ -28,11 +28,16 @@ THE SOFTWARE.
 #include "cloffset.h"
 #include "watched.h"
 #include "clause.h"
+#include "bigmem.h"
 
 #include <stdlib.h>
 #include <map>
 #include <vector>
 
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
+
 namespace CMSat {
 
 class Clause;
@@ -42,6 +47,15 @@ class PropEngine;
 using std::map;
 using std::vector;
 
+///Clauses are allocated in separate regions depending on how long they are
+///expected to live, so the regions with churn can be compacted on their own
+enum class ClRegion : uint32_t {
+    irred = 0
+    , red_tier0 = 1
+    , red_tier1 = 2
+    , red_tier2 = 3 ///<Short-lived learnts, most of the churn is here
+};
+
 /**
 @brief Allocates memory for (xor) clauses
 
@@ -50,6 +64,15 @@ needed. When instructed, it consolidates the unused space (i.e. clauses free()-e
 Essentially, it is a stack-like allocator for clauses. It is useful to have
 this, because this way, we can address clauses according to their number,
 which is 32-bit, instead of their address, which might be 64-bit
+
+There is one such stack per ClRegion. The top bits of the offset give a slot,
+and the slots are handed out to the regions as their stacks grow, and taken
+back when compaction shrinks them. So any region can use all of the offset
+space the others leave free. Consolidation only compacts the regions that
+are fragmented, and moves the clauses it copies to the region of their
+current tier. Tier 0 clauses are never reduced, so their region is only
+compacted once half of it is garbage. Tier 2 is reduced in bulk, and its
+region is reclaimed whenever anything was freed.
 */
 class ClauseAllocator {
     public:
@@ -61,12 +84,13 @@ class ClauseAllocator {
             #ifdef STATS_NEEDED
             , const int64_t ID
             #endif
+            , const ClRegion region = ClRegion::irred
         ) {
             if (ps.size() > (0x01UL << 28)) {
                 throw CMSat::TooLongClauseError();
             }
 
-            void* mem = allocEnough(ps.size());
+            void* mem = allocEnough(ps.size(), (uint32_t)region);
             Clause* real = new (mem) Clause(ps, conflictNum
             #ifdef STATS_NEEDED
             , ID
@@ -80,7 +104,7 @@ class ClauseAllocator {
 
         inline Clause* ptr(const ClOffset offset) const
         {
-            return (Clause*)(&dataStart[offset]);
+            return (Clause*)(slot_start[offset >> slot_bits] + (offset & slot_mask));
         }
 
         void clauseFree(Clause* c); ///Frees memory and associated clause number
@@ -93,35 +117,89 @@ class ClauseAllocator {
         );
 
         size_t mem_used() const;
+        void print_mem_stats(const size_t totalMem) const;
+        void set_backing(const BigMem backing); ///<Must be called while empty
+
+        ///Only for tests: no more than num slots will be handed out
+        void testing_limit_slots(const uint32_t num);
+
+        static const uint32_t num_regions = 4;
+        static const uint32_t num_slots = 32;
+        static const uint32_t slot_bits = EFFECTIVELY_USEABLE_BITS - 5;
 
     private:
-        void update_offsets(vector<ClOffset>& offsets);
+        #ifdef CMS_TESTING_ENABLED
+        FRIEND_TEST(clause_allocator, tier_change);
+        FRIEND_TEST(clause_allocator, fill_and_release_slots);
+        #endif
+
+        static const ClOffset slot_mask = (((ClOffset)1) << slot_bits) - 1;
+
+        struct Region
+        {
+            BASE_DATA_TYPE* dataStart = NULL; ///<Stack starts at this position
+            uint64_t size = 0; ///<The number of BASE_DATA_TYPE datapieces currently used
+            uint64_t capacity = 0; ///<The number of BASE_DATA_TYPE datapieces allocated
+            /**
+            @brief The estimated used size of the stack
+            This is incremented by clauseSize each time a clause is allocated, and
+            decremetented by clauseSize each time a clause is deallocated. The
+            problem is, that clauses can shrink, and thus this value will be an
+            overestimation almost all the time
+            */
+            uint64_t currentlyUsedSize = 0;
+            uint32_t owned[ClauseAllocator::num_slots]; ///<Slots of the stack, in order
+            uint32_t num_owned = 0;
+            double compact_below = 0.8; ///<Compact once used/size drops to this
+
+            //Stats
+            uint64_t num_compact = 0;
+            uint64_t moved_in = 0; ///<Clauses moved here from other regions
+            uint64_t reclaimed = 0; ///<Datapieces freed by compaction
+
+            bool fragmented() const;
+        };
+        Region regions[num_regions];
+        BASE_DATA_TYPE* slot_start[num_slots]; ///<Where the offsets of each slot start
+        uint32_t slot_region[num_slots]; ///<num_regions if the slot is free
+        uint32_t free_slots[num_slots];
+        uint32_t num_free_slots = 0;
+
+        BigMem backing = BigMem::malloc_backed;
+
+        //Stats of consolidate()
+        uint64_t num_consolidate = 0;
+        double consolidate_time = 0;
+        double max_pause = 0;
+
+        static uint32_t proper_region(const Clause* cl);
+        uint32_t region_of(const Clause* cl) const;
+        uint32_t region_of(const ClOffset offset) const
+        {
+            return slot_region[offset >> slot_bits];
+        }
+        void update_slot_start(const uint32_t region);
+        uint64_t max_size(const Region& r) const
+        {
+            return (uint64_t)(r.num_owned + num_free_slots) << slot_bits;
+        }
+        ClOffset offset_at(const Region& r, const uint64_t pos) const
+        {
+            return ((ClOffset)r.owned[pos >> slot_bits] << slot_bits) | (pos & slot_mask);
+        }
+        void take_slots(Region& r, const uint32_t region);
+        void release_slots(Region& r);
+        bool reserve(Region& r, const uint32_t region, const uint64_t needed);
+        ClOffset relocated_offset(const Clause* old) const;
+        void update_offsets(vector<ClOffset>& offsets, const bool* compact);
 
         ClOffset move_cl(
-            ClOffset* newDataStart
-            , ClOffset*& new_ptr
+            Region* new_regions
+            , const bool* compact
             , Clause* old
-        ) const;
-
-        BASE_DATA_TYPE* dataStart; ///<Stack starts at these positions
-        uint64_t size; ///<The number of BASE_DATA_TYPE datapieces currently used in each stack
-        /**
-        @brief Clauses in the stack had this size when they were allocated
-        This my NOT be their current size: the clauses may be shrinked during
-        the running of the solver. Therefore, it is imperative that their orignal
-        size is saved. This way, we can later move clauses around.
-        */
-        uint64_t capacity; ///<The number of BASE_DATA_TYPE datapieces allocated
-        /**
-        @brief The estimated used size of the stack
-        This is incremented by clauseSize each time a clause is allocated, and
-        decremetented by clauseSize each time a clause is deallocated. The
-        problem is, that clauses can shrink, and thus this value will be an
-        overestimation almost all the time
-        */
-        uint64_t currentlyUsedSize;
-
-        void* allocEnough(const uint32_t num_lits);
+        );
+
+        void* allocEnough(const uint32_t num_lits, const uint32_t region);
 };
 
 } //end namespace
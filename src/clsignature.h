@@ -0,0 +1,144 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef __CL_SIGNATURE__H__
+#define __CL_SIGNATURE__H__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "cryptominisat5/solvertypesmini.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace CMSat {
+
+/**
+@brief 64-bit Bloom signature of the literals of a clause
+
+Unlike cl_abst_type, which hashes variables into 29 bits and is shared with
+strengthening, this hashes literals, so it also filters out clauses that
+only contain the negation of a literal. Only usable for plain subsumption.
+*/
+typedef uint64_t cl_sig_type;
+
+inline cl_sig_type lit_sig(const Lit lit)
+{
+    return 1ULL << ((lit.toInt() * 2654435761U) >> 26);
+}
+
+template <class T>
+cl_sig_type calc_sig(const T& ps)
+{
+    cl_sig_type sig = 0;
+    for (const Lit l: ps)
+        sig |= lit_sig(l);
+
+    return sig;
+}
+
+/**
+@brief Puts into 'out' the indexes of 'sigs' that could be supersets of 'sig'
+
+'sigs' is contiguous so this can test multiple signatures at a time.
+@return number of candidates written. 'out' must have room for 'num'.
+*/
+inline size_t filter_sig_supersets(
+    const cl_sig_type* sigs
+    , const size_t num
+    , const cl_sig_type sig
+    , uint32_t* out
+) {
+    size_t n = 0;
+    size_t i = 0;
+
+    #if defined(__AVX2__)
+    const __m256i s = _mm256_set1_epi64x((long long)sig);
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 4 <= num; i += 4) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(sigs + i));
+        const __m256i missing = _mm256_andnot_si256(v, s);
+        int mask = _mm256_movemask_pd(
+            _mm256_castsi256_pd(_mm256_cmpeq_epi64(missing, zero)));
+        while (mask) {
+            const int at = __builtin_ctz(mask);
+            out[n++] = i + at;
+            mask &= mask - 1;
+        }
+    }
+    #elif defined(__SSE2__)
+    //No 64-bit compare in SSE2: both 32-bit halves must be zero
+    const __m128i s = _mm_set1_epi64x((long long)sig);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 2 <= num; i += 2) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(sigs + i));
+        const __m128i missing = _mm_andnot_si128(v, s);
+        const int mask = _mm_movemask_ps(
+            _mm_castsi128_ps(_mm_cmpeq_epi32(missing, zero)));
+        out[n] = i;
+        n += (mask & 3) == 3;
+        out[n] = i + 1;
+        n += (mask & 12) == 12;
+    }
+    #endif
+
+    //Branch-free, so it is also fine for the compiler to vectorise
+    for (; i < num; i++) {
+        out[n] = i;
+        n += (sig & ~sigs[i]) == 0;
+    }
+
+    return n;
+}
+
+/**
+@brief Sorted-merge subset test: are all literals of A in B?
+
+Both must be sorted. On return 'i' is the number of literals of A found and
+'i2' the number of literals of B walked
+*/
+template<class T1, class T2>
+inline bool sorted_subset(const T1& A, const T2& B, uint32_t& i, uint32_t& i2)
+{
+    i = 0;
+    for (i2 = 0; i2 < B.size(); i2++) {
+        //Literals are ordered
+        if (A[i] < B[i2]) {
+            return false;
+        } else if (A[i] == B[i2]) {
+            i++;
+
+            //went through the whole of A now, so A subsumes B
+            if (i == A.size())
+                return true;
+        }
+    }
+
+    return false;
+}
+
+} //end namespace
+
+#endif //__CL_SIGNATURE__H__
@@ -28,6 +28,9 @@ THE SOFTWARE.
 
 using namespace CMSat;
 
+//cmsat_add_clauses() hands the literals over as they are
+static_assert(sizeof(Lit) == sizeof(uint32_t), "Lit must be a 32bit unsigned integer");
+
 extern "C" {
 
 struct cmsat_solver {
@@ -199,6 +202,38 @@ CMS_DLL_PUBLIC int32_t cmsat_add_clause(cmsat_solver_t *s, const uint32_t *a, ui
   return s->solver.add_clause(s->lit_buffer) - 1;
 }
 
+/*
+ * Add many clauses in one call:
+ * - n = number of clauses
+ * - a = array of literals of all the clauses, one after the other
+ * - offsets = array of n+1 indices into a: clause i is
+ *   a[offsets[i]] ... a[offsets[i+1]-1]
+ * - literals are encoded as in cmsat_add_clause. a is not copied.
+ *
+ * - return -1 if the solver became unsat
+ * - return 0 otherwise
+ */
+CMS_DLL_PUBLIC int32_t cmsat_add_clauses(cmsat_solver_t *s, const uint32_t *a, const uint32_t *offsets, uint32_t n) {
+  return s->solver.add_clauses(reinterpret_cast<const Lit*>(a), offsets, n) - 1;
+}
+
+/*
+ * Freeze variable var: simplification won't eliminate, decompose or
+ * replace it, so it stays cheap to use in later clauses and assumptions.
+ * Freezing is reference counted, cmsat_melt() undoes one cmsat_freeze().
+ */
+CMS_DLL_PUBLIC void cmsat_freeze(cmsat_solver_t *s, uint32_t var) {
+  s->solver.freeze(var);
+}
+
+CMS_DLL_PUBLIC void cmsat_melt(cmsat_solver_t *s, uint32_t var) {
+  s->solver.melt(var);
+}
+
+CMS_DLL_PUBLIC bool cmsat_is_frozen(const cmsat_solver_t *s, uint32_t var) {
+  return s->solver.is_frozen(var);
+}
+
 /*
  * Add an xor clause
  * - n = number of variables in the clause
@@ -234,6 +269,46 @@ CMS_DLL_PUBLIC cmsat_status_t cmsat_solve_with_assumptions(cmsat_solver_t *s, co
 /*
  * Value of variable x in s
  */
+CMS_DLL_PUBLIC int32_t cmsat_solve_async(cmsat_solver_t *s, const uint32_t* a, uint32_t n, void (*on_finished)(void *user_data, cmsat_status_t status), void *user_data) {
+  if (!s->solver.solve_async_poll()) {
+    return -1;
+  }
+
+  std::function<void(lbool)> callback;
+  if (on_finished) {
+    callback = [on_finished, user_data](lbool result) {
+      on_finished(user_data, lbool2status(result));
+    };
+  }
+  build_lit_array(s, a, n);
+  s->solver.solve_async(&s->lit_buffer, false, callback);
+  return 0;
+}
+
+CMS_DLL_PUBLIC bool cmsat_solve_async_poll(const cmsat_solver_t *s) {
+  return s->solver.solve_async_poll();
+}
+
+CMS_DLL_PUBLIC bool cmsat_solve_async_wait_for(const cmsat_solver_t *s, double secs) {
+  return s->solver.solve_async_wait_for(secs);
+}
+
+CMS_DLL_PUBLIC cmsat_status_t cmsat_solve_async_result(cmsat_solver_t *s) {
+  return lbool2status(s->solver.solve_async_result());
+}
+
+CMS_DLL_PUBLIC void cmsat_solve_async_cancel(cmsat_solver_t *s) {
+  s->solver.solve_async_cancel();
+}
+
+CMS_DLL_PUBLIC void cmsat_get_live_progress(const cmsat_solver_t *s, cmsat_progress_t *p) {
+  const SearchProgress progress = s->solver.get_live_progress();
+  p->conflicts = progress.conflicts;
+  p->propagations = progress.propagations;
+  p->decisions = progress.decisions;
+  p->restarts = progress.restarts;
+}
+
 CMS_DLL_PUBLIC cmsat_value_t cmsat_var_value(cmsat_solver_t *s, uint32_t x) {
   const std::vector<lbool> model = s->solver.get_model();
   return lbool2value(model[x]);
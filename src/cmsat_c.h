@@ -175,6 +175,27 @@ extern CMS_DLL_PUBLIC uint32_t cmsat_nvars(const cmsat_solver_t *s);
  */
 extern CMS_DLL_PUBLIC int32_t cmsat_add_clause(cmsat_solver_t *s, const uint32_t *a, uint32_t n);
 
+/*
+ * Add many clauses in one call:
+ * - n = number of clauses
+ * - a = array of literals of all the clauses, one after the other
+ * - offsets = array of n+1 indices into a: clause i is
+ *   a[offsets[i]] ... a[offsets[i+1]-1]
+ * - literals are encoded as in cmsat_add_clause. a is not copied.
+ *
+ * - return -1 if the solver became unsat
+ * - return 0 otherwise
+ */
+extern CMS_DLL_PUBLIC int32_t cmsat_add_clauses(cmsat_solver_t *s, const uint32_t *a, const uint32_t *offsets, uint32_t n);
+
+/*
+ * Freeze variable var: simplification won't eliminate, decompose or
+ * replace it, so it stays cheap to use in later clauses and assumptions.
+ * Freezing is reference counted, cmsat_melt() undoes one cmsat_freeze().
+ */
+extern CMS_DLL_PUBLIC void cmsat_freeze(cmsat_solver_t *s, uint32_t var);
+extern CMS_DLL_PUBLIC void cmsat_melt(cmsat_solver_t *s, uint32_t var);
+extern CMS_DLL_PUBLIC bool cmsat_is_frozen(const cmsat_solver_t *s, uint32_t var);
 
 /*
  * Add an xor clause
@@ -202,6 +223,45 @@ extern CMS_DLL_PUBLIC cmsat_status_t cmsat_solve(cmsat_solver_t *s);
 extern CMS_DLL_PUBLIC cmsat_status_t cmsat_solve_with_assumptions(cmsat_solver_t *s, const uint32_t* a, uint32_t n);
 
 
+/*
+ * Solve in the background, with assumptions:
+ * - n = number of assumptions
+ * - a = array of n assumptions, it is copied
+ * - if on_finished is not NULL, on_finished(user_data, status) is called
+ *   from the solving thread once it's done. It must not call into s.
+ * - until it has finished, only the cmsat_solve_async_* functions
+ *   and cmsat_get_live_progress can be called on s
+ *
+ * - return -1 if the previous cmsat_solve_async is still running
+ * - return 0 otherwise
+ */
+extern CMS_DLL_PUBLIC int32_t cmsat_solve_async(cmsat_solver_t *s, const uint32_t* a, uint32_t n, void (*on_finished)(void *user_data, cmsat_status_t status), void *user_data);
+
+/*
+ * - poll: true if the call started by cmsat_solve_async has finished
+ * - wait_for: wait at most secs seconds for it to finish, then poll
+ * - result: wait for it to finish and return its result
+ * - cancel: stop it as soon as possible, its result will be CMSAT_UNKNOWN
+ */
+extern CMS_DLL_PUBLIC bool cmsat_solve_async_poll(const cmsat_solver_t *s);
+extern CMS_DLL_PUBLIC bool cmsat_solve_async_wait_for(const cmsat_solver_t *s, double secs);
+extern CMS_DLL_PUBLIC cmsat_status_t cmsat_solve_async_result(cmsat_solver_t *s);
+extern CMS_DLL_PUBLIC void cmsat_solve_async_cancel(cmsat_solver_t *s);
+
+/*
+ * Search statistics, summed over all threads, as of their last restart.
+ * Safe to call while cmsat_solve_async is running.
+ */
+typedef struct cmsat_progress {
+  uint64_t conflicts;
+  uint64_t propagations;
+  uint64_t decisions;
+  uint64_t restarts;
+} cmsat_progress_t;
+
+extern CMS_DLL_PUBLIC void cmsat_get_live_progress(const cmsat_solver_t *s, cmsat_progress_t *p);
+
+
 /*
  * Value of variable x in s
  */
@@ -249,6 +249,7 @@ uint64_t CNF::print_mem_used_longclauses(const size_t totalMem) const
         , stats_line_percent(mem, totalMem)
         , "%"
     );
+    cl_alloc.print_mem_stats(totalMem);
 
     return mem;
 }
@@ -388,9 +389,11 @@ void CNF::save_state(SimpleOutFile& f) const
 
 void CNF::load_state(SimpleInFile& f)
 {
-    assert(seen.empty());
-    assert(varData.empty());
-    assert(watches.size() == 0);
+    //Loading into a solver whose variables were already set up
+    //(e.g. when resuming from a checkpoint) must not leave watches behind
+    for(watch_subarray_const ws: watches) {
+        assert(ws.empty());
+    }
 
     f.get_vector(interToOuterMain);
     f.get_vector(outerToInterMain);
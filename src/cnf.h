@@ -75,6 +75,13 @@ public:
         if (_conf != NULL) {
             conf = *_conf;
         }
+        if (conf.huge_pages >= 1 && conf.huge_pages <= 2) {
+            cl_alloc.set_backing((BigMem)conf.huge_pages);
+        }
+        if (conf.watch_pool) {
+            watches.use_pool((BigMem)std::max(0, std::min(conf.huge_pages, 2)));
+        }
+        implCache.set_max_bytes((size_t)conf.maxCacheSizeMB*1024ULL*1024ULL);
         drat = new Drat();
         assert(_must_interrupt_inter != NULL);
         must_interrupt_inter = _must_interrupt_inter;
@@ -284,8 +291,12 @@ protected:
     void test_reflectivity_of_renumbering() const;
     vector<lbool> back_number_solution_from_inter_to_outer(const vector<lbool>& solution) const
     {
+        //Like updateArrayRev(), but without its extra copy
+        assert(solution.size() >= interToOuterMain.size());
         vector<lbool> back_numbered = solution;
-        updateArrayRev(back_numbered, interToOuterMain);
+        for(size_t i = 0; i < interToOuterMain.size(); i++) {
+            back_numbered[interToOuterMain[i]] = solution[i];
+        }
         return back_numbered;
     }
 
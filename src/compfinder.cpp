@@ -46,11 +46,67 @@ using std::endl;
 
 //#define PART_FINDING
 
-CompFinder::CompFinder(Solver* _solver) :
-    timedout(false)
-    , seen(_solver->seen)
+CompFinder::CompFinder(Solver* _solver, const bool _incremental) :
+    incremental(_incremental)
+    , timedout(false)
+    , rebuilt(false)
     , solver(_solver)
 {
+    uf_grow(solver->nVarsOuter());
+
+    //Every irred clause will be streamed in from the start
+    uf_valid = incremental;
+}
+
+void CompFinder::uf_grow(const size_t n)
+{
+    for(size_t var = uf_parent.size(); var < n; var++) {
+        uf_parent.push_back(var);
+        uf_size.push_back(1);
+    }
+}
+
+void CompFinder::new_var(const uint32_t /*orig_outer*/)
+{
+    uf_grow(solver->nVarsOuter());
+}
+
+void CompFinder::new_vars(const size_t /*n*/)
+{
+    uf_grow(solver->nVarsOuter());
+}
+
+void CompFinder::new_irred_clause(const vector<Lit>& lits)
+{
+    if (!incremental || !uf_valid)
+        return;
+
+    irred_cls_added++;
+    const uint32_t first = solver->map_inter_to_outer(lits[0].var());
+    for(size_t i = 1; i < lits.size(); i++) {
+        uf_union(first, solver->map_inter_to_outer(lits[i].var()));
+    }
+}
+
+void CompFinder::vars_merged_outer(const uint32_t var1, const uint32_t var2)
+{
+    if (!incremental || !uf_valid)
+        return;
+
+    uf_union(var1, var2);
+}
+
+size_t CompFinder::mem_used() const
+{
+    size_t mem = 0;
+    mem += uf_parent.capacity()*sizeof(uint32_t);
+    mem += uf_size.capacity()*sizeof(uint32_t);
+    mem += table.capacity()*sizeof(uint32_t);
+    for(const auto& it: reverseTable) {
+        mem += it.second.capacity()*sizeof(uint32_t);
+    }
+
+    return mem;
 }
 
 void CompFinder::print_found_components() const
@@ -98,6 +154,21 @@ bool CompFinder::reverse_table_is_correct() const
     return true;
 }
 
+uint64_t CompFinder::num_irred_cls() const
+{
+    return solver->longIrredCls.size() + solver->binTri.irredBins;
+}
+
+bool CompFinder::must_rebuild() const
+{
+    if (!incremental || !uf_valid)
+        return true;
+
+    //Many irred clauses are gone, components may have split up
+    const uint64_t expected = irred_cls_at_build + irred_cls_added;
+    return num_irred_cls()*10 < expected*9;
+}
+
 void CompFinder::find_components()
 {
     assert(solver->okay());
@@ -106,25 +177,71 @@ void CompFinder::find_components()
     table.clear();
     table.resize(solver->nVars(), std::numeric_limits<uint32_t>::max());
     reverseTable.clear();
-    comp_no = 0;
-    used_comp_no = 0;
 
     solver->clauseCleaner->remove_and_clean_all();
 
-    //Add the clauses to the sets
     bogoprops_remain =
         solver->conf.comp_find_time_limitM*1000ULL*1000ULL
         *solver->conf.global_timeout_multiplier;
     orig_bogoprops = bogoprops_remain;
     timedout = false;
+    rebuilt = must_rebuild();
+    if (rebuilt && !rebuild_union_find() && incremental && uf_valid) {
+        //The streamed union-find may be coarser, but it is correct
+        timedout = false;
+    }
+    if (!timedout) {
+        fill_tables();
+    }
+    print_and_add_to_sql_result(myTime);
+
+    assert(solver->okay());
+}
+
+//Builds the union-find from the clauses. Keeps the old one if it times out
+bool CompFinder::rebuild_union_find()
+{
+    vector<uint32_t> old_parent;
+    vector<uint32_t> old_size;
+    old_parent.swap(uf_parent);
+    old_size.swap(uf_size);
+    uf_grow(solver->nVarsOuter());
+
     add_clauses_to_component(solver->longIrredCls);
     addToCompImplicits();
     if (timedout) {
-        reverseTable.clear();
+        old_parent.swap(uf_parent);
+        old_size.swap(uf_size);
+        return false;
     }
-    print_and_add_to_sql_result(myTime);
 
-    assert(solver->okay());
+    uf_valid = true;
+    irred_cls_at_build = num_irred_cls();
+    irred_cls_added = 0;
+    return true;
+}
+
+//Every unset, non-removed var that is in an irred clause is in the
+//component of its union-find root
+void CompFinder::fill_tables()
+{
+    bogoprops_remain -= (int64_t)solver->nVars()*2;
+    for (uint32_t var = 0; var < solver->nVars(); var++) {
+        if (solver->value(var) != l_Undef
+            || solver->varData[var].removed != Removed::none
+        ) {
+            continue;
+        }
+
+        const uint32_t root = uf_find(solver->map_inter_to_outer(var));
+
+        //Never been in an irred clause
+        if (uf_size[root] < 2)
+            continue;
+
+        table[var] = root;
+        reverseTable[root].push_back(var);
+    }
 }
 
 void CompFinder::print_and_add_to_sql_result(const double myTime) const
@@ -140,6 +257,7 @@ void CompFinder::print_and_add_to_sql_result(const double myTime) const
         << " BP: "
         << std::setprecision(2) << std::fixed
         << (double)(orig_bogoprops-bogoprops_remain)/(1000.0*1000.0)<< "M"
+        << " rebuilt: " << (int)rebuilt
         << solver->conf.print_times(time_used, timedout, time_remain)
         << endl;
 
@@ -174,8 +292,6 @@ void CompFinder::add_clauses_to_component(const vector<ClOffset>& cs)
 
 void CompFinder::addToCompImplicits()
 {
-    vector<Lit> lits;
-
     for (size_t var = 0; var < solver->nVars(); var++) {
         if (bogoprops_remain <= 0) {
             timedout = true;
@@ -183,100 +299,29 @@ void CompFinder::addToCompImplicits()
         }
 
         bogoprops_remain -= 2;
-        Lit lit(var, false);
-        lits.clear();
-        lits.push_back(lit);
         for(int sign = 0; sign < 2; sign++) {
-            lit = Lit(var, sign);
-            watch_subarray ws = solver->watches[lit];
+            const Lit lit = Lit(var, sign);
+            watch_subarray_const ws = solver->watches[lit];
 
             //If empty, skip
             if (ws.empty())
                 continue;
 
             bogoprops_remain -= (int64_t)ws.size() + 10;
-            for(const Watched *it2 = ws.begin(), *end2 = ws.end()
-                ; it2 != end2
-                ; it2++
-            ) {
-                if (it2->isBin()
+            for(const Watched& w: ws) {
+                if (w.isBin()
                     //Only irred
-                    && !it2->red()
+                    && !w.red()
                     //Only do each binary once
-                    && lit < it2->lit2()
+                    && lit < w.lit2()
                 ) {
-                    if (!seen[it2->lit2().var()]) {
-                        lits.push_back(it2->lit2());
-                        seen[it2->lit2().var()] = 1;
-                    }
+                    uf_union(
+                        solver->map_inter_to_outer(var)
+                        , solver->map_inter_to_outer(w.lit2().var())
+                    );
                 }
             }
         }
-
-        if (lits.size() > 1) {
-            //Clear seen
-            for(vector<Lit>::const_iterator
-                it = lits.begin(), end = lits.end()
-                ; it != end
-                ; ++it
-            ) {
-                seen[it->var()] = 0;
-            }
-
-            add_clause_to_component(lits);
-        }
-
-    }
-}
-
-template<class T>
-bool CompFinder::belong_to_same_component(const T& cl)
-{
-    if (table[cl[0].var()] != std::numeric_limits<uint32_t>::max()) {
-        bogoprops_remain -= (int64_t)cl.size()/2 + 1;
-        const uint32_t comp = table[cl[0].var()];
-
-        for (const Lit l: cl) {
-            if (table[l.var()] != comp) {
-                return false;
-            }
-        }
-
-        return true;
-    }
-
-    return false;
-}
-
-template<class T>
-void CompFinder::fill_newset_and_tomerge(const T& cl)
-{
-    bogoprops_remain -= (int64_t)cl.size()*2;
-
-    for (const Lit lit: cl) {
-        if (table[lit.var()] != std::numeric_limits<uint32_t>::max()
-        ) {
-            if (!seen[table[lit.var()]]) {
-                tomerge.push_back(table[lit.var()]);
-                seen[table[lit.var()]] = 1;
-            }
-        } else {
-            newSet.push_back(lit.var());
-        }
-    }
-}
-
-void CompFinder::merge_newset_into_single_component()
-{
-    const uint32_t into = tomerge[0];
-    seen[into] = 0;
-    map<uint32_t, vector<uint32_t> >::iterator intoReverse
-        = reverseTable.find(into);
-
-    //Put the new lits into this set
-    for (const uint32_t v: newSet) {
-        intoReverse->second.push_back(v);
-        table[v] = into;
     }
 }
 
@@ -284,59 +329,10 @@ template<class T>
 void CompFinder::add_clause_to_component(const T& cl)
 {
     assert(cl.size() > 1);
-    tomerge.clear();
-    newSet.clear();
-
-    if (belong_to_same_component(cl)) {
-        return;
-    }
+    bogoprops_remain -= (int64_t)cl.size();
 
-    fill_newset_and_tomerge(cl);
-
-    //no sets to merge, only merge the clause into one tree
-    if (tomerge.size() == 1) {
-        merge_newset_into_single_component();
-        return;
-    }
-
-    //Expensive merging coming up
-    bogoprops_remain -= 20;
-
-    //Delete tables to merge and put their elements into newSet
-    for (const uint32_t merge: tomerge) {
-        //Clear seen
-        seen[merge] = 0;
-
-        //Find in reverseTable
-        bogoprops_remain -= (int64_t)reverseTable.size()*2;
-        map<uint32_t, vector<uint32_t> >::iterator it2 = reverseTable.find(merge);
-        assert(it2 != reverseTable.end());
-
-        //Add them all
-        bogoprops_remain -= (int64_t)it2->second.size();
-        newSet.insert(
-            newSet.end()
-            , it2->second.begin()
-            , it2->second.end()
-        );
-
-        //Delete this comp
-        bogoprops_remain -= (int64_t)reverseTable.size();
-        reverseTable.erase(it2);
-        used_comp_no--;
-    }
-
-    //No literals lie outside of already seen components
-    if (newSet.empty())
-        return;
-
-    //Mark all lits not belonging to seen components as belonging to comp_no
-    bogoprops_remain -= (int64_t)newSet.size();
-    for (const uint32_t v: newSet) {
-        table[v] = comp_no;
+    const uint32_t first = solver->map_inter_to_outer(cl[0].var());
+    for (const Lit lit: cl) {
+        uf_union(first, solver->map_inter_to_outer(lit.var()));
     }
-
-    reverseTable[comp_no] = newSet;
-    comp_no++;
-    used_comp_no++;
 }
@@ -29,6 +29,10 @@ THE SOFTWARE.
 #include "solvertypes.h"
 #include "cloffset.h"
 
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
+
 namespace CMSat {
 
 class Solver;
@@ -38,13 +42,34 @@ using std::map;
 using std::vector;
 using std::pair;
 
+/**
+@brief Finds the disconnected components of the irreducible clauses
+
+Components are kept in a union-find over the outer variables. If
+"incremental" is set, the irred clauses and variable merges coming in
+through new_irred_clause() and vars_merged() are applied to it as they
+happen, so finding the components does not need to go through the clauses.
+Clause removal is not tracked: it only makes components that could be split
+look connected. Once enough of the irred clauses are gone, the union-find is
+rebuilt from scratch.
+*/
 class CompFinder {
 
     public:
-        explicit CompFinder(Solver* solver);
+        explicit CompFinder(Solver* solver, const bool incremental = false);
         void find_components();
         bool getTimedOut() const;
 
+        //Streaming updates. The union-find is over outer variables:
+        //new_irred_clause() takes inter literals and maps them itself,
+        //vars_merged_outer() takes outer variables
+        void new_var(const uint32_t orig_outer);
+        void new_vars(const size_t n);
+        void new_irred_clause(const vector<Lit>& lits);
+        void vars_merged_outer(const uint32_t var1, const uint32_t var2);
+        void invalidate(); ///<Clauses came in behind our back, rebuild next time
+        size_t mem_used() const;
+
         const map<uint32_t, vector<uint32_t> >& getReverseTable() const; // comp->var
         uint32_t getVarComp(const uint32_t var) const;
         const vector<uint32_t>& getTable() const; //var -> comp
@@ -52,29 +77,37 @@ class CompFinder {
         uint32_t getNumComps() const;
 
     private:
+        #ifdef CMS_TESTING_ENABLED
+        FRIEND_TEST(comp_handle_incr, bridge_between_solves);
+        FRIEND_TEST(comp_handle_incr, removal_splits);
+        FRIEND_TEST(comp_handle_incr, same_as_rebuild);
+        #endif
+
+        bool must_rebuild() const;
+        uint64_t num_irred_cls() const;
+        bool rebuild_union_find();
         void addToCompImplicits();
         void add_clauses_to_component(const vector<ClOffset>& cs);
         template<class T>
         void add_clause_to_component(const T& cl);
-        template<class T>
-        bool belong_to_same_component(const T& cl);
-        template<class T>
-        void fill_newset_and_tomerge(const T& cl);
-        void merge_newset_into_single_component();
+        void fill_tables();
 
         void print_found_components() const;
         bool reverse_table_is_correct() const;
         void print_and_add_to_sql_result(const double myTime) const;
 
-        struct MySorter
-        {
-            bool operator () (
-                const pair<uint32_t, uint32_t>& left
-                , const pair<uint32_t, uint32_t>& right
-            ) {
-                return left.second < right.second;
-            }
-        };
+        //Union-find over outer vars, union by size, path halving
+        vector<uint32_t> uf_parent;
+        vector<uint32_t> uf_size;
+        uint32_t uf_find(uint32_t var);
+        void uf_union(uint32_t var1, uint32_t var2);
+        void uf_grow(const size_t n);
+
+        //Keeping the union-find up-to-date
+        const bool incremental;
+        bool uf_valid = false;
+        uint64_t irred_cls_at_build = 0; ///<Irred clauses at the last rebuild
+        uint64_t irred_cls_added = 0; ///<Irred clauses streamed in since
 
         //comp -> vars
         map<uint32_t, vector<uint32_t> > reverseTable;
@@ -82,23 +115,20 @@ class CompFinder {
         //var -> comp
         vector<uint32_t> table;
 
-        //The comp counter
-        uint32_t comp_no;
-        uint32_t used_comp_no;
-
-        //Temporary
-        vector<uint32_t> newSet;
-        vector<uint32_t> tomerge;
-
         //Keep track of time
         long long bogoprops_remain;
         long long orig_bogoprops;
         bool timedout;
+        bool rebuilt;
 
-        vector<uint16_t>& seen;
         Solver* solver;
 };
 
+inline void CompFinder::invalidate()
+{
+    uf_valid = false;
+}
+
 inline uint32_t CompFinder::getNumComps() const
 {
     return reverseTable.size();
@@ -133,6 +163,28 @@ inline bool CompFinder::getTimedOut() const
     return timedout;
 }
 
+inline uint32_t CompFinder::uf_find(uint32_t var)
+{
+    while (uf_parent[var] != var) {
+        uf_parent[var] = uf_parent[uf_parent[var]];
+        var = uf_parent[var];
+    }
+    return var;
+}
+
+inline void CompFinder::uf_union(uint32_t var1, uint32_t var2)
+{
+    var1 = uf_find(var1);
+    var2 = uf_find(var2);
+    if (var1 == var2)
+        return;
+
+    if (uf_size[var1] < uf_size[var2])
+        std::swap(var1, var2);
+    uf_parent[var2] = var1;
+    uf_size[var1] += uf_size[var2];
+}
+
 } //End namespace
 
 #endif //PARTFINDER_H
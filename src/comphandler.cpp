@@ -31,6 +31,13 @@ THE SOFTWARE.
 #include <iostream>
 #include <cassert>
 #include <iomanip>
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <memory>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
 #include "cryptominisat5/cryptominisat.h"
 #include "sqlstats.h"
 
@@ -41,17 +48,88 @@ using std::endl;
 
 //#define VERBOSE_DEBUG
 
+/**
+@brief Keeps the interrupt flags of the component solvers raised while the
+parent is interrupted or the answer is already decided
+
+Every component solver gets its own flag: SATSolver::solve() clears the flag
+it was given when it starts, which would lose an interrupt of the parent if
+the parent's flag was shared. The flags are re-raised every millisecond so a
+solver that clears its flag on start still sees the interrupt.
+*/
+class CompInterrupter
+{
+public:
+    CompInterrupter(
+        std::atomic<bool>* _parent
+        , std::atomic<bool>* _flags
+        , const size_t _num_flags
+    ) :
+        parent(_parent)
+        , flags(_flags)
+        , num_flags(_num_flags)
+    {
+        for(size_t i = 0; i < num_flags; i++) {
+            flags[i].store(false);
+        }
+        watcher = std::thread(&CompInterrupter::watch, this);
+    }
+
+    ~CompInterrupter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            finished = true;
+        }
+        cv.notify_one();
+        watcher.join();
+    }
+
+    void stop_all()
+    {
+        stop.store(true);
+        raise();
+    }
+
+private:
+    void raise()
+    {
+        for(size_t i = 0; i < num_flags; i++) {
+            flags[i].store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void watch()
+    {
+        std::unique_lock<std::mutex> lock(mu);
+        while(!finished) {
+            if (stop.load() || parent->load(std::memory_order_relaxed)) {
+                raise();
+            }
+            cv.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    std::atomic<bool>* parent;
+    std::atomic<bool>* flags;
+    const size_t num_flags;
+    std::atomic<bool> stop{false};
+
+    std::mutex mu;
+    std::condition_variable cv;
+    bool finished = false;
+    std::thread watcher;
+};
+
 CompHandler::CompHandler(Solver* _solver) :
     solver(_solver)
-    , compFinder(NULL)
+    , compFinder(new CompFinder(_solver, true))
 {
 }
 
 CompHandler::~CompHandler()
 {
-    if (compFinder != NULL) {
-        delete compFinder;
-    }
+    delete compFinder;
 }
 
 void CompHandler::new_var(const uint32_t orig_outer)
@@ -60,32 +138,66 @@ void CompHandler::new_var(const uint32_t orig_outer)
         savedState.push_back(l_Undef);
     }
     assert(savedState.size() == solver->nVarsOuter());
+    compFinder->new_var(orig_outer);
 }
 
 void CompHandler::new_vars(size_t n)
 {
     savedState.insert(savedState.end(), n, l_Undef);
     assert(savedState.size() == solver->nVarsOuter());
+    compFinder->new_vars(n);
+}
+
+void CompHandler::new_irred_clause(const vector<Lit>& lits)
+{
+    compFinder->new_irred_clause(lits);
+}
+
+void CompHandler::vars_merged_outer(const uint32_t var1, const uint32_t var2)
+{
+    compFinder->vars_merged_outer(var1, var2);
 }
 
 void CompHandler::save_on_var_memory()
 {
 }
 
+void CompHandler::save_state(SimpleOutFile& f) const
+{
+    f.put_vector(savedState);
+    f.put_vector(removedClauses.lits);
+    f.put_vector(removedClauses.sizes);
+    f.put_uint64_t(num_vars_removed);
+    f.put_uint64_t(components_solved);
+}
+
+void CompHandler::load_state(SimpleInFile& f)
+{
+    f.get_vector(savedState);
+    f.get_vector(removedClauses.lits);
+    f.get_vector(removedClauses.sizes);
+    num_vars_removed = f.get_uint64_t();
+    components_solved = f.get_uint64_t();
+
+    //The clauses were loaded without going through add_clause_int()
+    compFinder->invalidate();
+}
+
 size_t CompHandler::mem_used() const
 {
     size_t mem = 0;
     mem += savedState.capacity()*sizeof(lbool);
     mem += useless.capacity()*sizeof(uint32_t);
-    mem += smallsolver_to_bigsolver.capacity()*sizeof(uint32_t);
     mem += bigsolver_to_smallsolver.capacity()*sizeof(uint32_t);
+    mem += compFinder->mem_used();
 
     return mem;
 }
 
+//Components are disjoint, so the renumbering of all moved-out components
+//fits into bigsolver_to_smallsolver at the same time
 void CompHandler::createRenumbering(const vector<uint32_t>& vars)
 {
-    smallsolver_to_bigsolver.resize(vars.size());
     bigsolver_to_smallsolver.resize(solver->nVars());
 
     for(size_t i = 0, size = vars.size()
@@ -93,14 +205,15 @@ void CompHandler::createRenumbering(const vector<uint32_t>& vars)
         ; ++i
     ) {
         bigsolver_to_smallsolver[vars[i]] = i;
-        smallsolver_to_bigsolver[i] = vars[i];
     }
 }
 
 bool CompHandler::assumpsInsideComponent(const vector<uint32_t>& vars)
 {
     for(uint32_t var: vars) {
-        if (solver->var_inside_assumptions(var)) {
+        if (solver->var_inside_assumptions(var)
+            || solver->var_frozen(var)
+        ) {
             return true;
         }
     }
@@ -137,12 +250,8 @@ bool CompHandler::handle()
     assert(solver->okay());
     double myTime = cpuTime();
 
-    delete compFinder;
-    compFinder = new CompFinder(solver);
     compFinder->find_components();
     if (compFinder->getTimedOut()) {
-        delete compFinder;
-        compFinder = NULL;
         return solver->okay();
     }
 
@@ -156,8 +265,6 @@ bool CompHandler::handle()
             << endl;
         }
 
-        delete compFinder;
-        compFinder = NULL;
         return solver->okay();
     }
 
@@ -171,21 +278,22 @@ bool CompHandler::handle()
 
     size_t num_comps_solved = 0;
     size_t vars_solved = 0;
-    for (uint32_t it = 0; it < sizes.size()-1; ++it) {
-        const uint32_t comp = sizes[it].first;
-        vector<uint32_t>& vars = reverseTable[comp];
-        const bool ok = try_to_solve_component(it, comp, vars, num_comps);
-        if (!ok) {
-            break;
+    if (solver->conf.comp_threads > 1) {
+        solve_components_par(sizes, reverseTable, num_comps_solved, vars_solved);
+    } else {
+        for (uint32_t it = 0; it < sizes.size()-1; ++it) {
+            const uint32_t comp = sizes[it].first;
+            vector<uint32_t>& vars = reverseTable[comp];
+            const bool ok = try_to_solve_component(it, comp, vars, num_comps);
+            if (!ok) {
+                break;
+            }
+            num_comps_solved++;
+            vars_solved += vars.size();
         }
-        num_comps_solved++;
-        vars_solved += vars.size();
     }
 
     if (!solver->okay()) {
-        delete compFinder;
-        compFinder = NULL;
-
         return solver->okay();
     }
 
@@ -209,17 +317,11 @@ bool CompHandler::handle()
 
     check_local_vardata_sanity();
 
-    delete compFinder;
-    compFinder = NULL;
     return solver->okay();
 }
 
-bool CompHandler::try_to_solve_component(
-    const uint32_t comp_at
-    , const uint32_t comp
-    , const vector<uint32_t>& vars_orig
-    , const size_t num_comps
-) {
+bool CompHandler::can_solve_component(const vector<uint32_t>& vars_orig)
+{
     for(const uint32_t var: vars_orig) {
         assert(solver->value(var) == l_Undef);
     }
@@ -230,66 +332,207 @@ bool CompHandler::try_to_solve_component(
         //There too many variables -- don't create a sub-solver
         //I'm afraid that we will memory-out
 
-        return true;
+        return false;
     }
 
     //Components with assumptions should not be removed
     if (assumpsInsideComponent(vars_orig))
-        return true;
+        return false;
 
-    return solve_component(comp_at, comp, vars_orig, num_comps);
+    return true;
 }
 
-bool CompHandler::solve_component(
+bool CompHandler::try_to_solve_component(
     const uint32_t comp_at
     , const uint32_t comp
     , const vector<uint32_t>& vars_orig
     , const size_t num_comps
+) {
+    if (!can_solve_component(vars_orig))
+        return true;
+
+    CompJob job;
+    job.comp_at = comp_at;
+    job.comp = comp;
+    move_component_out(job, vars_orig, num_comps);
+    std::atomic<bool> interrupt(false);
+    {
+        CompInterrupter interrupter(
+            solver->get_must_interrupt_inter_asap_ptr(), &interrupt, 1);
+        solve_job(job, &interrupt);
+    }
+
+    //Out of time
+    if (job.status == l_Undef) {
+        if (solver->conf.verbosity) {
+            cout
+            << "c [comp] subcomponent returned l_Undef -- timeout or interrupt."
+            << endl;
+        }
+        readdRemovedClauses();
+        return false;
+    }
+
+    return merge_solved_component(job, num_comps);
+}
+
+/**
+@brief Moves out all components but the largest one, then solves them with
+a pool of solver threads
+
+The largest components are handed out first so a big one does not end up
+running alone at the end. Once a component turns out UNSAT or times out,
+the remaining ones are not started and the running ones are interrupted:
+their results are not needed. Results are merged back in the original order.
+*/
+void CompHandler::solve_components_par(
+    const vector<pair<uint32_t, uint32_t> >& sizes
+    , map<uint32_t, vector<uint32_t> >& reverseTable
+    , size_t& num_comps_solved
+    , size_t& vars_solved
+) {
+    const size_t num_comps = sizes.size();
+    vector<CompJob> jobs;
+    for (uint32_t it = 0; it < sizes.size()-1; ++it) {
+        const uint32_t comp = sizes[it].first;
+        const vector<uint32_t>& vars = reverseTable[comp];
+        if (!can_solve_component(vars))
+            continue;
+
+        jobs.push_back(CompJob());
+        jobs.back().comp_at = it;
+        jobs.back().comp = comp;
+        move_component_out(jobs.back(), vars, num_comps);
+    }
+
+    vector<size_t> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&](const size_t a, const size_t b) {
+            return jobs[a].vars.size() > jobs[b].vars.size();
+    });
+
+    std::unique_ptr<std::atomic<bool>[]> interrupts(
+        new std::atomic<bool>[jobs.size()]);
+    CompInterrupter interrupter(
+        solver->get_must_interrupt_inter_asap_ptr(), interrupts.get(), jobs.size());
+
+    std::atomic<size_t> next(0);
+    std::atomic<bool> stop(false);
+    auto worker = [&]() {
+        while(!stop.load(std::memory_order_relaxed)) {
+            const size_t at = next.fetch_add(1);
+            if (at >= order.size())
+                return;
+
+            CompJob& job = jobs[order[at]];
+            solve_job(job, &interrupts[order[at]]);
+            if (job.status != l_True) {
+                stop = true;
+                interrupter.stop_all();
+            }
+        }
+    };
+
+    const size_t num_threads = std::min<size_t>(solver->conf.comp_threads, jobs.size());
+    vector<std::thread> threads;
+    for(size_t i = 1; i < num_threads; i++) {
+        threads.push_back(std::thread(worker));
+    }
+    worker();
+    for(std::thread& t: threads) {
+        t.join();
+    }
+
+    //UNSAT trumps everything
+    for(const CompJob& job: jobs) {
+        if (job.status == l_False) {
+            merge_solved_component(job, num_comps);
+            return;
+        }
+    }
+
+    bool all_solved = true;
+    for(const CompJob& job: jobs) {
+        if (job.status == l_Undef) {
+            all_solved = false;
+            continue;
+        }
+        merge_solved_component(job, num_comps);
+        num_comps_solved++;
+        vars_solved += job.vars.size();
+    }
+
+    if (!all_solved) {
+        if (solver->conf.verbosity) {
+            cout
+            << "c [comp] subcomponent returned l_Undef -- timeout or interrupt."
+            << endl;
+        }
+        readdRemovedClauses();
+    }
+}
+
+void CompHandler::move_component_out(
+    CompJob& job
+    , const vector<uint32_t>& vars_orig
+    , const size_t num_comps
 ) {
     assert(!solver->drat->enabled());
-    vector<uint32_t> vars(vars_orig);
+    const uint32_t comp = job.comp;
+    job.vars = vars_orig;
     components_solved++;
 
     //Sort and renumber
-    std::sort(vars.begin(), vars.end());
-    createRenumbering(vars);
+    std::sort(job.vars.begin(), job.vars.end());
+    createRenumbering(job.vars);
 
     if (solver->conf.verbosity && num_comps < 20) {
         cout
-        << "c [comp] Solving component " << comp_at
-        << " num vars: " << vars.size()
+        << "c [comp] Solving component " << job.comp_at
+        << " num vars: " << job.vars.size()
         << " ======================================="
         << endl;
     }
 
     //Set up new solver
-    SolverConf conf = configureNewSolver(vars.size());
-    SATSolver newSolver(
-        (void*)&conf
-        , solver->get_must_interrupt_inter_asap_ptr()
-    );
-    moveVariablesBetweenSolvers(&newSolver, vars, comp);
+    job.conf = configureNewSolver(job.vars.size());
+    moveVariablesBetweenSolvers(job.vars, comp);
 
     //Move clauses over
-    moveClausesImplicit(&newSolver, comp, vars);
-    moveClausesLong(solver->longIrredCls, &newSolver, comp);
+    moveClausesImplicit(job, comp, job.vars);
+    moveClausesLong(solver->longIrredCls, job, comp);
     for(auto& lredcls: solver->longRedCls) {
-        moveClausesLong(lredcls, &newSolver, comp);
+        moveClausesLong(lredcls, job, comp);
     }
+}
 
-    const lbool status = newSolver.solve();
-    //Out of time
-    if (status == l_Undef) {
-        if (solver->conf.verbosity) {
-            cout
-            << "c [comp] subcomponent returned l_Undef -- timeout or interrupt."
-            << endl;
-        }
-        readdRemovedClauses();
-        return false;
+//Only touches "job", so jobs can be solved in parallel
+void CompHandler::solve_job(CompJob& job, std::atomic<bool>* interrupt) const
+{
+    SATSolver newSolver((void*)&job.conf, interrupt);
+    newSolver.new_vars(job.vars.size());
+
+    vector<Lit> tmp;
+    size_t at = 0;
+    for(const uint32_t sz: job.cls_sizes) {
+        tmp.assign(job.cls_lits.begin() + at, job.cls_lits.begin() + at + sz);
+        newSolver.add_clause(tmp);
+        at += sz;
+    }
+    vector<Lit>().swap(job.cls_lits);
+    vector<uint32_t>().swap(job.cls_sizes);
+
+    job.status = newSolver.solve();
+    if (job.status == l_True) {
+        job.model = newSolver.get_model();
+        job.zero_assigned = newSolver.get_zero_assigned_lits();
     }
+}
 
-    if (status == l_False) {
+bool CompHandler::merge_solved_component(const CompJob& job, const size_t num_comps)
+{
+    if (job.status == l_False) {
         solver->ok = false;
         if (solver->conf.verbosity) {
             cout
@@ -298,14 +541,15 @@ bool CompHandler::solve_component(
         }
         return false;
     }
+    assert(job.status == l_True);
 
-    check_solution_is_unassigned_in_main_solver(&newSolver, vars);
-    save_solution_to_savedstate(&newSolver, vars, comp);
-    move_decision_level_zero_vars_here(&newSolver);
+    check_solution_is_unassigned_in_main_solver(job);
+    save_solution_to_savedstate(job);
+    move_decision_level_zero_vars_here(job);
 
     if (solver->conf.verbosity && num_comps < 20) {
         cout
-        << "c [comp] component " << comp_at
+        << "c [comp] component " << job.comp_at
         << " ======================================="
         << endl;
     }
@@ -334,43 +578,38 @@ void CompHandler::check_local_vardata_sanity()
 }
 
 void CompHandler::check_solution_is_unassigned_in_main_solver(
-    const SATSolver* newSolver
-    , const vector<uint32_t>& vars
+    const CompJob& job
 ) {
-    for (size_t i = 0; i < vars.size(); ++i) {
-        uint32_t var = vars[i];
-        if (newSolver->get_model()[upd_bigsolver_to_smallsolver(var)] != l_Undef) {
+    for (size_t i = 0; i < job.vars.size(); ++i) {
+        uint32_t var = job.vars[i];
+        if (job.model[i] != l_Undef) {
             assert(solver->value(var) == l_Undef);
         }
     }
 }
 
 void CompHandler::save_solution_to_savedstate(
-    const SATSolver* newSolver
-    , const vector<uint32_t>& vars
-    , const uint32_t comp
+    const CompJob& job
 ) {
     assert(savedState.size() == solver->nVarsOuter());
-    for (size_t i = 0; i < vars.size(); ++i) {
-        uint32_t var = vars[i];
+    for (size_t i = 0; i < job.vars.size(); ++i) {
+        uint32_t var = job.vars[i];
         uint32_t outerVar = solver->map_inter_to_outer(var);
-        if (newSolver->get_model()[upd_bigsolver_to_smallsolver(var)] != l_Undef) {
+        if (job.model[i] != l_Undef) {
             assert(savedState[outerVar] == l_Undef);
-            assert(compFinder->getVarComp(var) == comp);
+            assert(compFinder->getVarComp(var) == job.comp);
 
-            savedState[outerVar] = newSolver->get_model()[upd_bigsolver_to_smallsolver(var)];
+            savedState[outerVar] = job.model[i];
         }
     }
 }
 
 void CompHandler::move_decision_level_zero_vars_here(
-    const SATSolver* newSolver
+    const CompJob& job
 ) {
-    const vector<Lit> zero_assigned = newSolver->get_zero_assigned_lits();
-    for (Lit lit: zero_assigned) {
-        assert(lit.var() < newSolver->nVars());
-        assert(lit.var() < smallsolver_to_bigsolver.size());
-        lit = Lit(smallsolver_to_bigsolver[lit.var()], lit.sign());
+    for (Lit lit: job.zero_assigned) {
+        assert(lit.var() < job.vars.size());
+        lit = Lit(job.vars[lit.var()], lit.sign());
         assert(solver->value(lit) == l_Undef);
 
         assert(solver->varData[lit.var()].removed == Removed::decomposed);
@@ -432,12 +671,10 @@ This implies making the right variables decision in the new solver,
 and making it non-decision in the old solver.
 */
 void CompHandler::moveVariablesBetweenSolvers(
-    SATSolver* newSolver
-    , const vector<uint32_t>& vars
+    const vector<uint32_t>& vars
     , const uint32_t comp
 ) {
     for(const uint32_t var: vars) {
-        newSolver->new_var();
         assert(compFinder->getVarComp(var) == comp);
         assert(solver->value(var) == l_Undef);
 
@@ -449,7 +686,7 @@ void CompHandler::moveVariablesBetweenSolvers(
 
 void CompHandler::moveClausesLong(
     vector<ClOffset>& cs
-    , SATSolver* newSolver
+    , CompJob& job
     , const uint32_t comp
 ) {
     vector<Lit> tmp;
@@ -517,7 +754,7 @@ void CompHandler::moveClausesLong(
             //newSolver->addRedClause(tmp, cl.stats);
         } else {
             saveClause(cl);
-            newSolver->add_clause(tmp);
+            job.add_clause(tmp);
         }
 
         //Remove from here
@@ -536,7 +773,7 @@ void CompHandler::remove_bin_except_for_lit1(const Lit lit, const Lit lit2)
 }
 
 void CompHandler::move_binary_clause(
-    SATSolver* newSolver
+    CompJob& job
     , const uint32_t comp
     ,  Watched *i
     , const Lit lit
@@ -581,7 +818,7 @@ void CompHandler::move_binary_clause(
             //Save backup
             saveClause(vector<Lit>{lit, lit2});
 
-            newSolver->add_clause(tmp_lits);
+            job.add_clause(tmp_lits);
             numRemovedHalfIrred++;
         }
     } else {
@@ -596,7 +833,7 @@ void CompHandler::move_binary_clause(
 }
 
 void CompHandler::moveClausesImplicit(
-    SATSolver* newSolver
+    CompJob& job
     , const uint32_t comp
     , const vector<uint32_t>& vars
 ) {
@@ -625,7 +862,7 @@ void CompHandler::moveClausesImplicit(
                     || compFinder->getVarComp(i->lit2().var()) == comp
                 )
             ) {
-                move_binary_clause(newSolver, comp, i, lit);
+                move_binary_clause(job, comp, i, lit);
                 continue;
             }
             *j++ = *i;
@@ -773,3 +1010,11 @@ uint32_t CompHandler::dump_removed_clauses(std::ostream* outfile) const
     }
     return num_cls;
 }
+
+void CompHandler::get_removed_clauses(ClauseBuffer& out) const
+{
+    out.lits.insert(out.lits.end(), removedClauses.lits.begin(), removedClauses.lits.end());
+    for (uint32_t size :removedClauses.sizes) {
+        out.offsets.push_back(out.offsets.back() + size);
+    }
+}
@@ -24,9 +24,12 @@ THE SOFTWARE.
 #define PARTHANDLER_H
 
 #include "solvertypes.h"
+#include "solverconf.h"
 #include "cloffset.h"
+#include "simplefile.h"
 #include <map>
 #include <vector>
+#include <atomic>
 
 namespace CMSat {
 
@@ -62,11 +65,16 @@ class CompHandler
         const vector<lbool>& getSavedState();
         void new_var(const uint32_t orig_outer);
         void new_vars(const size_t n);
+        void new_irred_clause(const vector<Lit>& lits);
+        void vars_merged_outer(const uint32_t var1, const uint32_t var2);
         void save_on_var_memory();
+        void save_state(SimpleOutFile& f) const;
+        void load_state(SimpleInFile& f);
         void addSavedState(vector<lbool>& solution, vector<Lit>& decisions);
         void readdRemovedClauses();
         const RemovedClauses& getRemovedClauses() const;
         uint32_t dump_removed_clauses(std::ostream* outfile) const;
+        void get_removed_clauses(ClauseBuffer& out) const;
         size_t get_num_vars_removed() const;
         size_t get_num_components_solved() const;
         size_t mem_used() const;
@@ -80,32 +88,54 @@ class CompHandler
                 return left.second < right.second;
             }
         };
+        ///A component moved out of the solver, to be solved by a sub-solver
+        struct CompJob
+        {
+            uint32_t comp_at = 0;
+            uint32_t comp = 0;
+            vector<uint32_t> vars; ///<Sorted. Var i of the sub-solver is vars[i]
+            SolverConf conf;
+
+            //The irred clauses of the component, in sub-solver numbering
+            vector<Lit> cls_lits;
+            vector<uint32_t> cls_sizes;
+            void add_clause(const vector<Lit>& lits)
+            {
+                cls_lits.insert(cls_lits.end(), lits.begin(), lits.end());
+                cls_sizes.push_back(lits.size());
+            }
+
+            //Result
+            lbool status = l_Undef;
+            vector<lbool> model;
+            vector<Lit> zero_assigned;
+        };
+
         bool assumpsInsideComponent(const vector<uint32_t>& vars);
-        void move_decision_level_zero_vars_here(
-            const SATSolver* newSolver
-        );
-        void save_solution_to_savedstate(
-            const SATSolver* newSolver
-            , const vector<uint32_t>& vars
-            , const uint32_t comp
-        );
-        void check_solution_is_unassigned_in_main_solver(
-            const SATSolver* newSolver
-            , const vector<uint32_t>& vars
-        );
+        void move_decision_level_zero_vars_here(const CompJob& job);
+        void save_solution_to_savedstate(const CompJob& job);
+        void check_solution_is_unassigned_in_main_solver(const CompJob& job);
         void check_local_vardata_sanity();
+        bool can_solve_component(const vector<uint32_t>& vars);
         bool try_to_solve_component(
             const uint32_t comp_at
             , const uint32_t comp
             , const vector<uint32_t>& vars
             , const size_t num_comps
         );
-        bool solve_component(
-            const uint32_t comp_at
-            , const uint32_t comp
+        void solve_components_par(
+            const vector<pair<uint32_t, uint32_t> >& sizes
+            , map<uint32_t, vector<uint32_t> >& reverseTable
+            , size_t& num_comps_solved
+            , size_t& vars_solved
+        );
+        void move_component_out(
+            CompJob& job
             , const vector<uint32_t>& vars_orig
             , const size_t num_comps
         );
+        void solve_job(CompJob& job, std::atomic<bool>* interrupt) const;
+        bool merge_solved_component(const CompJob& job, const size_t num_comps);
         vector<pair<uint32_t, uint32_t> > get_component_sizes() const;
 
         SolverConf configureNewSolver(
@@ -113,30 +143,33 @@ class CompHandler
         ) const;
 
         void moveVariablesBetweenSolvers(
-            SATSolver* newSolver
-            , const vector<uint32_t>& vars
+            const vector<uint32_t>& vars
             , const uint32_t comp
         );
 
         //For moving clauses
         void moveClausesImplicit(
-            SATSolver* newSolver
+            CompJob& job
             , const uint32_t comp
             , const vector<uint32_t>& vars
         );
         void moveClausesLong(
             vector<ClOffset>& cs
-            , SATSolver* newSolver
+            , CompJob& job
             , const uint32_t comp
         );
         void move_binary_clause(
-            SATSolver* newSolver
+            CompJob& job
             , const uint32_t comp
             ,  Watched *i
             , const Lit lit
         );
         void remove_bin_except_for_lit1(const Lit lit, const Lit lit2);
 
+        #ifdef CMS_TESTING_ENABLED
+        friend struct comp_handle_incr;
+        #endif
+
         Solver* solver;
         CompFinder* compFinder;
 
@@ -146,7 +179,6 @@ class CompHandler
         //Re-numbering
         void createRenumbering(const vector<uint32_t>& vars);
         vector<uint32_t> useless; //temporary
-        vector<uint32_t> smallsolver_to_bigsolver;
         vector<uint32_t> bigsolver_to_smallsolver;
 
         Lit upd_bigsolver_to_smallsolver(const Lit lit) const
@@ -70,6 +70,7 @@ THE SOFTWARE.
 #endif
 
 #define MAX_XOR_RECOVER_SIZE 8
+#define VELIM_PAR_MIN_RESOLVENTS 32
 
 #if defined _WIN32
     #define DLL_PUBLIC __declspec(dllexport)
@@ -25,11 +25,17 @@ THE SOFTWARE.
 #include "solver.h"
 #include "drat.h"
 #include "shareddata.h"
+#include "extprophandler.h"
+#include "approxcount.h"
+#include "bigmem.h"
 #include <fstream>
 
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
 using std::thread;
 
 #define CACHE_SIZE 10ULL*1000ULL*1000UL
@@ -86,15 +92,39 @@ namespace CMSat {
         uint64_t previous_sum_conflicts = 0;
         uint64_t previous_sum_propagations = 0;
         uint64_t previous_sum_decisions = 0;
+
+        std::mutex stream_mutex; ///<The threads stream one at a time
+
+        //solve_async()
+        std::thread async_thread;
+        vector<Lit> async_assumptions;
+        std::atomic<bool> async_cancelled{false};
+        std::mutex async_mutex; ///<Guards async_finished and async_result
+        std::condition_variable async_cv;
+        bool async_finished = true;
+        lbool async_result = l_Undef;
     };
 }
 
+//Clauses given in one flat buffer, see SATSolver::add_clauses()
+struct ClauseBatch
+{
+    const Lit* lits;
+    const uint32_t* offsets;
+    size_t num_clauses;
+};
+
 struct DataForThread
 {
-    explicit DataForThread(CMSatPrivateData* data, const vector<Lit>* _assumptions = NULL) :
+    explicit DataForThread(
+        CMSatPrivateData* data
+        , const vector<Lit>* _assumptions = NULL
+        , const ClauseBatch* _batch = NULL
+    ) :
         solvers(data->solvers)
         , cpu_times(data->cpu_times)
         , lits_to_add(&(data->cls_lits))
+        , batch(_batch)
         , vars_to_add(data->vars_to_add)
         , assumptions(_assumptions)
         , update_mutex(new std::mutex)
@@ -111,6 +141,7 @@ struct DataForThread
     vector<Solver*>& solvers;
     vector<double>& cpu_times;
     vector<Lit> *lits_to_add;
+    const ClauseBatch* batch;
     uint32_t vars_to_add;
     const vector<Lit> *assumptions;
     std::mutex* update_mutex;
@@ -118,6 +149,31 @@ struct DataForThread
     lbool* ret;
 };
 
+//The solver can only be used again once solve_async() has finished
+static void check_no_async_solve(CMSatPrivateData* data, const char* func)
+{
+    if (data->async_thread.joinable()) {
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock(data->async_mutex);
+            finished = data->async_finished;
+        }
+        if (!finished) {
+            std::string err = "ERROR: ";
+            err += func;
+            err += "() called while solve_async() is still running";
+            std::cerr << err << endl;
+            throw std::runtime_error(err);
+        }
+        data->async_thread.join();
+    }
+
+    //A cancel only applies to the call it was meant for
+    if (data->async_cancelled.load(std::memory_order_relaxed)) {
+        data->async_cancelled = false;
+    }
+}
+
 DLL_PUBLIC SATSolver::SATSolver(
     void* config
     , std::atomic<bool>* interrupt_asap
@@ -138,6 +194,18 @@ DLL_PUBLIC SATSolver::SATSolver(
 
 DLL_PUBLIC SATSolver::~SATSolver()
 {
+    if (data->async_thread.joinable()) {
+        //The interrupt flag may be shared, only raise it if it's needed
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock(data->async_mutex);
+            finished = data->async_finished;
+        }
+        if (!finished) {
+            solve_async_cancel();
+        }
+        data->async_thread.join();
+    }
     delete data;
 }
 
@@ -146,6 +214,7 @@ void update_config(SolverConf& conf, unsigned thread_num)
     //Don't accidentally reconfigure everything to a specific value!
     if (thread_num > 0) {
         conf.reconfigure_val = 0;
+        conf.checkpoint_file.clear();
     }
     conf.origSeed += thread_num;
 
@@ -426,6 +495,10 @@ struct OneThreadAddCls
     void operator()()
     {
         Solver& solver = *data_for_thread.solvers[tid];
+        if (data_for_thread.solvers.size() > 1 && solver.conf.numa_first_touch) {
+            //Thread-local data is first touched below, pin before that
+            bind_thread_to_numa_node(tid);
+        }
         solver.new_external_vars(data_for_thread.vars_to_add);
 
         vector<Lit> lits;
@@ -462,6 +535,16 @@ struct OneThreadAddCls
             }
         }
 
+        //Read straight out of the caller's buffer, it's not written to
+        //until all threads are done
+        const ClauseBatch* batch = data_for_thread.batch;
+        for(size_t i = 0; batch && i < batch->num_clauses && ret; i++) {
+            ret = solver.add_clause_outer(
+                batch->lits + batch->offsets[i]
+                , batch->offsets[i+1] - batch->offsets[i]
+            );
+        }
+
         if (!ret) {
             data_for_thread.update_mutex->lock();
             *data_for_thread.ret = l_False;
@@ -473,9 +556,11 @@ struct OneThreadAddCls
     const size_t tid;
 };
 
-static bool actually_add_clauses_to_threads(CMSatPrivateData* data)
-{
-    DataForThread data_for_thread(data);
+static bool actually_add_clauses_to_threads(
+    CMSatPrivateData* data
+    , const ClauseBatch* batch = NULL
+) {
+    DataForThread data_for_thread(data, NULL, batch);
     std::vector<std::thread> thds;
     for(size_t i = 0; i < data->solvers.size(); i++) {
         thds.push_back(thread(OneThreadAddCls(data_for_thread, i)));
@@ -483,7 +568,7 @@ static bool actually_add_clauses_to_threads(CMSatPrivateData* data)
     for(std::thread& thread : thds){
         thread.join();
     }
-    bool ret = (*data_for_thread.ret == l_True);
+    bool ret = (*data_for_thread.ret != l_False);
 
     //clear what has been added
     data->cls_lits.clear();
@@ -590,6 +675,15 @@ DLL_PUBLIC void SATSolver::set_no_bve()
     }
 }
 
+DLL_PUBLIC void SATSolver::set_incremental_simplify(uint64_t every_confl, double max_time)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.simplify_every_confl_incremental = every_confl;
+        s.conf.simplify_incremental_max_time = max_time;
+    }
+}
+
 DLL_PUBLIC void SATSolver::set_greedy_undef()
 {
     assert(false && "ERROR: Unfortunately, greedy undef is broken, please don't use it");
@@ -629,6 +723,7 @@ DLL_PUBLIC void SATSolver::set_timeout_all_calls(double timeout)
 
 DLL_PUBLIC bool SATSolver::add_clause(const vector< Lit >& lits)
 {
+    check_no_async_solve(data, "add_clause");
     if (data->log) {
         (*data->log) << lits << " 0" << endl;
     }
@@ -654,6 +749,44 @@ DLL_PUBLIC bool SATSolver::add_clause(const vector< Lit >& lits)
     return ret;
 }
 
+DLL_PUBLIC bool SATSolver::add_clauses(
+    const Lit* lits
+    , const uint32_t* offsets
+    , size_t num_clauses
+) {
+    check_no_async_solve(data, "add_clauses");
+    if (data->log) {
+        for(size_t i = 0; i < num_clauses; i++) {
+            for(uint32_t at = offsets[i]; at < offsets[i+1]; at++) {
+                (*data->log) << lits[at] << " ";
+            }
+            (*data->log) << "0" << endl;
+        }
+    }
+
+    bool ret = true;
+    if (data->solvers.size() > 1) {
+        //Clauses added earlier must go in first. Then the threads all
+        //read the buffer directly, there is no need to copy it
+        const ClauseBatch batch = {lits, offsets, num_clauses};
+        ret = actually_add_clauses_to_threads(data, &batch);
+    } else {
+        Solver& solver = *data->solvers[0];
+        solver.new_vars(data->vars_to_add);
+        data->vars_to_add = 0;
+
+        for(size_t i = 0; i < num_clauses && ret; i++) {
+            ret = solver.add_clause_outer(
+                lits + offsets[i]
+                , offsets[i+1] - offsets[i]
+            );
+        }
+        data->cls += num_clauses;
+    }
+
+    return ret;
+}
+
 void add_xor_clause_to_log(const std::vector<unsigned>& vars, bool rhs, std::ofstream* file)
 {
     if (vars.size() == 0) {
@@ -673,6 +806,7 @@ void add_xor_clause_to_log(const std::vector<unsigned>& vars, bool rhs, std::ofs
 
 DLL_PUBLIC bool SATSolver::add_xor_clause(const std::vector<unsigned>& vars, bool rhs)
 {
+    check_no_async_solve(data, "add_xor_clause");
     if (data->log) {
        add_xor_clause_to_log(vars, rhs, data->log);
     }
@@ -764,10 +898,15 @@ struct OneThreadCalc
 lbool calc(
     const vector< Lit >* assumptions,
     bool solve, CMSatPrivateData *data,
-    bool only_indep_solution = false
+    bool only_indep_solution = false,
+    const EnumerateParams* enumerate = NULL
 ) {
-    //Reset the interrupt signal if it was set
-    data->must_interrupt->store(false, std::memory_order_relaxed);
+    //Reset the interrupt signal if it was set, unless solve_async_cancel()
+    //got here first
+    data->must_interrupt->store(false);
+    if (data->async_cancelled) {
+        data->must_interrupt->store(true);
+    }
 
     //Set timeout information
     if (data->timeout != std::numeric_limits<double>::max()) {
@@ -799,7 +938,9 @@ lbool calc(
         data->vars_to_add = 0;
 
         lbool ret ;
-        if (solve) {
+        if (enumerate) {
+            ret = data->solvers[0]->enumerate_solutions(assumptions, only_indep_solution, *enumerate);
+        } else if (solve) {
             ret = data->solvers[0]->solve_with_assumptions(assumptions, only_indep_solution);
         } else {
             ret = data->solvers[0]->simplify_with_assumptions(assumptions);
@@ -835,6 +976,8 @@ lbool calc(
 
 DLL_PUBLIC lbool SATSolver::solve(const vector< Lit >* assumptions, bool only_indep_solution)
 {
+    check_no_async_solve(data, "solve");
+
     //set information data (props, confl, dec)
     data->previous_sum_conflicts = get_sum_conflicts();
     data->previous_sum_propagations = get_sum_propagations();
@@ -843,8 +986,150 @@ DLL_PUBLIC lbool SATSolver::solve(const vector< Lit >* assumptions, bool only_in
     return calc(assumptions, true, data, only_indep_solution);
 }
 
+DLL_PUBLIC lbool SATSolver::enumerate_solutions(
+    std::function<bool(const std::vector<lbool>& model)> callback
+    , uint64_t max_solutions
+    , const std::vector<Lit>* assumptions
+    , const std::vector<unsigned>* projection
+    , bool only_indep_solution
+    , bool decision_blocking
+) {
+    check_no_async_solve(data, "enumerate_solutions");
+    if (max_solutions == 0) {
+        return l_True;
+    }
+
+    //The threads don't share their search, ban each solution with a clause
+    if (data->solvers.size() > 1) {
+        const vector<uint32_t>* vars = projection;
+        vector<uint32_t> all_vars;
+        if (!vars) {
+            vars = data->solvers[0]->conf.independent_vars;
+        }
+        if (!vars) {
+            for(uint32_t var = 0; var < nVars(); var++) {
+                all_vars.push_back(var);
+            }
+            vars = &all_vars;
+        }
+
+        //Like in the single-threaded case, frozen vars stay in the search,
+        //so they are set in every solution. Anything still unset is taken
+        //to be at the default polarity, both in the solution and in the ban
+        for(const uint32_t var: *vars) {
+            freeze(var);
+        }
+        const lbool default_val =
+            data->solvers[0]->conf.polarity_mode == PolarityMode::polarmode_pos
+            ? l_True : l_False;
+        uint64_t num_found = 0;
+        vector<lbool> model;
+        vector<Lit> ban;
+        lbool ret;
+        while((ret = solve(assumptions, only_indep_solution)) == l_True) {
+            model = get_model();
+            ban.clear();
+            for(const uint32_t var: *vars) {
+                if (model[var] == l_Undef) {
+                    model[var] = default_val;
+                }
+                ban.push_back(Lit(var, model[var] == l_True));
+            }
+
+            num_found++;
+            if (!callback(model) || num_found >= max_solutions) {
+                break;
+            }
+            add_clause(ban);
+        }
+        for(const uint32_t var: *vars) {
+            melt(var);
+        }
+        return ret;
+    }
+
+    data->previous_sum_conflicts = get_sum_conflicts();
+    data->previous_sum_propagations = get_sum_propagations();
+    data->previous_sum_decisions = get_sum_decisions();
+
+    EnumerateParams params;
+    params.callback = callback;
+    params.max_solutions = max_solutions;
+    params.projection = projection;
+    params.decision_blocking = decision_blocking;
+    return calc(assumptions, true, data, only_indep_solution, &params);
+}
+
+DLL_PUBLIC lbool SATSolver::approx_count(
+    ApproxCount& result
+    , double epsilon
+    , double delta
+    , uint32_t seed
+    , const std::vector<unsigned>* projection
+) {
+    check_no_async_solve(data, "approx_count");
+    if (!(epsilon > 0) || !(delta > 0 && delta < 1)) {
+        const char err[] = "ERROR: approx_count() needs epsilon > 0 and 0 < delta < 1";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+
+    vector<uint32_t> sampling_set;
+    if (projection) {
+        sampling_set = *projection;
+    } else if (data->solvers[0]->conf.independent_vars) {
+        sampling_set = *data->solvers[0]->conf.independent_vars;
+    } else {
+        for(uint32_t var = 0; var < nVars(); var++) {
+            sampling_set.push_back(var);
+        }
+    }
+    std::sort(sampling_set.begin(), sampling_set.end());
+    sampling_set.erase(
+        std::unique(sampling_set.begin(), sampling_set.end())
+        , sampling_set.end());
+    if (!sampling_set.empty() && sampling_set.back() >= nVars()) {
+        std::string err = "ERROR: approx_count() was given var "
+            + std::to_string(sampling_set.back()+1)
+            + " but there are only "
+            + std::to_string(nVars())
+            + " vars";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+
+    //The hashes and the bans would stay in this solver, count on a copy. It
+    //shares the interrupt flag, and the time limit is for the whole count.
+    //Only the sampling vars are needed in its models, and they must not be
+    //eliminated, since the hashes are added over them later
+    data->must_interrupt->store(false);
+    SATSolver* counting = copy(1, data->must_interrupt, "approx_count");
+    counting->set_up_for_scalmc();
+    counting->set_independent_vars(&sampling_set);
+    Solver& solver = *counting->data->solvers[0];
+    solver.conf.verbosity = 0;
+    if (data->timeout != std::numeric_limits<double>::max()) {
+        solver.conf.maxTime = cpuTime() + data->timeout;
+    }
+
+    ApproxCounter counter(
+        &solver
+        , sampling_set
+        , epsilon
+        , delta
+        , seed
+        , data->solvers[0]->conf.verbosity
+    );
+    const lbool ret = counter.count(result);
+    delete counting;
+
+    return ret;
+}
+
 DLL_PUBLIC lbool SATSolver::simplify(const vector< Lit >* assumptions)
 {
+    check_no_async_solve(data, "simplify");
+
     //set information data (props, confl, dec)
     data->previous_sum_conflicts = get_sum_conflicts();
     data->previous_sum_propagations = get_sum_propagations();
@@ -853,6 +1138,149 @@ DLL_PUBLIC lbool SATSolver::simplify(const vector< Lit >* assumptions)
     return calc(assumptions, false, data);
 }
 
+DLL_PUBLIC void SATSolver::solve_async(
+    const vector<Lit>* assumptions
+    , bool only_indep_solution
+    , std::function<void(lbool result)> on_finished
+) {
+    check_no_async_solve(data, "solve_async");
+
+    //set information data (props, confl, dec)
+    data->previous_sum_conflicts = get_sum_conflicts();
+    data->previous_sum_propagations = get_sum_propagations();
+    data->previous_sum_decisions = get_sum_decisions();
+
+    //The caller's vector may be gone by the time the thread reads it
+    const vector<Lit>* assumps = NULL;
+    if (assumptions) {
+        data->async_assumptions = *assumptions;
+        assumps = &data->async_assumptions;
+    }
+    data->async_finished = false;
+    data->async_result = l_Undef;
+
+    CMSatPrivateData* d = data;
+    data->async_thread = thread([d, assumps, only_indep_solution, on_finished]() {
+        const lbool ret = calc(assumps, true, d, only_indep_solution);
+        {
+            std::lock_guard<std::mutex> lock(d->async_mutex);
+            d->async_result = ret;
+            d->async_finished = true;
+        }
+        d->async_cv.notify_all();
+        if (on_finished) {
+            on_finished(ret);
+        }
+    });
+}
+
+DLL_PUBLIC bool SATSolver::solve_async_poll() const
+{
+    std::lock_guard<std::mutex> lock(data->async_mutex);
+    return data->async_finished;
+}
+
+DLL_PUBLIC bool SATSolver::solve_async_wait_for(double secs) const
+{
+    std::unique_lock<std::mutex> lock(data->async_mutex);
+    if (secs >= 1e9) {
+        data->async_cv.wait(lock, [this]{return data->async_finished;});
+        return true;
+    }
+    return data->async_cv.wait_for(
+        lock
+        , std::chrono::duration<double>(secs)
+        , [this]{return data->async_finished;}
+    );
+}
+
+DLL_PUBLIC lbool SATSolver::solve_async_result()
+{
+    solve_async_wait_for(std::numeric_limits<double>::max());
+    if (data->async_thread.joinable()) {
+        data->async_thread.join();
+    }
+    return data->async_result;
+}
+
+DLL_PUBLIC void SATSolver::solve_async_cancel()
+{
+    data->async_cancelled = true;
+    data->must_interrupt->store(true);
+}
+
+DLL_PUBLIC SearchProgress SATSolver::get_live_progress() const
+{
+    SearchProgress progress;
+    for(const Solver* solver: data->solvers) {
+        const SearchProgress p = solver->get_live_progress();
+        progress.conflicts += p.conflicts;
+        progress.propagations += p.propagations;
+        progress.decisions += p.decisions;
+        progress.restarts += p.restarts;
+    }
+    return progress;
+}
+
+SATSolver* SATSolver::copy(
+    const unsigned num_threads
+    , std::atomic<bool>* interrupt_asap
+    , const char* func
+) const {
+    check_no_async_solve(data, func);
+    Solver& base = *data->solvers[0];
+    if (base.get_num_bva_vars() > 0) {
+        std::string err = "ERROR: ";
+        err += func;
+        err += "() cannot be used with bounded variable addition (BVA)";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+
+    //Everything added so far must be in
+    if (data->solvers.size() > 1) {
+        actually_add_clauses_to_threads(data);
+    } else {
+        base.new_vars(data->vars_to_add);
+        data->vars_to_add = 0;
+    }
+
+    SolverConf conf = base.getConf();
+    SATSolver* s = new SATSolver(&conf, interrupt_asap);
+    s->set_num_threads(num_threads);
+    s->new_vars(base.nVarsOutside());
+
+    ClauseBuffer irred;
+    ClauseBuffer red;
+    base.get_clauses_for_clone(irred, red);
+    s->add_clauses(irred.lits.data(), irred.offsets.data(), irred.size());
+    for(uint32_t var = 0; var < base.nVarsOutside(); var++) {
+        for(uint32_t i = base.frozen_cnt_outside(var); i > 0; i--) {
+            s->freeze(var);
+        }
+    }
+
+    //Learnt clauses are only worth it if they stay redundant
+    for(Solver* solver: s->data->solvers) {
+        for(size_t i = 0; i < red.size() && solver->okay(); i++) {
+            solver->add_red_clause_outer(
+                red.lits.data() + red.offsets[i]
+                , red.offsets[i+1] - red.offsets[i]
+                , red.glues[i]
+            );
+        }
+    }
+
+    return s;
+}
+
+DLL_PUBLIC SATSolver* SATSolver::clone() const
+{
+    SATSolver* s = copy(data->solvers.size(), NULL, "clone");
+    s->data->timeout = data->timeout;
+    return s;
+}
+
 DLL_PUBLIC const vector< lbool >& SATSolver::get_model() const
 {
     return data->solvers[data->which_solved]->get_model();
@@ -874,8 +1302,93 @@ DLL_PUBLIC void SATSolver::new_var()
     new_vars(1);
 }
 
+DLL_PUBLIC void SATSolver::freeze(unsigned var)
+{
+    if (var >= nVars()) {
+        std::cerr << "ERROR: freeze() called on variable " << var+1
+        << " but you never inserted that variable into the solver. Exiting."
+        << endl;
+        exit(-1);
+    }
+
+    //The variable may still be waiting to be added
+    if (data->solvers.size() > 1) {
+        actually_add_clauses_to_threads(data);
+    } else {
+        data->solvers[0]->new_vars(data->vars_to_add);
+        data->vars_to_add = 0;
+    }
+
+    for(Solver* solver: data->solvers) {
+        solver->freeze_var(var);
+    }
+}
+
+DLL_PUBLIC void SATSolver::melt(unsigned var)
+{
+    if (var >= nVars()) {
+        std::cerr << "ERROR: melt() called on variable " << var+1
+        << " but you never inserted that variable into the solver. Exiting."
+        << endl;
+        exit(-1);
+    }
+
+    for(Solver* solver: data->solvers) {
+        solver->melt_var(var);
+    }
+}
+
+DLL_PUBLIC bool SATSolver::is_frozen(unsigned var) const
+{
+    if (var >= nVars()) {
+        std::cerr << "ERROR: is_frozen() called on variable " << var+1
+        << " but you never inserted that variable into the solver. Exiting."
+        << endl;
+        exit(-1);
+    }
+
+    return data->solvers[0]->var_frozen_outside(var);
+}
+
+DLL_PUBLIC void SATSolver::connect_external_propagator(ExternalPropagator* propagator)
+{
+    if (data->solvers.size() > 1) {
+        const char err[] = "ERROR: External propagators cannot be used in multi-threaded mode";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    data->solvers[0]->connect_external_propagator(propagator);
+}
+
+DLL_PUBLIC void SATSolver::disconnect_external_propagator()
+{
+    data->solvers[0]->disconnect_external_propagator();
+}
+
+DLL_PUBLIC void SATSolver::add_observed_var(unsigned var)
+{
+    if (!data->solvers[0]->ext_prop) {
+        std::cerr << "ERROR: add_observed_var() called without an external"
+        << " propagator connected. Exiting." << endl;
+        exit(-1);
+    }
+
+    //The variable may still be waiting to be added
+    data->solvers[0]->new_vars(data->vars_to_add);
+    data->vars_to_add = 0;
+    data->solvers[0]->ext_prop->add_observed_var(var);
+}
+
+DLL_PUBLIC void SATSolver::remove_observed_var(unsigned var)
+{
+    if (data->solvers[0]->ext_prop) {
+        data->solvers[0]->ext_prop->remove_observed_var(var);
+    }
+}
+
 DLL_PUBLIC void SATSolver::new_vars(const size_t n)
 {
+    check_no_async_solve(data, "new_vars");
     if (n >= MAX_VARS
         || (data->vars_to_add + n) >= MAX_VARS
     ) {
@@ -984,6 +1497,12 @@ DLL_PUBLIC void SATSolver::interrupt_asap()
     data->must_interrupt->store(true, std::memory_order_relaxed);
 }
 
+DLL_PUBLIC void SATSolver::request_checkpoint()
+{
+    //Only the first thread writes checkpoints
+    data->solvers[0]->request_checkpoint();
+}
+
 void DLL_PUBLIC SATSolver::add_in_partial_solving_stats()
 {
     data->solvers[data->which_solved]->add_in_partial_solving_stats();
@@ -1142,6 +1661,45 @@ void DLL_PUBLIC SATSolver::end_getting_small_clauses()
     data->solvers[0]->end_getting_small_clauses();
 }
 
+void DLL_PUBLIC SATSolver::set_learnt_callback(
+    std::function<void(const std::vector<Lit>& clause)> callback
+    , uint32_t max_len
+    , uint32_t max_glue
+    , uint32_t max_per_restart
+) {
+    for (size_t i = 0; i < data->solvers.size(); i++) {
+        std::function<void(const vector<Lit>&)> locked;
+        if (callback) {
+            std::mutex* mu = &data->stream_mutex;
+            locked = [callback, mu](const vector<Lit>& clause) {
+                std::lock_guard<std::mutex> lock(*mu);
+                callback(clause);
+            };
+        }
+        data->solvers[i]->set_learnt_stream(locked, max_len, max_glue, max_per_restart);
+    }
+}
+
+void DLL_PUBLIC SATSolver::set_progress_callback(
+    std::function<void(const SearchProgress& progress)> callback
+    , uint64_t every_conflicts
+) {
+    for (size_t i = 0; i < data->solvers.size(); i++) {
+        std::function<void(const SearchProgress&)> locked;
+        if (callback) {
+            std::mutex* mu = &data->stream_mutex;
+            const unsigned thread_num = i;
+            locked = [callback, mu, thread_num](const SearchProgress& progress) {
+                SearchProgress p = progress;
+                p.thread_num = thread_num;
+                std::lock_guard<std::mutex> lock(*mu);
+                callback(p);
+            };
+        }
+        data->solvers[i]->set_progress_stream(locked, every_conflicts);
+    }
+}
+
 void DLL_PUBLIC SATSolver::set_up_for_scalmc()
 {
     for (size_t i = 0; i < data->solvers.size(); i++) {
@@ -1185,3 +1743,175 @@ DLL_PUBLIC bool SATSolver::get_decision_reaching_valid() const
 {
     return data->solvers[data->which_solved]->get_decision_reaching_valid();
 }
+
+namespace CMSat {
+    struct SolverPoolData {
+        ~SolverPoolData()
+        {
+            for(SATSolver* s: idle) {
+                delete s;
+            }
+            delete base;
+        }
+
+        SATSolver* base = NULL; ///<Only ever cloned, never solved
+        std::mutex base_mu; ///<Guards base, so cloning doesn't hold up mu
+        uint32_t num_vars = 0;
+        uint32_t queries_per_instance = 0;
+        std::mutex mu; ///<Guards idle, num_instances and num_busy
+        vector<SATSolver*> idle;
+        size_t num_instances = 0;
+        size_t num_busy = 0; ///<solve() calls running, their clones aren't in idle
+    };
+
+    //Gives the clone of a solve() call back to the pool, or throws it away
+    //if it has been used up, however the call is left
+    struct PoolCheckout {
+        explicit PoolCheckout(SolverPoolData* _data) :
+            data(_data)
+        {
+            std::lock_guard<std::mutex> lock(data->mu);
+            data->num_busy++;
+            if (!data->idle.empty()) {
+                s = data->idle.back();
+                data->idle.pop_back();
+            }
+        }
+
+        ~PoolCheckout()
+        {
+            {
+                std::lock_guard<std::mutex> lock(data->mu);
+                if (s && !retire) {
+                    data->idle.push_back(s);
+                }
+                data->num_busy--;
+            }
+            if (retire) {
+                delete s;
+            }
+        }
+
+        SolverPoolData* data;
+        SATSolver* s = NULL;
+        bool retire = false;
+    };
+}
+
+DLL_PUBLIC SolverPool::SolverPool(
+    const SATSolver& base
+    , unsigned num_ready
+    , unsigned queries_per_instance
+) {
+    if (queries_per_instance == 0) {
+        const char err[] = "ERROR: SolverPool needs queries_per_instance to be at least 1";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+
+    data = new SolverPoolData;
+    data->base = base.clone();
+    data->num_vars = data->base->nVars();
+    data->queries_per_instance = queries_per_instance;
+    for(unsigned i = 0; i < num_ready; i++) {
+        data->idle.push_back(data->base->clone());
+        data->num_instances++;
+    }
+}
+
+DLL_PUBLIC SolverPool::~SolverPool()
+{
+    //The clone of a running query would be used after it's freed
+    {
+        std::lock_guard<std::mutex> lock(data->mu);
+        if (data->num_busy > 0) {
+            std::cerr << "ERROR: SolverPool destroyed while " << data->num_busy
+            << " solve() call(s) are still running. Exiting." << endl;
+            exit(-1);
+        }
+    }
+    delete data;
+}
+
+DLL_PUBLIC lbool SolverPool::solve(
+    const vector<vector<Lit> >& clauses
+    , const vector<Lit>* assumptions
+    , vector<lbool>* model
+    , vector<Lit>* conflict
+) {
+    for(const vector<Lit>& cl: clauses) {
+        for(const Lit lit: cl) {
+            if (lit.var() >= data->num_vars) {
+                std::string err = "ERROR: SolverPool::solve() got a clause with variable ";
+                err += std::to_string(lit.var()+1);
+                err += " but the problem only has ";
+                err += std::to_string(data->num_vars);
+                std::cerr << err << endl;
+                throw std::runtime_error(err);
+            }
+        }
+    }
+
+    //Cloning can take long, other queries can go on meanwhile
+    PoolCheckout checkout(data);
+    if (!checkout.s) {
+        {
+            std::lock_guard<std::mutex> lock(data->base_mu);
+            checkout.s = data->base->clone();
+        }
+        std::lock_guard<std::mutex> lock(data->mu);
+        data->num_instances++;
+    }
+    SATSolver* s = checkout.s;
+
+    //The clauses are only active while the selector is assumed. Queries
+    //without clauses don't need one.
+    const bool need_sel = !clauses.empty();
+    Lit sel = lit_Undef;
+    vector<Lit> tmp;
+    vector<Lit> assumps;
+    if (assumptions) {
+        assumps = *assumptions;
+    }
+    if (need_sel) {
+        s->new_var();
+        sel = Lit(s->nVars()-1, false);
+        for(const vector<Lit>& cl: clauses) {
+            tmp = cl;
+            tmp.push_back(~sel);
+            s->add_clause(tmp);
+        }
+        assumps.push_back(sel);
+    }
+
+    const lbool ret = s->solve(&assumps);
+    if (ret == l_True && model) {
+        *model = s->get_model();
+        model->resize(data->num_vars);
+    }
+    if (ret == l_False && conflict) {
+        conflict->clear();
+        for(const Lit lit: s->get_conflict()) {
+            if (!need_sel || lit.var() != sel.var()) {
+                conflict->push_back(lit);
+            }
+        }
+    }
+
+    //A selector can't be used again, it's set to false for good. Once there
+    //are enough of them, the clone is replaced by a fresh one.
+    if (need_sel) {
+        tmp.clear();
+        tmp.push_back(~sel);
+        s->add_clause(tmp);
+        checkout.retire = s->nVars() - data->num_vars >= data->queries_per_instance;
+    }
+
+    return ret;
+}
+
+DLL_PUBLIC size_t SolverPool::num_instances() const
+{
+    std::lock_guard<std::mutex> lock(data->mu);
+    return data->num_instances;
+}
@@ -92,6 +92,10 @@ extern "C"
         return self->add_clause(wrap(fromc(lits), num_lits));
     } NOEXCEPT_END
 
+    DLL_PUBLIC bool cmsat_add_clauses(SATSolver* self, const c_Lit* lits, const uint32_t* offsets, size_t num_clauses) NOEXCEPT_START {
+        return self->add_clauses(fromc(lits), offsets, num_clauses);
+    } NOEXCEPT_END
+
     DLL_PUBLIC bool cmsat_add_xor_clause(SATSolver* self, const unsigned* vars, size_t num_vars, bool rhs) NOEXCEPT_START {
         return self->add_xor_clause(wrap(vars, num_vars), rhs);
     } NOEXCEPT_END
@@ -100,6 +104,18 @@ extern "C"
         self->new_vars(n);
     } NOEXCEPT_END
 
+    DLL_PUBLIC void cmsat_freeze(SATSolver* self, unsigned var) NOEXCEPT_START {
+        self->freeze(var);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void cmsat_melt(SATSolver* self, unsigned var) NOEXCEPT_START {
+        self->melt(var);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC bool cmsat_is_frozen(const SATSolver* self, unsigned var) NOEXCEPT_START {
+        return self->is_frozen(var);
+    } NOEXCEPT_END
+
     DLL_PUBLIC c_lbool cmsat_solve(SATSolver* self) NOEXCEPT_START {
         return toc(self->solve(nullptr));
     } NOEXCEPT_END
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "sqlstats.h"
 
 #include <iomanip>
+#include <algorithm>
 using namespace CMSat;
 using std::cout;
 using std::endl;
@@ -82,6 +83,290 @@ end:
     return solver->okay();
 }
 
+/**
+@brief Vivifies the best tier 0 and 1 learnt clauses, called between restarts
+
+Literals of each candidate are ordered by how often they occur among the
+candidates, and candidates are ordered lexicographically by those literals.
+Consecutive candidates then share a prefix of decisions, and the propagation
+of that prefix is kept instead of being re-done.
+*/
+bool DistillerLong::vivify_red()
+{
+    assert(solver->ok);
+    assert(solver->decisionLevel() == 0);
+    const double myTime = cpuTime();
+    vivRunStats = VivStats();
+    vivRunStats.numCalled = 1;
+
+    maxNumProps =
+        solver->conf.vivify_red_time_limitM*1000LL*1000ULL
+        *solver->conf.global_timeout_multiplier;
+    orig_maxNumProps = maxNumProps;
+    oldBogoProps = solver->propStats.bogoProps;
+
+    viv_collect_cands();
+    viv_sort_cands();
+
+    bool time_out = false;
+    for(const VivCand& cand: viv_cands) {
+        if ((int64_t)solver->propStats.bogoProps-(int64_t)oldBogoProps >= maxNumProps
+            || solver->must_interrupt_asap()
+        ) {
+            vivRunStats.timeOut++;
+            time_out = true;
+            break;
+        }
+        maxNumProps -= 5;
+        if (!viv_cand(cand)) {
+            break;
+        }
+    }
+    viv_back_to_zero();
+    viv_last_checked = vivRunStats.checkedClauses;
+
+    //Clauses that became binary or unit left an empty slot
+    for(uint32_t tier = 0; tier < 2; tier++) {
+        vector<ClOffset>& cls = solver->longRedCls[tier];
+        cls.erase(std::remove(cls.begin(), cls.end(), CL_OFFSET_MAX), cls.end());
+    }
+
+    const double time_used = cpuTime() - myTime;
+    const double time_remain = float_div(
+        maxNumProps - ((int64_t)solver->propStats.bogoProps-(int64_t)oldBogoProps),
+        orig_maxNumProps);
+    vivRunStats.time_used = time_used;
+    if (solver->conf.verbosity) {
+        vivRunStats.print_short(solver);
+    }
+    if (solver->sqlStats) {
+        solver->sqlStats->time_passed(
+            solver
+            , "vivify red"
+            , time_used
+            , time_out
+            , time_remain
+        );
+    }
+    vivGlobalStats += vivRunStats;
+
+    return solver->okay();
+}
+
+void DistillerLong::viv_collect_cands()
+{
+    viv_cands.clear();
+    for(uint32_t tier = 0; tier < 2; tier++) {
+        const vector<ClOffset>& cls = solver->longRedCls[tier];
+        for(uint32_t at = 0; at < cls.size(); at++) {
+            const Clause* cl = solver->cl_alloc.ptr(cls[at]);
+            if (cl->getdistilled() || cl->used_in_xor()) {
+                continue;
+            }
+
+            //Tier 1 clauses are only worth it while they are being used
+            if (tier == 1
+                && cl->stats.last_touched + solver->conf.must_touch_lev1_within < solver->sumConflicts
+            ) {
+                continue;
+            }
+
+            VivCand cand;
+            cand.offset = cls[at];
+            cand.tier = tier;
+            cand.at = at;
+            cand.lits_at = 0;
+            cand.size = cl->size();
+            cand.glue = cl->stats.glue;
+            viv_cands.push_back(cand);
+        }
+    }
+    vivRunStats.potentialClauses = viv_cands.size();
+
+    //Lowest glue first, about as many as we could get through last time
+    const size_t max_cands = std::max<size_t>(1000, viv_last_checked*2);
+    if (viv_cands.size() > max_cands) {
+        std::nth_element(viv_cands.begin()
+            , viv_cands.begin() + max_cands
+            , viv_cands.end()
+            , [](const VivCand& a, const VivCand& b) {
+                return a.glue < b.glue;
+            });
+        viv_cands.resize(max_cands);
+    }
+}
+
+void DistillerLong::viv_sort_cands()
+{
+    viv_lit_count.resize(solver->nVars()*2, 0);
+    for(const VivCand& cand: viv_cands) {
+        for(const Lit lit: *solver->cl_alloc.ptr(cand.offset)) {
+            viv_lit_count[lit.toInt()]++;
+        }
+    }
+
+    viv_lits.clear();
+    for(VivCand& cand: viv_cands) {
+        const Clause& cl = *solver->cl_alloc.ptr(cand.offset);
+        cand.lits_at = viv_lits.size();
+        viv_lits.insert(viv_lits.end(), cl.begin(), cl.end());
+        std::sort(viv_lits.begin() + cand.lits_at, viv_lits.end()
+            , [&](const Lit a, const Lit b) {
+                if (viv_lit_count[a.toInt()] != viv_lit_count[b.toInt()]) {
+                    return viv_lit_count[a.toInt()] > viv_lit_count[b.toInt()];
+                }
+                return a < b;
+            });
+    }
+    for(const Lit lit: viv_lits) {
+        viv_lit_count[lit.toInt()] = 0;
+    }
+    maxNumProps -= viv_lits.size();
+
+    std::sort(viv_cands.begin(), viv_cands.end()
+        , [&](const VivCand& a, const VivCand& b) {
+            return std::lexicographical_compare(
+                viv_lits.begin() + a.lits_at, viv_lits.begin() + a.lits_at + a.size
+                , viv_lits.begin() + b.lits_at, viv_lits.begin() + b.lits_at + b.size);
+        });
+}
+
+void DistillerLong::viv_back_to_zero()
+{
+    solver->cancelUntil<false, true>(0);
+    for(const ClOffset offset: viv_pending_attach) {
+        solver->attachClause(*solver->cl_alloc.ptr(offset));
+    }
+    viv_pending_attach.clear();
+    viv_decided.clear();
+}
+
+//Returns false if the solver became UNSAT
+bool DistillerLong::viv_cand(const VivCand& cand)
+{
+    Clause& cl = *solver->cl_alloc.ptr(cand.offset);
+    const Lit* sorted = viv_lits.data() + cand.lits_at;
+
+    //Satisfied at level 0 -- the clause cleaner will deal with it
+    for(uint32_t i = 0; i < cand.size; i++) {
+        if (solver->value(sorted[i]) == l_True
+            && solver->varData[sorted[i].var()].level == 0
+        ) {
+            return true;
+        }
+    }
+
+    //Keep the decisions shared with the previous candidate
+    uint32_t k = 0;
+    while(k < viv_decided.size()
+        && k < cand.size
+        && sorted[k] == viv_decided[k]
+    ) {
+        k++;
+    }
+    if (k > 0) {
+        solver->cancelUntil<false, true>(k);
+        viv_decided.resize(k);
+
+        //The clause itself was attached while these levels were propagated.
+        //It can only have been a reason if all but one of its literals are false.
+        uint32_t num_false = 0;
+        for(uint32_t i = 0; i < cand.size; i++) {
+            num_false += solver->value(sorted[i]) == l_False;
+        }
+        if (num_false+1 >= cand.size) {
+            k = 0;
+        }
+    }
+    if (k == 0) {
+        viv_back_to_zero();
+    }
+    vivRunStats.levelsReused += k;
+    vivRunStats.checkedClauses++;
+    cl.set_distilled(true);
+
+    maxNumProps -= solver->watches[cl[0]].size();
+    maxNumProps -= solver->watches[cl[1]].size();
+    maxNumProps -= cl.size();
+    solver->detachClause(cand.offset, false);
+    (*solver->drat) << deldelay << cl << fin;
+
+    lits.clear();
+    lits.insert(lits.end(), sorted, sorted + k);
+    bool True_confl = false;
+    PropBy confl;
+    for(uint32_t i = k; i < cand.size; i++) {
+        const Lit lit = sorted[i];
+        const lbool val = solver->value(lit);
+        if (val == l_Undef) {
+            solver->new_decision_level();
+            solver->enqueue(~lit);
+            viv_decided.push_back(lit);
+            lits.push_back(lit);
+            vivRunStats.decisions++;
+
+            maxNumProps -= 5;
+            confl = solver->propagate<true>();
+            if (!confl.isNULL()) {
+                break;
+            }
+        } else if (val == l_False) {
+            //Implied by the others, drop
+        } else {
+            assert(val == l_True);
+            lits.push_back(lit);
+            True_confl = true;
+            confl = solver->varData[lit.var()].reason;
+            break;
+        }
+    }
+    assert(solver->ok);
+
+    if (lits.size() > 1 && (!confl.isNULL() || True_confl)) {
+        maxNumProps -= 20;
+        viv_learnt.clear();
+        if (True_confl) {
+            viv_learnt.push_back(lits.back());
+        }
+        solver->simple_create_learnt_clause(confl, viv_learnt, True_confl);
+        if (viv_learnt.size() < lits.size()) {
+            lits.swap(viv_learnt);
+        }
+    }
+
+    if (lits.size() == cand.size) {
+        //Couldn't simplify. The level with the conflict can't be re-used,
+        //and the clause is attached back once at level 0.
+        if (!confl.isNULL() && !True_confl) {
+            solver->cancelUntil<false, true>(solver->decisionLevel()-1);
+            viv_decided.pop_back();
+        }
+        viv_pending_attach.push_back(cand.offset);
+        solver->drat->forget_delay();
+        return true;
+    }
+
+    vivRunStats.numClShorten++;
+    vivRunStats.numLitsRem += cand.size - lits.size();
+    viv_back_to_zero();
+
+    const ClauseStats stats = cl.stats;
+    solver->cl_alloc.clauseFree(cand.offset);
+    Clause* cl2 = solver->add_clause_int(lits, true, stats);
+    (*solver->drat) << findelay;
+
+    ClOffset& slot = solver->longRedCls[cand.tier][cand.at];
+    if (cl2 != NULL) {
+        cl2->set_distilled(true);
+        slot = solver->cl_alloc.get_offset(cl2);
+    } else {
+        //it became a bin/unit/zero
+        slot = CL_OFFSET_MAX;
+    }
+
+    return solver->okay();
+}
+
 struct ClauseSizeSorterInv
 {
     ClauseSizeSorterInv(const ClauseAllocator& _cl_alloc) :
@@ -524,9 +809,78 @@ void DistillerLong::Stats::print(const size_t nVars) const
     cout << "c -------- DISTILL STATS END --------" << endl;
 }
 
+DistillerLong::VivStats& DistillerLong::VivStats::operator+=(const VivStats& other)
+{
+    time_used += other.time_used;
+    timeOut += other.timeOut;
+    numCalled += other.numCalled;
+    potentialClauses += other.potentialClauses;
+    checkedClauses += other.checkedClauses;
+    numClShorten += other.numClShorten;
+    numLitsRem += other.numLitsRem;
+    decisions += other.decisions;
+    levelsReused += other.levelsReused;
+
+    return *this;
+}
+
+void DistillerLong::VivStats::print_short(const Solver* _solver) const
+{
+    cout
+    << "c [vivify-red]"
+    << " useful: "<< numClShorten
+    << "/" << checkedClauses << "/" << potentialClauses
+    << " lits-rem: " << numLitsRem
+    << " lits-rem/s: " << std::setprecision(0) << std::fixed
+    << float_div(numLitsRem, time_used)
+    << " dec-reused: " << std::setprecision(2)
+    << stats_line_percent(levelsReused, levelsReused + decisions) << "%"
+    << _solver->conf.print_times(time_used, timeOut)
+    << endl;
+}
+
+void DistillerLong::VivStats::print() const
+{
+    cout << "c -------- VIVIFY RED STATS --------" << endl;
+    print_stats_line("c time"
+        , time_used
+        , ratio_for_stat(time_used, numCalled)
+        , "per call"
+    );
+
+    print_stats_line("c timed out"
+        , timeOut
+        , stats_line_percent(timeOut, numCalled)
+        , "% of calls"
+    );
+
+    print_stats_line("c shortened/checked/potential"
+        , numClShorten
+        , checkedClauses
+        , potentialClauses
+    );
+
+    print_stats_line("c lits-rem"
+        , numLitsRem
+        , float_div(numLitsRem, time_used)
+        , "lits/s"
+    );
+
+    print_stats_line("c decisions re-used"
+        , levelsReused
+        , stats_line_percent(levelsReused, levelsReused + decisions)
+        , "% of decisions"
+    );
+    cout << "c -------- VIVIFY RED STATS END --------" << endl;
+}
+
 double DistillerLong::mem_used() const
 {
     double mem_used = sizeof(DistillerLong);
     mem_used += lits.size()*sizeof(Lit);
+    mem_used += viv_cands.capacity()*sizeof(VivCand);
+    mem_used += viv_lits.capacity()*sizeof(Lit);
+    mem_used += viv_lit_count.capacity()*sizeof(uint32_t);
+    mem_used += viv_decided.capacity()*sizeof(Lit);
     return mem_used;
 }
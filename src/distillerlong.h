@@ -41,6 +41,7 @@ class DistillerLong {
     public:
         explicit DistillerLong(Solver* solver);
         bool distill(const bool red, bool fullstats = true);
+        bool vivify_red(); ///<Between restarts: vivify good tier 0/1 learnts
 
         struct Stats
         {
@@ -64,7 +65,25 @@ class DistillerLong {
             uint64_t numCalled = 0;
         };
 
+        struct VivStats
+        {
+            VivStats& operator+=(const VivStats& other);
+            void print_short(const Solver* solver) const;
+            void print() const;
+
+            double time_used = 0.0;
+            uint64_t timeOut = 0;
+            uint64_t numCalled = 0;
+            uint64_t potentialClauses = 0;
+            uint64_t checkedClauses = 0;
+            uint64_t numClShorten = 0;
+            uint64_t numLitsRem = 0;
+            uint64_t decisions = 0;
+            uint64_t levelsReused = 0;
+        };
+
         const Stats& get_stats() const;
+        const VivStats& get_viv_stats() const;
         double mem_used() const;
 
     private:
@@ -97,6 +116,30 @@ class DistillerLong {
         Stats globalStats;
         size_t numCalls = 0;
 
+        //For vivify_red
+        struct VivCand
+        {
+            ClOffset offset;
+            uint32_t tier;
+            uint32_t at; ///<Position in longRedCls[tier]
+            uint32_t lits_at; ///<Start of its sorted literals in viv_lits
+            uint32_t size;
+            uint32_t glue;
+        };
+        void viv_collect_cands();
+        void viv_sort_cands();
+        bool viv_cand(const VivCand& cand);
+        void viv_back_to_zero();
+        vector<VivCand> viv_cands;
+        vector<Lit> viv_lits;
+        vector<uint32_t> viv_lit_count;
+        vector<Lit> viv_learnt;
+        vector<Lit> viv_decided; ///<viv_decided[i] was falsified at level i+1
+        vector<ClOffset> viv_pending_attach;
+        size_t viv_last_checked = 0;
+        VivStats vivRunStats;
+        VivStats vivGlobalStats;
+
 };
 
 inline const DistillerLong::Stats& DistillerLong::get_stats() const
@@ -104,6 +147,11 @@ inline const DistillerLong::Stats& DistillerLong::get_stats() const
     return globalStats;
 }
 
+inline const DistillerLong::VivStats& DistillerLong::get_viv_stats() const
+{
+    return vivGlobalStats;
+}
+
 } //end namespace
 
 #endif //__DISTILLERALL_WITH_ALL_H__
@@ -145,8 +145,8 @@ bool DistillerLongWithImpl::str_and_sub_clause_with_cache(const Lit lit, const b
     if (solver->conf.doCache
         && seen[lit.toInt()] //We haven't yet removed this literal from the clause
      ) {
-        timeAvailable -= (1+(int)alsoStrengthen)*(long)solver->implCache[lit].lits.size();
-        for (const LitExtra elit: solver->implCache[lit].lits) {
+        timeAvailable -= (1+(int)alsoStrengthen)*(long)solver->implCache[lit].size();
+        for (const LitExtra elit: solver->implCache[lit]) {
              if (alsoStrengthen
                 && seen[(~(elit.getLit())).toInt()]
             ) {
@@ -0,0 +1,264 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "extprophandler.h"
+#include "solver.h"
+#include "varreplacer.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace CMSat;
+using std::cerr;
+using std::endl;
+
+ExtPropHandler::ExtPropHandler(Solver* _solver, ExternalPropagator* _prop) :
+    solver(_solver)
+    , prop(_prop)
+{
+}
+
+ExtPropHandler::~ExtPropHandler()
+{
+    for(const uint32_t var: observed) {
+        solver->melt_var(var);
+    }
+}
+
+void ExtPropHandler::add_observed_var(const uint32_t var)
+{
+    if (var >= solver->nVarsOutside()) {
+        cerr << "ERROR: Observed variable " << var+1
+        << " is too large, you never inserted that variable into the"
+        << " solver. Exiting." << endl;
+        exit(-1);
+    }
+    if (observed_at.size() < solver->nVarsOutside()) {
+        observed_at.resize(solver->nVarsOutside(), 0);
+        fixed_notified.resize(solver->nVarsOutside(), 0);
+    }
+    if (observed_at[var]) {
+        return;
+    }
+
+    solver->freeze_var(var);
+    observed_at[var] = 1;
+    observed.push_back(var);
+}
+
+void ExtPropHandler::remove_observed_var(const uint32_t var)
+{
+    if (var >= observed_at.size() || !observed_at[var]) {
+        return;
+    }
+
+    solver->melt_var(var);
+    observed_at[var] = 0;
+    fixed_notified[var] = 0;
+    observed.erase(std::find(observed.begin(), observed.end(), var));
+}
+
+Lit ExtPropHandler::outside_to_inter(Lit lit) const
+{
+    lit = solver->map_to_with_bva(lit);
+    lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+    return solver->map_outer_to_inter(lit);
+}
+
+void ExtPropHandler::start_search()
+{
+    //Enumeration searches on from the trail of the last solution, with
+    //nothing renumbered or replaced in between
+    if (solver->decisionLevel() > 0) {
+        return;
+    }
+
+    obs_start.assign(solver->nVarsOuter()+1, 0);
+    for(const uint32_t var: observed) {
+        obs_start[outside_to_inter(Lit(var, false)).var()+1]++;
+    }
+    for(size_t i = 1; i < obs_start.size(); i++) {
+        obs_start[i] += obs_start[i-1];
+    }
+    obs.resize(observed.size());
+    vector<uint32_t> at(obs_start.begin(), obs_start.end()-1);
+
+    //Values set since the last search, e.g. by simplification
+    assigned.clear();
+    for(const uint32_t var: observed) {
+        const Lit lit = outside_to_inter(Lit(var, false));
+        obs[at[lit.var()]++] = Lit(var, lit.sign());
+        if (!fixed_notified[var] && solver->value(lit) != l_Undef) {
+            fixed_notified[var] = 1;
+            assigned.push_back(Lit(var, solver->value(lit) == l_False));
+        }
+    }
+    if (!assigned.empty()) {
+        prop->notify_assignment(assigned);
+    }
+
+    notified_at = solver->trail.size();
+    notified_level = 0;
+}
+
+void ExtPropHandler::notify_assignments()
+{
+    const vector<Lit>& trail = solver->trail;
+    assigned.clear();
+    for(; notified_at < trail.size(); notified_at++) {
+        const Lit lit = trail[notified_at];
+        const uint32_t level = solver->varData[lit.var()].level;
+        if (level > notified_level) {
+            if (!assigned.empty()) {
+                prop->notify_assignment(assigned);
+                assigned.clear();
+            }
+            for(; notified_level < level; notified_level++) {
+                prop->notify_new_decision_level();
+            }
+        }
+
+        for(uint32_t i = obs_start[lit.var()]; i < obs_start[lit.var()+1]; i++) {
+            const Lit outside = obs[i] ^ lit.sign();
+            if (level == 0) {
+                if (fixed_notified[outside.var()]) {
+                    continue;
+                }
+                fixed_notified[outside.var()] = 1;
+            }
+            assigned.push_back(outside);
+        }
+    }
+    if (!assigned.empty()) {
+        prop->notify_assignment(assigned);
+    }
+}
+
+void ExtPropHandler::canceling(const uint32_t level)
+{
+    if (level < notified_level) {
+        prop->notify_backtrack(level);
+        notified_level = level;
+    }
+    notified_at = std::min<size_t>(notified_at, solver->trail_lim[level]);
+}
+
+bool ExtPropHandler::add_clause(vector<Lit>& cl, const bool red)
+{
+    tmp_cl.clear();
+    bool removed = false;
+    for(const Lit lit: cl) {
+        if (lit.var() >= solver->nVarsOutside()) {
+            cerr << "ERROR: The external propagator gave variable " << lit.var()+1
+            << ", but the max var is " << solver->nVarsOutside() << endl;
+            exit(-1);
+        }
+        const Lit inter = outside_to_inter(lit);
+        removed |= solver->varData[inter.var()].removed != Removed::none;
+        tmp_cl.push_back(inter);
+    }
+
+    //Eliminated and decomposed vars are brought back by the usual way
+    if (removed) {
+        solver->cancelUntil(0);
+        if (!solver->propagate<false>().isNULL()) {
+            solver->ok = false;
+            return false;
+        }
+        return solver->add_clause_outer(cl, red);
+    }
+    return solver->add_clause_in_search(tmp_cl, red);
+}
+
+llbool ExtPropHandler::propagate()
+{
+    notify_assignments();
+
+    bool added = false;
+    outside_cl.clear();
+    while(prop->cb_has_external_clause(outside_cl)) {
+        if (!add_clause(outside_cl, false)) {
+            return l_False;
+        }
+        added = true;
+        outside_cl.clear();
+    }
+    if (added) {
+        return l_Continue;
+    }
+
+    props.clear();
+    prop->cb_propagate(props);
+    for(const Lit lit: props) {
+        if (lit.var() >= solver->nVarsOutside()) {
+            cerr << "ERROR: The external propagator propagated variable " << lit.var()+1
+            << ", but the max var is " << solver->nVarsOutside() << endl;
+            exit(-1);
+        }
+        if (solver->value(outside_to_inter(lit)) == l_True) {
+            continue;
+        }
+
+        outside_cl.clear();
+        prop->cb_add_reason_clause(lit, outside_cl);
+        if (std::find(outside_cl.begin(), outside_cl.end(), lit) == outside_cl.end()) {
+            cerr << "ERROR: The reason clause of external propagation " << lit
+            << " does not contain it" << endl;
+            exit(-1);
+        }
+        if (!add_clause(outside_cl, true)) {
+            return l_False;
+        }
+        added = true;
+    }
+
+    return added ? l_Continue : l_Nothing;
+}
+
+llbool ExtPropHandler::check_model()
+{
+    notify_assignments();
+
+    model.assign(solver->nVarsOutside(), l_Undef);
+    for(const uint32_t var: observed) {
+        model[var] = solver->value(outside_to_inter(Lit(var, false)));
+    }
+    if (prop->cb_check_found_model(model)) {
+        return l_Nothing;
+    }
+
+    bool added = false;
+    outside_cl.clear();
+    while(prop->cb_has_external_clause(outside_cl)) {
+        if (!add_clause(outside_cl, false)) {
+            return l_False;
+        }
+        added = true;
+        outside_cl.clear();
+    }
+    if (!added) {
+        cerr << "ERROR: The external propagator rejected the model,"
+        << " but gave no clause to exclude it" << endl;
+        exit(-1);
+    }
+    return l_Continue;
+}
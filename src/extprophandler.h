@@ -0,0 +1,94 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef __EXTPROPHANDLER_H__
+#define __EXTPROPHANDLER_H__
+
+#include <vector>
+#include "solvertypes.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Solver;
+
+/**
+@brief Connects an ExternalPropagator to the search
+
+The propagator is told about the assignments of observed variables in trail
+order, one decision level at a time, after each propagation that reached a
+fixedpoint. Its propagations are added right away together with their reason
+clause, as redundant clauses. Its external clauses are added as irredundant
+clauses. Both go through Solver::add_clause_in_search(), which only backtracks
+as far as needed.
+
+Observed variables are frozen, so they are never eliminated. Their
+replacements are followed: the handler maps each observed variable to the
+internal variable that stands for it at the start of every Searcher::solve().
+*/
+class ExtPropHandler
+{
+public:
+    ExtPropHandler(Solver* solver, ExternalPropagator* prop);
+    ~ExtPropHandler();
+
+    void add_observed_var(const uint32_t var);
+    void remove_observed_var(const uint32_t var);
+
+    //Called from the search
+    void start_search();
+    llbool propagate();
+    llbool check_model();
+    void canceling(const uint32_t level);
+
+private:
+    Solver* solver;
+    ExternalPropagator* prop;
+
+    Lit outside_to_inter(const Lit lit) const;
+    void notify_assignments();
+    bool add_clause(vector<Lit>& cl, const bool red);
+
+    vector<uint32_t> observed; ///<Observed outside vars
+    vector<char> observed_at; ///<Indexed by outside var
+    vector<char> fixed_notified; ///<Indexed by outside var
+
+    ///Observed vars that inter var V stands for are in
+    ///obs[obs_start[V]...obs_start[V+1]-1], as the outside lit that is
+    ///equivalent to the positive lit of V
+    vector<uint32_t> obs_start;
+    vector<Lit> obs;
+
+    size_t notified_at = 0; ///<Trail position up to which assignments were notified
+    uint32_t notified_level = 0;
+
+    vector<Lit> assigned;
+    vector<Lit> tmp_cl;
+    vector<Lit> outside_cl;
+    vector<Lit> props;
+    vector<lbool> model;
+};
+
+}
+
+#endif //__EXTPROPHANDLER_H__
@@ -0,0 +1,527 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gatetable.h"
+#include "solver.h"
+#include "clauseallocator.h"
+#include "popcnt.h"
+#include "drat.h"
+#include "time_mem.h"
+#include <algorithm>
+#include <limits>
+
+using namespace CMSat;
+
+GateTable::GateTable(Solver* _solver) :
+    solver(_solver)
+{
+}
+
+bool GateTable::find_def(
+    const uint32_t var
+    , GateDef& def
+    , Scratch& s
+    , vector<uint16_t>& seen
+    , int64_t* limit
+) const {
+    def.clear();
+    const Lit x = Lit(var, false);
+    if (find_and(x, def, s, seen, limit)
+        || find_and(~x, def, s, seen, limit)
+        || find_xor(x, def, limit)
+        || find_ite(x, def, s, limit)
+    ) {
+        return true;
+    }
+    def.clear();
+
+    return false;
+}
+
+/**
+@brief out = AND(l_1..l_k) if there are binaries (~out, l_i) and the clause
+(out, ~l_1, .., ~l_k). With k=1 the latter is a binary: an equivalence
+*/
+bool GateTable::find_and(
+    const Lit out
+    , GateDef& def
+    , Scratch& s
+    , vector<uint16_t>& seen
+    , int64_t* limit
+) const {
+    assert(s.toClear.empty());
+    watch_subarray_const ws_out = solver->watches[out];
+    watch_subarray_const ws_neg = solver->watches[~out];
+    *limit -= (long)ws_out.size() + (long)ws_neg.size();
+
+    for(const Watched& w: ws_neg) {
+        if (w.isBin() && !w.red() && !seen[(~w.lit2()).toInt()]) {
+            seen[(~w.lit2()).toInt()] = 1;
+            s.toClear.push_back(~w.lit2());
+        }
+    }
+    if (s.toClear.empty()) {
+        return false;
+    }
+
+    bool found = false;
+    for(const Watched& w: ws_out) {
+        if (w.isBin()) {
+            if (!w.red() && seen[w.lit2().toInt()]) {
+                def.inputs.push_back(~w.lit2());
+                def.bins.push_back(std::make_pair(out, w.lit2()));
+                def.bins.push_back(std::make_pair(~out, ~w.lit2()));
+                found = true;
+                break;
+            }
+            continue;
+        }
+
+        if (!w.isClause()) {
+            continue;
+        }
+
+        const Clause& cl = *solver->cl_alloc.ptr(w.get_offset());
+        if (cl.freed() || cl.getRemoved() || cl.red()) {
+            continue;
+        }
+
+        *limit -= (long)cl.size();
+        bool all_in = true;
+        for(const Lit l: cl) {
+            if (l != out && !seen[l.toInt()]) {
+                all_in = false;
+                break;
+            }
+        }
+        if (all_in) {
+            for(const Lit l: cl) {
+                if (l != out) {
+                    def.inputs.push_back(~l);
+                    def.bins.push_back(std::make_pair(~out, ~l));
+                }
+            }
+            def.cls.push_back(w.get_offset());
+            found = true;
+            break;
+        }
+    }
+
+    for(const Lit l: s.toClear) {
+        seen[l.toInt()] = 0;
+    }
+    s.toClear.clear();
+
+    if (found) {
+        def.type = GateType::and_gate;
+        def.out = out;
+        std::sort(def.inputs.begin(), def.inputs.end());
+    }
+
+    return found;
+}
+
+void GateTable::fill_terns(
+    watch_subarray_const ws
+    , const Lit lit
+    , vector<Scratch::Tern>& terns
+    , int64_t* limit
+) const {
+    terns.clear();
+    *limit -= (long)ws.size();
+    for(const Watched& w: ws) {
+        if (!w.isClause()) {
+            continue;
+        }
+
+        const Clause& cl = *solver->cl_alloc.ptr(w.get_offset());
+        if (cl.size() != 3 || cl.freed() || cl.getRemoved() || cl.red()) {
+            continue;
+        }
+
+        Scratch::Tern t;
+        t.offset = w.get_offset();
+        t.a = (cl[0] == lit) ? cl[1] : cl[0];
+        t.b = (cl[2] == lit) ? cl[1] : cl[2];
+        terns.push_back(t);
+
+        //Quadratic matching below, keep it cheap
+        if (terns.size() >= 64) {
+            break;
+        }
+    }
+}
+
+/**
+@brief x = c ? t : e if there are the clauses
+(~x, ~c, t) (x, ~c, ~t) (~x, c, e) (x, c, ~e)
+
+Each pair (~x, sel, val) (x, sel, ~val) is half of it: if sel is false, x = val
+*/
+bool GateTable::find_ite(const Lit x, GateDef& def, Scratch& s, int64_t* limit) const
+{
+    fill_terns(solver->watches[x], x, s.tern_pos, limit);
+    fill_terns(solver->watches[~x], ~x, s.tern_neg, limit);
+    if (s.tern_pos.size() < 2 || s.tern_neg.size() < 2) {
+        return false;
+    }
+
+    s.halves.clear();
+    *limit -= (long)(s.tern_neg.size()*s.tern_pos.size())*2;
+    for(const Scratch::Tern& n: s.tern_neg) {
+        for(uint32_t k = 0; k < 2; k++) {
+            const Lit sel = k ? n.b : n.a;
+            const Lit val = k ? n.a : n.b;
+            for(const Scratch::Tern& p: s.tern_pos) {
+                if ((p.a == sel && p.b == ~val)
+                    || (p.b == sel && p.a == ~val)
+                ) {
+                    Scratch::Half h;
+                    h.sel = sel;
+                    h.val = val;
+                    h.neg_cl = n.offset;
+                    h.pos_cl = p.offset;
+                    s.halves.push_back(h);
+                    break;
+                }
+            }
+        }
+    }
+
+    for(size_t i = 0; i < s.halves.size(); i++) {
+        for(size_t j = i+1; j < s.halves.size(); j++) {
+            const Scratch::Half& h1 = s.halves[i];
+            const Scratch::Half& h2 = s.halves[j];
+            if (h2.sel != ~h1.sel) {
+                continue;
+            }
+
+            //h1.sel false: x = h1.val, h1.sel true: x = h2.val
+            Lit c = h1.sel;
+            Lit t = h2.val;
+            Lit e = h1.val;
+            Lit out = x;
+            if (c.sign()) {
+                c = ~c;
+                std::swap(t, e);
+            }
+            if (t.sign()) {
+                t = ~t;
+                e = ~e;
+                out = ~out;
+            }
+            def.type = GateType::ite_gate;
+            def.out = out;
+            def.inputs.push_back(c);
+            def.inputs.push_back(t);
+            def.inputs.push_back(e);
+            def.cls.push_back(h1.neg_cl);
+            def.cls.push_back(h1.pos_cl);
+            def.cls.push_back(h2.neg_cl);
+            def.cls.push_back(h2.pos_cl);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+@brief x = XOR(inputs) if all 2^(k-1) clauses over the k vars with the same
+parity are present. Only up to 5 vars.
+*/
+bool GateTable::find_xor(const Lit x, GateDef& def, int64_t* limit) const
+{
+    watch_subarray_const poss = solver->watches[x];
+    watch_subarray_const negs = solver->watches[~x];
+    uint32_t tries = 0;
+    for(const Watched& w: poss) {
+        if (!w.isClause()) {
+            continue;
+        }
+
+        const Clause& cl = *solver->cl_alloc.ptr(w.get_offset());
+        if (cl.size() > 5 || cl.freed() || cl.getRemoved() || cl.red()) {
+            continue;
+        }
+        if (tries++ >= 4 || *limit < 0) {
+            break;
+        }
+
+        const uint32_t k = cl.size();
+        uint32_t parity = 0;
+        for(const Lit l: cl) {
+            parity ^= (uint32_t)l.sign();
+        }
+
+        uint32_t found = 0;
+        def.cls.clear();
+        for(uint32_t side = 0; side < 2; side++) {
+            watch_subarray_const ws = side ? negs : poss;
+            *limit -= (long)ws.size();
+            for(const Watched& w2: ws) {
+                if (!w2.isClause()) {
+                    continue;
+                }
+
+                const Clause& cl2 = *solver->cl_alloc.ptr(w2.get_offset());
+                if (cl2.size() != k || cl2.freed() || cl2.getRemoved() || cl2.red()) {
+                    continue;
+                }
+
+                *limit -= (long)k;
+                uint32_t mask = 0;
+                bool same_vars = true;
+                for(uint32_t i = 0; i < k; i++) {
+                    if (cl2[i].var() != cl[i].var()) {
+                        same_vars = false;
+                        break;
+                    }
+                    mask |= (uint32_t)cl2[i].sign() << i;
+                }
+                if (!same_vars
+                    || (my_popcnt(mask) & 1) != parity
+                    || (found & (1U << mask))
+                ) {
+                    continue;
+                }
+                found |= 1U << mask;
+                def.cls.push_back(w2.get_offset());
+            }
+        }
+
+        if ((uint32_t)my_popcnt(found) == (1U << (k-1))) {
+            //Forbidden assignments have XOR == parity, so XOR of all is !parity
+            def.type = GateType::xor_gate;
+            def.out = Lit(x.var(), parity == 0);
+            for(const Lit l: cl) {
+                if (l.var() != x.var()) {
+                    def.inputs.push_back(Lit(l.var(), false));
+                }
+            }
+            return true;
+        }
+    }
+    def.cls.clear();
+
+    return false;
+}
+
+/**
+@brief Rewrites the inputs with the equivalences found so far, then makes the
+definition canonical again
+
+This way gates over equivalent inputs are also found to be equivalent, in the
+same pass if the inputs are defined by lower-numbered vars
+*/
+void GateTable::substitute_equivs(GateDef& def) const
+{
+    for(Lit& l: def.inputs) {
+        l = repr[l.var()] ^ l.sign();
+    }
+
+    switch(def.type) {
+        case GateType::and_gate:
+            break;
+
+        case GateType::xor_gate:
+            for(Lit& l: def.inputs) {
+                if (l.sign()) {
+                    l = ~l;
+                    def.out = ~def.out;
+                }
+            }
+            break;
+
+        case GateType::ite_gate:
+            if (def.inputs[0].sign()) {
+                def.inputs[0] = ~def.inputs[0];
+                std::swap(def.inputs[1], def.inputs[2]);
+            }
+            if (def.inputs[1].sign()) {
+                def.inputs[1] = ~def.inputs[1];
+                def.inputs[2] = ~def.inputs[2];
+                def.out = ~def.out;
+            }
+            return;
+
+        default:
+            assert(false);
+    }
+    std::sort(def.inputs.begin(), def.inputs.end());
+}
+
+uint32_t GateTable::hash_def(const GateType type, const vector<Lit>& inputs)
+{
+    uint32_t h = (uint32_t)type;
+    for(const Lit l: inputs) {
+        h = h*31 + l.toInt();
+    }
+    return h ^ (h >> 16);
+}
+
+bool GateTable::same_def(const uint32_t gate, const GateDef& def) const
+{
+    const Gate& g = gates[gate];
+    if (g.type != def.type || g.num_inputs != def.inputs.size()) {
+        return false;
+    }
+
+    return std::equal(
+        def.inputs.begin()
+        , def.inputs.end()
+        , gate_inputs.begin() + g.inputs_at
+    );
+}
+
+void GateTable::build(vector<uint16_t>& seen, int64_t* limit)
+{
+    const double myTime = cpuTime();
+    Stats stats;
+    stats.numCalls = 1;
+    gates.clear();
+    gate_inputs.clear();
+    equivs.clear();
+    size_t table_size = 16;
+    while(table_size < solver->nVars()*2) {
+        table_size *= 2;
+    }
+    table.assign(table_size, 0);
+    repr.resize(solver->nVars());
+    for(uint32_t i = 0; i < repr.size(); i++) {
+        repr[i] = Lit(i, false);
+    }
+
+    for(uint32_t var = 0; var < solver->nVars() && *limit > 0; var++) {
+        if (solver->value(var) != l_Undef
+            || solver->varData[var].removed != Removed::none
+            || !find_def(var, tmp_def, scratch, seen, limit)
+        ) {
+            continue;
+        }
+
+        switch(tmp_def.type) {
+            case GateType::and_gate:
+                stats.and_gates++;
+                break;
+            case GateType::xor_gate:
+                stats.xor_gates++;
+                break;
+            case GateType::ite_gate:
+                stats.ite_gates++;
+                break;
+            default:
+                assert(false);
+        }
+
+        substitute_equivs(tmp_def);
+        const uint32_t h = hash_def(tmp_def.type, tmp_def.inputs);
+        size_t at = h & (table_size-1);
+        uint32_t dup = std::numeric_limits<uint32_t>::max();
+        *limit -= 10;
+        while(table[at] != 0) {
+            const uint32_t g = table[at]-1;
+            if (gates[g].hash == h && same_def(g, tmp_def)) {
+                dup = g;
+                break;
+            }
+            at = (at+1) & (table_size-1);
+        }
+
+        if (dup != std::numeric_limits<uint32_t>::max()) {
+            stats.dups++;
+
+            //Only with AND gates can unit propagation prove the equivalence,
+            //so with DRAT on, only those can be added
+            const Lit other = gates[dup].out;
+            if ((tmp_def.type == GateType::and_gate || !solver->drat->enabled())
+                && other.var() != tmp_def.out.var()
+            ) {
+                equivs.push_back(std::make_pair(other, tmp_def.out));
+                repr[tmp_def.out.var()] = other ^ tmp_def.out.sign();
+                stats.equivs++;
+            }
+            continue;
+        }
+
+        Gate g;
+        g.type = tmp_def.type;
+        g.out = tmp_def.out;
+        g.hash = h;
+        g.inputs_at = gate_inputs.size();
+        g.num_inputs = tmp_def.inputs.size();
+        gate_inputs.insert(gate_inputs.end(), tmp_def.inputs.begin(), tmp_def.inputs.end());
+        gates.push_back(g);
+        table[at] = gates.size();
+    }
+
+    //Only the equivalences are needed from here on
+    vector<Gate>().swap(gates);
+    vector<Lit>().swap(gate_inputs);
+    vector<uint32_t>().swap(table);
+    vector<Lit>().swap(repr);
+
+    stats.time_used = cpuTime() - myTime;
+    if (solver->conf.verbosity) {
+        stats.print_short(solver);
+    }
+    globalStats += stats;
+}
+
+size_t GateTable::mem_used() const
+{
+    size_t b = 0;
+    b += gates.capacity()*sizeof(Gate);
+    b += gate_inputs.capacity()*sizeof(Lit);
+    b += table.capacity()*sizeof(uint32_t);
+    b += equivs.capacity()*sizeof(std::pair<Lit, Lit>);
+    b += repr.capacity()*sizeof(Lit);
+
+    return b;
+}
+
+GateTable::Stats& GateTable::Stats::operator+=(const Stats& other)
+{
+    numCalls += other.numCalls;
+    and_gates += other.and_gates;
+    xor_gates += other.xor_gates;
+    ite_gates += other.ite_gates;
+    dups += other.dups;
+    equivs += other.equivs;
+    time_used += other.time_used;
+
+    return *this;
+}
+
+void GateTable::Stats::print_short(const Solver* s) const
+{
+    cout
+    << "c [occ-gate-table]"
+    << " and: " << and_gates
+    << " xor: " << xor_gates
+    << " ite: " << ite_gates
+    << " dup: " << dups
+    << " equiv: " << equivs
+    << s->conf.print_times(time_used)
+    << endl;
+}
@@ -0,0 +1,187 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef __GATETABLE_H__
+#define __GATETABLE_H__
+
+#include "cloffset.h"
+#include "solvertypes.h"
+#include "watched.h"
+#include "watcharray.h"
+#include <vector>
+#include <utility>
+using std::vector;
+
+namespace CMSat {
+
+class Solver;
+
+enum class GateType : uint8_t {
+    none
+    , and_gate ///<out = AND(inputs). An OR gate is an AND gate with negated out
+    , xor_gate ///<out = XOR(inputs), inputs are all positive
+    , ite_gate ///<out = inputs[0] ? inputs[1] : inputs[2]
+};
+
+/**
+@brief A definition of a variable, with the irredundant clauses encoding it
+
+Inputs are canonical, so structurally equal definitions have equal inputs
+*/
+struct GateDef
+{
+    GateType type = GateType::none;
+    Lit out = lit_Undef;
+    vector<Lit> inputs;
+    vector<ClOffset> cls; ///<Long clauses of the definition
+    vector<std::pair<Lit, Lit> > bins; ///<Binary clauses: (lit of defined var, other lit)
+
+    void clear()
+    {
+        type = GateType::none;
+        out = lit_Undef;
+        inputs.clear();
+        cls.clear();
+        bins.clear();
+    }
+};
+
+/**
+@brief Finds AND/OR, XOR and ITE definitions in the occurrence lists
+
+find_def() only reads, so multiple threads can call it with their own Scratch.
+build() makes one pass over all variables and hash-conses the definitions:
+if two variables have the same definition, they are equivalent. Inputs are
+rewritten with the equivalences already found, so equivalences propagate
+upwards through the circuit within the pass.
+*/
+class GateTable
+{
+public:
+    explicit GateTable(Solver* solver);
+
+    struct Scratch
+    {
+        struct Tern
+        {
+            ClOffset offset;
+            Lit a;
+            Lit b;
+        };
+        struct Half
+        {
+            Lit sel;
+            Lit val;
+            ClOffset neg_cl;
+            ClOffset pos_cl;
+        };
+        vector<Lit> toClear;
+        vector<Tern> tern_pos;
+        vector<Tern> tern_neg;
+        vector<Half> halves;
+    };
+
+    bool find_def(
+        const uint32_t var
+        , GateDef& def
+        , Scratch& s
+        , vector<uint16_t>& seen
+        , int64_t* limit
+    ) const;
+
+    //Fills get_equivs() with the pairs of equivalent literals found
+    void build(vector<uint16_t>& seen, int64_t* limit);
+    const vector<std::pair<Lit, Lit> >& get_equivs() const;
+    size_t mem_used() const;
+
+    struct Stats
+    {
+        Stats& operator+=(const Stats& other);
+        void print_short(const Solver* solver) const;
+
+        uint64_t numCalls = 0;
+        uint64_t and_gates = 0;
+        uint64_t xor_gates = 0;
+        uint64_t ite_gates = 0;
+        uint64_t dups = 0;
+        uint64_t equivs = 0;
+        double time_used = 0;
+    };
+    const Stats& get_stats() const;
+
+private:
+    bool find_and(
+        const Lit out
+        , GateDef& def
+        , Scratch& s
+        , vector<uint16_t>& seen
+        , int64_t* limit
+    ) const;
+    bool find_ite(const Lit x, GateDef& def, Scratch& s, int64_t* limit) const;
+    bool find_xor(const Lit x, GateDef& def, int64_t* limit) const;
+    void fill_terns(
+        watch_subarray_const ws
+        , const Lit lit
+        , vector<Scratch::Tern>& terns
+        , int64_t* limit
+    ) const;
+    void substitute_equivs(GateDef& def) const;
+    static uint32_t hash_def(const GateType type, const vector<Lit>& inputs);
+    bool same_def(const uint32_t gate, const GateDef& def) const;
+
+    Solver* solver;
+
+    //The table: gates are stored flat, 'table' is open-addressed with
+    //gate index+1 in each slot (0 is empty)
+    struct Gate
+    {
+        GateType type;
+        Lit out;
+        uint32_t hash;
+        uint32_t inputs_at;
+        uint32_t num_inputs;
+    };
+    vector<Gate> gates;
+    vector<Lit> gate_inputs;
+    vector<uint32_t> table;
+    vector<std::pair<Lit, Lit> > equivs;
+    vector<Lit> repr; ///<Representative of each var, from the equivalences found
+    GateDef tmp_def;
+    Scratch scratch;
+
+    Stats globalStats;
+};
+
+inline const vector<std::pair<Lit, Lit> >& GateTable::get_equivs() const
+{
+    return equivs;
+}
+
+inline const GateTable::Stats& GateTable::get_stats() const
+{
+    return globalStats;
+}
+
+} //end namespace
+
+#endif //__GATETABLE_H__
@@ -35,32 +35,113 @@ using namespace CMSat;
 using std::cout;
 using std::endl;
 
+void TransCache::decode(vector<LitExtra>& out) const
+{
+    out.reserve(out.size() + num);
+    for(const LitExtra le: *this) {
+        out.push_back(le);
+    }
+}
+
+void TransCache::encode(const vector<LitExtra>& lits)
+{
+    data.clear();
+    uint32_t prev = 0;
+    for(const LitExtra le: lits) {
+        assert(data.empty() || le.toRaw() > prev);
+        uint32_t delta = le.toRaw() - prev;
+        prev = le.toRaw();
+        while (delta >= 0x80) {
+            data.push_back((uint8_t)(delta & 0x7f) | 0x80);
+            delta >>= 7;
+        }
+        data.push_back((uint8_t)delta);
+    }
+    num = lits.size();
+
+    //Don't keep much slack around, that would defeat the purpose
+    if (data.capacity() > data.size() + data.size()/4 + 16) {
+        data.shrink_to_fit();
+    }
+}
+
+void TransCache::free()
+{
+    vector<uint8_t> tmp;
+    data.swap(tmp);
+    num = 0;
+}
+
+void ImplCache::set_lits(TransCache& tc, const vector<LitExtra>& lits)
+{
+    bytes_used -= tc.mem_used();
+    tc.encode(lits);
+    bytes_used += tc.mem_used();
+}
+
+void ImplCache::free_lits(TransCache& tc)
+{
+    bytes_used -= tc.mem_used();
+    tc.free();
+}
+
+void ImplCache::recount_bytes()
+{
+    bytes_used = 0;
+    for(const TransCache& tc: implCache) {
+        bytes_used += tc.mem_used();
+    }
+}
+
 //Make all literals as if propagated only by redundant
 void ImplCache::makeAllRed()
 {
-    for(vector<TransCache>::iterator
-        it = implCache.begin(), end = implCache.end()
-        ; it != end
-        ; ++it
-    ) {
-        it->makeAllRed();
+    for(TransCache& tc: implCache) {
+        if (tc.empty())
+            continue;
+
+        //Clearing the lowest bit keeps the order
+        tmp_lits.clear();
+        tc.decode(tmp_lits);
+        for(LitExtra& le: tmp_lits) {
+            le = LitExtra(le.getLit(), false);
+        }
+        set_lits(tc, tmp_lits);
     }
 }
 
 size_t ImplCache::mem_used() const
 {
-    double numBytes = 0;
-    for(vector<TransCache>::const_iterator
-        it = implCache.begin(), end = implCache.end()
-        ; it != end
-        ; ++it
-    ) {
-        //1.2 is overhead
-        numBytes += (double)it->lits.capacity()*(double)sizeof(LitExtra)*1.2;
+    return bytes_used + implCache.capacity()*sizeof(TransCache);
+}
+
+size_t ImplCache::evict_lru(const size_t target_bytes)
+{
+    if (bytes_used <= target_bytes)
+        return 0;
+
+    vector<std::pair<uint32_t, uint32_t> > by_age;
+    for(size_t i = 0; i < implCache.size(); i++) {
+        if (implCache[i].mem_used() > 0) {
+            by_age.push_back(std::make_pair(implCache[i].last_used, i));
+        }
     }
-    numBytes += implCache.capacity()*sizeof(vector<TransCache>);
+    std::sort(by_age.begin(), by_age.end());
 
-    return numBytes;
+    const size_t orig_bytes = bytes_used;
+    size_t num = 0;
+    for(const auto& x: by_age) {
+        if (bytes_used <= target_bytes)
+            break;
+
+        free_lits(implCache[x.second]);
+        num++;
+    }
+    evictStats.rounds++;
+    evictStats.caches += num;
+    evictStats.bytes += orig_bytes - bytes_used;
+
+    return orig_bytes - bytes_used;
 }
 
 void ImplCache::print_stats(const Solver* solver) const
@@ -87,8 +168,8 @@ void ImplCache::print_statsSort(const Solver* solver) const
 
         if (solver->varData[lit.var()].removed == Removed::none) {
             activeLits++;
-            totalElems += implCache[i].lits.size();
-            numHasElems += !implCache[i].lits.empty();
+            totalElems += implCache[i].size();
+            numHasElems += !implCache[i].empty();
         }
     }
 
@@ -103,6 +184,19 @@ void ImplCache::print_statsSort(const Solver* solver) const
         , stats_line_percent(totalElems, numHasElems)
         , "extralits"
     );
+
+    print_stats_line(
+        "c bytes in cache/elem"
+        , float_div(bytes_used, totalElems)
+        , "bytes"
+    );
+
+    print_stats_line(
+        "c cache evictions"
+        , evictStats.rounds
+        , evictStats.caches
+        , "caches"
+    );
 }
 
 bool ImplCache::clean(Solver* solver, bool* setSomething)
@@ -123,7 +217,7 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
         if (solver->varData[var].removed == Removed::replaced) {
             for(int i = 0; i < 2; i++) {
                 const Lit litOrig = Lit(var, i);
-                if (implCache[litOrig.toInt()].lits.empty())
+                if (implCache[litOrig.toInt()].empty())
                     continue;
 
                 const Lit lit = solver->varReplacer->get_lit_replaced_with(litOrig);
@@ -131,8 +225,9 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
                 //Updated literal must be normal, otherwise, biig problems e.g
                 //implCache is not even large enough, etc.
                 if (solver->varData[lit.var()].removed == Removed::none) {
-                    bool taut = implCache.at(lit.toInt()).merge(
-                        implCache[litOrig.toInt()].lits
+                    bool taut = merge(
+                        lit
+                        , litOrig
                         , lit_Undef //nothing to add
                         , false //replaced, so 'irred'
                         , lit.var() //exclude the literal itself
@@ -156,13 +251,11 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
         if (solver->value(var) != l_Undef
             || solver->varData[var].removed != Removed::none
         ) {
-            vector<LitExtra> tmp1;
-            numFreed += implCache[Lit(var, false).toInt()].lits.capacity();
-            implCache[Lit(var, false).toInt()].lits.swap(tmp1);
+            numFreed += implCache[Lit(var, false).toInt()].size();
+            free_lits(implCache[Lit(var, false).toInt()]);
 
-            vector<LitExtra> tmp2;
-            numFreed += implCache[Lit(var, true).toInt()].lits.capacity();
-            implCache[Lit(var, true).toInt()].lits.swap(tmp2);
+            numFreed += implCache[Lit(var, true).toInt()].size();
+            free_lits(implCache[Lit(var, true).toInt()]);
         }
     }
 
@@ -174,14 +267,19 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
         ; trans != transEnd
         ; trans++, wsLit++
     ) {
+        if (trans->empty())
+            continue;
+
         //Stats
-        size_t origSize = trans->lits.size();
+        size_t origSize = trans->size();
         size_t newSize = 0;
+        tmp_lits.clear();
+        trans->decode(tmp_lits);
 
         //Update to replaced vars, remove vars already set or eliminated
         Lit vertLit = Lit::toLit(wsLit);
-        for (vector<LitExtra>::iterator end = trans->lits.end(),
-            it=trans->lits.begin(), it2 = trans->lits.begin()
+        for (vector<LitExtra>::iterator end = tmp_lits.end(),
+            it=tmp_lits.begin(), it2 = tmp_lits.begin()
             ; it != end
             ; ++it
         ) {
@@ -223,14 +321,14 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
             *it2++ = LitExtra(lit, it->getOnlyIrredBin());
             newSize++;
         }
-        trans->lits.resize(newSize);
+        tmp_lits.resize(newSize);
 
         //Now that we have gone through the list, go through once more to:
         //1) set irred right (above we might have it set later)
         //2) clear 'inside'
         //3) clear 'irred'
         for (vector<LitExtra>::iterator
-            it2 = trans->lits.begin(), end2 = trans->lits.end()
+            it2 = tmp_lits.begin(), end2 = tmp_lits.end()
             ;it2 != end2
             ; it2++
         ) {
@@ -248,7 +346,9 @@ bool ImplCache::clean(Solver* solver, bool* setSomething)
             assert(solver->varData[it2->getLit().var()].removed == Removed::none);
             assert(solver->value(it2->getLit()) == l_Undef);
         }
-        numCleaned += origSize-trans->lits.size();
+        std::sort(tmp_lits.begin(), tmp_lits.end(), LitExtraRawSorter());
+        set_lits(*trans, tmp_lits);
+        numCleaned += origSize-trans->size();
     }
 
     size_t origTrailDepth = solver->trail_size();
@@ -413,27 +513,23 @@ void ImplCache::tryVar(
 
     Lit lit = Lit(var, false);
 
-    const vector<LitExtra>& cache1 = implCache[lit.toInt()].lits;
+    const TransCache& cache1 = implCache[lit.toInt()];
     assert(solver->watches.size() > (lit.toInt()));
     watch_subarray_const ws1 = solver->watches[lit];
-    const vector<LitExtra>& cache2 = implCache[(~lit).toInt()].lits;
+    const TransCache& cache2 = implCache[(~lit).toInt()];
     watch_subarray_const ws2 = solver->watches[~lit];
 
     //Fill 'seen' and 'val' from cache
-    for (vector<LitExtra>::const_iterator
-        it = cache1.begin(), end = cache1.end()
-        ; it != end
-        ; ++it
-    ) {
-        const uint32_t var2 = it->getLit().var();
+    for (const LitExtra le: cache1) {
+        const uint32_t var2 = le.getLit().var();
 
         //A variable that has been really eliminated, skip
         if (solver->varData[var2].removed != Removed::none) {
             continue;
         }
 
-        seen[it->getLit().var()] = 1;
-        val[it->getLit().var()] = it->getLit().sign();
+        seen[le.getLit().var()] = 1;
+        val[le.getLit().var()] = le.getLit().sign();
     }
 
     //Fill 'seen' and 'val' from watch
@@ -458,13 +554,9 @@ void ImplCache::tryVar(
 
     //Try to see if we propagate the same or opposite from the other end
     //Using cache
-    for (vector<LitExtra>::const_iterator
-        it = cache2.begin(), end = cache2.end()
-        ; it != end
-        ; ++it
-    ) {
-        assert(it->getLit().var() != var);
-        const uint32_t var2 = it->getLit().var();
+    for (const LitExtra le: cache2) {
+        assert(le.getLit().var() != var);
+        const uint32_t var2 = le.getLit().var();
 
         //Only if the other one also contained it
         if (!seen[var2])
@@ -475,7 +567,7 @@ void ImplCache::tryVar(
             continue;
         }
 
-        handleNewData(val, var, it->getLit());
+        handleNewData(val, var, le.getLit());
     }
 
     //Try to see if we propagate the same or opposite from the other end
@@ -496,9 +588,9 @@ void ImplCache::tryVar(
     }
 
     //Clear 'seen' and 'val'
-    for (vector<LitExtra>::const_iterator it = cache1.begin(), end = cache1.end(); it != end; ++it) {
-        seen[it->getLit().var()] = false;
-        val[it->getLit().var()] = false;
+    for (const LitExtra le: cache1) {
+        seen[le.getLit().var()] = false;
+        val[le.getLit().var()] = false;
     }
 
     for (const Watched *it = ws1.begin(), *end = ws1.end(); it != end; ++it) {
@@ -510,85 +602,47 @@ void ImplCache::tryVar(
     }
 }
 
-bool TransCache::merge(
-    const vector<LitExtra>& otherLits //Lits to add
-    , const Lit extraLit //Add this, too to the list of lits
-    , const bool red //The step was a redundant-dependent step?
-    , const uint32_t leaveOut //Leave this literal out
+bool ImplCache::merge(
+    const Lit to
+    , const Lit from
+    , const Lit extraLit
+    , const bool red
+    , const uint32_t leaveOut
     , vector<uint16_t>& seen
 ) {
-    //Mark every literal that is to be added in 'seen'
-    for (size_t i = 0, size = otherLits.size(); i < size; i++) {
-        const Lit lit = otherLits[i].getLit();
-        const bool onlyIrred = otherLits[i].getOnlyIrredBin();
-
-        seen[lit.toInt()] = 1 + (int)onlyIrred;
-    }
-
-    bool taut = mergeHelper(extraLit, red, seen);
-
-    //Whatever rests needs to be added
-    for (size_t i = 0 ,size = otherLits.size(); i < size; i++) {
-        const Lit lit = otherLits[i].getLit();
-        if (seen[lit.toInt()]) {
-            if (lit.var() != leaveOut)
-                lits.push_back(LitExtra(lit, !red && otherLits[i].getOnlyIrredBin()));
-            seen[lit.toInt()] = 0;
-        }
-    }
+    tmp_other.clear();
+    implCache[from.toInt()].decode(tmp_other);
+    return merge_into(implCache[to.toInt()], tmp_other, extraLit, red, leaveOut, seen);
+}
 
-    //Handle extra lit
-    if (extraLit != lit_Undef && seen[extraLit.toInt()]) {
-        if (extraLit.var() != leaveOut)
-            lits.push_back(LitExtra(extraLit, !red));
-        seen[extraLit.toInt()] = 0;
+bool ImplCache::merge(
+    const Lit to
+    , const vector<Lit>& otherLits
+    , const Lit extraLit
+    , const bool red
+    , const uint32_t leaveOut
+    , vector<uint16_t>& seen
+) {
+    tmp_other.clear();
+    for(const Lit lit: otherLits) {
+        tmp_other.push_back(LitExtra(lit, false));
     }
-
-    return taut;
+    return merge_into(implCache[to.toInt()], tmp_other, extraLit, red, leaveOut, seen);
 }
 
-bool TransCache::merge(
-    const vector<Lit>& otherLits //Lits to add
+bool ImplCache::merge_into(
+    TransCache& tc
+    , const vector<LitExtra>& otherLits //Lits to add
     , const Lit extraLit //Add this, too to the list of lits
     , const bool red //The step was a redundant-dependent step?
     , const uint32_t leaveOut //Leave this literal out
     , vector<uint16_t>& seen
 ) {
     //Mark every literal that is to be added in 'seen'
-    for (size_t i = 0, size = otherLits.size(); i < size; i++) {
-        const Lit lit = otherLits[i];
-        seen[lit.toInt()] = 1;
-    }
-
-    bool taut = mergeHelper(extraLit, red, seen);
-
-    //Whatever rests needs to be added
-    for (size_t i = 0 ,size = otherLits.size(); i < size; i++) {
-        const Lit lit = otherLits[i];
-        if (seen[lit.toInt()]) {
-            if (lit.var() != leaveOut)
-                lits.push_back(LitExtra(lit, false));
-            seen[lit.toInt()] = 0;
-        }
+    for (const LitExtra le: otherLits) {
+        seen[le.getLit().toInt()] = 1 + (int)le.getOnlyIrredBin();
     }
 
-    //Handle extra lit
-    if (extraLit != lit_Undef && seen[extraLit.toInt()]) {
-        if (extraLit.var() != leaveOut)
-            lits.push_back(LitExtra(extraLit, !red));
-        seen[extraLit.toInt()] = 0;
-    }
-
-    return taut;
-}
-
-bool TransCache::mergeHelper(
-    const Lit extraLit //Add this, too to the list of lits
-    , const bool red //The step was a redundant-dependent step?
-    , vector<uint16_t>& seen
-) {
-    bool taut = false;
-
     //Handle extra lit
     if (extraLit != lit_Undef)
         seen[extraLit.toInt()] = 1 + (int)!red;
@@ -596,43 +650,64 @@ bool TransCache::mergeHelper(
     //Everything that's already in the cache, set seen[] to zero
     //Also, if seen[] is 2, but it's marked redundant in the cache
     //mark it as irred
-    for (size_t i = 0, size = lits.size(); i < size; i++) {
+    bool taut = false;
+    bool changed = false;
+    tmp_lits.clear();
+    tc.decode(tmp_lits);
+    for (LitExtra& le: tmp_lits) {
         if (!red
-            && !lits[i].getOnlyIrredBin()
-            && seen[lits[i].getLit().toInt()] == 2
+            && !le.getOnlyIrredBin()
+            && seen[le.getLit().toInt()] == 2
         ) {
-            lits[i].setOnlyIrredBin();
+            le.setOnlyIrredBin();
+            changed = true;
         }
 
-        seen[lits[i].getLit().toInt()] = 0;
+        seen[le.getLit().toInt()] = 0;
 
         //Both L and ~L are in, the ancestor is a tautology
-        if (seen[(~(lits[i].getLit())).toInt()]) {
+        if (seen[(~(le.getLit())).toInt()]) {
             taut = true;
         }
     }
 
-    return taut;
-}
+    //Whatever rests needs to be added
+    const size_t origSize = tmp_lits.size();
+    for (const LitExtra le: otherLits) {
+        const Lit lit = le.getLit();
+        if (seen[lit.toInt()]) {
+            if (lit.var() != leaveOut)
+                tmp_lits.push_back(LitExtra(lit, !red && le.getOnlyIrredBin()));
+            seen[lit.toInt()] = 0;
+        }
+    }
 
-//Make all literals as if propagated only by redundant
-void TransCache::makeAllRed()
-{
-    for(size_t i = 0; i < lits.size(); i++) {
-        lits[i] = LitExtra(lits[i].getLit(), false);
+    //Handle extra lit
+    if (extraLit != lit_Undef && seen[extraLit.toInt()]) {
+        if (extraLit.var() != leaveOut)
+            tmp_lits.push_back(LitExtra(extraLit, !red));
+        seen[extraLit.toInt()] = 0;
     }
 
-}
+    if (changed || tmp_lits.size() != origSize) {
+        std::sort(tmp_lits.begin() + origSize, tmp_lits.end(), LitExtraRawSorter());
+        std::inplace_merge(
+            tmp_lits.begin()
+            , tmp_lits.begin() + origSize
+            , tmp_lits.end()
+            , LitExtraRawSorter()
+        );
+        set_lits(tc, tmp_lits);
+    }
 
-void TransCache::updateVars(
-    const std::vector< uint32_t >& outerToInter
-    , const size_t newMaxVars
-) {
-    for(size_t i = 0; i < lits.size(); i++) {
-        lits[i] = LitExtra(getUpdatedLit(lits[i].getLit(), outerToInter), lits[i].getOnlyIrredBin());
-        assert(lits[i].getLit().var() < newMaxVars);
+    //Over budget: drop the least recently used caches, with some
+    //hysteresis so that we don't have to do this at every merge
+    if (bytes_used > max_bytes) {
+        touch(tc);
+        evict_lru(max_bytes - max_bytes/5);
     }
 
+    return taut;
 }
 
 void ImplCache::updateVars(
@@ -642,8 +717,18 @@ void ImplCache::updateVars(
     , const size_t newMaxVar
 ) {
     updateBySwap(implCache, seen, interToOuter2);
-    for(size_t i = 0; i < implCache.size(); i++) {
-        implCache[i].updateVars(outerToInter, newMaxVar);
+    for(TransCache& tc: implCache) {
+        if (tc.empty())
+            continue;
+
+        tmp_lits.clear();
+        tc.decode(tmp_lits);
+        for(LitExtra& le: tmp_lits) {
+            le = LitExtra(getUpdatedLit(le.getLit(), outerToInter), le.getOnlyIrredBin());
+            assert(le.getLit().var() < newMaxVar);
+        }
+        std::sort(tmp_lits.begin(), tmp_lits.end(), LitExtraRawSorter());
+        set_lits(tc, tmp_lits);
     }
 }
 
@@ -43,6 +43,18 @@ public:
         x = ((uint32_t)onlyNLBin) | (l.toInt() << 1);
     }
 
+    static LitExtra fromRaw(const uint32_t raw)
+    {
+        LitExtra le;
+        le.x = raw;
+        return le;
+    }
+
+    uint32_t toRaw() const
+    {
+        return x;
+    }
+
     const Lit getLit() const
     {
         return Lit::toLit(x>>1);
@@ -79,49 +91,137 @@ private:
 
 };
 
+//Orders by literal first, the irred flag being the lowest bit
+struct LitExtraRawSorter
+{
+    bool operator()(const LitExtra a, const LitExtra b) const
+    {
+        return a.toRaw() < b.toRaw();
+    }
+};
+
+/**
+@brief The implied literals of a literal, stored compactly
+
+The literals are kept sorted and stored as LEB128-style varints of the
+difference between consecutive raw LitExtra values. Dense caches thus take
+~1 byte per element instead of 4. Elements can only be read in order, through
+the iterator. Modification is done by ImplCache, which decodes, updates and
+re-encodes the list.
+*/
 class TransCache {
 public:
-    TransCache()
-        //conflictLastUpdated(std::numeric_limits<uint64_t>::max())
-    {}
+    class const_iterator
+    {
+    public:
+        const_iterator(const uint8_t* _at, const uint8_t* _end) :
+            at(_at)
+            , next(_at)
+            , end(_end)
+        {
+            decode();
+        }
 
-    bool merge(
-        const vector<LitExtra>& otherLits
-        , const Lit extraLit
-        , const bool red
-        , const uint32_t leaveOut
-        , vector<uint16_t>& seen
-    );
-    bool merge(
-        const vector<Lit>& otherLits //Lits to add
-        , const Lit extraLit //Add this, too to the list of lits
-        , const bool red //The step was a redundant-dependent step?
-        , const uint32_t leaveOut //Leave this literal out
-        , vector<uint16_t>& seen
-    );
-    void makeAllRed();
+        LitExtra operator*() const
+        {
+            return LitExtra::fromRaw(x);
+        }
 
-    void updateVars(
-        const std::vector< uint32_t >& outerToInter
-        , const size_t newMaxVars
-    );
+        const_iterator& operator++()
+        {
+            at = next;
+            decode();
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            return at == other.at;
+        }
+
+        bool operator!=(const const_iterator& other) const
+        {
+            return at != other.at;
+        }
+
+    private:
+        void decode()
+        {
+            if (at == end)
+                return;
+
+            uint32_t delta = 0;
+            uint32_t shift = 0;
+            while (*next & 0x80) {
+                delta |= (uint32_t)(*next & 0x7f) << shift;
+                shift += 7;
+                next++;
+            }
+            delta |= (uint32_t)*next << shift;
+            next++;
+            x += delta;
+        }
+
+        const uint8_t* at;
+        const uint8_t* next;
+        const uint8_t* end;
+        uint32_t x = 0;
+    };
+
+    const_iterator begin() const
+    {
+        return const_iterator(data.data(), data.data() + data.size());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(data.data() + data.size(), data.data() + data.size());
+    }
 
-    std::vector<LitExtra> lits;
-    //uint64_t conflictLastUpdated;
+    size_t size() const
+    {
+        return num;
+    }
+
+    bool empty() const
+    {
+        return num == 0;
+    }
+
+    size_t mem_used() const
+    {
+        return data.capacity();
+    }
+
+    void swap(TransCache& other)
+    {
+        data.swap(other.data);
+        std::swap(num, other.num);
+        std::swap(last_used, other.last_used);
+    }
+
+    //Last time (in ImplCache::use_clock ticks) this was accessed
+    uint32_t last_used = 0;
 
 private:
-    bool mergeHelper(
-        const Lit extraLit //Add this, too to the list of lits
-        , const bool red //The step was a redundant-dependent step?
-        , vector<uint16_t>& seen
-    );
+    friend class ImplCache;
+
+    //Appends the decoded literals to "out"
+    void decode(vector<LitExtra>& out) const;
+
+    //"lits" must be sorted by LitExtraRawSorter and contain every literal once
+    void encode(const vector<LitExtra>& lits);
+    void free();
+
+    vector<uint8_t> data;
+    uint32_t num = 0;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const TransCache& tc)
 {
-    for (size_t i = 0; i < tc.lits.size(); i++) {
-        os << tc.lits[i].getLit()
-        << "(" << (tc.lits[i].getOnlyIrredBin() ? "NL" : "L") << ") ";
+    for (const LitExtra le: tc) {
+        os << le.getLit()
+        << "(" << (le.getOnlyIrredBin() ? "NL" : "L") << ") ";
     }
     return os;
 }
@@ -136,6 +236,7 @@ public:
     {
         implCache.resize(newNumVars*2);
         implCache.shrink_to_fit();
+        recount_bytes();
     }
 
     std::vector<TransCache> implCache;
@@ -167,8 +268,35 @@ public:
 
     TransCache& operator[](const Lit at)
     {
-        return implCache[at.toInt()];
+        TransCache& tc = implCache[at.toInt()];
+        touch(tc);
+        return tc;
+    }
+
+    bool merge(
+        const Lit to
+        , const Lit from //Lits to add are the ones in the cache of this lit
+        , const Lit extraLit //Add this, too to the list of lits
+        , const bool red //The step was a redundant-dependent step?
+        , const uint32_t leaveOut //Leave this literal out
+        , vector<uint16_t>& seen
+    );
+    bool merge(
+        const Lit to
+        , const vector<Lit>& otherLits //Lits to add
+        , const Lit extraLit //Add this, too to the list of lits
+        , const bool red //The step was a redundant-dependent step?
+        , const uint32_t leaveOut //Leave this literal out
+        , vector<uint16_t>& seen
+    );
+
+    //Hard limit on the memory of the elements. Exceeding it evicts the
+    //least recently used caches
+    void set_max_bytes(const size_t _max_bytes)
+    {
+        max_bytes = _max_bytes;
     }
+    size_t evict_lru(const size_t target_bytes);
 
     void new_var()
     {
@@ -222,24 +350,65 @@ public:
         return globalStats;
     }
 
+    struct EvictStats
+    {
+        uint64_t rounds = 0;
+        uint64_t caches = 0;
+        uint64_t bytes = 0;
+    };
+    const EvictStats& get_evict_stats() const
+    {
+        return evictStats;
+    }
+
     void free()
     {
         vector<TransCache> tmp;
         implCache.swap(tmp);
+        bytes_used = 0;
     }
 
     void clear()
     {
-        for(vector<TransCache>::iterator
-            it = implCache.begin(), end = implCache.end()
-            ; it != end
-            ; ++it
-        ) {
-            it->lits.clear();
+        for(TransCache& tc: implCache) {
+            tc.free();
         }
+        bytes_used = 0;
     }
 
 private:
+    void touch(TransCache& tc)
+    {
+        use_clock++;
+        if (use_clock == 0) {
+            for(TransCache& tc2: implCache) {
+                tc2.last_used = 0;
+            }
+            use_clock = 1;
+        }
+        tc.last_used = use_clock;
+    }
+
+    //Replaces the elements of "tc" with "lits", keeping "bytes_used" in sync
+    void set_lits(TransCache& tc, const vector<LitExtra>& lits);
+    void free_lits(TransCache& tc);
+    void recount_bytes();
+    bool merge_into(
+        TransCache& tc
+        , const vector<LitExtra>& otherLits
+        , const Lit extraLit
+        , const bool red
+        , const uint32_t leaveOut
+        , vector<uint16_t>& seen
+    );
+
+    size_t bytes_used = 0;
+    size_t max_bytes = std::numeric_limits<size_t>::max();
+    uint32_t use_clock = 0;
+    EvictStats evictStats;
+    vector<LitExtra> tmp_lits;
+    vector<LitExtra> tmp_other;
+
     void tryVar(Solver* solver, uint32_t var);
 
     void handleNewData(
@@ -265,7 +434,7 @@ namespace std
     noexcept (true)
     #endif
     {
-         m1.lits.swap(m2.lits);
+         m1.swap(m2);
     }
 }
 
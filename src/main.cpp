@@ -273,6 +273,11 @@ void Main::printResultFunc(
         *os << "s INDETERMINATE" << endl;
     }
 
+    //There is no model, just the count
+    if (ret == l_True && approx_count) {
+        return;
+    }
+
     if (ret == l_True && (printResult || toFile)) {
         if (toFile) {
             for (uint32_t var = 0; var < solver->nVars(); var++) {
@@ -413,6 +418,12 @@ void Main::add_supported_options()
     iterativeOptions.add_options()
     ("maxsol", po::value(&max_nr_of_solutions)->default_value(max_nr_of_solutions)
         , "Search for given amount of solutions. Thanks to Jannis Harder for the decision-based banning idea")
+    ("approxcount", po::bool_switch(&approx_count)
+        , "Approximately count the solutions, projected on the independent vars if given, instead of solving")
+    ("epsilon", po::value(&approx_epsilon)->default_value(approx_epsilon)
+        , "Approximate count is within a factor of 1+epsilon of the real one...")
+    ("delta", po::value(&approx_delta)->default_value(approx_delta)
+        , "...with probability at least 1-delta")
     ("debuglib", po::value<string>(&debugLib)
         , "MainSolver at specific 'solve()' points in CNF file")
     ("dumpresult", po::value(&resultFilename)
@@ -427,6 +438,8 @@ void Main::add_supported_options()
         , "Carry out probing")
     ("probemaxm", po::value(&conf.probe_bogoprops_time_limitM)->default_value(conf.probe_bogoprops_time_limitM)
       , "Time in mega-bogoprops to perform probing")
+    ("probethreads", po::value(&conf.probe_threads)->default_value(conf.probe_threads)
+        , "Number of threads used for probing. With more than 1, each thread probes its share of the literals on a read-only snapshot of the clauses, with its own time limit of probemaxm. Failed literals, equivalences and hyper-binary resolvents are added at the end. The implication cache and stamps are not updated in this mode")
     ("transred", po::value(&conf.doTransRed)->default_value(conf.doTransRed)
         , "Remove useless binary clauses (transitive reduction)")
     ("intree", po::value(&conf.doIntreeProbe)->default_value(conf.doIntreeProbe)
@@ -462,6 +475,10 @@ void Main::add_supported_options()
         , "Start first simplification after this many conflicts")
     ("confbtwsimpinc", po::value(&conf.num_conflicts_of_search_inc)->default_value(conf.num_conflicts_of_search_inc)
         , "Simp rounds increment by this power of N")
+    ("confbtwsimpincr", po::value(&conf.simplify_every_confl_incremental)->default_value(conf.simplify_every_confl_incremental)
+        , "In library mode, simplify at the start of a solve() call once this many conflicts were done since the last simplification, summed over all calls. 0 = never")
+    ("incrsimpmaxtime", po::value(&conf.simplify_incremental_max_time)->default_value(conf.simplify_incremental_max_time)
+        , "Stop such a simplification between its steps once it took this many seconds")
     ;
 
 
@@ -483,6 +500,10 @@ void Main::add_supported_options()
         , "Time-out in bogoprops M of subsumption of long clauses with long clauses, after computing occur")
     ("strstimelim", po::value(&conf.strengthening_time_limitM)->default_value(conf.strengthening_time_limitM)
         , "Time-out in bogoprops M of strengthening of long clauses with long clauses, after computing occur")
+    ("occsubstrincr", po::value(&conf.occ_sub_str_incremental)->default_value(conf.occ_sub_str_incremental)
+        , "Between occurrence-based simplification rounds, remember which long clauses were already used for subsumption and strengthening. Later rounds only use new or changed clauses, checked against the others in both directions. Useful with many incremental solve() calls")
+    ("substrthreads", po::value(&conf.sub_str_threads)->default_value(conf.sub_str_threads)
+        , "Number of threads used to find long clauses backward-subsumed or strengthened by long clauses. With more than 1, one deterministic pass is made instead of the randomised sequential ones")
     ;
 
     po::options_description bva_options("BVA options");
@@ -513,6 +534,10 @@ void Main::add_supported_options()
         , "Eliminate this ratio of free variables at most per variable elimination iteration")
     ("skipresol", po::value(&conf.skip_some_bve_resolvents)->default_value(conf.skip_some_bve_resolvents)
         , "Skip BVE resolvents in case they belong to a gate")
+    ("varelimthreads", po::value(&conf.varelim_threads)->default_value(conf.varelim_threads)
+        , "Number of threads to compute BVE resolvents with. Resolvents are calculated ahead of time for variables near the top of the heap that share no clause. Eliminates the same variables as one thread")
+    ("gatetable", po::value(&conf.varelim_gate_table)->default_value(conf.varelim_gate_table)
+        , "Before BVE, find AND/XOR/ITE definitions and make vars with the same definition equivalent. Off by default: by the first inprocessing round, most of these equivalences have usually been found already. Worth turning on together with --presimp 1 for circuits with repeated structure, e.g. miters")
     ("agrelimtimelim", po::value(&conf.aggressive_elim_time_limitM)->default_value(conf.aggressive_elim_time_limitM)
         , "Time-out in bogoprops M of aggressive(=uses reverse distillation) var-elimination")
     ;
@@ -540,6 +565,8 @@ void Main::add_supported_options()
         , "Find equivalent literals through SCC and replace them")
     ("extscc", po::value(&conf.doExtendedSCC)->default_value(conf.doExtendedSCC)
         , "Perform SCC using cache")
+    ("vreplthreads", po::value(&conf.varreplace_threads)->default_value(conf.varreplace_threads)
+        , "Number of threads to scan long clauses for replaced literals with")
     ;
 
     po::options_description gateOptions("Gate-related options");
@@ -604,7 +631,7 @@ void Main::add_supported_options()
     ("cache", po::value(&conf.doCache)->default_value(conf.doCache)
         , "Use implication cache -- may use a lot of memory")
     ("cachesize", po::value(&conf.maxCacheSizeMB)->default_value(conf.maxCacheSizeMB)
-        , "Maximum size of the implication cache in MB. It may temporarily reach higher usage, but will be deleted&disabled if this limit is reached.")
+        , "Maximum size of the implication cache in MB. When reached, the least recently used caches are evicted.")
     ("cachecutoff", po::value(&conf.cacheUpdateCutoff)->default_value(conf.cacheUpdateCutoff)
         , "If the number of literals propagated by a literal is more than this, it's not included into the implication cache")
     ;
@@ -642,7 +669,9 @@ void Main::add_supported_options()
     ("compsvar", po::value(&conf.compVarLimit)->default_value(conf.compVarLimit)
         , "Only use components in case the number of variables is below this limit")
     ("compslimit", po::value(&conf.comp_find_time_limitM)->default_value(conf.comp_find_time_limitM)
-        , "Limit how much time is spent in component-finding");
+        , "Limit how much time is spent in component-finding")
+    ("compthreads", po::value(&conf.comp_threads)->default_value(conf.comp_threads)
+        , "Number of threads solving the disconnected components with, largest component first");
 
     po::options_description distillOptions("Misc options");
     distillOptions.add_options()
@@ -653,6 +682,10 @@ void Main::add_supported_options()
         , "Maximum number of Mega-bogoprops(~time) to spend on vivifying/distilling long cls by enqueueing and propagating")
     ("distillto", po::value(&conf.distill_time_limitM)->default_value(conf.distill_time_limitM)
         , "Maximum time in bogoprops M for distillation")
+    ("vivifyred", po::value(&conf.do_vivify_red)->default_value(conf.do_vivify_red)
+        , "Between restarts, vivify the best tier 0 and 1 learnt clauses (instead of distilling tier 0 only)")
+    ("vivifyredmaxm", po::value(&conf.vivify_red_time_limitM)->default_value(conf.vivify_red_time_limitM)
+        , "Maximum number of Mega-bogoprops to spend on one round of learnt clause vivification")
     ;
 
     po::options_description miscOptions("Misc options");
@@ -666,6 +699,14 @@ void Main::add_supported_options()
         , "Save memory by deallocating variable space after renumbering. Only works if renumbering is active.")
     ("fullwatchconseveryn", po::value(&conf.full_watch_consolidate_every_n_confl)->default_value(conf.full_watch_consolidate_every_n_confl)
         , "Consolidate watchlists fully once every N conflicts. Scheduled during simplification rounds.")
+    ("hugepages", po::value(&conf.huge_pages)->default_value(conf.huge_pages)
+        , "Back the clause arena (and watch slabs) with 0 = malloc, 1 = mmap with transparent huge pages, 2 = explicit huge pages, falling back to 1")
+    ("watchpool", po::value(&conf.watch_pool)->default_value(conf.watch_pool)
+        , "Allocate watchlists from per-solver slabs of memory")
+    ("numa", po::value(&conf.numa_first_touch)->default_value(conf.numa_first_touch)
+        , "With multiple threads, bind each thread to a NUMA node, so its solver's memory is allocated there")
+    ("membudget", po::value(&conf.mem_budget_MB)->default_value(conf.mem_budget_MB)
+        , "Memory budget in MB per solver thread (0 = none). When over it, the solver sheds in order: learnt clauses, implication cache, stamps, Gauss matrices, occurrence-list limits")
 
     ("implicitmanip", po::value(&conf.doStrSubImplicit)->default_value(conf.doStrSubImplicit)
         , "Subsume and strengthen implicit clauses with each other")
@@ -699,6 +740,12 @@ void Main::add_supported_options()
         , "Put DRAT verification information into this file")
     ("savedstate", po::value(&conf.saved_state_file)->default_value(conf.saved_state_file)
         , "The file to save the saved state of the solver")
+    ("checkpoint", po::value(&conf.checkpoint_file)
+        , "Write checkpoints of the full search state to this file. Sending SIGUSR1 also writes one")
+    ("checkpointevery", po::value(&conf.checkpoint_every_secs)->default_value(conf.checkpoint_every_secs)
+        , "Write a checkpoint every this many seconds of search. 0 = only on SIGUSR1")
+    ("resume", po::value(&conf.resume_file)
+        , "Resume search from this checkpoint. No CNF must be given")
     ("maxsccdepth", po::value(&conf.max_scc_depth)->default_value(conf.max_scc_depth)
         , "The maximum for scc search depth")
     ("simdrat", po::value(&conf.simulate_drat)->default_value(conf.simulate_drat)
@@ -1014,16 +1061,38 @@ void Main::manually_parse_some_options()
         exit(-1);
     }
 
+    //Ctrl+C must stop cleanly so the last checkpoint gets written
+    if (!conf.checkpoint_file.empty()) {
+        need_clean_exit = 1;
+    }
+
+    if (!conf.resume_file.empty()) {
+        if (conf.preprocess != 0 || vm.count("input") || vm.count("drat")) {
+            cout << "ERROR: When resuming from a checkpoint, no input file, DRAT file or preprocessing can be given" << endl;
+            exit(-1);
+        }
+        if (num_threads > 1) {
+            cout << "ERROR: Resuming from a checkpoint only works with a single thread" << endl;
+            exit(-1);
+        }
+    }
+
     if (!decisions_for_model_fname.empty() && max_nr_of_solutions > 1) {
         std::cerr << "ERROR: dumping decisions for multi-solution makes no sense. Exiting." << endl;
         std::exit(-1);
     }
 
-    if (!decisions_for_model_fname.empty()) {
-        conf.need_decisions_reaching = true;
+    if (approx_count && (max_nr_of_solutions > 1 || !decisions_for_model_fname.empty())) {
+        std::cerr << "ERROR: approximate counting cannot be combined with multi-solutions or dumping decisions. Exiting." << endl;
+        std::exit(-1);
     }
 
-    if (max_nr_of_solutions > 1) {
+    if (approx_count && conf.do_bva) {
+        std::cerr << "ERROR: approximate counting cannot be used with BVA. Exiting." << endl;
+        std::exit(-1);
+    }
+
+    if (!decisions_for_model_fname.empty()) {
         conf.need_decisions_reaching = true;
     }
 
@@ -1307,11 +1376,16 @@ int Main::solve()
 
     //Parse in DIMACS (maybe gzipped) files
     //solver->log_to_file("mydump.cnf");
-    if (conf.preprocess != 2) {
+    if (conf.preprocess != 2 && conf.resume_file.empty()) {
         parseInAllFiles(solver);
     }
 
-    lbool ret = multi_solutions();
+    lbool ret;
+    if (approx_count) {
+        ret = approx_count_solutions();
+    } else {
+        ret = multi_solutions();
+    }
 
     if (conf.preprocess != 1) {
         if (ret == l_Undef && conf.verbosity) {
@@ -1367,20 +1441,23 @@ void Main::dump_decisions_for_model()
 
 lbool Main::multi_solutions()
 {
-    unsigned long current_nr_of_solutions = 0;
-    lbool ret = l_True;
-    while(current_nr_of_solutions < max_nr_of_solutions && ret == l_True) {
-        ret = solver->solve(NULL, only_indep_solution);
-        current_nr_of_solutions++;
+    if (max_nr_of_solutions == 1) {
+        const lbool ret = solver->solve(NULL, only_indep_solution);
         if (ret == l_True && !decisions_for_model_fname.empty()) {
             dump_decisions_for_model();
-            assert(max_nr_of_solutions == 1);
         }
+        return ret;
+    }
 
-        if (ret == l_True && current_nr_of_solutions < max_nr_of_solutions) {
-            printResultFunc(&cout, false, ret);
+    unsigned long current_nr_of_solutions = 0;
+    auto print_solution = [&](const vector<lbool>& /*model*/) -> bool {
+        current_nr_of_solutions++;
+
+        //The last one is printed as the final result
+        if (current_nr_of_solutions < max_nr_of_solutions) {
+            printResultFunc(&cout, false, l_True);
             if (resultfile) {
-                printResultFunc(resultfile, true, ret);
+                printResultFunc(resultfile, true, l_True);
             }
 
             if (conf.verbosity) {
@@ -1392,32 +1469,35 @@ lbool Main::multi_solutions()
             #ifdef VERBOSE_DEBUG_RECONSTRUCT
             solver->print_removed_vars();
             #endif
-
-            //Banning found solution
-            vector<Lit> lits;
-            if (independent_vars.empty()) {
-                if (solver->get_decision_reaching_valid()) {
-                    //only decision vars
-                    for (Lit lit: solver->get_decisions_reaching_model()) {
-                      lits.push_back(~lit);
-                    }
-                } else {
-                    //all of the solution
-                    for (uint32_t var = 0; var < solver->nVars(); var++) {
-                        if (solver->get_model()[var] != l_Undef) {
-                            lits.push_back( Lit(var, (solver->get_model()[var] == l_True)? true : false) );
-                        }
-                    }
-                }
-            } else {
-              for (const uint32_t var: independent_vars) {
-                  if (solver->get_model()[var] != l_Undef) {
-                      lits.push_back( Lit(var, (solver->get_model()[var] == l_True)? true : false) );
-                  }
-              }
-            }
-            solver->add_clause(lits);
         }
+        return true;
+    };
+
+    //Solutions differ on the independent vars if they are set. Otherwise
+    //only the decisions that led to the solution get banned
+    return solver->enumerate_solutions(
+        print_solution
+        , max_nr_of_solutions
+        , NULL //no assumptions
+        , NULL //independent vars, or all vars
+        , only_indep_solution
+        , true //ban decisions
+    );
+}
+
+lbool Main::approx_count_solutions()
+{
+    ApproxCount count;
+    const lbool ret = solver->approx_count(
+        count
+        , approx_epsilon
+        , approx_delta
+        , conf.origSeed
+    );
+    if (ret == l_True) {
+        cout << "c Number of solutions is: "
+        << count.cell_count << "*2^" << count.hash_count
+        << endl;
     }
     return ret;
 }
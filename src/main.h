@@ -102,6 +102,7 @@ class Main
         void printVersionInfo();
         int correctReturnValue(const lbool ret) const;
         lbool multi_solutions();
+        lbool approx_count_solutions();
         void dump_red_file();
 
         //Config
@@ -112,6 +113,9 @@ class Main
         string commandLine;
         unsigned num_threads = 1;
         uint32_t max_nr_of_solutions = 1;
+        bool approx_count = false;
+        double approx_epsilon = 0.8;
+        double approx_delta = 0.2;
         int sql = 0;
         string sqlite_filename;
         string decisions_for_model_fname;
@@ -33,6 +33,8 @@ THE SOFTWARE.
 #include <limits>
 #include <cmath>
 #include <functional>
+#include <thread>
+#include <atomic>
 
 
 #include "popcnt.h"
@@ -98,6 +100,7 @@ OccSimplifier::OccSimplifier(Solver* _solver):
     , blockedMapBuilt(false)
 {
     bva = new BVA(solver, this);
+    gate_table = new GateTable(solver);
     topLevelGauss = new TopLevelGaussAbst;
     #ifdef USE_M4RI
     delete topLevelGauss;
@@ -114,6 +117,7 @@ OccSimplifier::OccSimplifier(Solver* _solver):
 OccSimplifier::~OccSimplifier()
 {
     delete bva;
+    delete gate_table;
     delete topLevelGauss;
     delete sub_str;
     //delete gateFinder;
@@ -145,6 +149,19 @@ void OccSimplifier::save_on_var_memory()
 
     elim_calc_need_update.shrink_to_fit();
     blockedClauses.shrink_to_fit();;
+
+    velim_scratch.clear();
+    velim_scratch.shrink_to_fit();
+    velim_spec.clear();
+    velim_spec.shrink_to_fit();
+    velim_spec_free.clear();
+    velim_spec_free.shrink_to_fit();
+    velim_spec_at.clear();
+    velim_spec_at.shrink_to_fit();
+    velim_occs_now.clear();
+    velim_occs_now.shrink_to_fit();
+    velim_batch_blocked.clear();
+    velim_batch_blocked.shrink_to_fit();
 }
 
 void OccSimplifier::print_blocked_clauses_reverse() const
@@ -210,6 +227,24 @@ uint32_t OccSimplifier::dump_blocked_clauses(std::ostream* outfile) const
     return num_cls;
 }
 
+void OccSimplifier::get_blocked_clauses(ClauseBuffer& out) const
+{
+    for (const BlockedClauses& blocked: blockedClauses) {
+        if (blocked.toRemove)
+            continue;
+
+        //The first literal is the one it's blocked on
+        for (size_t i = 1; i < blocked.size(); i++) {
+            const Lit l = blocked.at(i, blkcls);
+            if (l == lit_Undef) {
+                out.offsets.push_back(out.lits.size());
+            } else {
+                out.lits.push_back(l);
+            }
+        }
+    }
+}
+
 void OccSimplifier::extend_model(SolutionExtender* extender)
 {
     //Either a variable is not eliminated, or its value is undef
@@ -562,6 +597,7 @@ OccSimplifier::LinkInData OccSimplifier::link_in_clauses(
             << " link_in_lit_limit: " << link_in_lit_limit << endl;*/
             //assert(cl->red());
             cl->setOccurLinked(false);
+            cl->set_occur_sub_str_done(false);
             link_in_data.cl_not_linked++;
             std::sort(cl->begin(), cl->end());
         }
@@ -771,6 +807,7 @@ bool OccSimplifier::can_eliminate_var(const uint32_t var) const
     if (solver->value(var) != l_Undef
         || solver->varData[var].removed != Removed::none
         || solver->var_inside_assumptions(var)
+        || solver->var_frozen(var)
         || (solver->conf.independent_vars && indep_vars[var])
         //|| (!solver->conf.allow_elim_xor_vars && solver->varData[var].added_for_xor)
     ) {
@@ -981,6 +1018,7 @@ bool OccSimplifier::eliminate_vars()
     assert(solver->watches.get_smudged_list().empty());
     bvestats.clear();
     bvestats.numCalls = 1;
+    setup_velim_scratch(std::max(1U, solver->conf.varelim_threads));
 
     //Go through the ordered list of variables to eliminate
     int64_t last_elimed = 1;
@@ -1009,6 +1047,12 @@ bool OccSimplifier::eliminate_vars()
 //     }
     //
 
+    if (solver->conf.varelim_gate_table
+        && !add_gate_equivalences()
+    ) {
+        goto end;
+    }
+
     if (!prop_and_clean_long_and_impl_clauses()) {
         goto end;
     }
@@ -1194,6 +1238,11 @@ bool OccSimplifier::eliminate_vars()
 
 end:
     free_clauses_to_free();
+    for(const VarElimScratch& s: velim_scratch) {
+        bvestats.gatesAnd += s.gates_and;
+        bvestats.gatesXor += s.gates_xor;
+        bvestats.gatesIte += s.gates_ite;
+    }
     const double time_used = cpuTime() - myTime;
     const bool time_out = (*limit_to_decrease <= 0);
     const double time_remain = float_div(*limit_to_decrease, orig_norm_varelim_time_limit);
@@ -1201,7 +1250,15 @@ end:
     if (solver->conf.verbosity) {
         cout
         << "c  #try to eliminate: "; print_value_kilo_mega(wenThrough); cout << endl
-        << "c  #var-elim        : "; print_value_kilo_mega(vars_elimed); cout << endl
+        << "c  #var-elim        : "; print_value_kilo_mega(vars_elimed); cout << endl;
+        if (bvestats.parBatches > 0) {
+            cout
+            << "c  #par-batches     : "; print_value_kilo_mega(bvestats.parBatches); cout << endl
+            << "c  #par-avg-batch   : " << std::setprecision(1)
+            << float_div(bvestats.parBatchVars, bvestats.parBatches) << endl
+            << "c  #par-used        : "; print_value_kilo_mega(bvestats.parUsed); cout << endl;
+        }
+        cout
         << "c  #T-o: " << (time_out ? "Y" : "N") << endl
         << "c  #T-r: " << std::fixed << std::setprecision(2) << (time_remain*100.0) << "%" << endl
         << "c  #T  : " << time_used << endl;
@@ -1231,6 +1288,60 @@ end:
     return solver->okay();
 }
 
+//Vars with the same definition are equivalent, BVE will then get rid of one
+//of the two. With DRAT, only AND definitions are used: their binaries are RUP
+bool OccSimplifier::add_gate_equivalences()
+{
+    int64_t gate_time_limit = norm_varelim_time_limit/10;
+    const int64_t orig_limit = gate_time_limit;
+    gate_table->build(velim_scratch[0].seen, &gate_time_limit);
+    norm_varelim_time_limit -= orig_limit - gate_time_limit;
+
+    size_t added = 0;
+    for(const std::pair<Lit, Lit>& eq: gate_table->get_equivs()) {
+        for(uint32_t i = 0; i < 2 && solver->okay(); i++) {
+            const Lit a = i ? ~eq.first : eq.first;
+            const Lit b = i ? eq.second : ~eq.second;
+            if (solver->value(a) != l_Undef
+                || solver->value(b) != l_Undef
+                || solver->varData[a.var()].removed != Removed::none
+                || solver->varData[b.var()].removed != Removed::none
+            ) {
+                continue;
+            }
+
+            tmp_bin_cl.resize(2);
+            tmp_bin_cl[0] = a;
+            tmp_bin_cl[1] = b;
+            solver->add_clause_int(tmp_bin_cl, false, ClauseStats(), false, &tmp_bin_cl);
+            if (!solver->okay()) {
+                return false;
+            }
+            if (tmp_bin_cl.size() != 2) {
+                continue;
+            }
+
+            added++;
+            added_bin_cl.push_back(std::make_pair(tmp_bin_cl[0], tmp_bin_cl[1]));
+            for(const Lit l: tmp_bin_cl) {
+                n_occurs[l.toInt()]++;
+                elim_calc_need_update.touch(l.var());
+                added_cl_to_var.touch(l.var());
+            }
+            varelim_linkin_limit_bytes -= 2*8;
+        }
+    }
+
+    if (solver->conf.verbosity) {
+        cout
+        << "c [occ-gate-table] equivalences added: " << added/2
+        << endl;
+    }
+    tmp_bin_cl.resize(2);
+
+    return solver->okay();
+}
+
 void OccSimplifier::free_clauses_to_free()
 {
     for(ClOffset off: cl_to_free_later) {
@@ -1520,15 +1631,27 @@ bool OccSimplifier::backward_sub_str()
         goto end;
     }
 
-    sub_str->backw_sub_long_with_long();
-    if (solver->must_interrupt_asap())
-        goto end;
+    if (solver->conf.sub_str_threads > 1) {
+        //One combined pass, it gets both budgets
+        strengthening_time_limit += std::max<int64_t>(0, subsumption_time_limit);
+        subsumption_time_limit = 0;
+        limit_to_decrease = &strengthening_time_limit;
+        if (!sub_str->backw_sub_str_long_with_long_par(solver->conf.sub_str_threads)
+            || solver->must_interrupt_asap()
+        ) {
+            goto end;
+        }
+    } else {
+        sub_str->backw_sub_long_with_long();
+        if (solver->must_interrupt_asap())
+            goto end;
 
-    limit_to_decrease = &strengthening_time_limit;
-    if (!sub_str->backw_str_long_with_long()
-        || solver->must_interrupt_asap()
-    ) {
-        goto end;
+        limit_to_decrease = &strengthening_time_limit;
+        if (!sub_str->backw_str_long_with_long()
+            || solver->must_interrupt_asap()
+        ) {
+            goto end;
+        }
     }
 
     if (!deal_with_added_long_and_bin(true)
@@ -1545,6 +1668,19 @@ bool OccSimplifier::backward_sub_str()
     return solver->okay();
 }
 
+/**
+@brief Links the long clauses into the watch lists as occurrence lists
+
+This is redone on every call: the occurrence lists share the watch lists
+with search, which only watches two literals of each clause. What carries
+over between calls is the per-clause occur_sub_str_done bit, see
+--occsubstrincr
+
+Lists kept in a structure of their own would not be cheaper to keep: the
+schedules consolidate the clauses after every occ round, and renumber the
+variables once enough were removed. All offsets and literals in them would
+then have to be remapped, which is about as much work as this link-in.
+*/
 bool OccSimplifier::fill_occur()
 {
     //Calculate binary clauses' contribution to n_occurs
@@ -2049,84 +2185,77 @@ void OccSimplifier::add_clause_to_blck(const vector<Lit>& lits)
     blockedClauses.back().end = blkcls.size();
 }
 
-void OccSimplifier::find_gate(
-    Lit elim_lit
-    , watch_subarray_const a
-    , watch_subarray_const b
+void OccSimplifier::mark_gate_in_poss_negs(
+    VarElimScratch& s
+    , const uint32_t var
 ) {
-    assert(toClear.empty());
-    for(const Watched w: a) {
-        if (w.isBin() && !w.red()) {
-            seen[(~w.lit2()).toInt()] = 1;
-            toClear.push_back(~w.lit2());
-        }
+    //Finding ONE definition is enough, we don't look for the best one
+    s.gate_found = gate_table->find_def(
+        var, s.gate_def, s.gate_scratch, s.seen, s.limit);
+    if (!s.gate_found) {
+        return;
     }
 
-    //Have to find the corresponding gate. Finding one is good enough
-    for(const Watched w: b) {
-        if (w.isBin()) {
-            continue;
-        }
-
-        if (w.isClause()) {
-            Clause* cl = solver->cl_alloc.ptr(w.get_offset());
-            if (cl->getRemoved()) {
-                continue;
-            }
-
-            assert(cl->size() > 2);
-            if (!cl->red()) {
-                bool OK = true;
-                for(const Lit lit: *cl) {
-                    if (lit != ~elim_lit) {
-                        if (!seen[lit.toInt()]) {
-                            OK = false;
-                            break;
-                        }
-                    }
-                }
-
-                //Found all lits inside
-                if (OK) {
-                    cl->stats.marked_clause = true;
-                    gate_varelim_clause = cl;
-                    break;
-                }
-            }
-        }
+    for(const ClOffset offs: s.gate_def.cls) {
+        solver->cl_alloc.ptr(offs)->stats.marked_clause = true;
+    }
+    switch(s.gate_def.type) {
+        case GateType::and_gate:
+            s.gates_and++;
+            break;
+        case GateType::xor_gate:
+            s.gates_xor++;
+            break;
+        case GateType::ite_gate:
+            s.gates_ite++;
+            break;
+        default:
+            assert(false);
     }
 
-    for(Lit l: toClear) {
-        seen[l.toInt()] = 0;
+    if (solver->conf.verbosity >= 10) {
+        cout
+        << "Var: " << var + 1
+        << " gate type: " << (int)s.gate_def.type
+        << " out: " << s.gate_def.out
+        << " inputs: " << s.gate_def.inputs
+        << endl;
     }
-    toClear.clear();
 }
 
-void OccSimplifier::mark_gate_in_poss_negs(
-    Lit elim_lit
-    , watch_subarray_const poss
-    , watch_subarray_const negs
-) {
-    //Either of the two is OK. Let's just find ONE, not the biggest one.
-    //We could find the biggest one, but it's expensive.
-    bool found_pos = false;
-    gate_varelim_clause = NULL;
-    find_gate(elim_lit, poss, negs);
-    if (gate_varelim_clause == NULL) {
-        find_gate(~elim_lit, negs, poss);
-        found_pos = true;
+void OccSimplifier::unmark_gate(VarElimScratch& s)
+{
+    if (!s.gate_found) {
+        return;
     }
 
-    if (gate_varelim_clause != NULL && solver->conf.verbosity >= 10) {
-        cout
-        << "Lit: " << elim_lit
-        << " gate_found_elim_pos:" << found_pos
-        << endl;
+    for(const ClOffset offs: s.gate_def.cls) {
+        solver->cl_alloc.ptr(offs)->stats.marked_clause = false;
     }
+    s.gate_found = false;
 }
 
-int OccSimplifier::test_elim_and_fill_resolvents(const uint32_t var)
-{
+//w is in the occurrence list of lit. Binaries are only part of AND
+//definitions, and are not marked, so they are looked up
+bool OccSimplifier::in_gate(
+    const VarElimScratch& s
+    , const Watched& w
+    , const Clause* cl
+    , const Lit lit
+) const {
+    if (w.isBin()) {
+        const std::pair<Lit, Lit> bin(lit, w.lit2());
+        return std::find(s.gate_def.bins.begin(), s.gate_def.bins.end(), bin)
+            != s.gate_def.bins.end();
+    }
+    return cl->stats.marked_clause;
+}
+
+int OccSimplifier::test_elim_and_fill_resolvents(
+    const uint32_t var
+    , VarElimScratch& s
+) {
+    int64_t* limit = s.limit;
     assert(solver->ok);
     assert(solver->varData[var].removed == Removed::none);
     assert(solver->value(var) == l_Undef);
@@ -2150,17 +2279,13 @@ int OccSimplifier::test_elim_and_fill_resolvents(const uint32_t var)
     const uint32_t neg = n_occurs[Lit(var, true).toInt()];
 
     //Heuristic calculation took too much time
-    if (*limit_to_decrease < 0) {
+    if (*limit < 0) {
         return std::numeric_limits<int>::max();
     }
 
     //set-up
     const Lit lit = Lit(var, false);
-    watch_subarray poss = solver->watches[lit];
-    watch_subarray negs = solver->watches[~lit];
-    std::sort(poss.begin(), poss.end(), watch_sort_smallest_first());
-    std::sort(negs.begin(), negs.end(), watch_sort_smallest_first());
-    resolvents.clear();
+    s.resolvents.clear();
 
     //Pure literal, no resolvents
     //we look at "pos" and "neg" (and not poss&negs) because we don't care about redundant clauses
@@ -2175,45 +2300,50 @@ int OccSimplifier::test_elim_and_fill_resolvents(const uint32_t var)
         return std::numeric_limits<int>::max();
     }
 
-    gate_varelim_clause = NULL;
+    s.gate_found = false;
     if (solver->conf.skip_some_bve_resolvents) {
-        mark_gate_in_poss_negs(lit, poss, negs);
+        mark_gate_in_poss_negs(s, var);
     }
 
+    //Binaries first, they are the cheapest to resolve. The occurrence lists
+    //themselves are left as they are, parallel BVE relies on this
+    fill_bins_first(solver->watches[lit], s.poss);
+    fill_bins_first(solver->watches[~lit], s.negs);
+
     // Count clauses/literals after elimination
     uint32_t before_clauses = pos + neg;
     uint32_t after_clauses = 0;
 
     size_t at_poss = 0;
-    for (const Watched* it = poss.begin(), *end = poss.end()
+    for (const Watched* it = s.poss.data(), *end = it + s.poss.size()
         ; it != end
         ; ++it, at_poss++
     ) {
-        *limit_to_decrease -= 3;
+        *limit -= 3;
         if (solver->redundant_or_removed(*it))
             continue;
 
         size_t at_negs = 0;
-        for (const Watched *it2 = negs.begin(), *end2 = negs.end()
+        for (const Watched *it2 = s.negs.data(), *end2 = it2 + s.negs.size()
             ; it2 != end2
             ; it2++, at_negs++
         ) {
-            *limit_to_decrease -= 3;
+            *limit -= 3;
             if (solver->redundant_or_removed(*it2))
                 continue;
 
             //Resolve the two clauses
-            bool tautological = resolve_clauses(*it, *it2, lit);
+            bool tautological = resolve_clauses(s, *it, *it2, lit);
             if (tautological) {
                 continue;
             }
 
-            if (solver->satisfied_cl(dummy)) {
+            if (solver->satisfied_cl(s.dummy)) {
                 continue;
             }
 
             #ifdef VERBOSE_DEBUG_VARELIM
-            cout << "Adding new clause due to varelim: " << dummy << endl;
+            cout << "Adding new clause due to varelim: " << s.dummy << endl;
             #endif
 
             after_clauses++;
@@ -2221,14 +2351,12 @@ int OccSimplifier::test_elim_and_fill_resolvents(const uint32_t var)
             if (after_clauses > (before_clauses + grow)
                 //Too long resolvent
                 || (solver->conf.velim_resolvent_too_large != -1
-                    && ((int)dummy.size() > solver->conf.velim_resolvent_too_large))
+                    && ((int)s.dummy.size() > solver->conf.velim_resolvent_too_large))
                 //Over-time
-                || *limit_to_decrease < -10LL*1000LL
+                || *limit < -10LL*1000LL
 
             ) {
-                if (gate_varelim_clause) {
-                    gate_varelim_clause->stats.marked_clause = false;
-                }
+                unmark_gate(s);
                 return std::numeric_limits<int>::max();
             }
 
@@ -2254,17 +2382,32 @@ int OccSimplifier::test_elim_and_fill_resolvents(const uint32_t var)
             #endif
             //must clear marking that has been set due to gate
             stats.marked_clause = 0;
-            resolvents.add_resolvent(dummy, stats, is_xor);
+            s.resolvents.add_resolvent(s.dummy, stats, is_xor);
         }
     }
 
-    if (gate_varelim_clause) {
-        gate_varelim_clause->stats.marked_clause = false;
-    }
+    unmark_gate(s);
 
     return -1;
 }
 
+void OccSimplifier::fill_bins_first(
+    watch_subarray_const ws
+    , vector<Watched>& out
+) const {
+    out.clear();
+    for(const Watched& w: ws) {
+        if (!w.isClause()) {
+            out.push_back(w);
+        }
+    }
+    for(const Watched& w: ws) {
+        if (w.isClause()) {
+            out.push_back(w);
+        }
+    }
+}
+
 void OccSimplifier::printOccur(const Lit lit) const
 {
     for(size_t i = 0; i < solver->watches[lit].size(); i++) {
@@ -2451,16 +2594,34 @@ bool OccSimplifier::maybe_eliminate(const uint32_t var)
     assert(solver->ok);
     print_var_elim_complexity_stats(var);
     bvestats.testedToElimVars++;
-    const Lit lit = Lit(var, false);
 
     //Heuristic says no, or we ran out of time
-    if (test_elim_and_fill_resolvents(var) > 0
+    int ret = 0;
+    Resolvents* res = NULL;
+    if (velim_scratch.size() > 1
+        && velim_worth_speculating(var)
+    ) {
+        res = get_speculated_resolvents(var, ret);
+    }
+    if (res == NULL) {
+        VarElimScratch& s = velim_scratch[0];
+        s.limit = limit_to_decrease;
+        ret = test_elim_and_fill_resolvents(var, s);
+        res = &s.resolvents;
+    }
+    if (ret > 0
         || *limit_to_decrease < 0
     ) {
         return false;  //didn't eliminate :(
     }
-    bvestats.triedToElimVars++;
 
+    return elim_var_by_resolvents(var, *res);
+}
+
+bool OccSimplifier::elim_var_by_resolvents(const uint32_t var, Resolvents& res)
+{
+    bvestats.triedToElimVars++;
+    const Lit lit = Lit(var, false);
     print_var_eliminate_stat(lit);
 
     //Remove clauses
@@ -2469,13 +2630,13 @@ bool OccSimplifier::maybe_eliminate(const uint32_t var)
     rem_cls_from_watch_due_to_varelim(solver->watches[~lit], ~lit);
 
     //Add resolvents
-    while(!resolvents.empty()) {
-        if (!add_varelim_resolvent(resolvents.back_lits(),
-            resolvents.back_stats(), resolvents.back_xor())
+    while(!res.empty()) {
+        if (!add_varelim_resolvent(res.back_lits(),
+            res.back_stats(), res.back_xor())
         ) {
             goto end;
         }
-        resolvents.pop();
+        res.pop();
     }
     limit_to_decrease = &norm_varelim_time_limit;
 
@@ -2485,61 +2646,313 @@ end:
     return true; //eliminated!
 }
 
+void OccSimplifier::setup_velim_scratch(const size_t num)
+{
+    velim_scratch.resize(num);
+    for(VarElimScratch& s: velim_scratch) {
+        s.seen.resize(solver->nVars()*2, 0);
+        s.limit = limit_to_decrease;
+        s.gates_and = 0;
+        s.gates_xor = 0;
+        s.gates_ite = 0;
+    }
+    if (num > 1) {
+        velim_batch_blocked.resize(solver->nVars(), 0);
+        velim_spec_at.clear();
+        velim_spec_at.resize(solver->nVars(), std::numeric_limits<uint32_t>::max());
+        velim_spec_free.clear();
+        for(uint32_t i = 0; i < velim_spec.size(); i++) {
+            velim_spec[i].var = var_Undef;
+            velim_spec_free.push_back(i);
+        }
+    }
+}
+
+//A variable can only be in the same batch as another if no clause contains
+//both. Then testing one does not read what testing the other marks.
+bool OccSimplifier::velim_batch_var_independent(const uint32_t var)
+{
+    if (velim_batch_blocked[var]) {
+        return false;
+    }
+
+    const auto block = [&](const uint32_t v) {
+        if (!velim_batch_blocked[v]) {
+            velim_batch_blocked[v] = 1;
+            velim_batch_blocked_vars.push_back(v);
+        }
+    };
+
+    block(var);
+    for(const Lit lit: {Lit(var, false), Lit(var, true)}) {
+        for(const Watched& w: solver->watches[lit]) {
+            if (w.isBin()) {
+                block(w.lit2().var());
+                continue;
+            }
+
+            assert(w.isClause());
+            const Clause& cl = *solver->cl_alloc.ptr(w.get_offset());
+            if (cl.getRemoved() || cl.freed()) {
+                continue;
+            }
+            for(const Lit l: cl) {
+                block(l.var());
+            }
+        }
+    }
+
+    return true;
+}
+
+void OccSimplifier::free_velim_spec(const uint32_t at)
+{
+    VelimSpec& sp = velim_spec[at];
+    assert(sp.var != var_Undef);
+    velim_spec_at[sp.var] = std::numeric_limits<uint32_t>::max();
+    sp.var = var_Undef;
+    velim_spec_free.push_back(at);
+}
+
+void OccSimplifier::free_all_velim_spec()
+{
+    for(uint32_t i = 0; i < velim_spec.size(); i++) {
+        if (velim_spec[i].var != var_Undef) {
+            free_velim_spec(i);
+        }
+    }
+}
+
+void OccSimplifier::add_to_velim_batch(const uint32_t var)
+{
+    uint32_t at;
+    if (velim_spec_free.empty()) {
+        at = velim_spec.size();
+        velim_spec.push_back(VelimSpec());
+    } else {
+        at = velim_spec_free.back();
+        velim_spec_free.pop_back();
+    }
+    velim_spec[at].var = var;
+    velim_spec_at[var] = at;
+    velim_batch.push_back(var);
+}
+
+//The batch is "var" and the independent ones of those that come out of the
+//heap next. These are found by walking the heap from its root, smallest
+//first. The heap itself is not changed, so the order of elimination stays
+//that of the sequential code. Results not used yet are kept for later.
+void OccSimplifier::fill_velim_batch(const uint32_t var)
+{
+    const size_t max_batch = 8*velim_scratch.size();
+    if (velim_spec.size() - velim_spec_free.size() > 8*max_batch) {
+        free_all_velim_spec();
+    }
+
+    velim_batch.clear();
+    velim_batch_var_independent(var);
+    add_to_velim_batch(var);
+
+    typedef std::pair<uint64_t, uint32_t> Cand;
+    const auto push = [&](const uint32_t at) {
+        if (at < (uint32_t)velim_order.size()) {
+            velim_batch_cand.push_back(Cand(varElimComplexity[velim_order[at]], at));
+            std::push_heap(velim_batch_cand.begin(), velim_batch_cand.end(), std::greater<Cand>());
+        }
+    };
+    velim_batch_cand.clear();
+    push(0);
+    for(size_t looked = 0
+        ; !velim_batch_cand.empty()
+            && looked < 4*max_batch
+            && velim_batch.size() < max_batch
+        ; looked++
+    ) {
+        std::pop_heap(velim_batch_cand.begin(), velim_batch_cand.end(), std::greater<Cand>());
+        const uint32_t at = velim_batch_cand.back().second;
+        velim_batch_cand.pop_back();
+        push(2*at+1);
+        push(2*at+2);
+
+        const uint32_t v = velim_order[at];
+        if (velim_spec_at[v] == std::numeric_limits<uint32_t>::max()
+            && can_eliminate_var(v)
+            && velim_worth_speculating(v)
+            && velim_batch_var_independent(v)
+        ) {
+            add_to_velim_batch(v);
+        }
+    }
+
+    for(const uint32_t v: velim_batch_blocked_vars) {
+        velim_batch_blocked[v] = 0;
+    }
+    velim_batch_blocked_vars.clear();
+}
+
+void OccSimplifier::test_elim_batch_parallel()
+{
+    const size_t num_threads = std::min(velim_scratch.size(), velim_batch.size());
+
+    //Every worker gets what remains of the budget. What each calculation
+    //costs is only charged when its result is used
+    std::atomic<size_t> at(0);
+    const auto worker = [&](const size_t thread_num) {
+        VarElimScratch& sc = velim_scratch[thread_num];
+        size_t i;
+        while((i = at.fetch_add(1)) < velim_batch.size()) {
+            const uint32_t var = velim_batch[i];
+            VelimSpec& sp = velim_spec[velim_spec_at[var]];
+            sc.own_limit = *limit_to_decrease;
+            sc.limit = &sc.own_limit;
+            sp.ret = test_elim_and_fill_resolvents(var, sc);
+            sp.cost = *limit_to_decrease - sc.own_limit;
+            sp.grow = grow;
+            velim_occ_snapshot(var, sp.occs);
+            std::swap(sp.res, sc.resolvents);
+        }
+    };
+
+    std::vector<std::thread> thds;
+    for(size_t i = 1; i < num_threads; i++) {
+        thds.push_back(std::thread(worker, i));
+    }
+    worker(0);
+    for(std::thread& thread : thds) {
+        thread.join();
+    }
+    velim_scratch[0].limit = limit_to_decrease;
+
+    bvestats.parBatches++;
+    bvestats.parBatchVars += velim_batch.size();
+}
+
+//Everything test_elim_and_fill_resolvents() looks at, in order. The encoding
+//can be decoded unambiguously, so two snapshots are equal only if the
+//occurrence lists are
+void OccSimplifier::velim_occ_snapshot(
+    const uint32_t var
+    , vector<uint64_t>& out
+) const {
+    const auto lit_val = [&](const Lit l) {
+        return ((uint64_t)l.toInt() << 2) | solver->value(l).getValue();
+    };
+
+    out.clear();
+    for(const Lit lit: {Lit(var, false), Lit(var, true)}) {
+        out.push_back(n_occurs[lit.toInt()]);
+        for(const Watched& w: solver->watches[lit]) {
+            //Lowest bit 0: binary, 1: long clause followed by its size and lits
+            if (w.isBin()) {
+                out.push_back((lit_val(w.lit2()) << 2) | ((uint64_t)w.red() << 1));
+                continue;
+            }
+            if (!w.isClause()) {
+                continue;
+            }
+
+            const Clause& cl = *solver->cl_alloc.ptr(w.get_offset());
+            if (cl.getRemoved() || cl.freed() || cl.red()) {
+                continue;
+            }
+            out.push_back(((uint64_t)w.get_offset() << 1) | 1);
+            out.push_back(cl.size());
+            for(const Lit l: cl) {
+                out.push_back(lit_val(l));
+            }
+        }
+        //Neither a binary nor a long clause can encode to this
+        out.push_back(std::numeric_limits<uint64_t>::max());
+    }
+}
+
+//A result calculated ahead of time is the same as what the sequential code
+//would get now if the occurrence lists are the same and the time limit would
+//not have run out meanwhile. Returns NULL if it has to be recalculated.
+OccSimplifier::Resolvents* OccSimplifier::get_speculated_resolvents(
+    const uint32_t var
+    , int& ret
+) {
+    uint32_t at = velim_spec_at[var];
+    if (at == std::numeric_limits<uint32_t>::max()) {
+        fill_velim_batch(var);
+        test_elim_batch_parallel();
+        at = velim_spec_at[var];
+    }
+    free_velim_spec(at);
+
+    VelimSpec& sp = velim_spec[at];
+    if (sp.grow != grow || sp.cost > *limit_to_decrease) {
+        return NULL;
+    }
+    velim_occ_snapshot(var, velim_occs_now);
+    if (sp.occs == velim_occs_now) {
+        *limit_to_decrease -= sp.cost;
+        ret = sp.ret;
+        bvestats.parUsed++;
+        return &sp.res;
+    }
+
+    return NULL;
+}
+
 void OccSimplifier::add_pos_lits_to_dummy_and_seen(
-    const Watched ps
+    VarElimScratch& s
+    , const Watched ps
     , const Lit posLit
 ) {
     if (ps.isBin()) {
-        *limit_to_decrease -= 1;
+        *s.limit -= 1;
         assert(ps.lit2() != posLit);
 
-        seen[ps.lit2().toInt()] = 1;
-        dummy.push_back(ps.lit2());
+        s.seen[ps.lit2().toInt()] = 1;
+        s.dummy.push_back(ps.lit2());
     }
 
     if (ps.isClause()) {
         Clause& cl = *solver->cl_alloc.ptr(ps.get_offset());
-        *limit_to_decrease -= (long)cl.size()/2;
+        *s.limit -= (long)cl.size()/2;
         for (const Lit lit : cl){
             if (lit != posLit) {
-                seen[lit.toInt()] = 1;
-                dummy.push_back(lit);
+                s.seen[lit.toInt()] = 1;
+                s.dummy.push_back(lit);
             }
         }
     }
 }
 
 bool OccSimplifier::add_neg_lits_to_dummy_and_seen(
-    const Watched qs
+    VarElimScratch& s
+    , const Watched qs
     , const Lit posLit
 ) {
     if (qs.isBin()) {
-        *limit_to_decrease -= 1;
+        *s.limit -= 1;
         assert(qs.lit2() != ~posLit);
 
-        if (seen[(~qs.lit2()).toInt()]) {
+        if (s.seen[(~qs.lit2()).toInt()]) {
             return true;
         }
-        if (!seen[qs.lit2().toInt()]) {
-            dummy.push_back(qs.lit2());
-            seen[qs.lit2().toInt()] = 1;
+        if (!s.seen[qs.lit2().toInt()]) {
+            s.dummy.push_back(qs.lit2());
+            s.seen[qs.lit2().toInt()] = 1;
         }
     }
 
     if (qs.isClause()) {
         Clause& cl = *solver->cl_alloc.ptr(qs.get_offset());
-        *limit_to_decrease -= (long)cl.size()/2;
+        *s.limit -= (long)cl.size()/2;
         for (const Lit lit: cl) {
             if (lit == ~posLit)
                 continue;
 
-            if (seen[(~lit).toInt()]) {
+            if (s.seen[(~lit).toInt()]) {
                 return true;
             }
 
-            if (!seen[lit.toInt()]) {
-                dummy.push_back(lit);
-                seen[lit.toInt()] = 1;
+            if (!s.seen[lit.toInt()]) {
+                s.dummy.push_back(lit);
+                s.seen[lit.toInt()] = 1;
             }
         }
     }
@@ -2548,7 +2961,8 @@ bool OccSimplifier::add_neg_lits_to_dummy_and_seen(
 }
 
 bool OccSimplifier::resolve_clauses(
-    const Watched ps
+    VarElimScratch& s
+    , const Watched ps
     , const Watched qs
     , const Lit posLit
 ) {
@@ -2568,28 +2982,24 @@ bool OccSimplifier::resolve_clauses(
             return true;
         }
     }
-    if (gate_varelim_clause
-        && cl1 && cl2
-        && !cl1->stats.marked_clause
-        && !cl2->stats.marked_clause
+    if (s.gate_found
+        && !in_gate(s, ps, cl1, posLit)
+        && !in_gate(s, qs, cl2, ~posLit)
     ) {
         //for G (U) R, we only neede to resolve to
         // (Gx * R!x) (U) (G!x * Rx)
         // So Rx * R!x is skipped
-        //
-        // Here: Both are long clauses, so only one could be in G. But neither
-        // are marked, hence neither are in G, so both are in R.
         // see:  http://baldur.iti.kit.edu/sat/files/ex04.pdf
         return true;
     }
 
-    dummy.clear();
-    add_pos_lits_to_dummy_and_seen(ps, posLit);
-    bool tautological = add_neg_lits_to_dummy_and_seen(qs, posLit);
+    s.dummy.clear();
+    add_pos_lits_to_dummy_and_seen(s, ps, posLit);
+    bool tautological = add_neg_lits_to_dummy_and_seen(s, qs, posLit);
 
-    *limit_to_decrease -= (long)dummy.size()/2 + 1;
-    for (const Lit lit: dummy) {
-        seen[lit.toInt()] = 0;
+    *s.limit -= (long)s.dummy.size()/2 + 1;
+    for (const Lit lit: s.dummy) {
+        s.seen[lit.toInt()] = 0;
     }
 
     return tautological;
@@ -2913,9 +3323,19 @@ void OccSimplifier::check_elimed_vars_are_unassignedAndStats() const
 size_t OccSimplifier::mem_used() const
 {
     size_t b = 0;
-    b += dummy.capacity()*sizeof(char);
+    for(const VarElimScratch& s: velim_scratch) {
+        b += s.seen.capacity()*sizeof(uint16_t);
+        b += s.dummy.capacity()*sizeof(Lit);
+    }
+    b += velim_batch_blocked.capacity()*sizeof(uint8_t);
+    b += velim_spec_at.capacity()*sizeof(uint32_t);
+    for(const VelimSpec& sp: velim_spec) {
+        b += sp.occs.capacity()*sizeof(uint64_t);
+    }
+    b += velim_occs_now.capacity()*sizeof(uint64_t);
     b += added_long_cl.capacity()*sizeof(ClOffset);
     b += sub_str->mem_used();
+    b += gate_table->mem_used();
     b += blockedClauses.capacity()*sizeof(BlockedClauses);
     b += blkcls.capacity()*sizeof(Lit);
     b += blk_var_to_cls.size()*sizeof(uint32_t);
@@ -3003,6 +3423,13 @@ OccSimplifier::Stats& OccSimplifier::Stats::operator+=(const Stats& other)
     finalCleanupTime += other.finalCleanupTime;
     zeroDepthAssings += other.zeroDepthAssings;
 
+    parSubStrCalls += other.parSubStrCalls;
+    parSubStrSubsumed += other.parSubStrSubsumed;
+    parSubStrLitsRem += other.parSubStrLitsRem;
+    parSubStrThreadTime += other.parSubStrThreadTime;
+    parSubStrMaxThreadTime += other.parSubStrMaxThreadTime;
+    parSubStrMergeTime += other.parSubStrMergeTime;
+
     return *this;
 }
 
@@ -3021,6 +3448,12 @@ BVEStats& BVEStats::operator+=(const BVEStats& other)
     triedToElimVars += other.triedToElimVars;
     newClauses += other.newClauses;
     subsumedByVE  += other.subsumedByVE;
+    parBatches += other.parBatches;
+    parBatchVars += other.parBatchVars;
+    parUsed += other.parUsed;
+    gatesAnd += other.gatesAnd;
+    gatesXor += other.gatesXor;
+    gatesIte += other.gatesIte;
 
     return *this;
 }
@@ -3062,6 +3495,32 @@ void OccSimplifier::Stats::print(const size_t nVars) const
         , "% vars"
     );
 
+    if (parSubStrCalls > 0) {
+        print_stats_line("c par sub-str calls"
+            , parSubStrCalls
+        );
+
+        print_stats_line("c par sub-str subsumed"
+            , parSubStrSubsumed
+        );
+
+        print_stats_line("c par sub-str lits rem"
+            , parSubStrLitsRem
+            , float_div(parSubStrLitsRem, parSubStrThreadTime)
+            , "lits/thread-s"
+        );
+
+        print_stats_line("c par sub-str thread T"
+            , parSubStrThreadTime
+            , parSubStrMaxThreadTime
+            , "s slowest thread"
+        );
+
+        print_stats_line("c par sub-str merge T"
+            , parSubStrMergeTime
+        );
+    }
+
     cout << "c -------- OccSimplifier STATS END ----------" << endl;
 }
 
@@ -3081,6 +3540,7 @@ void OccSimplifier::save_state(SimpleOutFile& f)
 }
 void OccSimplifier::load_state(SimpleInFile& f)
 {
+    blockedClauses.clear();
     const uint64_t sz = f.get_uint64_t();
     for(uint64_t i = 0; i < sz; i++) {
         BlockedClauses b;
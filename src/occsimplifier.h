@@ -41,6 +41,11 @@ THE SOFTWARE.
 #include "watched.h"
 #include "watcharray.h"
 #include "simplefile.h"
+#include "gatetable.h"
+
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
 
 namespace CMSat {
 
@@ -118,6 +123,12 @@ struct BVEStats
     uint64_t triedToElimVars = 0;
     uint64_t newClauses = 0;
     uint64_t subsumedByVE = 0;
+    uint64_t parBatches = 0;
+    uint64_t parBatchVars = 0;
+    uint64_t parUsed = 0;
+    uint64_t gatesAnd = 0;
+    uint64_t gatesXor = 0;
+    uint64_t gatesIte = 0;
 
     BVEStats& operator+=(const BVEStats& other);
 
@@ -142,6 +153,22 @@ struct BVEStats
         << " red-bin rem: " << binRedClRemThroughElim
         << " red-long rem: " << longRedClRemThroughElim
         << endl;
+
+        if (parBatches > 0) {
+            cout
+            << "c [occ-bve]"
+            << " par-batches: " << parBatches
+            << " avg-batch-sz: " << float_div(parBatchVars, parBatches)
+            << " used: " << parUsed
+            << endl;
+        }
+
+        cout
+        << "c [occ-bve]"
+        << " gate-defs and: " << gatesAnd
+        << " xor: " << gatesXor
+        << " ite: " << gatesIte
+        << endl;
     }
 
     void print()
@@ -225,6 +252,7 @@ public:
     size_t mem_used_bva() const;
     void print_gatefinder_stats() const;
     uint32_t dump_blocked_clauses(std::ostream* outfile) const;
+    void get_blocked_clauses(ClauseBuffer& out) const;
 
     //UnElimination
     void print_blocked_clauses_reverse() const;
@@ -252,6 +280,14 @@ public:
 
         //General stat
         uint64_t zeroDepthAssings = 0;
+
+        //Parallel backward subsumption and strengthening
+        uint64_t parSubStrCalls = 0;
+        uint64_t parSubStrSubsumed = 0;
+        uint64_t parSubStrLitsRem = 0;
+        double parSubStrThreadTime = 0; ///<Summed over all threads
+        double parSubStrMaxThreadTime = 0; ///<Slowest thread of each call
+        double parSubStrMergeTime = 0;
     };
 
     BVEStats bvestats;
@@ -259,6 +295,7 @@ public:
 
     const Stats& get_stats() const;
     const SubsumeStrengthen* getSubsumeStrengthen() const;
+    const GateTable* getGateTable() const;
     void check_elimed_vars_are_unassigned() const;
     void check_clid_correct() const;
     bool getAnythingHasBeenBlocked() const;
@@ -286,6 +323,7 @@ private:
     SubsumeStrengthen* sub_str;
     friend class BVA;
     BVA* bva;
+    GateTable* gate_table;
     bool startup = false;
     bool backward_sub_str();
     bool execute_simplifier_strategy(const string& strategy);
@@ -300,9 +338,6 @@ private:
     vector<Lit>& toClear;
     vector<bool> indep_vars;
 
-    //Temporaries
-    vector<Lit>     dummy;       ///<Used by merge()
-
     //Limits
     uint64_t clause_lits_added;
     int64_t  strengthening_time_limit;              ///<Max. number self-subsuming resolution tries to do this run
@@ -366,20 +401,6 @@ private:
     uint32_t    sum_irred_cls_longs() const;
     uint32_t    sum_irred_cls_longs_lits() const;
 
-    struct watch_sort_smallest_first {
-        bool operator()(const Watched& first, const Watched& second)
-        {
-            //Anything but clause!
-            if (first.isClause())
-                return false;
-            if (second.isClause())
-                return true;
-
-            //Both are bin
-            return false;
-        }
-    };
-
     /////////////////////
     //Variable elimination
     uint32_t grow = 0; /// maximum grow rate for clauses
@@ -418,9 +439,6 @@ private:
     bool        prop_and_clean_long_and_impl_clauses();
     vector<Lit> tmp_bin_cl;
     void        create_dummy_blocked_clause(const Lit lit);
-    int         test_elim_and_fill_resolvents(uint32_t var);
-    void        mark_gate_in_poss_negs(Lit elim_lit, watch_subarray_const poss, watch_subarray_const negs);
-    void        find_gate(Lit elim_lit, watch_subarray_const a, watch_subarray_const b);
     void        print_var_eliminate_stat(Lit lit) const;
     bool        add_varelim_resolvent(vector<Lit>& finalLits, const ClauseStats& stats, bool is_xor);
     void        update_varelim_complexity_heap();
@@ -478,8 +496,71 @@ private:
             return at;
         }
     };
-    Resolvents resolvents;
-    Clause* gate_varelim_clause;
+
+    ///Everything needed to test-eliminate a single variable. The sequential
+    ///path uses velim_scratch[0], parallel BVE gives each worker its own.
+    struct VarElimScratch {
+        vector<uint16_t> seen;
+        vector<Lit> toClear;
+        vector<Lit> dummy;
+        vector<Watched> poss;
+        vector<Watched> negs;
+        Resolvents resolvents;
+        GateDef gate_def; ///<Definition of the var being tested, if any
+        GateTable::Scratch gate_scratch;
+        bool gate_found = false;
+        uint64_t gates_and = 0;
+        uint64_t gates_xor = 0;
+        uint64_t gates_ite = 0;
+        int64_t* limit = NULL;
+        int64_t own_limit = 0;
+    };
+    vector<VarElimScratch> velim_scratch;
+    void        setup_velim_scratch(const size_t num);
+    int         test_elim_and_fill_resolvents(uint32_t var, VarElimScratch& s);
+    void        fill_bins_first(watch_subarray_const ws, vector<Watched>& out) const;
+    void        mark_gate_in_poss_negs(VarElimScratch& s, uint32_t var);
+    void        unmark_gate(VarElimScratch& s);
+    bool        in_gate(const VarElimScratch& s, const Watched& w, const Clause* cl, const Lit lit) const;
+    bool        add_gate_equivalences();
+    bool        elim_var_by_resolvents(const uint32_t var, Resolvents& res);
+
+    //Parallel BVE -- the resolvents of variables that come out of the heap
+    //soon and share no clause are calculated ahead of time, in parallel
+    struct VelimSpec {
+        uint32_t var; ///<var_Undef if this slot is free
+        int ret;
+        int64_t cost; ///<What it took off the time limit
+        uint32_t grow;
+        vector<uint64_t> occs; ///<The occurrence lists it was calculated from
+        Resolvents res;
+    };
+    vector<uint32_t> velim_batch;
+    vector<VelimSpec> velim_spec;
+    vector<uint32_t> velim_spec_free;
+    vector<uint32_t> velim_spec_at; ///<Index into velim_spec, per var
+    vector<uint8_t> velim_batch_blocked;
+    vector<uint32_t> velim_batch_blocked_vars;
+    vector<std::pair<uint64_t, uint32_t> > velim_batch_cand;
+    bool        velim_batch_var_independent(const uint32_t var);
+    bool        velim_worth_speculating(const uint32_t var) const
+    {
+        //Threads only pay off for the vars with many resolvents to check
+        return (uint64_t)n_occurs[Lit(var, false).toInt()]
+            * (uint64_t)n_occurs[Lit(var, true).toInt()] >= VELIM_PAR_MIN_RESOLVENTS;
+    }
+    void        fill_velim_batch(const uint32_t var);
+    void        add_to_velim_batch(const uint32_t var);
+    void        free_velim_spec(const uint32_t at);
+    void        free_all_velim_spec();
+    void        test_elim_batch_parallel();
+    vector<uint64_t> velim_occs_now;
+    void        velim_occ_snapshot(const uint32_t var, vector<uint64_t>& out) const;
+    Resolvents* get_speculated_resolvents(const uint32_t var, int& ret);
+    #ifdef CMS_TESTING_ENABLED
+    FRIEND_TEST(occsimp, bve_speculation_checks_occurrences);
+    #endif
+
     uint32_t calc_data_for_heuristic(const Lit lit);
     uint64_t time_spent_on_calc_otf_update;
     uint64_t num_otf_update_until_now;
@@ -499,16 +580,19 @@ private:
 
     uint64_t heuristicCalcVarElimScore(const uint32_t var);
     bool resolve_clauses(
-        const Watched ps
+        VarElimScratch& s
+        , const Watched ps
         , const Watched qs
         , const Lit noPosLit
     );
     void add_pos_lits_to_dummy_and_seen(
-        const Watched ps
+        VarElimScratch& s
+        , const Watched ps
         , const Lit posLit
     );
     bool add_neg_lits_to_dummy_and_seen(
-        const Watched qs
+        VarElimScratch& s
+        , const Watched qs
         , const Lit posLit
     );
     bool eliminate_vars();
@@ -574,6 +658,11 @@ inline const SubsumeStrengthen* OccSimplifier::getSubsumeStrengthen() const
     return sub_str;
 }
 
+inline const GateTable* OccSimplifier::getGateTable() const
+{
+    return gate_table;
+}
+
 } //end namespace
 
 #endif //SIMPLIFIER_H
@@ -178,6 +178,11 @@ public:
         return numRows;
     }
 
+    size_t mem_used() const
+    {
+        return (size_t)numRows*(numCols+1)*sizeof(uint64_t);
+    }
+
 private:
 
     uint64_t* mp;
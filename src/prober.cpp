@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <set>
 #include <utility>
 #include <cmath>
+#include <thread>
 
 #include "solver.h"
 #include "clausecleaner.h"
@@ -357,6 +358,12 @@ bool Prober::probe(vector<uint32_t>* probe_order)
     assert(solver->propStats.otfHyperTime == 0);
     single_prop_tout = (double)num_props_limit *solver->conf.single_probe_time_limit_perc;
 
+    if (solver->conf.probe_threads > 1) {
+        probe_par(solver->conf.probe_threads, num_props_limit);
+        num_props_limit *= solver->conf.probe_threads;
+        goto end;
+    }
+
     for(size_t i = 0
         ; i < vars_to_probe.size()
         && limit_used() < num_props_limit
@@ -478,15 +485,16 @@ void Prober::update_cache(Lit thisLit, Lit lit, size_t numElemsSet)
         //Update stats/markings
         //cacheUpdated[(~ancestor).toInt()]++;
         extraTime += 1;
-        extraTimeCache += solver->implCache[~ancestor].lits.size()/30;
-        extraTimeCache += solver->implCache[~thisLit].lits.size()/30;
+        extraTimeCache += solver->implCache[~ancestor].size()/30;
+        extraTimeCache += solver->implCache[~thisLit].size()/30;
 
         const bool redStep = solver->varData[thisLit.var()].reason.isRedStep();
 
         //Update the cache now
         assert(ancestor != lit_Undef);
-        bool taut = solver->implCache[~ancestor].merge(
-            solver->implCache[~thisLit].lits
+        bool taut = solver->implCache.merge(
+            ~ancestor
+            , ~thisLit
             , thisLit
             , redStep
             , ancestor.var()
@@ -575,8 +583,9 @@ void Prober::add_rest_of_lits_to_cache(Lit lit)
         tmp_lits.push_back(thisLit);
     }
 
-    bool taut = solver->implCache[~lit].merge(
-        tmp_lits
+    bool taut = solver->implCache.merge(
+        ~lit
+        , tmp_lits
         , lit_Undef
         , true //Red step -- we don't know, so we assume
         , lit.var()
@@ -952,3 +961,592 @@ void Prober::Stats::print_short(const Solver* s, const bool time_out, const doub
     << s->conf.print_times(cpu_time, time_out, time_remain)
     << endl;
 }
+
+namespace CMSat {
+
+/**
+@brief Failed literal probing on a ProbeSnapshot, inside one thread
+
+Propagation is BFS: binary implications first, then long clauses through
+counters of false literals in each clause. The propagated literals form a tree
+rooted at the probed literal; a literal propagated by a long clause gets the
+deepest common ancestor of the clause's false literals as parent. The latter
+gives the hyper-binary resolvent (~ancestor V lit) and the failed literal
+on conflict.
+*/
+class ParProber
+{
+public:
+    ParProber(
+        const Prober::ProbeSnapshot& _snap
+        , Prober::ParProbeThread& _t
+        , const Solver* solver
+    ) :
+        snap(_snap)
+        , t(_t)
+    {
+        const size_t nVars = solver->nVars();
+        val.resize(nVars);
+        for(size_t i = 0; i < nVars; i++) {
+            val[i] = solver->value(i);
+        }
+        parent.resize(nVars, lit_Undef);
+        depth.resize(nVars, 0);
+        level.resize(nVars, 0);
+        first_val.resize(nVars, l_Undef);
+        cnt.resize(snap.cl_start.size()-1, 0);
+        t.visited.clear();
+        t.visited.resize(nVars*2, 0);
+    }
+
+    void probe_var(const uint32_t var);
+
+private:
+    lbool value(const Lit l) const
+    {
+        return val[l.var()] ^ l.sign();
+    }
+
+    void enqueue(const Lit l, const Lit par)
+    {
+        val[l.var()] = boolToLBool(!l.sign());
+        parent[l.var()] = par;
+        depth[l.var()] = (par == lit_Undef) ? 0 : depth[par.var()] + 1;
+        level[l.var()] = cur_level;
+        trail.push_back(l);
+    }
+
+    Lit common_ancestor(Lit a, Lit b) const;
+    bool propagate(Lit& failed);
+    bool prop_long(const uint32_t cl, Lit& failed);
+    bool probe_lit(const Lit lit, const bool first);
+    bool add_root(const Lit unit);
+    void backtrack();
+    bool bin_exists(const Lit a, const Lit b) const;
+
+    const Prober::ProbeSnapshot& snap;
+    Prober::ParProbeThread& t;
+
+    vector<lbool> val;
+    vector<Lit> parent;
+    vector<uint32_t> depth;
+    vector<uint8_t> level;
+    vector<uint32_t> cnt; ///<Number of false lits in each long clause
+    vector<Lit> trail;
+    size_t root_end = 0;
+    size_t qhead_bin = 0;
+    size_t qhead_long = 0;
+    uint8_t cur_level = 0;
+
+    //For both-prop and equivalences: values under the first probe
+    vector<lbool> first_val;
+    vector<uint32_t> first_set;
+    vector<std::pair<Lit, Lit> > both_same;
+};
+
+}
+
+Lit ParProber::common_ancestor(Lit a, Lit b) const
+{
+    if (level[a.var()] == 0)
+        return b;
+    if (level[b.var()] == 0)
+        return a;
+
+    while (a != b) {
+        if (depth[a.var()] > depth[b.var()]) {
+            a = parent[a.var()];
+        } else if (depth[b.var()] > depth[a.var()]) {
+            b = parent[b.var()];
+        } else {
+            a = parent[a.var()];
+            b = parent[b.var()];
+        }
+        t.limit--;
+    }
+
+    return a;
+}
+
+bool ParProber::bin_exists(const Lit a, const Lit b) const
+{
+    for(uint32_t i = snap.bin_start[a.toInt()]; i < snap.bin_start[a.toInt()+1]; i++) {
+        if (snap.bin[i] == b)
+            return true;
+    }
+    return false;
+}
+
+//Returns false on conflict. At level 1, "failed" is then set to the deepest
+//literal in the tree that implies the conflict
+bool ParProber::prop_long(const uint32_t cl, Lit& failed)
+{
+    const uint32_t start = snap.cl_start[cl];
+    const uint32_t end = snap.cl_start[cl+1];
+    Lit unset = lit_Undef;
+    for(uint32_t i = start; i < end; i++) {
+        const Lit l = snap.cl_lits[i];
+        const lbool v = value(l);
+        if (v == l_True)
+            return true;
+
+        if (v == l_Undef) {
+            if (unset != lit_Undef)
+                return true;
+            unset = l;
+        }
+    }
+    t.limit -= end - start;
+
+    Lit anc = lit_Undef;
+    uint32_t num_anc = 0;
+    for(uint32_t i = start; i < end; i++) {
+        const Lit l = snap.cl_lits[i];
+        if (l == unset || level[l.var()] == 0)
+            continue;
+
+        anc = (anc == lit_Undef) ? ~l : common_ancestor(anc, ~l);
+        num_anc++;
+    }
+    if (cur_level == 1 && anc == lit_Undef) {
+        anc = trail[root_end];
+    }
+
+    if (unset == lit_Undef) {
+        failed = anc;
+        return false;
+    }
+
+    enqueue(unset, anc);
+    if (num_anc >= 2 && !bin_exists(anc, unset)) {
+        t.hyper_bins.push_back(BinaryClause(~anc, unset, true));
+    }
+
+    return true;
+}
+
+bool ParProber::propagate(Lit& failed)
+{
+    bool ret = true;
+    while (ret) {
+        //Binary implications first, so that the tree is shallow
+        while (qhead_bin < trail.size()) {
+            const Lit p = trail[qhead_bin++];
+            const uint32_t start = snap.bin_start[p.toInt()];
+            const uint32_t end = snap.bin_start[p.toInt()+1];
+            t.limit -= 1 + (end - start)/4;
+            for(uint32_t i = start; i < end; i++) {
+                const Lit q = snap.bin[i];
+                const lbool v = value(q);
+                if (v == l_Undef) {
+                    enqueue(q, p);
+                } else if (v == l_False) {
+                    failed = (cur_level == 0) ? lit_Undef : common_ancestor(p, ~q);
+                    return false;
+                }
+            }
+        }
+
+        if (qhead_long == trail.size())
+            break;
+
+        //Every clause counter must be updated, even after a conflict,
+        //as backtrack() undoes them for the whole occurrence list
+        const Lit p = trail[qhead_long++];
+        const Lit f = ~p;
+        const uint32_t start = snap.occ_start[f.toInt()];
+        const uint32_t end = snap.occ_start[f.toInt()+1];
+        t.limit -= 1 + (end - start);
+        for(uint32_t i = start; i < end; i++) {
+            const uint32_t cl = snap.occ[i];
+            cnt[cl]++;
+            if (ret
+                && cnt[cl] + 1 >= snap.cl_start[cl+1] - snap.cl_start[cl]
+            ) {
+                ret = prop_long(cl, failed);
+            }
+        }
+    }
+    if (!ret && cur_level == 0) {
+        failed = lit_Undef;
+    }
+
+    return ret;
+}
+
+void ParProber::backtrack()
+{
+    for(size_t i = trail.size(); i > root_end; i--) {
+        const Lit p = trail[i-1];
+        if (i-1 < qhead_long) {
+            const Lit f = ~p;
+            for(uint32_t i2 = snap.occ_start[f.toInt()]; i2 < snap.occ_start[f.toInt()+1]; i2++) {
+                cnt[snap.occ[i2]]--;
+            }
+        }
+        val[p.var()] = l_Undef;
+    }
+    t.limit -= trail.size() - root_end;
+    trail.resize(root_end);
+    qhead_bin = root_end;
+    qhead_long = root_end;
+}
+
+bool ParProber::add_root(const Lit unit)
+{
+    const lbool v = value(unit);
+    if (v == l_True)
+        return true;
+
+    if (v == l_False) {
+        t.unsat = true;
+        return false;
+    }
+
+    cur_level = 0;
+    enqueue(unit, lit_Undef);
+    Lit failed;
+    if (!propagate(failed)) {
+        t.unsat = true;
+        return false;
+    }
+    root_end = trail.size();
+    return true;
+}
+
+bool ParProber::probe_lit(const Lit lit, const bool first)
+{
+    t.probed++;
+    cur_level = 1;
+    enqueue(lit, lit_Undef);
+    Lit failed = lit_Undef;
+    if (!propagate(failed)) {
+        backtrack();
+        t.failed++;
+        t.units.push_back(std::make_pair(~failed, lit_Undef));
+        add_root(~failed);
+        return false;
+    }
+
+    both_same.clear();
+    for(size_t i = root_end + 1; i < trail.size(); i++) {
+        const Lit x = trail[i];
+        t.visited[x.toInt()] = 1;
+        if (first) {
+            first_val[x.var()] = val[x.var()];
+            first_set.push_back(x.var());
+        } else if (first_val[x.var()] != l_Undef) {
+            if (first_val[x.var()] == val[x.var()]) {
+                both_same.push_back(std::make_pair(x, lit));
+            } else {
+                t.equivs.push_back(std::make_pair(lit, x));
+            }
+        }
+    }
+    t.visited[lit.toInt()] = 1;
+    backtrack();
+
+    for(const auto& p: both_same) {
+        t.units.push_back(p);
+        if (!add_root(p.first))
+            return false;
+    }
+
+    return true;
+}
+
+void ParProber::probe_var(const uint32_t var)
+{
+    const Lit lit = Lit(var, false);
+    if (val[var] != l_Undef || t.visited[lit.toInt()])
+        return;
+
+    t.var_probed++;
+    if (probe_lit(lit, true) && val[var] == l_Undef) {
+        probe_lit(~lit, false);
+    }
+
+    for(const uint32_t v: first_set) {
+        first_val[v] = l_Undef;
+    }
+    first_set.clear();
+}
+
+void Prober::build_probe_snapshot()
+{
+    const size_t nLits = solver->nVars()*2;
+    snap.bin_start.assign(nLits+1, 0);
+    snap.occ_start.assign(nLits+1, 0);
+    snap.cl_start.clear();
+    snap.cl_lits.clear();
+    vector<BinaryClause> extra_bins;
+
+    //Long clauses, minus the lits false at level 0
+    auto add_cl = [&](const Lit* begin, const Lit* end) {
+        const size_t at = snap.cl_lits.size();
+        for(const Lit* l = begin; l != end; l++) {
+            const lbool v = solver->value(*l);
+            if (v == l_True) {
+                snap.cl_lits.resize(at);
+                return;
+            }
+            if (v == l_Undef) {
+                snap.cl_lits.push_back(*l);
+            }
+        }
+        const size_t sz = snap.cl_lits.size() - at;
+        if (sz <= 2) {
+            if (sz == 2) {
+                extra_bins.push_back(BinaryClause(snap.cl_lits[at], snap.cl_lits[at+1], true));
+            }
+            snap.cl_lits.resize(at);
+            return;
+        }
+        snap.cl_start.push_back(at);
+        for(size_t i = at; i < snap.cl_lits.size(); i++) {
+            snap.occ_start[snap.cl_lits[i].toInt()]++;
+        }
+    };
+
+    for(const ClOffset offset: solver->longIrredCls) {
+        const Clause& cl = *solver->cl_alloc.ptr(offset);
+        add_cl(cl.begin(), cl.end());
+    }
+    for(const ClOffset offset: solver->longRedCls[0]) {
+        const Clause& cl = *solver->cl_alloc.ptr(offset);
+        add_cl(cl.begin(), cl.end());
+    }
+    const size_t num_cls = snap.cl_start.size();
+    snap.cl_start.push_back(snap.cl_lits.size());
+
+    //Occurrence lists
+    uint32_t sum = 0;
+    for(size_t i = 0; i <= nLits; i++) {
+        const uint32_t num = snap.occ_start[i];
+        snap.occ_start[i] = sum;
+        sum += num;
+    }
+    snap.occ.resize(sum);
+    vector<uint32_t> at(snap.occ_start.begin(), snap.occ_start.end() - 1);
+    for(size_t c = 0; c < num_cls; c++) {
+        for(uint32_t i = snap.cl_start[c]; i < snap.cl_start[c+1]; i++) {
+            snap.occ[at[snap.cl_lits[i].toInt()]++] = c;
+        }
+    }
+
+    //Binary implications: if P is true, the other lit of the binaries
+    //in watches[~P] is implied
+    auto bin_ok = [&](const Lit a, const Lit b) {
+        return solver->value(a) == l_Undef && solver->value(b) == l_Undef;
+    };
+    for(size_t i = 0; i < nLits; i++) {
+        const Lit lit = Lit::toLit(i);
+        for(const Watched& w: solver->watches[lit]) {
+            if (w.isBin() && bin_ok(lit, w.lit2())) {
+                snap.bin_start[(~lit).toInt()]++;
+            }
+        }
+    }
+    for(const BinaryClause& b: extra_bins) {
+        snap.bin_start[(~b.getLit1()).toInt()]++;
+        snap.bin_start[(~b.getLit2()).toInt()]++;
+    }
+    sum = 0;
+    for(size_t i = 0; i <= nLits; i++) {
+        const uint32_t num = snap.bin_start[i];
+        snap.bin_start[i] = sum;
+        sum += num;
+    }
+    snap.bin.resize(sum);
+    at.assign(snap.bin_start.begin(), snap.bin_start.end() - 1);
+    for(size_t i = 0; i < nLits; i++) {
+        const Lit lit = Lit::toLit(i);
+        for(const Watched& w: solver->watches[lit]) {
+            if (w.isBin() && bin_ok(lit, w.lit2())) {
+                snap.bin[at[(~lit).toInt()]++] = w.lit2();
+            }
+        }
+    }
+    for(const BinaryClause& b: extra_bins) {
+        snap.bin[at[(~b.getLit1()).toInt()]++] = b.getLit2();
+        snap.bin[at[(~b.getLit2()).toInt()]++] = b.getLit1();
+    }
+}
+
+//Runs in its own thread. Only reads the snapshot and the level 0 values
+void Prober::probe_par_thread(ParProbeThread& t)
+{
+    const double myTime = cpuTime();
+    ParProber p(snap, t, solver);
+    for(t.at = t.start
+        ; t.at < t.end && t.limit > 0 && !t.unsat && !solver->must_interrupt_asap()
+        ; t.at++
+    ) {
+        t.limit -= 20;
+        p.probe_var(vars_to_probe[t.at]);
+    }
+    t.time_used = cpuTime() - myTime;
+}
+
+bool Prober::apply_par_results()
+{
+    //Units first, in the order found: the rest may depend on them
+    vector<Lit> lits;
+    for(const ParProbeThread& t: par_threads) {
+        for(const auto& u: t.units) {
+            if (!solver->okay())
+                return false;
+
+            if (solver->value(u.first) == l_True)
+                continue;
+
+            if (u.second != lit_Undef) {
+                (*solver->drat) << add << u.second << u.first
+                #ifdef STATS_NEEDED
+                << solver->clauseID++
+                << solver->sumConflicts
+                #endif
+                << fin;
+                (*solver->drat) << add << ~u.second << u.first
+                #ifdef STATS_NEEDED
+                << solver->clauseID++
+                << solver->sumConflicts
+                #endif
+                << fin;
+                runStats.bothSameAdded++;
+            }
+            lits.clear();
+            lits.push_back(u.first);
+            solver->add_clause_int(lits, true);
+        }
+    }
+
+    if (solver->conf.doFindAndReplaceEqLits) {
+        for(const ParProbeThread& t: par_threads) {
+            for(const auto& eq: t.equivs) {
+                if (!solver->okay())
+                    return false;
+
+                if (solver->value(eq.first) != l_Undef
+                    || solver->value(eq.second) != l_Undef
+                ) {
+                    continue;
+                }
+                lits.clear();
+                lits.push_back(Lit(eq.first.var(), false));
+                lits.push_back(Lit(eq.second.var(), false));
+                solver->add_xor_clause_inter(lits, eq.first.sign() ^ eq.second.sign(), true);
+            }
+        }
+    }
+    if (!solver->okay())
+        return false;
+
+    for(const ParProbeThread& t: par_threads) {
+        for(const BinaryClause& b: t.hyper_bins) {
+            if (solver->value(b.getLit1()) != l_Undef
+                || solver->value(b.getLit2()) != l_Undef
+            ) {
+                continue;
+            }
+            if (solver->needToAddBinClause.insert(b).second) {
+                *solver->drat << add
+                #ifdef STATS_NEEDED
+                << solver->clauseID++ << solver->sumConflicts
+                #endif
+                << b.getLit1() << b.getLit2() << fin;
+            }
+        }
+    }
+    runStats.addedBin += solver->hyper_bin_res_all();
+
+    return solver->okay();
+}
+
+/**
+@brief Probes the literals in vars_to_probe with multiple threads
+
+Each thread gets a contiguous part of vars_to_probe and its own copy of the
+time limit, and probes on a read-only snapshot of the clauses. What the
+threads found is added at the end, in thread order, so the result does not
+depend on thread scheduling. Binaries found by one thread are not used by the
+others during the call.
+*/
+bool Prober::probe_par(const unsigned num_threads, const uint64_t num_props_limit)
+{
+    const double myTime = cpuTime();
+    build_probe_snapshot();
+    const double snapTime = cpuTime() - myTime;
+
+    par_threads.clear();
+    par_threads.resize(num_threads);
+    for(unsigned i = 0; i < num_threads; i++) {
+        ParProbeThread& t = par_threads[i];
+        t.start = (vars_to_probe.size()*i)/num_threads;
+        t.end = (vars_to_probe.size()*(i+1))/num_threads;
+        t.limit = num_props_limit;
+        t.start_limit = num_props_limit;
+    }
+
+    const double findStart = cpuTime();
+    vector<std::thread> threads;
+    for(unsigned i = 1; i < num_threads; i++) {
+        threads.push_back(std::thread(
+            &Prober::probe_par_thread, this, std::ref(par_threads[i])));
+    }
+    probe_par_thread(par_threads[0]);
+    for(std::thread& th: threads) {
+        th.join();
+    }
+    const double findTime = cpuTime() - findStart;
+
+    const double mergeStart = cpuTime();
+    size_t num_equivs = 0;
+    size_t num_hyper = 0;
+    for(size_t i = 0; i < par_threads.size(); i++) {
+        const ParProbeThread& t = par_threads[i];
+        solver->propStats.bogoProps += t.start_limit - std::max<int64_t>(t.limit, 0);
+        runStats.numLoopIters += t.at - t.start;
+        runStats.numVarProbed += t.var_probed;
+        runStats.numProbed += t.probed;
+        runStats.numFailed += t.failed;
+        runStats.conflStats.numConflicts += t.failed;
+        for(size_t l = 0; l < t.visited.size(); l++) {
+            visitedAlready[l] |= t.visited[l];
+        }
+        num_equivs += t.equivs.size();
+        num_hyper += t.hyper_bins.size();
+
+        if (solver->conf.verbosity >= 2) {
+            cout
+            << "c [probe-par] T" << i
+            << " vars: " << t.at - t.start << "/" << t.end - t.start
+            << " probed: " << t.probed
+            << " failed: " << t.failed
+            << " units: " << t.units.size()
+            << " equiv: " << t.equivs.size()
+            << " hyper-bin: " << t.hyper_bins.size()
+            << " T: " << std::setprecision(2) << std::fixed << t.time_used
+            << endl;
+        }
+    }
+    apply_par_results();
+    const double mergeTime = cpuTime() - mergeStart;
+
+    if (solver->conf.verbosity) {
+        cout
+        << "c [probe-par] threads: " << num_threads
+        << " equiv: " << num_equivs
+        << " hyper-bin: " << num_hyper
+        << " snapshot-T: " << std::setprecision(2) << std::fixed << snapTime
+        << " find-T: " << findTime
+        << " merge-T: " << mergeTime
+        << endl;
+    }
+
+    par_threads.clear();
+    ProbeSnapshot tmp;
+    std::swap(snap, tmp);
+
+    return solver->okay();
+}
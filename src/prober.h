@@ -209,6 +209,40 @@ class Prober {
         const Stats& get_stats() const;
         size_t mem_used() const;
 
+        //Read-only copy of the clauses for parallel probing
+        struct ProbeSnapshot
+        {
+            vector<uint32_t> bin_start; ///<Lits implied by lit L are bin[bin_start[L]..bin_start[L+1])
+            vector<Lit> bin;
+            vector<uint32_t> occ_start; ///<Clauses containing L are occ[occ_start[L]..occ_start[L+1])
+            vector<uint32_t> occ;
+            vector<uint32_t> cl_start; ///<Lits of clause C are cl_lits[cl_start[C]..cl_start[C+1])
+            vector<Lit> cl_lits;
+        };
+
+        //What one probing thread found
+        struct ParProbeThread
+        {
+            size_t start = 0;
+            size_t end = 0;
+            size_t at = 0;
+            int64_t limit = 0;
+            int64_t start_limit = 0;
+            double time_used = 0;
+            bool unsat = false;
+
+            ///Units in the order found: (unit, probed lit) if both the
+            ///probed lit and its negation implied it, (unit, lit_Undef) for
+            ///negated failed lits
+            vector<std::pair<Lit, Lit> > units;
+            vector<std::pair<Lit, Lit> > equivs; ///<The two lits are equivalent
+            vector<BinaryClause> hyper_bins;
+            vector<char> visited;
+            uint64_t probed = 0;
+            uint64_t var_probed = 0;
+            uint64_t failed = 0;
+        };
+
     private:
         //Main
         vector<uint32_t> vars_to_probe;
@@ -229,6 +263,14 @@ class Prober {
         void update_and_print_stats(const double myTime, const uint64_t num_props_limit);
         bool check_timeout_due_to_hyperbin();
 
+        //Parallel probing
+        ProbeSnapshot snap;
+        vector<ParProbeThread> par_threads;
+        void build_probe_snapshot();
+        void probe_par_thread(ParProbeThread& t);
+        bool probe_par(const unsigned num_threads, const uint64_t num_props_limit);
+        bool apply_par_results();
+
         //For bothprop
         vector<uint32_t> propagatedBitSet;
         vector<bool> propagated; ///<These lits have been propagated by propagating the lit picked
@@ -148,6 +148,7 @@ protected:
     Heap<VarOrderLt> order_heap_maple;
 
     friend class EGaussian;
+    friend class ExtPropHandler;
 
     template<bool update_bogoprops>
     PropBy propagate_any_order();
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "solverconf.h"
 #include "sqlstats.h"
 #include <functional>
+#include <algorithm>
 
 using namespace CMSat;
 
@@ -78,16 +79,21 @@ ReduceDB::ReduceDB(Solver* _solver) :
 {
 }
 
-void ReduceDB::sort_red_cls(ClauseClean clean_type)
-{
+//Moves the best N among [begin, end) to the front, in no particular order
+void ReduceDB::select_top_N(
+    ClauseClean clean_type
+    , vector<ClOffset>::iterator begin
+    , vector<ClOffset>::iterator nth
+    , vector<ClOffset>::iterator end
+) {
     switch (clean_type) {
         case ClauseClean::glue : {
-            std::sort(solver->longRedCls[2].begin(), solver->longRedCls[2].end(), SortRedClsGlue(solver->cl_alloc));
+            std::nth_element(begin, nth, end, SortRedClsGlue(solver->cl_alloc));
             break;
         }
 
         case ClauseClean::activity : {
-            std::sort(solver->longRedCls[2].begin(), solver->longRedCls[2].end(), SortRedClsAct(solver->cl_alloc));
+            std::nth_element(begin, nth, end, SortRedClsAct(solver->cl_alloc));
             break;
         }
 
@@ -101,7 +107,8 @@ void ReduceDB::sort_red_cls(ClauseClean clean_type)
 //kept no. of clauses as other solvers do
 void ReduceDB::handle_lev2()
 {
-    nbReduceDB_lev1++;
+    nbReduceDB_lev2++;
+    solver->stats.reduceDB_lev2++;
     solver->dump_memory_stats_to_sql();
 
     const double myTime = cpuTime();
@@ -117,8 +124,7 @@ void ReduceDB::handle_lev2()
         if (keep_num == 0) {
             continue;
         }
-        sort_red_cls(static_cast<ClauseClean>(keep_type));
-        mark_top_N_clauses(keep_num);
+        mark_top_N_clauses(static_cast<ClauseClean>(keep_type), keep_num);
     }
     assert(delayed_clause_free.empty());
     cl_marked = 0;
@@ -153,6 +159,7 @@ void ReduceDB::handle_lev2()
         );
     }
     total_time += cpuTime()-myTime;
+    solver->stats.reduceDB_time += cpuTime()-myTime;
 
     last_reducedb_num_conflicts = solver->sumConflicts;
 }
@@ -186,6 +193,7 @@ void ReduceDB::dump_sql_cl_data()
 void ReduceDB::handle_lev1()
 {
     nbReduceDB_lev1++;
+    solver->stats.reduceDB_lev1++;
     uint32_t moved_w0 = 0;
     uint32_t used_recently = 0;
     uint32_t non_recent_use = 0;
@@ -237,31 +245,102 @@ void ReduceDB::handle_lev1()
         );
     }
     total_time += cpuTime()-myTime;
+    solver->stats.reduceDB_time += cpuTime()-myTime;
 }
 
-void ReduceDB::mark_top_N_clauses(const uint64_t keep_num)
+size_t ReduceDB::shed_lev(const uint32_t lev)
 {
-    size_t marked = 0;
-    for(size_t i = 0
-        ; i < solver->longRedCls[2].size() && marked < keep_num
-        ; i++
-    ) {
+    assert(lev == 1 || lev == 2);
+    assert(solver->watches.get_smudged_list().empty());
+    const double myTime = cpuTime();
+
+    //Demote everything in lev1 that is not locked to lev2, then empty lev2
+    //regardless of activity, marks or TTL
+    if (lev == 1) {
+        size_t j = 0;
+        for(const ClOffset offset: solver->longRedCls[1]) {
+            Clause* cl = solver->cl_alloc.ptr(offset);
+            if (cl->stats.which_red_array == 0) {
+                solver->longRedCls[0].push_back(offset);
+            } else if (solver->clause_locked(*cl, offset)) {
+                solver->longRedCls[1][j++] = offset;
+            } else {
+                cl->stats.which_red_array = 2;
+                solver->longRedCls[2].push_back(offset);
+            }
+        }
+        solver->longRedCls[1].resize(j);
+    }
+
+    size_t removed = 0;
+    size_t j = 0;
+    for(size_t i = 0; i < solver->longRedCls[2].size(); i++) {
         const ClOffset offset = solver->longRedCls[2][i];
         Clause* cl = solver->cl_alloc.ptr(offset);
-
-        if (cl->used_in_xor()
-            || cl->stats.ttl > 0
-            || solver->clause_locked(*cl, offset)
-            || cl->stats.which_red_array != 2
-        ) {
-            //no need to mark, skip
+        cl->stats.marked_clause = 0;
+        if (cl->stats.which_red_array < 2) {
+            solver->longRedCls[cl->stats.which_red_array].push_back(offset);
             continue;
         }
 
-        if (!cl->stats.marked_clause) {
-            marked++;
-            cl->stats.marked_clause = true;
+        if (cl->used_in_xor() || solver->clause_locked(*cl, offset)) {
+            solver->longRedCls[2][j++] = offset;
+            continue;
         }
+
+        solver->watches.smudge((*cl)[0]);
+        solver->watches.smudge((*cl)[1]);
+        solver->litStats.redLits -= cl->size();
+        *solver->drat << del << *cl << fin;
+        cl->setRemoved();
+        delayed_clause_free.push_back(offset);
+        removed++;
+        solver->stats.reduceDB_removed++;
+    }
+    solver->longRedCls[2].resize(j);
+
+    solver->clean_occur_from_removed_clauses_only_smudged();
+    for(ClOffset offset: delayed_clause_free) {
+        solver->cl_alloc.clauseFree(offset);
+    }
+    delayed_clause_free.clear();
+    solver->cl_alloc.consolidate(solver, true, true);
+
+    if (solver->conf.verbosity >= 2) {
+        cout << "c [DBclean shed lev" << lev << "]"
+        << " removed: " << removed
+        << solver->conf.print_times(cpuTime()-myTime)
+        << endl;
+    }
+    total_time += cpuTime()-myTime;
+    solver->stats.reduceDB_time += cpuTime()-myTime;
+
+    return removed;
+}
+
+void ReduceDB::mark_top_N_clauses(ClauseClean clean_type, const uint64_t keep_num)
+{
+    //Clauses that are kept anyway, or have been marked already, don't
+    //compete -- move them to the back
+    vector<ClOffset>& cls = solver->longRedCls[2];
+    const auto cand_end = std::partition(cls.begin(), cls.end(),
+        [&](const ClOffset offset) {
+            const Clause* cl = solver->cl_alloc.ptr(offset);
+            return !cl->used_in_xor()
+                && cl->stats.ttl == 0
+                && cl->stats.which_red_array == 2
+                && !cl->stats.marked_clause
+                && !solver->clause_locked(*cl, offset);
+        });
+
+    const size_t num_cands = cand_end - cls.begin();
+    if (num_cands == 0) {
+        return;
+    }
+    const auto nth = cls.begin() + std::min<size_t>(keep_num, num_cands);
+    select_top_N(clean_type, cls.begin(), nth, cand_end);
+    for(auto it = cls.begin(); it != nth; ++it) {
+        solver->cl_alloc.ptr(*it)->stats.marked_clause = true;
     }
 }
 
@@ -318,6 +397,7 @@ void ReduceDB::remove_cl_from_lev2() {
         *solver->drat << del << *cl << fin;
         cl->setRemoved();
         delayed_clause_free.push_back(offset);
+        solver->stats.reduceDB_removed++;
     }
     solver->longRedCls[2].resize(j);
 }
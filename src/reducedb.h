@@ -26,6 +26,10 @@ THE SOFTWARE.
 #include "clauseallocator.h"
 #include "clauseusagestats.h"
 
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
+
 namespace CMSat {
 
 class Solver;
@@ -39,11 +43,19 @@ public:
     }
     void handle_lev1();
     void handle_lev2();
+    size_t shed_lev(const uint32_t lev); ///<Memory pressure: drop all removable clauses of tier 1 or 2
     void dump_sql_cl_data();
     uint64_t nbReduceDB_lev1 = 0;
     uint64_t nbReduceDB_lev2 = 0;
 
 private:
+    #ifdef CMS_TESTING_ENABLED
+    FRIEND_TEST(reducedb, same_as_full_sort_glue);
+    FRIEND_TEST(reducedb, same_as_full_sort_activity);
+    FRIEND_TEST(reducedb, same_as_full_sort_both);
+    FRIEND_TEST(reducedb, ties);
+    #endif
+
     Solver* solver;
     vector<ClOffset> delayed_clause_free;
     double total_time = 0.0;
@@ -59,8 +71,13 @@ private:
     bool cl_needs_removal(const Clause* cl, const ClOffset offset) const;
     void remove_cl_from_lev2();
 
-    void sort_red_cls(ClauseClean clean_type);
-    void mark_top_N_clauses(const uint64_t keep_num);
+    void select_top_N(
+        ClauseClean clean_type
+        , vector<ClOffset>::iterator begin
+        , vector<ClOffset>::iterator nth
+        , vector<ClOffset>::iterator end
+    );
+    void mark_top_N_clauses(ClauseClean clean_type, const uint64_t keep_num);
 };
 
 }
@@ -57,17 +57,15 @@ bool SCCFinder::performSCC(uint64_t* bogoprops_given)
     stackIndicator.resize(solver->nVars()*2, false);
     assert(stack.empty());
 
-    depth = 0;
+    build_graph();
     for (uint32_t vertex = 0; vertex < solver->nVars()*2; vertex++) {
         //Start a DFS at each node we haven't visited yet
         const uint32_t v = vertex>>1;
         if (solver->value(v) != l_Undef) {
             continue;
         }
-        assert(depth == 0);
         if (index[vertex] == std::numeric_limits<uint32_t>::max()) {
             tarjan(vertex);
-            depth--;
             assert(stack.empty());
         }
     }
@@ -90,20 +88,72 @@ bool SCCFinder::performSCC(uint64_t* bogoprops_given)
     return solver->okay();
 }
 
-void SCCFinder::tarjan(const uint32_t vertex)
+/**
+@brief Exports the binary implication graph (and the cache, if used) into a
+CSR array
+
+Only unset, non-removed literals are vertices with edges, and edges only lead
+to such literals. This is the same graph the watchlists gave before.
+*/
+void SCCFinder::build_graph()
+{
+    const bool use_cache = solver->conf.doCache
+        && solver->conf.doExtendedSCC
+        && (!(solver->drat->enabled() || solver->conf.simulate_drat) ||
+            solver->conf.otfHyperbin);
+
+    const size_t nLits = solver->nVars()*2;
+    graph_start.clear();
+    graph_start.resize(nLits+1, 0);
+    graph.clear();
+    auto usable = [&](const Lit lit) {
+        return solver->value(lit) == l_Undef
+            && solver->varData[lit.var()].removed == Removed::none;
+    };
+
+    for(uint32_t vertex = 0; vertex < nLits; vertex++) {
+        graph_start[vertex] = graph.size();
+        const Lit vertLit = Lit::toLit(vertex);
+        if (!usable(vertLit))
+            continue;
+
+        watch_subarray_const ws = solver->watches[~vertLit];
+        runStats.bogoprops += ws.size()/4;
+        for (const Watched& w: ws) {
+            //Only binary clauses matter
+            if (w.isBin() && usable(w.lit2())) {
+                graph.push_back(w.lit2().toInt());
+            }
+        }
+
+        if (use_cache) {
+            const TransCache& cache = solver->implCache[~vertLit];
+            runStats.bogoprops += cache.size()/4;
+            for (const LitExtra le: cache) {
+                const Lit lit = le.getLit();
+                if (lit != ~vertLit && usable(lit)) {
+                    graph.push_back(lit.toInt());
+                }
+            }
+        }
+    }
+    graph_start[nLits] = graph.size();
+}
+
+//Sets vertex up as visited and puts it on the DFS stack
+bool SCCFinder::visit(const uint32_t vertex)
 {
-    depth++;
-    if (depth >= (uint32_t)solver->conf.max_scc_depth) {
+    if (call_stack.size() + 1 >= (uint32_t)solver->conf.max_scc_depth) {
         if (solver->conf.verbosity && !depth_warning_issued) {
-            depth_warning_issued = true;
             cout << "c [scc] WARNING: reached maximum depth of " << solver->conf.max_scc_depth << endl;
         }
-        return;
+        depth_warning_issued = true;
+        return false;
     }
 
     const Lit vertLit = Lit::toLit(vertex);
     if (solver->varData[vertLit.var()].removed != Removed::none) {
-        return;
+        return false;
     }
 
     runStats.bogoprops += 1;
@@ -113,58 +163,55 @@ void SCCFinder::tarjan(const uint32_t vertex)
     stack.push(vertex); // Push v on the stack
     stackIndicator[vertex] = true;
 
-    vector<LitExtra>* transCache = NULL;
-    if (solver->conf.doCache
-        && solver->conf.doExtendedSCC
-        && (!(solver->drat->enabled() || solver->conf.simulate_drat) ||
-            solver->conf.otfHyperbin)
-    ) {
-        transCache = &(solver->implCache[~vertLit].lits);
-        __builtin_prefetch(transCache->data());
-    }
+    Frame f;
+    f.vertex = vertex;
+    f.at = graph_start[vertex];
+    call_stack.push_back(f);
+    return true;
+}
 
-    //Go through the watch
-    watch_subarray_const ws = solver->watches[~vertLit];
-    runStats.bogoprops += ws.size()/4;
-    for (const Watched& w: ws) {
-        //Only binary clauses matter
-        if (!w.isBin())
-            continue;
+//Iterative Tarjan, so that there is no recursion depth to worry about
+void SCCFinder::tarjan(const uint32_t start)
+{
+    assert(call_stack.empty());
+    visit(start);
+    while (!call_stack.empty()) {
+        Frame& f = call_stack.back();
+        const uint32_t vertex = f.vertex;
+        if (f.at < graph_start[vertex+1]) {
+            const uint32_t succ = graph[f.at++];
 
-        const Lit lit = w.lit2();
-        if (solver->value(lit) != l_Undef) {
+            // Was successor v' visited?
+            if (index[succ] == std::numeric_limits<uint32_t>::max()) {
+                //Its lowlink is taken into account once it's finished
+                visit(succ);
+            } else if (stackIndicator[succ]) {
+                lowlink[vertex] = std::min(lowlink[vertex], lowlink[succ]);
+            }
             continue;
         }
-        doit(lit, vertex);
-    }
+        call_stack.pop_back();
 
-    if (transCache) {
-        runStats.bogoprops += transCache->size()/4;
-        for (const LitExtra& le: *transCache) {
-            Lit lit = le.getLit();
-            if (solver->value(lit) != l_Undef) {
-                continue;
-            }
-            if (lit != ~vertLit) {
-                doit(lit, vertex);
+        // Is v the root of an SCC?
+        if (lowlink[vertex] == index[vertex]) {
+            uint32_t vprime;
+            tmp.clear();
+            do {
+                assert(!stack.empty());
+                vprime = stack.top();
+                stack.pop();
+                stackIndicator[vprime] = false;
+                tmp.push_back(vprime);
+            } while (vprime != vertex);
+            if (tmp.size() >= 2) {
+                runStats.bogoprops += 3;
+                add_bin_xor_in_tmp();
             }
         }
-    }
 
-    // Is v the root of an SCC?
-    if (lowlink[vertex] == index[vertex]) {
-        uint32_t vprime;
-        tmp.clear();
-        do {
-            assert(!stack.empty());
-            vprime = stack.top();
-            stack.pop();
-            stackIndicator[vprime] = false;
-            tmp.push_back(vprime);
-        } while (vprime != vertex);
-        if (tmp.size() >= 2) {
-            runStats.bogoprops += 3;
-            add_bin_xor_in_tmp();
+        if (!call_stack.empty()) {
+            const uint32_t parent = call_stack.back().vertex;
+            lowlink[parent] = std::min(lowlink[parent], lowlink[vertex]);
         }
     }
 }
@@ -225,6 +272,9 @@ size_t SCCFinder::mem_used() const
     mem += stack.size()*sizeof(uint32_t); //TODO under-estimates
     mem += stackIndicator.capacity()*sizeof(char);
     mem += tmp.capacity()*sizeof(uint32_t);
+    mem += graph_start.capacity()*sizeof(uint32_t);
+    mem += graph.capacity()*sizeof(uint32_t);
+    mem += call_stack.capacity()*sizeof(Frame);
 
     return mem;
 }
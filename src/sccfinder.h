@@ -101,11 +101,25 @@ class SCCFinder {
         bool depth_warning_triggered() const;
 
     private:
+        void build_graph();
         void tarjan(const uint32_t vertex);
+        bool visit(const uint32_t vertex);
         bool depth_warning_issued;
-        void doit(const Lit lit, const uint32_t vertex);
         void add_bin_xor_in_tmp();
 
+        //Implication graph: the successors of vertex V (i.e. Lit::toLit(V))
+        //are graph[graph_start[V]..graph_start[V+1])
+        vector<uint32_t> graph_start;
+        vector<uint32_t> graph;
+
+        //DFS state, instead of recursion
+        struct Frame
+        {
+            uint32_t vertex;
+            uint32_t at; ///<Next successor to visit
+        };
+        vector<Frame> call_stack;
+
         //temporaries
         uint32_t globalIndex;
         vector<uint32_t> index;
@@ -113,7 +127,6 @@ class SCCFinder {
         std::stack<uint32_t, vector<uint32_t> > stack;
         vector<char> stackIndicator;
         vector<uint32_t> tmp;
-        uint32_t depth;
 
         Solver* solver;
         std::set<BinaryXor> binxors;
@@ -123,17 +136,6 @@ class SCCFinder {
         Stats globalStats;
 };
 
-inline void SCCFinder::doit(const Lit lit, const uint32_t vertex) {
-    // Was successor v' visited?
-    if (index[lit.toInt()] ==  std::numeric_limits<uint32_t>::max()) {
-        tarjan(lit.toInt());
-        depth--;
-        lowlink[vertex] = std::min(lowlink[vertex], lowlink[lit.toInt()]);
-    } else if (stackIndicator[lit.toInt()])  {
-        lowlink[vertex] = std::min(lowlink[vertex], lowlink[lit.toInt()]);
-    }
-}
-
 inline bool SCCFinder::depth_warning_triggered() const
 {
     return depth_warning_issued;
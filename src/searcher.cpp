@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include <ratio>
 #include "sqlstats.h"
 #include "datasync.h"
+#include "extprophandler.h"
 #include "reducedb.h"
 #include "sqlstats.h"
 #include "watchalgos.h"
@@ -720,7 +721,7 @@ void Searcher::simple_create_learnt_clause(
     int mypathC = 0;
     Lit p = lit_Undef;
     int index = trail.size() - 1;
-    assert(decisionLevel() == 1);
+    assert(decisionLevel() >= 1);
 
     do {
         if (!confl.isNULL()) {
@@ -1167,7 +1168,7 @@ lbool Searcher::search()
     hist.clear();
     hist.reset_glue_hist_size(conf.shortTermHistorySize);
 
-    assert(solver->prop_at_head());
+    assert(solver->prop_at_head() || keep_trail_on_solution);
 
     //Loop until restart or finish (SAT/UNSAT)
     blocked_restart = false;
@@ -1231,6 +1232,17 @@ lbool Searcher::search()
             }
             #endif //USE_GAUSS
 
+            if (!update_bogoprops && solver->ext_prop) {
+                const llbool ret = solver->ext_prop->propagate();
+                if (ret == l_Continue) {
+                    check_need_restart();
+                    continue;
+                } else if (ret != l_Nothing) {
+                    dump_search_loop_stats(myTime);
+                    return ret;
+                }
+            }
+
             if (decisionLevel() == 0
                 && !clean_clauses_if_needed()
             ) {
@@ -1238,6 +1250,16 @@ lbool Searcher::search()
             };
             reduce_db_if_needed();
             dec_ret = new_decision<update_bogoprops>();
+            if (dec_ret == l_True && !update_bogoprops && solver->ext_prop) {
+                const llbool ret = solver->ext_prop->check_model();
+                if (ret == l_Continue) {
+                    dec_ret = l_Undef;
+                    continue;
+                } else if (ret != l_Nothing) {
+                    dump_search_loop_stats(myTime);
+                    return ret;
+                }
+            }
             if (dec_ret != l_Undef) {
                 dump_search_loop_stats(myTime);
                 return dec_ret;
@@ -1696,14 +1718,6 @@ Clause* Searcher::handle_last_confl_otf_subsumption(
             << fin;
             cl = NULL;
         } else {
-            cl = cl_alloc.Clause_new(learnt_clause
-            , sumConflicts
-            #ifdef STATS_NEEDED
-            , clauseID
-            #endif
-            );
-            cl->makeRed(glue);
-            ClOffset offset = cl_alloc.get_offset(cl);
             unsigned which_arr = 2;
 
             if (glue <= conf.glue_put_lev0_if_below_or_eq) {
@@ -1717,6 +1731,16 @@ Clause* Searcher::handle_last_confl_otf_subsumption(
                 which_arr = 2;
             }
 
+            cl = cl_alloc.Clause_new(learnt_clause
+            , sumConflicts
+            #ifdef STATS_NEEDED
+            , clauseID
+            #endif
+            , (ClRegion)((uint32_t)ClRegion::red_tier0 + which_arr)
+            );
+            cl->makeRed(glue);
+            ClOffset offset = cl_alloc.get_offset(cl);
+
             if (which_arr == 0) {
                 stats.red_cl_in_which0++;
             }
@@ -1864,6 +1888,9 @@ bool Searcher::handle_conflict(const PropBy confl)
     Clause* cl = handle_last_confl_otf_subsumption(subsumed_cl, glue, old_decision_level);
     assert(learnt_clause.size() <= 2 || cl != NULL);
     attach_and_enqueue_learnt_clause<update_bogoprops>(cl);
+    if (!update_bogoprops && learnt_stream) {
+        buffer_streamed_learnt(glue);
+    }
 
     //Add decision-based clause
     if (!update_bogoprops
@@ -2064,6 +2091,7 @@ void Searcher::reduce_db_if_needed()
         if (sumConflicts >= next_lev2_reduce) {
             solver->reduceDB->handle_lev2();
             cl_alloc.consolidate(solver);
+            solver->check_mem_budget(false);
             next_lev2_reduce = sumConflicts + conf.every_lev2_reduce;
         }
     } else {
@@ -2071,6 +2099,7 @@ void Searcher::reduce_db_if_needed()
             solver->reduceDB->handle_lev2();
             cur_max_temp_red_lev2_cls *= conf.inc_max_temp_lev2_red_cls;
             cl_alloc.consolidate(solver);
+            solver->check_mem_budget(false);
         }
     }
 }
@@ -2176,6 +2205,15 @@ bool Searcher::must_abort(const lbool status) {
         return true;
     }
 
+    if (solver->checkpoint_due()) {
+        if (conf.verbosity >= 3) {
+            cout
+            << "c search stopping to write a checkpoint"
+            << endl;
+        }
+        return true;
+    }
+
     return false;
 }
 
@@ -2183,7 +2221,8 @@ lbool Searcher::solve(
     const uint64_t _max_confls
 ) {
     assert(ok);
-    assert(qhead == trail.size());
+    //Enumeration continues with the banning clause's literal to propagate
+    assert(qhead == trail.size() || keep_trail_on_solution);
     max_confl_per_search_solve_call = _max_confls;
     num_search_called++;
     #ifdef SLOW_DEBUG
@@ -2240,7 +2279,13 @@ lbool Searcher::solve(
     }
     #endif //USE_GAUSS
 
+    if (solver->ext_prop) {
+        solver->ext_prop->start_search();
+    }
+
+    #ifdef SLOW_DEBUG
     assert(solver->check_order_heap_sanity());
+    #endif
     while(stats.conflStats.numConflicts < max_confl_per_search_solve_call
         && status == l_Undef
     ) {
@@ -2257,6 +2302,7 @@ lbool Searcher::solve(
         if (status == l_Undef) {
             adjust_phases_restarts();
         }
+        solver->flush_streams();
 
         if (must_abort(status)) {
             goto end;
@@ -2266,7 +2312,12 @@ lbool Searcher::solve(
             solver->conf.do_distill_clauses &&
             sumConflicts > next_distill
         ) {
-            if (!solver->distill_long_cls->distill(true, false)) {
+            if (conf.do_vivify_red) {
+                if (!solver->distill_long_cls->vivify_red()) {
+                    status = l_False;
+                    goto end;
+                }
+            } else if (!solver->distill_long_cls->distill(true, false)) {
                 status = l_False;
                 goto end;
             }
@@ -2436,7 +2487,7 @@ void Searcher::finish_up_solve(const lbool status)
                     , cpuTime()-myTime
                 );
             }
-        } else {
+        } else if (!keep_trail_on_solution) {
             cancelUntil(0);
         }
         print_solution_varreplace_status();
@@ -2556,8 +2607,8 @@ void Searcher::cache_based_morem_minim(vector<Lit>& cl)
 
         assert(solver->implCache.size() > lit.toInt());
         const TransCache& cache1 = solver->implCache[lit];
-        limit -= (int64_t)cache1.lits.size()/2;
-        for (const LitExtra litExtra: cache1.lits) {
+        limit -= (int64_t)cache1.size()/2;
+        for (const LitExtra litExtra: cache1) {
             assert(seen.size() > litExtra.getLit().toInt());
             if (seen[(~(litExtra.getLit())).toInt()]) {
                 stats.cacheShrinkedClause++;
@@ -2824,6 +2875,7 @@ llbool Searcher::Gauss_elimination()
                     #ifdef STATS_NEEDED
                     , clauseID++
                     #endif
+                    , ClRegion::red_tier2
                 );
 
                 conflPtr->set_gauss_temp_cl();
@@ -3153,10 +3205,7 @@ void Searcher::write_long_cls(
         Clause& cl = *cl_alloc.ptr(c);
         assert(cl.size() > 2);
         f.put_uint32_t(cl.size());
-        for(const Lit l: cl)
-        {
-            f.put_lit(l);
-        }
+        f.put_array(cl.begin(), cl.size());
         if (red) {
             assert(cl.red());
             f.put_struct(cl.stats);
@@ -3167,19 +3216,16 @@ void Searcher::write_long_cls(
 void Searcher::read_long_cls(
     SimpleInFile& f
     , const bool red
+    , const uint32_t tier
 ) {
     uint64_t num_cls = f.get_uint64_t();
 
     vector<Lit> tmp_cl;
     for(size_t i = 0; i < num_cls; i++)
     {
-        tmp_cl.clear();
-
         uint32_t sz = f.get_uint32_t();
-        for(size_t j = 0; j < sz; j++)
-        {
-            tmp_cl.push_back(f.get_lit());
-        }
+        tmp_cl.resize(sz);
+        f.get_array(tmp_cl.data(), sz);
         ClauseStats cl_stats;
         if (red) {
             f.get_struct(cl_stats);
@@ -3190,6 +3236,7 @@ void Searcher::read_long_cls(
         #ifdef STATS_NEEDED
         , cl_stats.ID
         #endif
+        , red ? (ClRegion)((uint32_t)ClRegion::red_tier0 + tier) : ClRegion::irred
         );
         if (red) {
             cl->makeRed(cl_stats.glue, cla_inc);
@@ -3198,16 +3245,9 @@ void Searcher::read_long_cls(
         attachClause(*cl);
         const ClOffset offs = cl_alloc.get_offset(cl);
         if (red) {
-            cl->stats.which_red_array = 2;
-            if (cl->stats.glue <= conf.glue_put_lev0_if_below_or_eq) {
-                cl->stats.which_red_array = 0;
-            } else if (cl->stats.glue <= conf.glue_put_lev1_if_below_or_eq
-                && conf.glue_put_lev1_if_below_or_eq != 0
-            ) {
-                cl->stats.which_red_array = 1;
-            }
-
-            longRedCls[0].push_back(cl->stats.which_red_array);
+            //Stays in the tier it was saved from
+            cl->stats.which_red_array = tier;
+            longRedCls[tier].push_back(offs);
             litStats.redLits += cl->size();
         } else {
             longIrredCls.push_back(offs);
@@ -3268,6 +3308,18 @@ void Searcher::save_state(SimpleOutFile& f, const lbool status) const
     f.put_vector(model);
     f.put_vector(conflict);
 
+    //Search heuristics, so a resumed search continues warm
+    f.put_uint32_t(sumConflicts);
+    f.put_struct(var_inc_vsids);
+    f.put_struct(var_decay_vsids);
+    f.put_struct(step_size);
+    f.put_struct(cla_inc);
+    f.put_uint64_t(luby_loop_num);
+    f.put_struct(max_confl_phase);
+    f.put_struct(max_confl_this_phase);
+    f.put_uint64_t(next_lev1_reduce);
+    f.put_uint64_t(next_lev2_reduce);
+
     //Clauses
     if (status == l_Undef) {
         write_binary_cls(f, false);
@@ -3296,13 +3348,24 @@ void Searcher::load_state(SimpleInFile& f, const lbool status)
     f.get_vector(model);
     f.get_vector(conflict);
 
+    sumConflicts = f.get_uint32_t();
+    f.get_struct(var_inc_vsids);
+    f.get_struct(var_decay_vsids);
+    f.get_struct(step_size);
+    f.get_struct(cla_inc);
+    luby_loop_num = f.get_uint64_t();
+    f.get_struct(max_confl_phase);
+    f.get_struct(max_confl_this_phase);
+    next_lev1_reduce = f.get_uint64_t();
+    next_lev2_reduce = f.get_uint64_t();
+
     //Clauses
     if (status == l_Undef) {
         binTri.irredBins = read_binary_cls(f, false);
         binTri.redBins =read_binary_cls(f, true);
-        read_long_cls(f, false);
+        read_long_cls(f, false, 0);
         for(size_t i = 0; i < longRedCls.size(); i++) {
-            read_long_cls(f, true);
+            read_long_cls(f, true, i);
         }
     }
 }
@@ -3330,6 +3393,9 @@ void Searcher::cancelUntil(uint32_t level)
         for (EGaussian* gauss: gmatrixes)
             gauss->canceling(trail_lim[level]);
         #endif //USE_GAUSS
+        if (solver->ext_prop) {
+            solver->ext_prop->canceling(level);
+        }
 
         //Go through in reverse order, unassign & insert then
         //back to the vars to be branched upon
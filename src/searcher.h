@@ -24,6 +24,7 @@ THE SOFTWARE.
 #define __SEARCHER_H__
 
 #include <array>
+#include <functional>
 
 #include "propengine.h"
 #include "solvertypes.h"
@@ -192,6 +193,7 @@ class Searcher : public HyperEngine
         void read_long_cls(
             SimpleInFile& f
             , const bool red
+            , const uint32_t tier
         );
         uint64_t read_binary_cls(
             SimpleInFile& f
@@ -236,6 +238,23 @@ class Searcher : public HyperEngine
         //insided this array twice, once it needs to be set to TRUE and once FALSE
         vector<AssumptionPair> assumptions;
 
+        //Solutions are enumerated by searching on from their trail
+        bool keep_trail_on_solution = false;
+
+        //Streaming learnt clauses and progress to the library user. Clauses
+        //are buffered during search and handed over at restarts
+        std::function<void(const vector<Lit>& clause)> learnt_stream;
+        uint32_t learnt_stream_max_len = 0;
+        uint32_t learnt_stream_max_glue = 0;
+        uint32_t learnt_stream_max_per_restart = 0;
+        vector<Lit> learnt_stream_lits;
+        vector<uint32_t> learnt_stream_ends; ///<Clause i ends at learnt_stream_lits[learnt_stream_ends[i]]
+        size_t learnt_stream_trail_at = 0; ///<Units before this have been streamed
+        std::function<void(const SearchProgress& progress)> progress_stream;
+        uint64_t progress_stream_every = 0;
+        uint64_t progress_stream_next = 0;
+        void buffer_streamed_learnt(const uint32_t glue);
+
         void update_assump_conflict_to_orig_outside(vector<Lit>& out_conflict);
 
 
@@ -397,6 +416,7 @@ class Searcher : public HyperEngine
         };
         friend class Gaussian;
         friend class DistillerLong;
+        friend class ReduceDB;
         #ifdef CMS_TESTING_ENABLED
         FRIEND_TEST(SearcherTest, pickpolar_rnd);
         FRIEND_TEST(SearcherTest, pickpolar_pos);
@@ -453,6 +473,20 @@ class Searcher : public HyperEngine
         SearchStats stats;
 };
 
+inline void Searcher::buffer_streamed_learnt(const uint32_t glue)
+{
+    //Units are streamed from the trail
+    if (learnt_clause.size() < 2
+        || learnt_clause.size() > learnt_stream_max_len
+        || glue > learnt_stream_max_glue
+        || learnt_stream_ends.size() >= learnt_stream_max_per_restart
+    ) {
+        return;
+    }
+    learnt_stream_lits.insert(learnt_stream_lits.end(), learnt_clause.begin(), learnt_clause.end());
+    learnt_stream_ends.push_back(learnt_stream_lits.size());
+}
+
 inline uint32_t Searcher::abstractLevel(const uint32_t x) const
 {
     return ((uint32_t)1) << (varData[x].level & 31);
@@ -70,6 +70,10 @@ SearchStats& SearchStats::operator+=(const SearchStats& other)
     otfSubsumedLitsGained += other.otfSubsumedLitsGained;
     cache_hit += other.cache_hit;
     red_cl_in_which0 += other.red_cl_in_which0;
+    reduceDB_lev1 += other.reduceDB_lev1;
+    reduceDB_lev2 += other.reduceDB_lev2;
+    reduceDB_removed += other.reduceDB_removed;
+    reduceDB_time += other.reduceDB_time;
 
     //Hyper-bin & transitive reduction
     advancedPropCalled += other.advancedPropCalled;
@@ -132,6 +136,10 @@ SearchStats& SearchStats::operator-=(const SearchStats& other)
     otfSubsumedLitsGained -= other.otfSubsumedLitsGained;
     cache_hit -= other.cache_hit;
     red_cl_in_which0 -= other.red_cl_in_which0;
+    reduceDB_lev1 -= other.reduceDB_lev1;
+    reduceDB_lev2 -= other.reduceDB_lev2;
+    reduceDB_removed -= other.reduceDB_removed;
+    reduceDB_time -= other.reduceDB_time;
 
     //Hyper-bin & transitive reduction
     advancedPropCalled -= other.advancedPropCalled;
@@ -280,6 +288,17 @@ void SearchStats::print(uint64_t props, bool do_print_times) const
         , "% of confl"
     );
 
+    print_stats_line("c reduceDB lev1/lev2/removed"
+        , reduceDB_lev1
+        , reduceDB_lev2
+        , reduceDB_removed
+    );
+    print_stats_line("c reduceDB time"
+        , reduceDB_time
+        , stats_line_percent(reduceDB_time, cpu_time)
+        , "% of search time"
+    );
+
     cout << "c SEAMLESS HYPERBIN&TRANS-RED stats" << endl;
     print_stats_line("c advProp called"
         , advancedPropCalled
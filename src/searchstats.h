@@ -89,6 +89,12 @@ public:
     uint64_t cache_hit = 0;
     uint64_t red_cl_in_which0 = 0;
 
+    //Learnt clause DB reduction
+    uint64_t reduceDB_lev1 = 0;
+    uint64_t reduceDB_lev2 = 0;
+    uint64_t reduceDB_removed = 0;
+    double reduceDB_time = 0.0;
+
     //Hyper-bin & transitive reduction
     uint64_t advancedPropCalled = 0;
     uint64_t hyperBinAdded = 0;
@@ -67,3 +67,12 @@ void SIGINT_handler(int)
         #endif
     }
 }
+
+//Asks for a checkpoint to be written, without stopping
+void SIGUSR1_handler(int)
+{
+    SATSolver* solver = solverToInterrupt;
+    if (solver) {
+        solver->request_checkpoint();
+    }
+}
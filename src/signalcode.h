@@ -36,5 +36,6 @@ extern int need_clean_exit;
 extern std::string redDumpFname;
 extern std::string irredDumpFname;
 void SIGINT_handler(int);
+void SIGUSR1_handler(int);
 
 #endif //SIGNALCODE_H_
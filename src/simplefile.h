@@ -27,6 +27,13 @@ THE SOFTWARE.
 #include <iostream>
 #include <string>
 #include <cstdint>
+#include <cstring>
+#if !defined(_MSC_VER)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 using std::ios;
 
 #include "solvertypes.h"
@@ -79,6 +86,12 @@ public:
         put(&d[0], d.size() * sizeof(T));
     }
 
+    template<class T>
+    void put_array(const T* d, const size_t num)
+    {
+        put(d, num * sizeof(T));
+    }
+
     template<class T>
     void put_struct(const T& d)
     {
@@ -95,11 +108,35 @@ private:
     }
 };
 
+/**
+@brief Reads back what SimpleOutFile wrote
+
+The file is mapped into memory where possible, so reading is a memcpy() out
+of the page cache.
+*/
 class SimpleInFile
 {
 public:
     void start(const string& fname)
     {
+        #if !defined(_MSC_VER)
+        fd = open(fname.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd == -1 || fstat(fd, &st) != 0) {
+            cout << "Error opening file " << fname.c_str() << endl;
+            exit(-1);
+        }
+        size = st.st_size;
+        if (size > 0) {
+            void* m = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m == MAP_FAILED) {
+                cout << "Error mapping file " << fname.c_str() << endl;
+                exit(-1);
+            }
+            data = (const char*)m;
+            madvise(m, size, MADV_SEQUENTIAL);
+        }
+        #else
         try {
             inf = new std::ifstream(fname.c_str(), ios::in | ios::binary);
             inf->exceptions(~std::ios::goodbit);
@@ -107,24 +144,34 @@ public:
             cout << "Error opening file " << fname.c_str() << endl;
             exit(-1);
         }
+        #endif
     }
 
     ~SimpleInFile()
     {
+        #if !defined(_MSC_VER)
+        if (data != NULL) {
+            munmap((void*)data, size);
+        }
+        if (fd != -1) {
+            ::close(fd);
+        }
+        #else
         delete inf;
+        #endif
     }
 
     uint32_t get_uint32_t()
     {
         uint32_t val = 0;
-        inf->read((char*)&val, 4);
+        get_raw(&val, 1, 4);
         return val;
     }
 
     uint64_t get_uint64_t()
     {
         uint64_t val = 0;
-        inf->read((char*)&val, 8);
+        get_raw(&val, 1, 8);
         return val;
     }
 
@@ -137,14 +184,15 @@ public:
     lbool get_lbool()
     {
         lbool l;
-        inf->read((char*)&l, sizeof(lbool));
+        get_raw(&l, 1, sizeof(lbool));
         return l;
     }
 
+    ///Overwrites "d"
     template<class T>
     void get_vector(vector<T>& d)
     {
-        assert(d.empty());
+        d.clear();
         uint64_t sz = get_uint64_t();
         if (sz == 0)
             return;
@@ -153,19 +201,45 @@ public:
         get_raw(&d[0], d.size(), sizeof(T));
     }
 
+    template<class T>
+    void get_array(T* d, const size_t num)
+    {
+        get_raw(d, num, sizeof(T));
+    }
+
     template<class T>
     void get_struct(T& d)
     {
-        inf->read((char*)&d, sizeof(T));
+        get_raw(&d, 1, sizeof(T));
     }
 
 private:
+    #if !defined(_MSC_VER)
+    int fd = -1;
+    const char* data = NULL;
+    size_t size = 0;
+    size_t at = 0;
+
+    void get_raw(void* ptr, size_t num, size_t elem_sz)
+    {
+        const size_t bytes = num*elem_sz;
+        if (bytes > size - at) {
+            cout << "Error: file is truncated" << endl;
+            exit(-1);
+        }
+        if (bytes > 0) {
+            memcpy(ptr, data + at, bytes);
+        }
+        at += bytes;
+    }
+    #else
     std::ifstream* inf = NULL;
 
     void get_raw(void* ptr, size_t num, size_t elem_sz)
     {
         inf->read((char*)ptr, num*elem_sz);
     }
+    #endif
 };
 
 }
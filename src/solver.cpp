@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "completedetachreattacher.h"
 #include "compfinder.h"
 #include "comphandler.h"
+#include "extprophandler.h"
 #include "subsumestrengthen.h"
 #include "watchalgos.h"
 #include "clauseallocator.h"
@@ -84,6 +85,8 @@ Solver::Solver(const SolverConf *_conf, std::atomic<bool>* _must_interrupt_inter
     Searcher(_conf, this, _must_interrupt_inter)
 {
     sqlStats = NULL;
+    checkpoint_requested = false;
+    next_checkpoint_time = conf.checkpoint_every_secs;
 
     if (conf.doProbe) {
         prober = new Prober(this);
@@ -116,6 +119,7 @@ Solver::Solver(const SolverConf *_conf, std::atomic<bool>* _must_interrupt_inter
 
 Solver::~Solver()
 {
+    delete ext_prop;
     delete compHandler;
     delete sqlStats;
     delete prober;
@@ -413,6 +417,11 @@ Clause* Solver::add_clause_int(
         }
     }
 
+    //Keep the components up-to-date
+    if (!red && ps.size() >= 2 && compHandler) {
+        compHandler->new_irred_clause(ps);
+    }
+
     //Handle special cases
     switch (ps.size()) {
         case 0:
@@ -445,6 +454,7 @@ Clause* Solver::add_clause_int(
             #ifdef STATS_NEEDED
             , cl_stats.ID
             #endif
+            , red ? ClRegion::red_tier2 : ClRegion::irred
             );
             if (red) {
                 c->makeRed(cl_stats.glue);
@@ -646,7 +656,7 @@ bool Solver::addClause(const vector<Lit>& lits, bool red)
     return Solver::addClauseInt(ps, red);
 }
 
-bool Solver::addClauseInt(vector<Lit>& ps, bool red)
+bool Solver::addClauseInt(vector<Lit>& ps, bool red, const ClauseStats& cl_stats)
 {
     if (conf.perform_occur_based_simp && occsimplifier->getAnythingHasBeenBlocked()) {
         std::cerr
@@ -675,7 +685,7 @@ bool Solver::addClauseInt(vector<Lit>& ps, bool red)
     Clause *cl = add_clause_int(
         ps
         , red
-        , ClauseStats() //default stats
+        , cl_stats
         , true //yes, attach
         , pFinalCl
         , false //add drat?
@@ -917,6 +927,9 @@ bool Solver::renumber_variables(bool must_renumber)
         interToOuter2[i*2+1] = interToOuter[i]*2+1;
     }
 
+    //The trail is lost below, stream the units on it first
+    flush_streams();
+
     renumber_clauses(outerToInter);
     CNF::updateVars(outerToInter, interToOuter);
     PropEngine::updateVars(outerToInter, interToOuter, interToOuter2);
@@ -1078,9 +1091,7 @@ void Solver::set_assumptions()
     conflict.clear();
     assumptions.clear();
 
-    back_number_from_outside_to_outer(outside_assumptions);
-    vector<Lit> inter_assumptions = back_number_from_outside_to_outer_tmp;
-    addClauseHelper(inter_assumptions);
+    translate_assumptions();
     assumptionsSet.resize(nVars(), false);
     if (outside_assumptions.empty()) {
         return;
@@ -1096,6 +1107,48 @@ void Solver::set_assumptions()
     fill_assumptions_set_from(assumptions);
 }
 
+//Incremental callers mostly keep a prefix of the last call's assumptions, so
+//only what comes after it is translated. The old translation is only good
+//while no simplification could have renumbered, replaced or eliminated a
+//variable, and no variable was added.
+void Solver::translate_assumptions()
+{
+    size_t keep = 0;
+    if (inter_assumptions_at_simp == solveStats.numSimplify
+        && inter_assumptions_at_vars == nVars()
+        && inter_assumptions_at_vars_outer == nVarsOuter()
+    ) {
+        while(keep < outside_assumptions.size()
+            && keep < inter_assumptions_of.size()
+            && outside_assumptions[keep] == inter_assumptions_of[keep]
+        ) {
+            keep++;
+        }
+    }
+    inter_assumptions.resize(keep);
+    inter_assumptions_of = outside_assumptions;
+
+    if (keep < outside_assumptions.size()) {
+        back_number_from_outside_to_outer(
+            outside_assumptions.data() + keep
+            , outside_assumptions.size() - keep
+        );
+        inter_assumptions_added = back_number_from_outside_to_outer_tmp;
+        addClauseHelper(inter_assumptions_added);
+        inter_assumptions.insert(
+            inter_assumptions.end()
+            , inter_assumptions_added.begin()
+            , inter_assumptions_added.end()
+        );
+    }
+
+    //Re-inserted variables only move around the unused ones, so the kept
+    //part is still good, but the next call must compare to the new numbers
+    inter_assumptions_at_simp = solveStats.numSimplify;
+    inter_assumptions_at_vars = nVars();
+    inter_assumptions_at_vars_outer = nVarsOuter();
+}
+
 void Solver::check_model_for_assumptions() const
 {
     for(const AssumptionPair lit_pair: assumptions) {
@@ -1241,8 +1294,10 @@ void Solver::extend_solution(const bool only_indep_solution)
         solver->varReplacer->extend_model_already_set();
     }
 
-    //map back without BVA
-    model = map_back_to_without_bva(model);
+    //map back without BVA, nothing to do if there are no BVA vars
+    if (get_num_bva_vars() > 0) {
+        model = map_back_to_without_bva(model);
+    }
     if (conf.need_decisions_reaching) {
         decisions_reaching_model_valid = true;
         const vector<uint32_t> my_map = build_outer_to_without_bva_map();
@@ -1390,6 +1445,10 @@ lbool Solver::solve_with_assumptions(
     const bool only_indep_solution
 ) {
     fresh_solver = false;
+    const bool resumed = !conf.resume_file.empty() && nVarsOuter() == 0;
+    if (resumed) {
+        resume_from_checkpoint();
+    }
     decisions_reaching_model.clear();
     decisions_reaching_model_valid = false;
     move_to_outside_assumps(_assumptions);
@@ -1406,14 +1465,16 @@ lbool Solver::solve_with_assumptions(
     solveStats.num_solve_calls++;
     conflict.clear();
     check_config_parameters();
-    luby_loop_num = 0;
-
-    //Reset parameters
-    max_confl_phase = conf.restart_first;
-    max_confl_this_phase = max_confl_phase;
     VSIDS = true;
-    var_decay_vsids = conf.var_decay_vsids_start;
-    step_size = conf.orig_step_size;
+
+    //Reset parameters, unless they came from a checkpoint
+    if (!resumed) {
+        luby_loop_num = 0;
+        max_confl_phase = conf.restart_first;
+        max_confl_this_phase = max_confl_phase;
+        var_decay_vsids = conf.var_decay_vsids_start;
+        step_size = conf.orig_step_size;
+    }
     conf.global_timeout_multiplier = conf.orig_global_timeout_multiplier;
     params.rest_type = conf.restartType;
     if (params.rest_type == Restart::glue_geom) {
@@ -1469,6 +1530,22 @@ lbool Solver::solve_with_assumptions(
         status = simplify_problem(!conf.full_simplify_at_startup);
     }
 
+    //Lots of small incremental calls never run out of their own conflict
+    //budget, so inprocess here once they did enough conflicts together.
+    //The schedule stops between steps once this call's time budget is used.
+    if (status == l_Undef
+        && nVars() > 0
+        && conf.do_simplify_problem
+        && conf.simplify_every_confl_incremental > 0
+        && solveStats.num_solve_calls > 1
+        && sumConflicts - solveStats.last_simplify_confl >= conf.simplify_every_confl_incremental
+    ) {
+        const double orig_max_time = conf.maxTime;
+        conf.maxTime = std::min(conf.maxTime, cpuTime() + conf.simplify_incremental_max_time);
+        status = simplify_problem(false);
+        conf.maxTime = orig_max_time;
+    }
+
     if (status == l_Undef
         && conf.preprocess == 0
     ) {
@@ -1512,26 +1589,248 @@ lbool Solver::solve_with_assumptions(
     return status;
 }
 
+lbool Solver::enumerate_solutions(
+    const vector<Lit>* _assumptions
+    , const bool only_indep_solution
+    , const EnumerateParams& _params
+) {
+    assert(_params.callback);
+    enum_vars.clear();
+    if (_params.projection) {
+        enum_vars = *_params.projection;
+    } else if (conf.independent_vars) {
+        enum_vars = *conf.independent_vars;
+    } else {
+        for(uint32_t var = 0; var < nVarsOutside(); var++) {
+            enum_vars.push_back(var);
+        }
+    }
+    for(const uint32_t var: enum_vars) {
+        if (var >= nVarsOutside()) {
+            std::cerr << "ERROR: Projection variable " << var+1
+            << " is too large, you never inserted that variable into the"
+            << " solver. Exiting." << endl;
+            exit(-1);
+        }
+    }
+
+    //Banned solutions are found on the search trail, so the projection
+    //must stay in the search. Without projection the decisions determine
+    //the whole solution, unless BVA added variables of its own
+    for(const uint32_t var: enum_vars) {
+        freeze_var(var);
+    }
+    enum_ban_decisions = _params.decision_blocking
+        && !_params.projection
+        && !conf.independent_vars
+        && nVarsOuter() == nVarsOutside();
+
+    enum_params = &_params;
+    enum_only_indep = only_indep_solution;
+    enum_num_found = 0;
+    keep_trail_on_solution = true;
+    const lbool status = solve_with_assumptions(_assumptions, only_indep_solution);
+    keep_trail_on_solution = false;
+    enum_params = NULL;
+
+    for(const uint32_t var: enum_vars) {
+        melt_var(var);
+    }
+    return status;
+}
+
+lbool Solver::report_enumerated_solution()
+{
+    assert(enum_params);
+
+    //Needs the search trail, so before the model is extended
+    enum_ban_cl.clear();
+    if (enum_ban_decisions) {
+        for(size_t i = 0; i < trail_lim.size(); i++) {
+            //Dummy decision levels may point to the next level's decision
+            if (trail_lim[i] < trail.size()) {
+                const Lit lit = ~trail[trail_lim[i]];
+                if (!seen[lit.toInt()]) {
+                    seen[lit.toInt()] = 1;
+                    enum_ban_cl.push_back(lit);
+                }
+            }
+        }
+    } else {
+        for(const uint32_t var: enum_vars) {
+            Lit lit = Lit(map_to_with_bva(var), false);
+            lit = varReplacer->get_lit_replaced_with_outer(lit);
+            lit = map_outer_to_inter(lit);
+            assert(varData[lit.var()].removed == Removed::none);
+            assert(value(lit) != l_Undef);
+            if (value(lit) == l_True) {
+                lit = ~lit;
+            }
+            if (!seen[lit.toInt()]) {
+                seen[lit.toInt()] = 1;
+                enum_ban_cl.push_back(lit);
+            }
+        }
+    }
+    for(const Lit lit: enum_ban_cl) {
+        seen[lit.toInt()] = 0;
+    }
+    if (enum_params->ban_guard != lit_Undef) {
+        Lit lit = map_to_with_bva(enum_params->ban_guard);
+        lit = varReplacer->get_lit_replaced_with_outer(lit);
+        enum_ban_cl.push_back(map_outer_to_inter(lit));
+    }
+
+    extend_solution(enum_only_indep);
+    model_already_extended = true;
+    enum_num_found++;
+    if (!enum_params->callback(model)
+        || enum_num_found >= enum_params->max_solutions
+    ) {
+        return l_True;
+    }
+    model_already_extended = false;
+    decisions_reaching_model.clear();
+
+    if (!add_clause_in_search(enum_ban_cl, false)) {
+        return l_False;
+    }
+    return l_Undef;
+}
+
+//Adds a clause in the middle of the search. Only backtracks as far as needed
+//for the clause to be watched correctly, and enqueues its first literal if it
+//became unit there. Returns FALSE if the problem became UNSAT
+bool Solver::add_clause_in_search(vector<Lit>& cl, const bool red)
+{
+    #ifdef USE_GAUSS
+    cancelUntil(0);
+    #endif
+
+    //Remove duplicates and literals set at level 0
+    std::sort(cl.begin(), cl.end());
+    Lit prev = lit_Undef;
+    size_t j = 0;
+    for(size_t i = 0; i < cl.size(); i++) {
+        const Lit lit = cl[i];
+        if (lit == ~prev
+            || (value(lit) == l_True && varData[lit.var()].level == 0)
+        ) {
+            return true;
+        }
+        if (lit == prev
+            || (value(lit) == l_False && varData[lit.var()].level == 0)
+        ) {
+            continue;
+        }
+        cl[j++] = lit;
+        prev = lit;
+    }
+    cl.resize(j);
+
+    *drat << add << cl
+    #ifdef STATS_NEEDED
+    << clauseID++
+    << sumConflicts
+    #endif
+    << fin;
+
+    if (cl.empty()) {
+        cancelUntil(0);
+        ok = false;
+        return false;
+    }
+    if (cl.size() == 1) {
+        cancelUntil(0);
+        enqueue(cl[0]);
+        return true;
+    }
+
+    //Put the two best literals to watch first: not false, or false as late
+    //as possible
+    for(size_t k = 0; k < 2; k++) {
+        size_t best = k;
+        for(size_t i = k+1; i < cl.size(); i++) {
+            const Lit a = cl[i];
+            const Lit b = cl[best];
+            if ((value(b) == l_False && value(a) != l_False)
+                || (value(b) == l_False && value(a) == l_False
+                    && varData[a.var()].level > varData[b.var()].level)
+            ) {
+                best = i;
+            }
+        }
+        std::swap(cl[k], cl[best]);
+    }
+
+    bool enq = false;
+    if (value(cl[1]) == l_False) {
+        const uint32_t lev0 = varData[cl[0].var()].level;
+        const uint32_t lev1 = varData[cl[1].var()].level;
+        if (value(cl[0]) == l_False && lev0 == lev1) {
+            //Conflicting on its own level, it will be found again from one below
+            cancelUntil(lev1-1);
+        } else if (value(cl[0]) != l_True || lev0 > lev1) {
+            cancelUntil(lev1);
+            enq = true;
+        }
+    }
+
+    if (!red && compHandler) {
+        compHandler->new_irred_clause(cl);
+    }
+    if (cl.size() == 2) {
+        attach_bin_clause(cl[0], cl[1], red, false);
+        if (enq) {
+            enqueue(cl[0], PropBy(cl[1], red));
+        }
+    } else {
+        Clause* c = cl_alloc.Clause_new(cl
+            , sumConflicts
+            #ifdef STATS_NEEDED
+            , clauseID++
+            #endif
+            , red ? ClRegion::red_tier2 : ClRegion::irred
+        );
+        const ClOffset offset = cl_alloc.get_offset(c);
+        if (red) {
+            c->makeRed(cl.size());
+            c->stats.which_red_array = 2;
+            longRedCls[2].push_back(offset);
+        } else {
+            longIrredCls.push_back(offset);
+        }
+        attachClause(*c, false);
+        if (enq) {
+            enqueue(cl[0], PropBy(offset));
+        }
+    }
+    return true;
+}
+
 void Solver::check_reconfigure()
 {
+    //Cheap checks first, this is called by every solve()
+    if (already_reconfigured
+        || conf.reconfigure_val == 0
+        || solveStats.numSimplify != conf.reconfigure_at
+    ) {
+        return;
+    }
+
     if (nVars() > 2
         && longIrredCls.size() > 1
         && (binTri.irredBins + binTri.redBins) > 1
     ) {
-        if (solveStats.numSimplify == conf.reconfigure_at &&
-            !already_reconfigured
-        ) {
-            check_calc_features();
-            if (conf.reconfigure_val == 100) {
-                conf.reconfigure_val = get_reconf_from_features(last_solve_feature, conf.verbosity);
-            }
-            if (conf.reconfigure_val != 0) {
-                reconfigure(conf.reconfigure_val);
-                already_reconfigured = true;
-            }
+        check_calc_features();
+        if (conf.reconfigure_val == 100) {
+            conf.reconfigure_val = get_reconf_from_features(last_solve_feature, conf.verbosity);
+        }
+        if (conf.reconfigure_val != 0) {
+            reconfigure(conf.reconfigure_val);
         }
+        already_reconfigured = true;
     }
-
 }
 
 void Solver::dump_memory_stats_to_sql()
@@ -1707,18 +2006,41 @@ lbool Solver::iterate_until_solved()
         }
 	// BD: iteration_num is not used and causes a compilation warning
 	//        status = Searcher::solve(num_confl, iteration_num);
-	status = Searcher::solve(num_confl);
-
-        //Check for effectiveness
-        check_recursive_minimization_effectiveness(status);
-        check_minimization_effectiveness(status);
-
-        //Update stats
-        sumSearchStats += Searcher::get_stats();
-        sumPropStats += propStats;
-        propStats.clear();
-        Searcher::resetStats();
-        check_too_many_low_glues();
+        const uint64_t confl_before = sumConflicts;
+        bool search_on = true;
+        while (search_on) {
+            status = Searcher::solve(num_confl - (long)(sumConflicts - confl_before));
+
+            //Check for effectiveness
+            check_recursive_minimization_effectiveness(status);
+            check_minimization_effectiveness(status);
+
+            //Update stats
+            sumSearchStats += Searcher::get_stats();
+            sumPropStats += propStats;
+            propStats.clear();
+            Searcher::resetStats();
+            check_too_many_low_glues();
+
+            //When enumerating, report the solution, ban it, and search on
+            //from where it was found
+            search_on = false;
+            if (status == l_True && enum_params) {
+                status = report_enumerated_solution();
+                search_on = status == l_Undef
+                    && sumConflicts - confl_before < (uint64_t)num_confl
+                    && !must_interrupt_asap()
+                    && cpuTime() < conf.maxTime;
+                if (status == l_Undef && !search_on) {
+                    //The banning clause may have left a unit to propagate
+                    cancelUntil(0);
+                    if (!propagate<false>().isNULL()) {
+                        ok = false;
+                        status = l_False;
+                    }
+                }
+            }
+        }
 
         //Solution has been found
         if (status != l_Undef) {
@@ -1733,6 +2055,19 @@ lbool Solver::iterate_until_solved()
             break;
         }
 
+        if (checkpoint_due()) {
+            write_checkpoint();
+            if (!okay()) {
+                status = l_False;
+                break;
+            }
+
+            //Search was cut short for the checkpoint, carry on with it
+            if (sumConflicts - confl_before < (uint64_t)num_confl) {
+                continue;
+            }
+        }
+
         if (conf.do_simplify_problem) {
             status = simplify_problem(false);
         }
@@ -1754,6 +2089,14 @@ lbool Solver::iterate_until_solved()
             VSIDS = true;
         }
     }
+
+    //Stopped by a limit or an interrupt, leave a checkpoint to resume from
+    if (status == l_Undef && !conf.checkpoint_file.empty()) {
+        write_checkpoint();
+        if (!okay()) {
+            status = l_False;
+        }
+    }
     #ifdef USE_GAUSS
     clearEnGaussMatrixes();
     #endif
@@ -1784,7 +2127,10 @@ void Solver::check_too_many_low_glues()
 void Solver::handle_found_solution(const lbool status, const bool only_indep_solution)
 {
     if (status == l_True) {
-        extend_solution(only_indep_solution);
+        if (!model_already_extended) {
+            extend_solution(only_indep_solution);
+        }
+        model_already_extended = false;
         cancelUntil(0);
 
         #ifdef DEBUG_ATTACH_MORE
@@ -1931,19 +2277,20 @@ bool Solver::execute_inprocess_strategy(
                 dist_impl_with_impl->str_impl_w_impl_stamp();
             }
         } else if (token == "check-cache-size") {
-            //Delete and disable cache if too large
+            //Evict least recently used caches if too large
             if (conf.doCache) {
                 const size_t memUsedMB = implCache.mem_used()/(1024UL*1024UL);
                 if (memUsedMB > conf.maxCacheSizeMB) {
+                    const size_t limit = (size_t)conf.maxCacheSizeMB*1024ULL*1024ULL;
+                    const size_t freed = implCache.evict_lru(limit - limit/5);
                     if (conf.verbosity) {
                         cout
-                        << "c Turning off cache, memory used, "
+                        << "c [cache] memory used "
                         << memUsedMB << " MB"
-                        << " is over limit of " << conf.maxCacheSizeMB  << " MB"
+                        << " is over limit of " << conf.maxCacheSizeMB  << " MB,"
+                        << " evicted " << freed/(1024UL*1024UL) << " MB"
                         << endl;
                     }
-                    implCache.free();
-                    conf.doCache = false;
                 }
             }
         } else if (token == "cl-consolidate") {
@@ -2009,6 +2356,7 @@ lbool Solver::simplify_problem(const bool startup)
     #ifdef USE_GAUSS
     clearEnGaussMatrixes();
     #endif
+    check_mem_budget(true);
 
     if (conf.verbosity >= 6) {
         cout
@@ -2038,6 +2386,7 @@ lbool Solver::simplify_problem(const bool startup)
         cout << "c global_timeout_multiplier: " << conf. global_timeout_multiplier << endl;
 
     solveStats.numSimplify++;
+    solveStats.last_simplify_confl = sumConflicts;
 
     if (!ok) {
         return l_False;
@@ -2357,6 +2706,9 @@ void Solver::print_full_restart_stat(const double cpu_time, const double cpu_tim
                     , stats_line_percent(distill_long_cls->get_stats().time_used, cpu_time)
                     , "% time");
     distill_long_cls->get_stats().print(nVarsOuter());
+    if (conf.do_vivify_red) {
+        distill_long_cls->get_viv_stats().print();
+    }
 
     if (conf.do_print_times)
     print_stats_line("c strength cache-irred time"
@@ -2418,6 +2770,9 @@ size_t Solver::mem_used() const
     size_t mem = 0;
     mem += Searcher::mem_used();
     mem += outside_assumptions.capacity()*sizeof(Lit);
+    mem += inter_assumptions.capacity()*sizeof(Lit);
+    mem += inter_assumptions_of.capacity()*sizeof(Lit);
+    mem += inter_assumptions_added.capacity()*sizeof(Lit);
 
     return mem;
 }
@@ -2431,6 +2786,167 @@ uint64_t Solver::mem_used_vardata() const
     return mem;
 }
 
+uint64_t Solver::mem_used_total() const
+{
+    uint64_t mem = 0;
+    mem += mem_used_longclauses();
+    mem += watches.mem_used_alloc();
+    mem += watches.mem_used_array();
+    mem += mem_used_vardata();
+    mem += implCache.mem_used();
+    mem += mem_used_stamp();
+    mem += mem_used();
+    mem += CNF::mem_used_renumberer();
+    if (compHandler) {
+        mem += compHandler->mem_used();
+    }
+    if (occsimplifier) {
+        mem += occsimplifier->mem_used();
+        mem += occsimplifier->mem_used_xor();
+    }
+    mem += varReplacer->mem_used();
+    if (subsumeImplicit) {
+        mem += subsumeImplicit->mem_used();
+    }
+    mem += distill_long_cls->mem_used();
+    mem += dist_long_with_impl->mem_used();
+    mem += dist_impl_with_impl->mem_used();
+    if (prober) {
+        mem += prober->mem_used();
+        mem += intree->mem_used();
+    }
+    #ifdef USE_GAUSS
+    for(const EGaussian* g: gmatrixes) {
+        mem += g->mem_used();
+    }
+    #endif
+
+    return mem;
+}
+
+static const char* mem_shed_to_string(const MemShed what)
+{
+    switch(what) {
+        case MemShed::red_tier2:
+            return "red-tier2";
+        case MemShed::red_tier1:
+            return "red-tier1";
+        case MemShed::impl_cache:
+            return "impl-cache";
+        case MemShed::stamps:
+            return "stamps";
+        case MemShed::gauss:
+            return "gauss";
+        case MemShed::occur_limits:
+            return "occur-limits";
+        case MemShed::end:
+            break;
+    }
+
+    assert(false);
+    return "";
+}
+
+//Returns whether anything could be given up
+bool Solver::shed_mem(const MemShed what)
+{
+    switch(what) {
+        case MemShed::red_tier2:
+        case MemShed::red_tier1: {
+            const size_t removed = reduceDB->shed_lev(what == MemShed::red_tier2 ? 2 : 1);
+            memBudgetStats.redClsShed += removed;
+            return removed > 0;
+        }
+
+        case MemShed::impl_cache:
+            if (!conf.doCache) {
+                return false;
+            }
+            implCache.free();
+            conf.doCache = false;
+            return true;
+
+        case MemShed::stamps:
+            if (!conf.doStamp) {
+                return false;
+            }
+            stamp.freeMem();
+            conf.doStamp = false;
+            return true;
+
+        case MemShed::gauss:
+            #ifdef USE_GAUSS
+            //Matrices are cleared before every simplification, this stops
+            //them from being re-built
+            if (conf.gaussconf.decision_until == 0) {
+                return false;
+            }
+            conf.gaussconf.decision_until = 0;
+            return true;
+            #else
+            return false;
+            #endif
+
+        case MemShed::occur_limits: {
+            //Only link in what fits into what's left of the budget
+            const uint64_t used = mem_used_total();
+            const uint64_t budget = conf.mem_budget_MB*1024ULL*1024ULL;
+            const double left_MB = used >= budget ? 0 :
+                (double)(budget - used)/(1000.0*1000.0);
+            if (conf.maxOccurRedMB == 0 && conf.maxOccurIrredMB <= left_MB) {
+                return false;
+            }
+            conf.maxOccurRedMB = 0;
+            conf.maxOccurIrredMB = std::min(conf.maxOccurIrredMB, left_MB);
+            return true;
+        }
+
+        case MemShed::end:
+            break;
+    }
+    assert(false);
+    return false;
+}
+
+//Give things up in MemShed order until we are within the memory budget.
+//Away from the top level only learnt clauses can be given up.
+void Solver::check_mem_budget(const bool toplevel)
+{
+    if (conf.mem_budget_MB == 0) {
+        return;
+    }
+
+    const uint64_t budget = conf.mem_budget_MB*1024ULL*1024ULL;
+    memBudgetStats.numChecks++;
+    uint64_t used = mem_used_total();
+    if (used <= budget) {
+        return;
+    }
+    memBudgetStats.numOver++;
+
+    for(int at = 0; at < (int)MemShed::end && used > budget; at++) {
+        const MemShed what = static_cast<MemShed>(at);
+        if (!toplevel && what > MemShed::red_tier1) {
+            break;
+        }
+        if (!shed_mem(what)) {
+            continue;
+        }
+
+        const uint64_t now = mem_used_total();
+        memBudgetStats.numShed[at]++;
+        memBudgetStats.bytesShed += used > now ? used - now : 0;
+        if (conf.verbosity) {
+            cout << "c [mem-budget] used " << used/(1024*1024) << " MB"
+            << " budget " << conf.mem_budget_MB << " MB"
+            << " -- shed " << mem_shed_to_string(what)
+            << " now " << now/(1024*1024) << " MB"
+            << endl;
+        }
+        used = now;
+    }
+}
+
 void Solver::print_mem_stats() const
 {
     double vm_mem_used = 0;
@@ -2565,6 +3081,34 @@ void Solver::print_mem_stats() const
         , stats_line_percent(account, vm_mem_used)
         , "%"
     );
+
+    if (conf.mem_budget_MB) {
+        print_stats_line("c Mem budget"
+            , conf.mem_budget_MB
+            , "MB"
+        );
+        print_stats_line("c Mem budget over"
+            , memBudgetStats.numOver
+            , stats_line_percent(memBudgetStats.numOver, memBudgetStats.numChecks)
+            , "% of checks"
+        );
+        print_stats_line("c Mem budget shed"
+            , memBudgetStats.bytesShed/(1024UL*1024UL)
+            , "MB"
+        );
+        print_stats_line("c Mem budget red cls shed"
+            , memBudgetStats.redClsShed
+        );
+        for(int at = 0; at < (int)MemShed::end; at++) {
+            if (memBudgetStats.numShed[at] == 0) {
+                continue;
+            }
+            print_stats_line(string("c Mem budget shed ") + mem_shed_to_string(static_cast<MemShed>(at))
+                , memBudgetStats.numShed[at]
+                , "times"
+            );
+        }
+    }
 }
 
 void Solver::print_clause_size_distrib()
@@ -3000,16 +3544,32 @@ unsigned long Solver::get_sql_id() const
 
 bool Solver::add_clause_outer(const vector<Lit>& lits, bool red)
 {
-    if (!ok) {
-        return false;
-    }
     #ifdef SLOW_DEBUG //we check for this during back-numbering
     check_too_large_variable_number(lits);
     #endif
-    back_number_from_outside_to_outer(lits);
+    return add_clause_outer(lits.data(), lits.size(), red);
+}
+
+bool Solver::add_clause_outer(const Lit* lits, const size_t num_lits, bool red)
+{
+    if (!ok) {
+        return false;
+    }
+    back_number_from_outside_to_outer(lits, num_lits);
     return addClauseInt(back_number_from_outside_to_outer_tmp, red);
 }
 
+bool Solver::add_red_clause_outer(const Lit* lits, const size_t num_lits, const uint32_t glue)
+{
+    if (!ok) {
+        return false;
+    }
+    back_number_from_outside_to_outer(lits, num_lits);
+    ClauseStats cl_stats;
+    cl_stats.glue = glue;
+    return addClauseInt(back_number_from_outside_to_outer_tmp, true, cl_stats);
+}
+
 bool Solver::add_xor_clause_outer(const vector<uint32_t>& vars, bool rhs)
 {
     if (!ok) {
@@ -3372,21 +3932,47 @@ void Solver::reconfigure(int val)
     */
 }
 
+static const uint32_t state_file_magic = 0x53534d43; //"CMSS"
+static const uint32_t state_file_version = 3;
+
+//Returns the number of outer variables the state was saved with
+static uint32_t read_state_header(SimpleInFile& f, const string& fname)
+{
+    const uint32_t magic = f.get_uint32_t();
+    const uint32_t version = f.get_uint32_t();
+    if (magic != state_file_magic || version != state_file_version) {
+        cout
+        << "ERROR: file '" << fname << "' is not a solver state file"
+        << " written by this version of the solver" << endl;
+        exit(-1);
+    }
+    return f.get_uint32_t();
+}
+
 void Solver::save_state(const string& fname, const lbool status) const
 {
     SimpleOutFile f;
     f.start(fname);
 
+    f.put_uint32_t(state_file_magic);
+    f.put_uint32_t(state_file_version);
+    f.put_uint32_t(nVarsOuter());
     f.put_lbool(status);
     Searcher::save_state(f, status);
+    f.put_struct(solveStats);
     //f.put_struct(sumStats);
     //f.put_struct(sumPropStats);
     //f.put_vector(outside_assumptions);
 
     varReplacer->save_state(f);
+    f.put_uint32_t(occsimplifier != NULL);
     if (occsimplifier) {
         occsimplifier->save_state(f);
     }
+    f.put_uint32_t(compHandler != NULL);
+    if (compHandler) {
+        compHandler->save_state(f);
+    }
 }
 
 lbool Solver::load_state(const string& fname)
@@ -3394,20 +3980,166 @@ lbool Solver::load_state(const string& fname)
     SimpleInFile f;
     f.start(fname);
 
+    read_state_header(f, fname);
     const lbool status = f.get_lbool();
     Searcher::load_state(f, status);
+    f.get_struct(solveStats);
     //f.get_struct(sumStats);
     //f.get_struct(sumPropStats);
     //f.get_vector(outside_assumptions);
 
     varReplacer->load_state(f);
-    if (occsimplifier) {
+
+    //Eliminated variables and solved components can only be put back
+    //by the module that removed them
+    if (f.get_uint32_t()) {
+        if (!occsimplifier) {
+            cout << "ERROR: state in '" << fname << "' was saved with"
+            << " occurrence-based simplification, it must be turned on" << endl;
+            exit(-1);
+        }
         occsimplifier->load_state(f);
     }
+    if (f.get_uint32_t()) {
+        if (!compHandler) {
+            cout << "ERROR: state in '" << fname << "' was saved with"
+            << " component handling, it must be turned on" << endl;
+            exit(-1);
+        }
+        compHandler->load_state(f);
+    }
 
     return status;
 }
 
+void Solver::freeze_var(const uint32_t outside_var)
+{
+    assert(outside_var < nVarsOutside());
+    const uint32_t outer_var = map_to_with_bva(outside_var);
+    if (frozen_cnt.size() < nVarsOuter()) {
+        frozen_cnt.resize(nVarsOuter(), 0);
+    }
+    frozen_cnt[outer_var]++;
+
+    //Bring it back in case it has already been eliminated or decomposed
+    if (frozen_cnt[outer_var] == 1 && ok) {
+        const Lit lit(outside_var, false);
+        back_number_from_outside_to_outer(&lit, 1);
+        addClauseHelper(back_number_from_outside_to_outer_tmp);
+    }
+}
+
+void Solver::melt_var(const uint32_t outside_var)
+{
+    if (!var_frozen_outside(outside_var)) {
+        std::cerr << "ERROR: melt() called on variable " << outside_var+1
+        << " which is not frozen. Exiting." << endl;
+        exit(-1);
+    }
+    frozen_cnt[map_to_with_bva(outside_var)]--;
+}
+
+bool Solver::var_frozen_outside(const uint32_t outside_var) const
+{
+    return outside_var < nVarsOutside()
+        && var_frozen_outer(map_to_with_bva(outside_var));
+}
+
+uint32_t Solver::frozen_cnt_outside(const uint32_t outside_var) const
+{
+    if (!var_frozen_outside(outside_var)) {
+        return 0;
+    }
+    return frozen_cnt[map_to_with_bva(outside_var)];
+}
+
+void Solver::connect_external_propagator(ExternalPropagator* prop)
+{
+    delete ext_prop;
+    ext_prop = new ExtPropHandler(this, prop);
+}
+
+void Solver::disconnect_external_propagator()
+{
+    delete ext_prop;
+    ext_prop = NULL;
+}
+
+void Solver::request_checkpoint()
+{
+    checkpoint_requested = true;
+}
+
+bool Solver::checkpoint_due() const
+{
+    if (conf.checkpoint_file.empty()) {
+        return false;
+    }
+
+    return checkpoint_requested
+        || (conf.checkpoint_every_secs > 0
+            && cpuTime() >= next_checkpoint_time);
+}
+
+void Solver::write_checkpoint()
+{
+    assert(decisionLevel() == 0);
+    const double myTime = cpuTime();
+    checkpoint_requested = false;
+    next_checkpoint_time = myTime + conf.checkpoint_every_secs;
+
+    //So no set variables end up in the clauses
+    clauseCleaner->remove_and_clean_all();
+    if (!okay()) {
+        return;
+    }
+
+    //Being stopped while writing must not destroy the previous checkpoint
+    const string tmp_fname = conf.checkpoint_file + ".tmp";
+    save_state(tmp_fname, l_Undef);
+    if (std::rename(tmp_fname.c_str(), conf.checkpoint_file.c_str()) != 0) {
+        cout << "ERROR: could not move checkpoint '" << tmp_fname
+        << "' to '" << conf.checkpoint_file << "'" << endl;
+        exit(-1);
+    }
+
+    if (conf.verbosity) {
+        cout << "c [checkpoint] written to '" << conf.checkpoint_file << "'"
+        << " confl: " << sumConflicts
+        << conf.print_times(cpuTime() - myTime)
+        << endl;
+    }
+}
+
+void Solver::resume_from_checkpoint()
+{
+    assert(nVarsOuter() == 0);
+    const double myTime = cpuTime();
+
+    uint32_t num_outer;
+    {
+        SimpleInFile f;
+        f.start(conf.resume_file);
+        num_outer = read_state_header(f, conf.resume_file);
+    }
+    new_vars(num_outer);
+    const lbool status = load_state(conf.resume_file);
+    if (status != l_Undef) {
+        cout << "ERROR: '" << conf.resume_file << "' is not a checkpoint" << endl;
+        exit(-1);
+    }
+    save_on_var_memory(nVars());
+    rebuildOrderHeap();
+
+    if (conf.verbosity) {
+        cout << "c [checkpoint] resumed from '" << conf.resume_file << "'"
+        << " vars: " << nVars()
+        << " confl: " << sumConflicts
+        << conf.print_times(cpuTime() - myTime)
+        << endl;
+    }
+}
+
 lbool Solver::load_solution_from_file(const string& fname)
 {
     //At this point, model is set up, we just need to fill the l_Undef in
@@ -3928,6 +4660,87 @@ void Solver::dump_irred_clauses(std::ostream *out) const
     dumper.dump_irred_clauses(out);
 }
 
+//The same clauses dump_irred_clauses() writes out: a problem with the
+//same solutions, including those of eliminated and replaced variables.
+//Plus the redundant clauses that are kept around for long.
+void Solver::get_clauses_for_clone(ClauseBuffer& irred, ClauseBuffer& red) const
+{
+    assert(get_num_bva_vars() == 0);
+    assert(decisionLevel() == 0);
+    vector<Lit> tmp;
+    if (!okay()) {
+        irred.add(tmp);
+        return;
+    }
+
+    for(const Lit lit: get_zero_assigned_lits()) {
+        tmp.clear();
+        tmp.push_back(lit);
+        irred.add(tmp);
+    }
+
+    for(size_t i = 0; i < watches.size(); i++) {
+        const Lit lit = Lit::toLit(i);
+        for(const Watched& w: watches[lit]) {
+            if (!w.isBin() || lit > w.lit2()) {
+                continue;
+            }
+            tmp.clear();
+            tmp.push_back(map_inter_to_outer(lit));
+            tmp.push_back(map_inter_to_outer(w.lit2()));
+            if (w.red()) {
+                red.add(tmp);
+                red.glues.push_back(2);
+            } else {
+                irred.add(tmp);
+            }
+        }
+    }
+
+    for(const ClOffset offs: longIrredCls) {
+        const Clause& cl = *cl_alloc.ptr(offs);
+        tmp.clear();
+        for(const Lit l: cl) {
+            tmp.push_back(map_inter_to_outer(l));
+        }
+        irred.add(tmp);
+    }
+
+    //Tier 2 is thrown away often anyway
+    for(size_t tier = 0; tier < 2; tier++) {
+        for(const ClOffset offs: longRedCls[tier]) {
+            const Clause& cl = *cl_alloc.ptr(offs);
+            tmp.clear();
+            for(const Lit l: cl) {
+                tmp.push_back(map_inter_to_outer(l));
+            }
+            red.add(tmp);
+            red.glues.push_back(cl.stats.glue);
+        }
+    }
+
+    for(uint32_t outer = 0; outer < nVarsOuter(); outer++) {
+        const Lit lit = varReplacer->get_lit_replaced_with_outer(Lit(outer, false));
+        if (lit.var() == outer) {
+            continue;
+        }
+        tmp.clear();
+        tmp.push_back(Lit(outer, true));
+        tmp.push_back(lit);
+        irred.add(tmp);
+        tmp[0] = ~tmp[0];
+        tmp[1] = ~tmp[1];
+        irred.add(tmp);
+    }
+
+    if (conf.perform_occur_based_simp) {
+        occsimplifier->get_blocked_clauses(irred);
+    }
+    if (compHandler) {
+        compHandler->get_removed_clauses(irred);
+    }
+}
+
 void Solver::dump_red_clauses(std::ostream *out) const
 {
     ClauseDumper dumper(this);
@@ -4153,3 +4966,107 @@ void Solver::learnt_clausee_query_map_without_bva(vector<Lit>& cl)
         l = Lit(learnt_clause_query_outer_to_without_bva_map[l.var()], l.sign());
     }
 }
+
+void Solver::set_learnt_stream(
+    std::function<void(const vector<Lit>& clause)> callback
+    , const uint32_t max_len
+    , const uint32_t max_glue
+    , const uint32_t max_per_restart
+) {
+    learnt_stream = callback;
+    learnt_stream_max_len = max_len;
+    learnt_stream_max_glue = max_glue;
+    learnt_stream_max_per_restart = max_per_restart;
+    learnt_stream_lits.clear();
+    learnt_stream_ends.clear();
+
+    //Units already known are streamed first
+    learnt_stream_trail_at = 0;
+}
+
+void Solver::set_progress_stream(
+    std::function<void(const SearchProgress& progress)> callback
+    , const uint64_t every_confl
+) {
+    progress_stream = callback;
+    progress_stream_every = every_confl;
+    progress_stream_next = sumConflicts + every_confl;
+}
+
+void Solver::flush_streams()
+{
+    if (learnt_stream) {
+        if (ok) {
+            const size_t lev0_end = decisionLevel() == 0 ? trail.size() : trail_lim[0];
+            for(size_t i = learnt_stream_trail_at; i < lev0_end; i++) {
+                //Renumbering leaves the values, but not the trail, intact
+                if (trail[i] == lit_Undef) {
+                    continue;
+                }
+                learnt_stream_tmp.clear();
+                learnt_stream_tmp.push_back(trail[i]);
+                stream_learnt_clause(learnt_stream_tmp);
+            }
+            learnt_stream_trail_at = std::max(learnt_stream_trail_at, lev0_end);
+
+            uint32_t start = 0;
+            for(const uint32_t end: learnt_stream_ends) {
+                learnt_stream_tmp.assign(
+                    learnt_stream_lits.begin() + start
+                    , learnt_stream_lits.begin() + end);
+                stream_learnt_clause(learnt_stream_tmp);
+                start = end;
+            }
+        }
+        learnt_stream_lits.clear();
+        learnt_stream_ends.clear();
+    }
+
+    const SearchProgress progress = get_progress();
+    live_conflicts.store(progress.conflicts, std::memory_order_relaxed);
+    live_propagations.store(progress.propagations, std::memory_order_relaxed);
+    live_decisions.store(progress.decisions, std::memory_order_relaxed);
+    live_restarts.store(progress.restarts, std::memory_order_relaxed);
+
+    if (progress_stream && sumConflicts >= progress_stream_next) {
+        progress_stream(progress);
+        progress_stream_next = sumConflicts + progress_stream_every;
+    }
+}
+
+SearchProgress Solver::get_progress() const
+{
+    SearchProgress progress;
+    progress.conflicts = sumConflicts;
+    progress.propagations = sumPropStats.propagations + propStats.propagations;
+    progress.decisions = sumSearchStats.decisions + Searcher::get_stats().decisions;
+    progress.restarts = sumRestarts();
+    return progress;
+}
+
+SearchProgress Solver::get_live_progress() const
+{
+    SearchProgress progress;
+    progress.conflicts = live_conflicts.load(std::memory_order_relaxed);
+    progress.propagations = live_propagations.load(std::memory_order_relaxed);
+    progress.decisions = live_decisions.load(std::memory_order_relaxed);
+    progress.restarts = live_restarts.load(std::memory_order_relaxed);
+    return progress;
+}
+
+void Solver::stream_learnt_clause(vector<Lit>& cl)
+{
+    for(Lit& l: cl) {
+        if (varData[l.var()].is_bva) {
+            return;
+        }
+        l = map_inter_to_outer(l);
+    }
+    if (nVarsOuter() != nVarsOutside()) {
+        if (learnt_stream_outer_to_without_bva_map.size() != nVarsOuter()) {
+            learnt_stream_outer_to_without_bva_map = build_outer_to_without_bva_map();
+        }
+        updateLitsMap(cl, learnt_stream_outer_to_without_bva_map);
+    }
+    learnt_stream(cl);
+}
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include <iostream>
 #include <utility>
 #include <string>
+#include <functional>
+#include <atomic>
 
 #include "constants.h"
 #include "solvertypes.h"
@@ -61,6 +63,7 @@ class SolutionExtender;
 class ImplCache;
 class CompFinder;
 class CompHandler;
+class ExtPropHandler;
 class SubsumeStrengthen;
 class SubsumeImplicit;
 class DataSync;
@@ -72,6 +75,36 @@ struct SolveStats
 {
     uint64_t numSimplify = 0;
     uint32_t num_solve_calls = 0;
+    uint64_t last_simplify_confl = 0; ///<sumConflicts at the end of the last simplification
+};
+
+//What to give up when over conf.mem_budget_MB, in the order it's given up
+enum class MemShed {
+    red_tier2
+    , red_tier1
+    , impl_cache
+    , stamps
+    , gauss
+    , occur_limits
+    , end
+};
+
+struct MemBudgetStats
+{
+    uint64_t numChecks = 0;
+    uint64_t numOver = 0;
+    uint64_t redClsShed = 0;
+    uint64_t bytesShed = 0;
+    uint64_t numShed[(int)MemShed::end] = {};
+};
+
+struct EnumerateParams
+{
+    std::function<bool(const vector<lbool>& model)> callback; ///<Gets every solution, returns false to stop
+    uint64_t max_solutions = std::numeric_limits<uint64_t>::max();
+    const vector<uint32_t>* projection = NULL; ///<Solutions must differ on these. NULL = independent vars, or all vars
+    bool decision_blocking = false; ///<Without projection, ban only the decisions that led to the solution
+    Lit ban_guard = lit_Undef; ///<Added to every ban, so the bans hold only while it's false
 };
 
 class Solver : public Searcher
@@ -85,10 +118,18 @@ class Solver : public Searcher
         void new_external_var();
         void new_external_vars(size_t n);
         bool add_clause_outer(const vector<Lit>& lits, bool red = false);
+        bool add_clause_outer(const Lit* lits, const size_t num_lits, bool red = false);
+        bool add_red_clause_outer(const Lit* lits, const size_t num_lits, const uint32_t glue);
         bool add_xor_clause_outer(const vector<uint32_t>& vars, bool rhs);
 
         lbool solve_with_assumptions(const vector<Lit>* _assumptions, bool only_indep_solution);
+        lbool enumerate_solutions(
+            const vector<Lit>* _assumptions
+            , bool only_indep_solution
+            , const EnumerateParams& _params
+        );
         lbool simplify_with_assumptions(const vector<Lit>* _assumptions = NULL);
+        bool add_clause_in_search(vector<Lit>& cl, bool red);
         void  set_shared_data(SharedData* shared_data);
 
         //Querying model
@@ -108,7 +149,22 @@ class Solver : public Searcher
         bool get_next_small_clause(std::vector<Lit>& out);
         void end_getting_small_clauses();
 
+        //stream learnt clauses and progress while solving
+        void set_learnt_stream(
+            std::function<void(const vector<Lit>& clause)> callback
+            , uint32_t max_len
+            , uint32_t max_glue
+            , uint32_t max_per_restart
+        );
+        void set_progress_stream(
+            std::function<void(const SearchProgress& progress)> callback
+            , uint64_t every_confl
+        );
+        void flush_streams();
+        SearchProgress get_live_progress() const; //as of the last restart, safe to call while solving
+
         void dump_irred_clauses(std::ostream *out) const;
+        void get_clauses_for_clone(ClauseBuffer& irred, ClauseBuffer& red) const;
         void dump_red_clauses(std::ostream *out) const;
         void open_file_and_dump_irred_clauses(const std::string &fname) const;
         void open_file_and_dump_red_clauses(const std::string &fname) const;
@@ -132,8 +188,11 @@ class Solver : public Searcher
         uint32_t num_active_vars() const;
         void print_mem_stats() const;
         uint64_t print_watch_mem_used(uint64_t totalMem) const;
+        uint64_t mem_used_total() const; ///<All memory accounted for in print_mem_stats()
+        void check_mem_budget(const bool toplevel);
         unsigned long get_sql_id() const;
         const SolveStats& get_solve_stats() const;
+        const MemBudgetStats& get_mem_budget_stats() const;
         const SearchStats& get_stats() const;
         void add_in_partial_solving_stats();
         void check_implicit_stats(const bool onlypairs = false) const;
@@ -159,6 +218,7 @@ class Solver : public Searcher
         DistillerLongWithImpl* dist_long_with_impl = NULL;
         StrImplWImplStamp* dist_impl_with_impl = NULL;
         CompHandler*           compHandler = NULL;
+        ExtPropHandler*        ext_prop = NULL;
 
         SearchStats sumSearchStats;
         PropStats sumPropStats;
@@ -169,9 +229,24 @@ class Solver : public Searcher
         bool fully_enqueue_this(const Lit lit);
         void update_assumptions_after_varreplace();
 
+        //Frozen vars are kept by simplification, so they stay cheap to use
+        //in later clauses and assumptions
+        void freeze_var(const uint32_t outside_var);
+        void melt_var(const uint32_t outside_var);
+        bool var_frozen_outside(const uint32_t outside_var) const;
+        uint32_t frozen_cnt_outside(const uint32_t outside_var) const;
+        bool var_frozen_outer(const uint32_t outer_var) const;
+        bool var_frozen(const uint32_t var) const;
+
+        //External propagation, see ExtPropHandler
+        void connect_external_propagator(ExternalPropagator* prop);
+        void disconnect_external_propagator();
+
         //State load/unload
         void save_state(const string& fname, const lbool status) const;
         lbool load_state(const string& fname);
+        void request_checkpoint();
+        bool checkpoint_due() const;
         template<typename A>
         void parse_v_line(A* in, const size_t lineNum);
         lbool load_solution_from_file(const string& fname);
@@ -272,7 +347,27 @@ class Solver : public Searcher
 
         vector<Lit> add_clause_int_tmp_cl;
         lbool iterate_until_solved();
+
+        //Checkpointing
+        void write_checkpoint();
+        void resume_from_checkpoint();
+        std::atomic<bool> checkpoint_requested;
+        double next_checkpoint_time = 0;
+
+        vector<uint32_t> frozen_cnt; ///<Number of freeze_var() calls not yet melted, indexed by outer var
+
+        //Enumerating solutions
+        const EnumerateParams* enum_params = NULL;
+        vector<uint32_t> enum_vars; ///<Outside vars the solutions are projected onto
+        bool enum_ban_decisions = false;
+        bool enum_only_indep = false;
+        uint64_t enum_num_found = 0;
+        bool model_already_extended = false;
+        vector<Lit> enum_ban_cl;
+        lbool report_enumerated_solution();
         uint64_t mem_used_vardata() const;
+        bool shed_mem(const MemShed what);
+        MemBudgetStats memBudgetStats;
         void check_reconfigure();
         void reconfigure(int val);
         bool already_reconfigured = false;
@@ -296,14 +391,20 @@ class Solver : public Searcher
         unsigned num_bits_set(const size_t x, const unsigned max_size) const;
         void check_too_large_variable_number(const vector<Lit>& lits) const;
         void set_assumptions();
+        void translate_assumptions();
 
         lbool simplify_problem_outside();
         void move_to_outside_assumps(const vector<Lit>* assumps);
         vector<Lit> back_number_from_outside_to_outer_tmp;
         void back_number_from_outside_to_outer(const vector<Lit>& lits)
+        {
+            back_number_from_outside_to_outer(lits.data(), lits.size());
+        }
+        void back_number_from_outside_to_outer(const Lit* lits, const size_t num_lits)
         {
             back_number_from_outside_to_outer_tmp.clear();
-            for (const Lit lit: lits) {
+            for (size_t i = 0; i < num_lits; i++) {
+                const Lit lit = lits[i];
                 assert(lit.var() < nVarsOutside());
                 if (get_num_bva_vars() > 0 || !fresh_solver) {
                     back_number_from_outside_to_outer_tmp.push_back(map_to_with_bva(lit));
@@ -316,6 +417,14 @@ class Solver : public Searcher
         void check_switchoff_limits_newvar(size_t n = 1);
         vector<Lit> outside_assumptions;
 
+        //Translation of the last call's assumptions, see translate_assumptions()
+        vector<Lit> inter_assumptions;
+        vector<Lit> inter_assumptions_of; ///<The outside assumptions translated
+        vector<Lit> inter_assumptions_added; ///<Newly translated part
+        uint64_t inter_assumptions_at_simp = 0; ///<solveStats.numSimplify at translation
+        uint32_t inter_assumptions_at_vars = 0; ///<nVars() at translation
+        uint32_t inter_assumptions_at_vars_outer = 0; ///<nVarsOuter() at translation
+
         //Stats printing
         void print_norm_stats(const double cpu_time, const double cpu_time_total) const;
         void print_min_stats(const double cpu_time, const double cpu_time_total) const;
@@ -345,6 +454,16 @@ class Solver : public Searcher
         vector<uint32_t> learnt_clause_query_outer_to_without_bva_map;
         bool all_vars_outside(const vector<Lit>& cl) const;
         void learnt_clausee_query_map_without_bva(vector<Lit>& cl);
+        vector<Lit> learnt_stream_tmp;
+        vector<uint32_t> learnt_stream_outer_to_without_bva_map;
+        void stream_learnt_clause(vector<Lit>& cl);
+        SearchProgress get_progress() const;
+
+        //Updated at every restart, read by other threads
+        std::atomic<uint64_t> live_conflicts{0};
+        std::atomic<uint64_t> live_propagations{0};
+        std::atomic<uint64_t> live_decisions{0};
+        std::atomic<uint64_t> live_restarts{0};
 
         /////////////////////////////
         //Renumberer
@@ -397,7 +516,7 @@ class Solver : public Searcher
         /////////////////////
         // Clauses
         bool addClauseHelper(vector<Lit>& ps);
-        bool addClauseInt(vector<Lit>& ps, const bool red = false);
+        bool addClauseInt(vector<Lit>& ps, const bool red = false, const ClauseStats& cl_stats = ClauseStats());
 
         /////////////////
         // Debug
@@ -431,6 +550,11 @@ inline const SolveStats& Solver::get_solve_stats() const
     return solveStats;
 }
 
+inline const MemBudgetStats& Solver::get_mem_budget_stats() const
+{
+    return memBudgetStats;
+}
+
 inline size_t Solver::get_num_long_irred_cls() const
 {
     return longIrredCls.size();
@@ -478,6 +602,16 @@ inline vector<uint32_t> Solver::xor_outer_numbered(const T& cl) const
     return tmpXor;
 }
 
+inline bool Solver::var_frozen_outer(const uint32_t outer_var) const
+{
+    return outer_var < frozen_cnt.size() && frozen_cnt[outer_var] > 0;
+}
+
+inline bool Solver::var_frozen(const uint32_t var) const
+{
+    return var_frozen_outer(map_inter_to_outer(var));
+}
+
 inline void Solver::move_to_outside_assumps(const vector<Lit>* assumps)
 {
     outside_assumptions.clear();
@@ -526,7 +660,7 @@ inline bool Solver::find_with_stamp_a_or_b(Lit a, const Lit b) const
 
 inline bool Solver::find_with_cache_a_or_b(Lit a, Lit b, int64_t* limit) const
 {
-    const vector<LitExtra>& cache = solver->implCache[a].lits;
+    const TransCache& cache = solver->implCache[a];
     *limit -= cache.size();
     for (LitExtra cacheLit: cache) {
         if (cacheLit.getOnlyIrredBin()
@@ -538,9 +672,9 @@ inline bool Solver::find_with_cache_a_or_b(Lit a, Lit b, int64_t* limit) const
 
     std::swap(a,b);
 
-    const vector<LitExtra>& cache2 = solver->implCache[a].lits;
+    const TransCache& cache2 = solver->implCache[a];
     *limit -= cache2.size();
-    for (LitExtra cacheLit: cache) {
+    for (LitExtra cacheLit: cache2) {
         if (cacheLit.getOnlyIrredBin()
             && cacheLit.getLit() == b
         ) {
@@ -591,6 +725,7 @@ inline const vector<Lit>& Solver::get_final_conflict() const
 inline void Solver::setConf(const SolverConf& _conf)
 {
     conf = _conf;
+    implCache.set_max_bytes((size_t)conf.maxCacheSizeMB*1024ULL*1024ULL);
 }
 
 inline bool Solver::prop_at_head() const
@@ -123,11 +123,14 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , skip_some_bve_resolvents(true) //based on gates
         , velim_resolvent_too_large(20)
         , var_linkin_limit_MB(1000)
+        , varelim_threads(1)
+        , varelim_gate_table(false) //little left to find by the first inprocessing
 
         //Subs, str limits for simplifier
         , subsumption_time_limitM(300)
         , strengthening_time_limitM(300)
         , aggressive_elim_time_limitM(300)
+        , sub_str_threads(1)
 
         //Bounded variable addition
         , do_bva(false)
@@ -156,6 +159,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , otf_hyper_time_limitM(340)
         , otf_hyper_ratio_limit(0.5) //if higher(closer to 1), we allow for less hyper-bin addition, i.e. we are stricter
         , single_probe_time_limit_perc(0.5)
+        , probe_threads(1)
 
         //XOR
         , doFindXors       (true)
@@ -175,6 +179,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , doFindAndReplaceEqLits(true)
         , doExtendedSCC         (true)
         , max_scc_depth (10000)
+        , varreplace_threads(1)
 
         //Iterative Alo Scheduling
         , simplify_at_startup(false)
@@ -185,6 +190,8 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , num_conflicts_of_search(50ULL*1000ULL)
         , num_conflicts_of_search_inc(1.4)
         , num_conflicts_of_search_inc_max(10)
+        , simplify_every_confl_incremental(0)
+        , simplify_incremental_max_time(0.05)
         , simplify_schedule_startup(
             "sub-impl,"
             "occ-backw-sub-str, occ-clean-implicit, occ-bve,"
@@ -229,10 +236,13 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , maxOccurRedMB    (600)
         , maxOccurRedLitLinkedM(50)
         , subsume_gothrough_multip(2.0)
+        , occ_sub_str_incremental(false)
 
         //Distillation
         , do_distill_clauses(true)
         , distill_long_cls_time_limitM(20ULL)
+        , do_vivify_red(true)
+        , vivify_red_time_limitM(5LL)
         , watch_cache_stamp_based_str_time_limitM(30LL)
         , distill_time_limitM(120LL)
 
@@ -240,12 +250,17 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , doRenumberVars   (true)
         , doSaveMem        (true)
         , full_watch_consolidate_every_n_confl (4ULL*1000ULL*1000ULL) //validated in run 8113323.wlm01
+        , huge_pages       (0)
+        , watch_pool       (false)
+        , numa_first_touch (false)
+        , mem_budget_MB    (0)
 
         //Component finding
         , doCompHandler    (false)
         , handlerFromSimpNum (0)
         , compVarLimit      (1ULL*1000ULL*1000ULL)
         , comp_find_time_limitM (500)
+        , comp_threads      (1)
 
         //Misc optimisations
         , doStrSubImplicit (true)
@@ -282,6 +297,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , simulate_drat(false)
         , need_decisions_reaching(false)
         , saved_state_file("savedstate.dat")
+        , checkpoint_every_secs(0)
 {
     ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
     ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.44;
@@ -259,11 +259,14 @@ class DLL_PUBLIC SolverConf
         int      skip_some_bve_resolvents;
         int velim_resolvent_too_large; //-1 == no limit
         int var_linkin_limit_MB;
+        unsigned varelim_threads; ///<Threads used to test-eliminate independent vars in parallel
+        int      varelim_gate_table; ///<Hash-cons gate definitions before BVE to find equivalent vars
 
         //Subs, str limits for simplifier
         long long subsumption_time_limitM;
         long long strengthening_time_limitM;
         long long aggressive_elim_time_limitM;
+        unsigned sub_str_threads; ///<Threads used to find backward-subsumed/strengthened long clauses
 
         //BVA
         int      do_bva;
@@ -288,6 +291,7 @@ class DLL_PUBLIC SolverConf
         unsigned long long otf_hyper_time_limitM;
         double  otf_hyper_ratio_limit;
         double single_probe_time_limit_perc;
+        unsigned probe_threads; ///<Threads probing failed literals on a snapshot of the clauses
 
         //XORs
         int      doFindXors;
@@ -303,6 +307,7 @@ class DLL_PUBLIC SolverConf
         int doFindAndReplaceEqLits;
         int doExtendedSCC;
         int max_scc_depth;
+        unsigned varreplace_threads; ///<Threads scanning long clauses for replaced literals
 
         //Iterative Alo Scheduling
         int      simplify_at_startup; //simplify at 1st startup (only)
@@ -313,6 +318,8 @@ class DLL_PUBLIC SolverConf
         uint64_t num_conflicts_of_search;
         double   num_conflicts_of_search_inc;
         double   num_conflicts_of_search_inc_max;
+        uint64_t simplify_every_confl_incremental; ///<Conflicts over all solve() calls between two inprocessing rounds, 0 = never
+        double   simplify_incremental_max_time; ///<Seconds such a round may add to the solve() call that runs it
         string   simplify_schedule_startup;
         string   simplify_schedule_nonstartup;
         string   simplify_schedule_preproc;
@@ -325,10 +332,13 @@ class DLL_PUBLIC SolverConf
         double maxOccurRedMB;
         double maxOccurRedLitLinkedM;
         double   subsume_gothrough_multip;
+        int      occ_sub_str_incremental; ///<Only use clauses changed since the last occur sub/str as subsumers
 
         //Distillation
         int      do_distill_clauses;
         unsigned long long distill_long_cls_time_limitM;
+        int      do_vivify_red; ///<Between restarts, vivify tier 0/1 learnts instead of distilling tier 0
+        long long vivify_red_time_limitM;
         long watch_cache_stamp_based_str_time_limitM;
         long long distill_time_limitM;
 
@@ -336,12 +346,17 @@ class DLL_PUBLIC SolverConf
         int       doRenumberVars;
         int       doSaveMem;
         uint64_t  full_watch_consolidate_every_n_confl;
+        int       huge_pages; ///<Clause arena and watch slabs: 0 = malloc, 1 = mmap + transparent huge pages, 2 = explicit huge pages
+        int       watch_pool; ///<Allocate watch lists from per-solver slabs
+        int       numa_first_touch; ///<With multiple threads, bind thread N to NUMA node N%nodes
+        uint64_t  mem_budget_MB; ///<Shed learnts, cache, stamps, etc. to stay under this. 0 = no budget
 
         //Component handling
         int       doCompHandler;
         unsigned  handlerFromSimpNum;
         size_t    compVarLimit;
         unsigned long long  comp_find_time_limitM;
+        unsigned  comp_threads; ///<Threads solving the disconnected components
 
 
         //Misc Optimisations
@@ -385,6 +400,11 @@ class DLL_PUBLIC SolverConf
         std::string simplified_cnf;
         std::string solution_file;
         std::string saved_state_file;
+
+        //Checkpointing
+        std::string checkpoint_file; ///<Write checkpoints of the search here. Empty = never
+        double checkpoint_every_secs; ///<0 = only when requested
+        std::string resume_file; ///<Resume from this checkpoint instead of starting fresh
 };
 
 } //end namespace
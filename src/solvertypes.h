@@ -178,6 +178,26 @@ inline std::ostream& operator<<(std::ostream& os, const BinaryClause val)
     return os;
 }
 
+//Clause i is lits[offsets[i]] ... lits[offsets[i+1]-1], as for
+//SATSolver::add_clauses()
+struct ClauseBuffer
+{
+    std::vector<Lit> lits;
+    std::vector<uint32_t> offsets = std::vector<uint32_t>(1, 0);
+    std::vector<uint32_t> glues; ///<Only filled in for redundant clauses
+
+    void add(const std::vector<Lit>& cl)
+    {
+        lits.insert(lits.end(), cl.begin(), cl.end());
+        offsets.push_back(lits.size());
+    }
+
+    size_t size() const
+    {
+        return offsets.size()-1;
+    }
+};
+
 inline double ratio_for_stat(double a, double b)
 {
     if (b == 0)
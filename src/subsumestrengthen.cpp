@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "solvertypes.h"
 #include "subsumeimplicit.h"
 #include <array>
+#include <thread>
+#include <functional>
 
 //#define VERBOSE_DEBUG
 
@@ -156,71 +158,83 @@ SubsumeStrengthen::Sub1Ret SubsumeStrengthen::strengthen_subsume_and_unlink_and_
         , cl.abst
         , subs
         , subsLits
+        , simplifier->limit_to_decrease
     );
 
     for (size_t j = 0
         ; j < subs.size() && solver->okay()
         ; j++
     ) {
-        ClOffset offset2 = subs[j];
-        Clause& cl2 = *solver->cl_alloc.ptr(offset2);
-        #ifdef USE_GAUSS
-        if (cl2.used_in_xor()) {
-            continue;
-        }
-        #endif
+        if (!apply_sub_str(cl, subs[j], subsLits[j], ret))
+            break;
+    }
 
-        if (subsLits[j] == lit_Undef) {  //Subsume
-            #ifdef VERBOSE_DEBUG
-            if (solver->conf.verbosity >= 6)
-                cout << "subsumed clause " << cl2 << endl;
-            #endif
+    return ret;
+}
 
-            //If subsumes a irred, and is redundant, make it irred
-            if (cl.red()
-                && !cl2.red()
-            ) {
-                cl.makeIrred();
-                solver->litStats.redLits -= cl.size();
-                solver->litStats.irredLits += cl.size();
-                if (!cl.getOccurLinked()) {
-                    simplifier->linkInClause(cl);
-                } else {
-                    for(const Lit l: cl) {
-                        simplifier->n_occurs[l.toInt()]++;
-                    }
-                }
-            }
+/**
+@brief Subsumes or strengthens clause at offset2 with clause cl
 
-            //Update stats
-            cl.combineStats(cl2.stats);
+@return FALSE if the caller should stop: we are UNSAT or waaay over time
+*/
+bool SubsumeStrengthen::apply_sub_str(
+    Clause& cl
+    , const ClOffset offset2
+    , const Lit lit
+    , Sub1Ret& ret
+) {
+    Clause& cl2 = *solver->cl_alloc.ptr(offset2);
+    #ifdef USE_GAUSS
+    if (cl2.used_in_xor()) {
+        return true;
+    }
+    #endif
 
-            simplifier->unlink_clause(offset2, true, false, true);
-            ret.sub++;
-        } else { //Strengthen
-            #ifdef VERBOSE_DEBUG
-            if (solver->conf.verbosity >= 6) {
-                cout << "strenghtened clause " << cl2 << endl;
-            }
-            #endif
-            #ifdef USE_GAUSS
-            if (cl2.used_in_xor()) {
-                continue;
+    if (lit == lit_Undef) {  //Subsume
+        #ifdef VERBOSE_DEBUG
+        if (solver->conf.verbosity >= 6)
+            cout << "subsumed clause " << cl2 << endl;
+        #endif
+
+        //If subsumes a irred, and is redundant, make it irred
+        if (cl.red()
+            && !cl2.red()
+        ) {
+            cl.makeIrred();
+            solver->litStats.redLits -= cl.size();
+            solver->litStats.irredLits += cl.size();
+            if (!cl.getOccurLinked()) {
+                simplifier->linkInClause(cl);
+            } else {
+                for(const Lit l: cl) {
+                    simplifier->n_occurs[l.toInt()]++;
+                }
             }
-            #endif
-            remove_literal(offset2, subsLits[j]);
+        }
 
-            ret.str++;
-            if (!solver->ok)
-                return ret;
+        //Update stats
+        cl.combineStats(cl2.stats);
 
-            //If we are waaay over time, just exit
-            if (*simplifier->limit_to_decrease < -20LL*1000LL*1000LL)
-                break;
+        simplifier->unlink_clause(offset2, true, false, true);
+        ret.sub++;
+    } else { //Strengthen
+        #ifdef VERBOSE_DEBUG
+        if (solver->conf.verbosity >= 6) {
+            cout << "strenghtened clause " << cl2 << endl;
         }
+        #endif
+        remove_literal(offset2, lit);
+
+        ret.str++;
+        if (!solver->ok)
+            return false;
+
+        //If we are waaay over time, just exit
+        if (*simplifier->limit_to_decrease < -20LL*1000LL*1000LL)
+            return false;
     }
 
-    return ret;
+    return true;
 }
 
 void SubsumeStrengthen::randomise_clauses_order()
@@ -248,6 +262,7 @@ void SubsumeStrengthen::backw_sub_long_with_long()
     size_t subsumed = 0;
     const int64_t orig_limit = simplifier->subsumption_time_limit;
     randomise_clauses_order();
+    build_sig_occ();
     while (*simplifier->limit_to_decrease > 0
         && (double)wenThrough < solver->conf.subsume_gothrough_multip*(double)simplifier->clauses.size()
     ) {
@@ -269,11 +284,19 @@ void SubsumeStrengthen::backw_sub_long_with_long()
         if (cl->freed() || cl->getRemoved())
             continue;
 
+        //Nothing new to subsume with it
+        if (solver->conf.occ_sub_str_incremental
+            && cl->get_occur_sub_str_done()
+        ) {
+            continue;
+        }
 
         *simplifier->limit_to_decrease -= 10;
         subsumed += subsume_and_unlink_and_markirred(offset);
     }
 
+    clear_sig_occ();
+
     const double time_used = cpuTime() - myTime;
     const bool time_out = (*simplifier->limit_to_decrease <= 0);
     const double time_remain = float_div(*simplifier->limit_to_decrease, orig_limit);
@@ -310,6 +333,18 @@ bool SubsumeStrengthen::backw_str_long_with_long()
     size_t wenThrough = 0;
     const int64_t orig_limit = *simplifier->limit_to_decrease;
     Sub1Ret ret;
+    const bool incremental = solver->conf.occ_sub_str_incremental;
+    size_t num_done = 0;
+    size_t skipped = 0;
+    if (incremental) {
+        for(const ClOffset offset: simplifier->clauses) {
+            const Clause* cl = solver->cl_alloc.ptr(offset);
+            num_done += !cl->freed()
+                && !cl->getRemoved()
+                && cl->get_occur_sub_str_done();
+        }
+        *simplifier->limit_to_decrease -= (long)simplifier->clauses.size();
+    }
 
     randomise_clauses_order();
     while(*simplifier->limit_to_decrease > 0
@@ -334,8 +369,26 @@ bool SubsumeStrengthen::backw_str_long_with_long()
         if (cl->freed() || cl->getRemoved())
             continue;
 
-        ret += strengthen_subsume_and_unlink_and_markirred(offset);
+        if (!incremental) {
+            ret += strengthen_subsume_and_unlink_and_markirred(offset);
+            continue;
+        }
 
+        if (cl->get_occur_sub_str_done()) {
+            skipped++;
+            continue;
+        }
+
+        //The done clauses have not seen this one yet
+        if (num_done > 0) {
+            ret += sub_str_with_done(offset);
+            if (cl->freed() || cl->getRemoved() || !solver->okay())
+                continue;
+        }
+        ret += strengthen_subsume_and_unlink_and_markirred(offset);
+        if (cl->getOccurLinked()) {
+            cl->set_occur_sub_str_done(true);
+        }
     }
 
     const double time_used = cpuTime() - myTime;
@@ -349,7 +402,11 @@ bool SubsumeStrengthen::backw_str_long_with_long()
         << " tried: " << wenThrough << "/" << simplifier->clauses.size()
         << " ("
         << stats_line_percent(wenThrough, simplifier->clauses.size())
-        << ") "
+        << ") ";
+        if (incremental) {
+            cout << " skip-done: " << skipped;
+        }
+        cout
         << solver->conf.print_times(time_used, time_out, time_remain)
         << endl;
     }
@@ -367,6 +424,281 @@ bool SubsumeStrengthen::backw_str_long_with_long()
     runStats.subsumedByStr += ret.sub;
     runStats.litsRemStrengthen += ret.str;
     runStats.strengthenTime += cpuTime() - myTime;
+    runStats.skippedAsDone += skipped;
+
+    return solver->okay();
+}
+
+/**
+@brief Subsumes or strengthens the clause at offset with the clauses that are
+already marked done, as those will not be used as subsumers again
+
+Only the clauses whose smallest literal is in the clause, or is the negation
+of one in it, can do this. So each is only looked at once.
+*/
+SubsumeStrengthen::Sub1Ret SubsumeStrengthen::sub_str_with_done(const ClOffset offset)
+{
+    Sub1Ret ret;
+    bool changed = true;
+    while(changed
+        && solver->okay()
+        && *simplifier->limit_to_decrease > 0
+    ) {
+        changed = false;
+        const Clause& cl = *solver->cl_alloc.ptr(offset);
+        if (cl.freed() || cl.getRemoved())
+            break;
+
+        #ifdef USE_GAUSS
+        if (cl.used_in_xor())
+            break;
+        #endif
+
+        for(uint32_t i = 0; i < cl.size()*2 && !changed; i++) {
+            const Lit lit = (i % 2) ? ~cl[i/2] : cl[i/2];
+            watch_subarray_const ws = solver->watches[lit];
+            *simplifier->limit_to_decrease -= (long)ws.size() + 10;
+            for(const Watched& w: ws) {
+                if (!w.isClause()
+                    || w.get_offset() == offset
+                    || !subsetAbst(w.getAbst(), cl.abst)
+                ) {
+                    continue;
+                }
+
+                Clause& cl2 = *solver->cl_alloc.ptr(w.get_offset());
+                if (cl2.freed()
+                    || cl2.getRemoved()
+                    || !cl2.get_occur_sub_str_done()
+                    || cl2.size() > cl.size()
+                    || cl2[0] != lit
+                ) {
+                    continue;
+                }
+
+                const Lit litSub = subset1(cl2, cl, simplifier->limit_to_decrease);
+                if (litSub == lit_Error)
+                    continue;
+
+                apply_sub_str(cl2, offset, litSub, ret);
+                changed = true;
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/**
+@brief Orders clauses by the var of their smallest occurrence lists and splits
+them into one contiguous range per thread, balanced by occurrence list size
+
+Clauses that walk the same occurrence lists end up in the same thread
+*/
+void SubsumeStrengthen::fill_par_sub_str_work(const unsigned num_threads)
+{
+    par_work.clear();
+    vector<uint64_t> cost;
+    uint64_t total_cost = 0;
+    for(const ClOffset offset: simplifier->clauses) {
+        const Clause& cl = *solver->cl_alloc.ptr(offset);
+        if (cl.freed() || cl.getRemoved())
+            continue;
+
+        uint32_t minVar = var_Undef;
+        uint32_t bestSize = std::numeric_limits<uint32_t>::max();
+        for (const Lit l: cl) {
+            const uint32_t newSize =
+                solver->watches[l].size() + solver->watches[~l].size();
+            if (newSize < bestSize) {
+                minVar = l.var();
+                bestSize = newSize;
+            }
+        }
+        *simplifier->limit_to_decrease -= (long)cl.size() + 10;
+        SubStrWork w;
+        w.min_var = minVar;
+        w.offset = offset;
+        par_work.push_back(w);
+    }
+    std::sort(par_work.begin(), par_work.end());
+
+    cost.reserve(par_work.size());
+    for(const SubStrWork& w: par_work) {
+        const uint64_t c = 40 + solver->watches[Lit(w.min_var, false)].size()
+            + solver->watches[Lit(w.min_var, true)].size();
+        total_cost += c;
+        cost.push_back(c);
+    }
+
+    par_threads.resize(num_threads);
+    const int64_t limit_per_thread = std::max<int64_t>(
+        0, *simplifier->limit_to_decrease/(int64_t)num_threads);
+    size_t at = 0;
+    uint64_t sum = 0;
+    for(unsigned i = 0; i < num_threads; i++) {
+        SubStrThread& t = par_threads[i];
+        t.found.clear();
+        t.limit = limit_per_thread;
+        t.start_limit = limit_per_thread;
+        t.time_used = 0;
+        t.sub = 0;
+        t.str = 0;
+        t.start = at;
+        const uint64_t until = (total_cost*(i+1))/num_threads;
+        while(at < par_work.size()
+            && (sum < until || i+1 == num_threads)
+        ) {
+            sum += cost[at];
+            at++;
+        }
+        t.end = at;
+    }
+}
+
+//Runs in its own thread. Only reads the clauses and the occurrence lists
+void SubsumeStrengthen::find_strengthened_thread(SubStrThread& t)
+{
+    const double myTime = cpuTime();
+    for(size_t at = t.start
+        ; at < t.end && t.limit > 0 && !solver->must_interrupt_asap()
+        ; at++
+    ) {
+        t.limit -= 10;
+        const ClOffset offset = par_work[at].offset;
+        const Clause& cl = *solver->cl_alloc.ptr(offset);
+        t.subs.clear();
+        t.subsLits.clear();
+        findStrengthened(offset, cl, cl.abst, t.subs, t.subsLits, &t.limit);
+        for(size_t i = 0; i < t.subs.size(); i++) {
+            SubStrFound f;
+            f.at = at;
+            f.offset2 = t.subs[i];
+            f.lit = t.subsLits[i];
+            t.found.push_back(f);
+        }
+    }
+    t.time_used = cpuTime() - myTime;
+}
+
+/**
+@brief Backward-subsumes and strengthens long clauses with long clauses using
+multiple threads
+
+The threads only search for candidates. The candidates are then applied in
+the order of the clauses, re-checking each, as earlier ones may have changed
+the clauses involved. The result does not depend on thread scheduling.
+*/
+bool SubsumeStrengthen::backw_sub_str_long_with_long_par(const unsigned num_threads)
+{
+    assert(solver->ok);
+    assert(num_threads > 1);
+
+    const double myTime = cpuTime();
+    const int64_t orig_limit = *simplifier->limit_to_decrease;
+    fill_par_sub_str_work(num_threads);
+
+    vector<std::thread> threads;
+    for(unsigned i = 1; i < num_threads; i++) {
+        threads.push_back(std::thread(
+            &SubsumeStrengthen::find_strengthened_thread, this, std::ref(par_threads[i])));
+    }
+    find_strengthened_thread(par_threads[0]);
+    for(std::thread& th: threads) {
+        th.join();
+    }
+
+    //Merge
+    const double mergeTime = cpuTime();
+    size_t tried = 0;
+    for(const SubStrThread& t: par_threads) {
+        *simplifier->limit_to_decrease -= t.start_limit - t.limit;
+        tried += t.end - t.start;
+    }
+    Sub1Ret ret;
+    bool cont = true;
+    for(SubStrThread& t: par_threads) {
+        for(const SubStrFound& f: t.found) {
+            if (!cont || !solver->okay())
+                break;
+
+            Clause& cl = *solver->cl_alloc.ptr(par_work[f.at].offset);
+            const Clause& cl2 = *solver->cl_alloc.ptr(f.offset2);
+            if (cl.freed() || cl.getRemoved()
+                || cl2.freed() || cl2.getRemoved()
+            ) {
+                continue;
+            }
+
+            const Lit lit = subset1(cl, cl2, simplifier->limit_to_decrease);
+            if (lit == lit_Error)
+                continue;
+
+            Sub1Ret this_ret;
+            cont = apply_sub_str(cl, f.offset2, lit, this_ret);
+            t.sub += this_ret.sub;
+            t.str += this_ret.str;
+            ret += this_ret;
+        }
+    }
+    const double merge_time = cpuTime() - mergeTime;
+
+    const double time_used = cpuTime() - myTime;
+    const bool time_out = *simplifier->limit_to_decrease <= 0;
+    const double time_remain = float_div(*simplifier->limit_to_decrease, orig_limit);
+    double thread_time = 0;
+    double max_thread_time = 0;
+    for(size_t i = 0; i < par_threads.size(); i++) {
+        const SubStrThread& t = par_threads[i];
+        thread_time += t.time_used;
+        max_thread_time = std::max(max_thread_time, t.time_used);
+        if (solver->conf.verbosity >= 2) {
+            cout
+            << "c [occ-sub-str-long-w-long-par] T" << i
+            << " cls: " << t.end - t.start
+            << " cands: " << t.found.size()
+            << " sub: " << t.sub
+            << " str: " << t.str
+            << " T: " << std::setprecision(2) << std::fixed << t.time_used
+            << endl;
+        }
+    }
+
+    if (solver->conf.verbosity) {
+        cout
+        << "c [occ-sub-str-long-w-long-par] sub: " << ret.sub
+        << " str: " << ret.str
+        << " tried: " << tried << "/" << simplifier->clauses.size()
+        << " threads: " << num_threads
+        << " find-T: " << std::setprecision(2) << std::fixed << max_thread_time
+        << " merge-T: " << merge_time
+        << solver->conf.print_times(time_used, time_out, time_remain)
+        << endl;
+    }
+    if (solver->sqlStats) {
+        solver->sqlStats->time_passed(
+            solver
+            , "occ-sub-str-long-w-long-par"
+            , time_used
+            , time_out
+            , time_remain
+        );
+    }
+
+    //Update stats
+    simplifier->runStats.parSubStrCalls++;
+    simplifier->runStats.parSubStrSubsumed += ret.sub;
+    simplifier->runStats.parSubStrLitsRem += ret.str;
+    simplifier->runStats.parSubStrThreadTime += thread_time;
+    simplifier->runStats.parSubStrMaxThreadTime += max_thread_time;
+    simplifier->runStats.parSubStrMergeTime += merge_time;
+    runStats.subsumedByStr += ret.sub;
+    runStats.litsRemStrengthen += ret.str;
+    runStats.strengthenTime += time_used;
+
+    vector<SubStrWork>().swap(par_work);
+    vector<SubStrThread>().swap(par_threads);
 
     return solver->okay();
 }
@@ -384,10 +716,11 @@ void inline SubsumeStrengthen::fillSubs(
     , vector<ClOffset>& out_subsumed
     , vector<Lit>& out_lits
     , const Lit lit
+    , int64_t* limit
 ) {
     Lit litSub;
     watch_subarray_const cs = solver->watches[lit];
-    *simplifier->limit_to_decrease -= (long)cs.size()*2+ 40;
+    *limit -= (long)cs.size()*2+ 40;
     for (const Watched *it = cs.begin(), *end = cs.end()
         ; it != end
         ; ++it
@@ -409,8 +742,8 @@ void inline SubsumeStrengthen::fillSubs(
             continue;
         }
 
-        *simplifier->limit_to_decrease -= (long)((cl.size() + cl2.size())/4);
-        litSub = subset1(cl, cl2);
+        *limit -= (long)((cl.size() + cl2.size())/4);
+        litSub = subset1(cl, cl2, limit);
         if (litSub != lit_Error) {
             out_subsumed.push_back(it->get_offset());
             out_lits.push_back(litSub);
@@ -447,6 +780,7 @@ void SubsumeStrengthen::findStrengthened(
     , const cl_abst_type abs
     , vector<ClOffset>& out_subsumed
     , vector<Lit>& out_lits
+    , int64_t* limit
 )
 {
     #ifdef VERBOSE_DEBUG
@@ -466,10 +800,10 @@ void SubsumeStrengthen::findStrengthened(
         }
     }
     assert(minVar != var_Undef);
-    *simplifier->limit_to_decrease -= (long)cl.size();
+    *limit -= (long)cl.size();
 
-    fillSubs(offset, cl, abs, out_subsumed, out_lits, Lit(minVar, true));
-    fillSubs(offset, cl, abs, out_subsumed, out_lits, Lit(minVar, false));
+    fillSubs(offset, cl, abs, out_subsumed, out_lits, Lit(minVar, true), limit);
+    fillSubs(offset, cl, abs, out_subsumed, out_lits, Lit(minVar, false), limit);
 }
 
 bool SubsumeStrengthen::handle_added_long_cl(
@@ -614,33 +948,9 @@ bool SubsumeStrengthen::subset(const T1& A, const T2& B)
     }
     #endif
 
-    bool ret;
-    uint32_t i = 0;
+    uint32_t i;
     uint32_t i2;
-    Lit lastB = lit_Undef;
-    for (i2 = 0; i2 < B.size(); i2++) {
-        if (lastB != lit_Undef)
-            assert(lastB < B[i2]);
-
-        lastB = B[i2];
-        //Literals are ordered
-        if (A[i] < B[i2]) {
-            ret = false;
-            goto end;
-        }
-        else if (A[i] == B[i2]) {
-            i++;
-
-            //went through the whole of A now, so A subsumes B
-            if (i == A.size()) {
-                ret = true;
-                goto end;
-            }
-        }
-    }
-    ret = false;
-
-    end:
+    const bool ret = sorted_subset(A, B, i, i2);
     *simplifier->limit_to_decrease -= (long)i2*4 + (long)i*4;
     return ret;
 }
@@ -659,7 +969,7 @@ clause B
 and returns the literal to remove if (2) is true
 */
 template<class T1, class T2>
-Lit SubsumeStrengthen::subset1(const T1& A, const T2& B)
+Lit SubsumeStrengthen::subset1(const T1& A, const T2& B, int64_t* limit)
 {
     Lit retLit = lit_Undef;
 
@@ -691,7 +1001,7 @@ Lit SubsumeStrengthen::subset1(const T1& A, const T2& B)
     retLit = lit_Error;
 
     end:
-    *simplifier->limit_to_decrease -= (long)i2*4 + (long)i*4;
+    *limit -= (long)i2*4 + (long)i*4;
     return retLit;
 }
 
@@ -712,6 +1022,106 @@ size_t SubsumeStrengthen::find_smallest_watchlist_for_clause(const T& ps) const
     return min_i;
 }
 
+void SubsumeStrengthen::build_sig_occ()
+{
+    const size_t num_lits = solver->nVars()*2;
+    sig_occ_start.assign(num_lits+1, 0);
+    for(const ClOffset offset: simplifier->clauses) {
+        const Clause& cl = *solver->cl_alloc.ptr(offset);
+        if (cl.freed() || cl.getRemoved() || !cl.getOccurLinked())
+            continue;
+
+        for(const Lit l: cl) {
+            sig_occ_start[l.toInt()+1]++;
+        }
+    }
+    for(size_t i = 1; i < sig_occ_start.size(); i++) {
+        sig_occ_start[i] += sig_occ_start[i-1];
+    }
+    const uint32_t total = sig_occ_start.back();
+    *simplifier->limit_to_decrease -= (long)total*2 + (long)num_lits;
+
+    //Fill, using sig_occ_start[lit] as the insertion point, then shift back
+    sig_occ.resize(total);
+    sig_occ_offs.resize(total);
+    for(const ClOffset offset: simplifier->clauses) {
+        const Clause& cl = *solver->cl_alloc.ptr(offset);
+        if (cl.freed() || cl.getRemoved() || !cl.getOccurLinked())
+            continue;
+
+        const cl_sig_type sig = calc_sig(cl);
+        for(const Lit l: cl) {
+            const uint32_t at = sig_occ_start[l.toInt()]++;
+            sig_occ[at] = sig;
+            sig_occ_offs[at] = offset;
+        }
+    }
+    for(size_t i = num_lits; i > 0; i--) {
+        sig_occ_start[i] = sig_occ_start[i-1];
+    }
+    sig_occ_start[0] = 0;
+}
+
+void SubsumeStrengthen::clear_sig_occ()
+{
+    vector<uint32_t>().swap(sig_occ_start);
+    vector<cl_sig_type>().swap(sig_occ);
+    vector<ClOffset>().swap(sig_occ_offs);
+    vector<uint32_t>().swap(sig_cands);
+}
+
+/**
+@brief Same as find_subsumed, but using the signatures in sig_occ
+
+The signatures of the smallest list are filtered many at a time, and only the
+survivors are looked up and checked with a sorted merge
+*/
+template<class T>
+void SubsumeStrengthen::find_subsumed_sig(
+    const ClOffset offset
+    , const T& ps
+    , vector<ClOffset>& out_subsumed
+) {
+    uint32_t smallest = ps[0].toInt();
+    for(const Lit l: ps) {
+        if (sig_occ_start[l.toInt()+1] - sig_occ_start[l.toInt()]
+            < sig_occ_start[smallest+1] - sig_occ_start[smallest]
+        ) {
+            smallest = l.toInt();
+        }
+    }
+    *simplifier->limit_to_decrease -= (long)ps.size();
+
+    const uint32_t start = sig_occ_start[smallest];
+    const uint32_t num = sig_occ_start[smallest+1] - start;
+    if (sig_cands.size() < num) {
+        sig_cands.resize(num);
+    }
+    const size_t num_cands = filter_sig_supersets(
+        sig_occ.data() + start, num, calc_sig(ps), sig_cands.data());
+    *simplifier->limit_to_decrease -= (long)num*2 + 40;
+    runStats.sigChecked += num;
+    runStats.sigPassed += num_cands;
+
+    for(size_t i = 0; i < num_cands; i++) {
+        const ClOffset offset2 = sig_occ_offs[start + sig_cands[i]];
+        if (offset2 == offset)
+            continue;
+
+        const Clause& cl2 = *solver->cl_alloc.ptr(offset2);
+        if (ps.size() > cl2.size() || cl2.getRemoved())
+            continue;
+
+        *simplifier->limit_to_decrease -= 50;
+        if (subset(ps, cl2)) {
+            out_subsumed.push_back(offset2);
+            #ifdef VERBOSE_DEBUG
+            cout << "subsumed cl offset: " << offset2 << endl;
+            #endif
+        }
+    }
+}
+
 /**
 @brief Finds clauses that are backward-subsumed by given clause
 
@@ -725,6 +1135,11 @@ template<class T> void SubsumeStrengthen::find_subsumed(
     , vector<ClOffset>& out_subsumed //List of clause indexes subsumed
     , bool removeImplicit
 ) {
+    if (!removeImplicit && !sig_occ_start.empty()) {
+        find_subsumed_sig(offset, ps, out_subsumed);
+        return;
+    }
+
     #ifdef VERBOSE_DEBUG
     cout << "find_subsumed: ";
     for (const Lit lit: ps) {
@@ -809,6 +1224,11 @@ size_t SubsumeStrengthen::mem_used() const
     size_t b = 0;
     b += subs.capacity()*sizeof(ClOffset);
     b += subsLits.capacity()*sizeof(Lit);
+    b += par_work.capacity()*sizeof(SubStrWork);
+    b += sig_occ_start.capacity()*sizeof(uint32_t);
+    b += sig_occ.capacity()*sizeof(cl_sig_type);
+    b += sig_occ_offs.capacity()*sizeof(ClOffset);
+    b += sig_cands.capacity()*sizeof(uint32_t);
 
     return b;
 }
@@ -839,6 +1259,15 @@ void SubsumeStrengthen::Stats::print() const
         , litsRemStrengthen
         , " Lits"
     );
+    print_stats_line("c cl-sub sig passed"
+        , sigPassed
+        , stats_line_percent(sigPassed, sigChecked)
+        , "% of checked"
+    );
+    print_stats_line("c cl-str skipped done"
+        , skippedAsDone
+        , " Clauses"
+    );
     print_stats_line("c cl-sub T"
         , subsumeTime
         , " s"
@@ -855,6 +1284,9 @@ SubsumeStrengthen::Stats& SubsumeStrengthen::Stats::operator+=(const Stats& othe
     subsumedBySub += other.subsumedBySub;
     subsumedByStr += other.subsumedByStr;
     litsRemStrengthen += other.litsRemStrengthen;
+    sigChecked += other.sigChecked;
+    sigPassed += other.sigPassed;
+    skippedAsDone += other.skippedAsDone;
 
     subsumeTime += other.subsumeTime;
     strengthenTime += other.strengthenTime;
@@ -874,6 +1306,7 @@ SubsumeStrengthen::Sub1Ret SubsumeStrengthen::backw_sub_str_long_with_implicit(
         , calcAbstraction(lits)
         , subs
         , subsLits
+        , simplifier->limit_to_decrease
     );
 
     Sub1Ret ret;
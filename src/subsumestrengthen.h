@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "cloffset.h"
 #include "cryptominisat5/solvertypesmini.h"
 #include "clabstraction.h"
+#include "clsignature.h"
 #include "clause.h"
 #include <vector>
 using std::vector;
@@ -44,6 +45,7 @@ public:
 
     void backw_sub_long_with_long();
     bool backw_str_long_with_long();
+    bool backw_sub_str_long_with_long_par(const unsigned num_threads);
     bool backw_sub_str_long_with_bins();
 
     //Called from simplifier at resolvent-adding of var-elim
@@ -87,6 +89,9 @@ public:
         uint64_t subsumedBySub = 0;
         uint64_t subsumedByStr = 0;
         uint64_t litsRemStrengthen = 0;
+        uint64_t sigChecked = 0;
+        uint64_t sigPassed = 0;
+        uint64_t skippedAsDone = 0;
 
         double subsumeTime = 0.0;
         double strengthenTime = 0.0;
@@ -121,6 +126,64 @@ private:
         , const bool removeImplicit = false
     );
 
+    //Parallel backward sub/str: threads only search, the merge modifies
+    struct SubStrFound
+    {
+        uint32_t at; ///<Index into par_work of the subsuming clause
+        ClOffset offset2;
+        Lit lit;
+    };
+    struct SubStrThread
+    {
+        vector<ClOffset> subs;
+        vector<Lit> subsLits;
+        vector<SubStrFound> found;
+        size_t start = 0;
+        size_t end = 0;
+        int64_t limit = 0;
+        int64_t start_limit = 0;
+        double time_used = 0;
+        uint64_t sub = 0;
+        uint64_t str = 0;
+    };
+    struct SubStrWork
+    {
+        uint32_t min_var; ///<Var with the smallest occurrence lists
+        ClOffset offset;
+        bool operator<(const SubStrWork& other) const
+        {
+            if (min_var != other.min_var)
+                return min_var < other.min_var;
+            return offset < other.offset;
+        }
+    };
+    vector<SubStrWork> par_work;
+    vector<SubStrThread> par_threads;
+    void fill_par_sub_str_work(const unsigned num_threads);
+    void find_strengthened_thread(SubStrThread& t);
+    bool apply_sub_str(
+        Clause& cl
+        , const ClOffset offset2
+        , const Lit lit
+        , Sub1Ret& ret
+    );
+
+    //Signatures of the linked-in long clauses, contiguous per literal.
+    //Only valid while clauses are only removed or shortened.
+    vector<uint32_t> sig_occ_start;
+    vector<cl_sig_type> sig_occ;
+    vector<ClOffset> sig_occ_offs;
+    vector<uint32_t> sig_cands;
+    void build_sig_occ();
+    void clear_sig_occ();
+    template<class T>
+    void find_subsumed_sig(
+        const ClOffset offset
+        , const T& ps
+        , vector<ClOffset>& out_subsumed
+    );
+
+    Sub1Ret sub_str_with_done(const ClOffset offset);
     void randomise_clauses_order();
     void remove_literal(ClOffset c, const Lit toRemoveLit);
 
@@ -134,6 +197,7 @@ private:
         , const cl_abst_type abs
         , vector<ClOffset>& out_subsumed
         , vector<Lit>& out_lits
+        , int64_t* limit
     );
 
     template<class T>
@@ -144,13 +208,14 @@ private:
         , vector<ClOffset>& out_subsumed
         , vector<Lit>& out_lits
         , const Lit lit
+        , int64_t* limit
     );
 
     template<class T1, class T2>
     bool subset(const T1& A, const T2& B);
 
     template<class T1, class T2>
-    Lit subset1(const T1& A, const T2& B);
+    Lit subset1(const T1& A, const T2& B, int64_t* limit);
     bool subsetAbst(const cl_abst_type A, const cl_abst_type B);
 
     vector<ClOffset> subs;
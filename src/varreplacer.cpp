@@ -28,9 +28,12 @@ THE SOFTWARE.
 #include "clauseallocator.h"
 #include "sqlstats.h"
 #include "sccfinder.h"
+#include "comphandler.h"
 #include <iostream>
 #include <iomanip>
 #include <set>
+#include <thread>
+#include <functional>
 using std::cout;
 using std::endl;
 
@@ -514,14 +517,73 @@ bool VarReplacer::replaceImplicit()
 /**
 @brief Replaces variables in long clauses
 */
+/**
+@brief Marks in cl_changed the clauses in cs[start..end) with a replaced lit
+
+Only reads the clauses and the replacement table, so ranges can be scanned
+concurrently.
+*/
+void VarReplacer::find_changed_cls(
+    const vector<ClOffset>& cs
+    , const size_t start
+    , const size_t end
+) {
+    for(size_t at = start; at < end; at++) {
+        const Clause& c = *solver->cl_alloc.ptr(cs[at]);
+        char changed = false;
+        for (const Lit l: c) {
+            if (isReplaced_fast(l)) {
+                changed = true;
+                break;
+            }
+        }
+        cl_changed[at] = changed;
+    }
+}
+
+void VarReplacer::find_changed_cls_par(
+    const vector<ClOffset>& cs
+    , unsigned num_threads
+) {
+    //Not worth starting threads for only a few clauses
+    num_threads = std::min<size_t>(num_threads, cs.size()/5000 + 1);
+    cl_changed.clear();
+    cl_changed.resize(cs.size(), false);
+
+    const size_t chunk = (cs.size() + num_threads - 1)/num_threads;
+    vector<std::thread> threads;
+    for(unsigned i = 1; i < num_threads; i++) {
+        const size_t start = std::min(cs.size(), chunk*i);
+        const size_t end = std::min(cs.size(), chunk*(i+1));
+        threads.push_back(std::thread(
+            &VarReplacer::find_changed_cls, this, std::cref(cs), start, end));
+    }
+    find_changed_cls(cs, 0, std::min(cs.size(), chunk));
+    for(std::thread& t: threads) {
+        t.join();
+    }
+}
+
 bool VarReplacer::replace_set(vector<ClOffset>& cs)
 {
     assert(!solver->drat->something_delayed());
+
+    //Find the (few) clauses to be updated in parallel, then update only
+    //those, in order
+    cl_changed.clear();
+    if (solver->conf.varreplace_threads > 1) {
+        find_changed_cls_par(cs, solver->conf.varreplace_threads);
+    }
+
     vector<ClOffset>::iterator i = cs.begin();
     vector<ClOffset>::iterator j = i;
     for (vector<ClOffset>::iterator end = cs.end(); i != end; i++) {
         runStats.bogoprops += 3;
         assert(!solver->drat->something_delayed());
+        if (!cl_changed.empty() && !cl_changed[i - cs.begin()]) {
+            *j++ = *i;
+            continue;
+        }
 
         Clause& c = *solver->cl_alloc.ptr(*i);
         assert(!c.getRemoved());
@@ -553,6 +615,7 @@ bool VarReplacer::replace_set(vector<ClOffset>& cs)
 
     }
     cs.resize(cs.size() - (i-j));
+    cl_changed.clear();
     assert(!solver->drat->something_delayed());
 
     return solver->okay();
@@ -921,8 +984,24 @@ bool VarReplacer::replace(
     return update_table_and_reversetable(lit1_outer, lit2_outer);
 }
 
-bool VarReplacer::update_table_and_reversetable(const Lit lit1, const Lit lit2)
+bool VarReplacer::update_table_and_reversetable(Lit lit1, Lit lit2)
 {
+    //The clauses of the two vars are about to be in the same component
+    if (solver->compHandler) {
+        solver->compHandler->vars_merged_outer(lit1.var(), lit2.var());
+    }
+
+    //A frozen var is never replaced by one that isn't
+    const bool frozen1 = solver->var_frozen_outer(lit1.var());
+    if (frozen1 != solver->var_frozen_outer(lit2.var())) {
+        if (frozen1) {
+            std::swap(lit1, lit2);
+        }
+        setAllThatPointsHereTo(lit1.var(), lit2 ^ lit1.sign());
+        replacedVars++;
+        return true;
+    }
+
     if (reverseTable.find(lit1.var()) == reverseTable.end()) {
         reverseTable[lit2.var()].push_back(lit1.var());
         table[lit1.var()] = lit2 ^ lit1.sign();
@@ -1060,6 +1139,7 @@ size_t VarReplacer::mem_used() const
     b += scc_finder->mem_used();
     b += delayedEnqueue.capacity()*sizeof(Lit);
     b += table.capacity()*sizeof(Lit);
+    b += cl_changed.capacity()*sizeof(char);
     for(map<uint32_t, vector<uint32_t> >::const_iterator
         it = reverseTable.begin(), end = reverseTable.end()
         ; it != end
@@ -1285,6 +1365,7 @@ void VarReplacer::load_state(SimpleInFile& f)
     f.get_vector(table);
     replacedVars = f.get_uint32_t();
 
+    reverseTable.clear();
     vector<uint32_t> point_to;
     uint32_t num = f.get_uint32_t();
     for(uint32_t i = 0; i < num; i++)
@@ -144,6 +144,9 @@ class VarReplacer
         void checkUnsetSanity();
 
         bool replace_set(vector<ClOffset>& cs);
+        void find_changed_cls_par(const vector<ClOffset>& cs, unsigned num_threads);
+        void find_changed_cls(const vector<ClOffset>& cs, size_t start, size_t end);
+        vector<char> cl_changed; ///<cl_changed[i]: cs[i] contains a replaced lit
         void attach_delayed_attach();
         void update_all_vardata_activities();
         void update_vardata_and_activities(
@@ -223,7 +226,7 @@ class VarReplacer
 
          //While replacing the implicit clauses we cannot enqeue
         vector<Lit> delayedEnqueue;
-        bool update_table_and_reversetable(const Lit lit1, const Lit lit2);
+        bool update_table_and_reversetable(Lit lit1, Lit lit2);
         void setAllThatPointsHereTo(const uint32_t var, const Lit lit);
 
         //Mapping tables
@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include "watched.h"
 #include "Vec.h"
+#include "watchpool.h"
 #include <vector>
 
 namespace CMSat {
@@ -40,6 +41,25 @@ public:
     vec<vec<Watched> > watches;
     vector<Lit> smudged_list;
     vector<char> smudged;
+    WatchPool* pool = NULL;
+
+    watch_array() = default;
+    watch_array(const watch_array&) = delete;
+    watch_array& operator=(const watch_array&) = delete;
+
+    ~watch_array()
+    {
+        //Lists must go back to the pool before it's gone
+        watches.clear(true);
+        delete pool;
+    }
+
+    ///Must be called while empty
+    void use_pool(const BigMem backing)
+    {
+        assert(watches.size() == 0 && pool == NULL);
+        pool = new WatchPool(backing);
+    }
 
     void smudge(const Lit lit) {
         if (!smudged[lit.toInt()]) {
@@ -87,7 +107,9 @@ public:
     {
         assert(smudged_list.empty());
         if (watches.size() < new_size) {
+            const size_t old_size = watches.size();
             watches.growTo(new_size);
+            set_pool(old_size);
         } else {
             watches.shrink(watches.size()-new_size);
         }
@@ -97,7 +119,20 @@ public:
     void insert(uint32_t num)
     {
         smudged.insert(smudged.end(), num, false);
+        const size_t old_size = watches.size();
         watches.insert(num);
+        set_pool(old_size);
+    }
+
+    void set_pool(const size_t from)
+    {
+        if (pool == NULL) {
+            return;
+        }
+        for(size_t i = from; i < watches.size(); i++) {
+            assert(watches[i].data == NULL);
+            watches[i].data = pool->empty();
+        }
     }
 
     size_t mem_used() const
@@ -166,6 +201,10 @@ public:
 
     size_t mem_used_alloc() const
     {
+        if (pool != NULL) {
+            return pool->mem_used();
+        }
+
         size_t mem = 0;
         for(auto& ws: watches) {
             mem += ws.capacity()*sizeof(Watched);
@@ -0,0 +1,200 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "watchpool.h"
+#include "Vec.h"
+
+#include <stdlib.h>
+#include <new>
+
+using namespace CMSat;
+
+WatchPool::WatchPool(const BigMem _backing) :
+    backing(_backing)
+{
+    for(Watched*& l: free_list) {
+        l = NULL;
+    }
+    set_pool_of(empty(), this);
+}
+
+WatchPool::~WatchPool()
+{
+    for(const auto& slab: slabs) {
+        big_free(slab.first, slab.second, backing);
+    }
+}
+
+Watched* WatchPool::alloc(uint32_t& cap)
+{
+    //Smallest class that fits cap+header
+    uint32_t k = 0;
+    while(k < num_classes && (2ULL << k) < (uint64_t)cap + 1) {
+        k++;
+    }
+
+    Watched* block;
+    if (k == num_classes) {
+        block = (Watched*)malloc(((size_t)cap + 1)*sizeof(Watched));
+        if (block == NULL) {
+            throw std::bad_alloc();
+        }
+        large_bytes += ((size_t)cap + 1)*sizeof(Watched);
+    } else if (free_list[k] != NULL) {
+        block = free_list[k];
+        memcpy(&free_list[k], block, sizeof(Watched*));
+        cap = (2U << k) - 1;
+    } else {
+        const size_t units = 2ULL << k;
+        if (slab_left < units) {
+            //The rest of the slab is lost, it's smaller than the largest class
+            void* slab = big_alloc(slab_bytes, backing);
+            slabs.push_back(std::make_pair(slab, slab_bytes));
+            slab_at = (Watched*)slab;
+            slab_left = slab_bytes/sizeof(Watched);
+        }
+        block = slab_at;
+        slab_at += units;
+        slab_left -= units;
+        cap = (2U << k) - 1;
+    }
+
+    Watched* data = block + 1;
+    set_pool_of(data, this);
+    return data;
+}
+
+void WatchPool::release(Watched* data, const uint32_t cap)
+{
+    if (cap == 0) {
+        assert(data == empty());
+        return;
+    }
+
+    Watched* block = data - 1;
+    const uint64_t units = (uint64_t)cap + 1;
+    if (units > (2ULL << (num_classes-1))) {
+        free(block);
+        large_bytes -= units*sizeof(Watched);
+        return;
+    }
+
+    uint32_t k = 0;
+    while((2ULL << k) < units) {
+        k++;
+    }
+    assert((2ULL << k) == units);
+    memcpy(block, &free_list[k], sizeof(Watched*));
+    free_list[k] = block;
+}
+
+size_t WatchPool::mem_used() const
+{
+    return slabs.size()*slab_bytes + large_bytes;
+}
+
+//vec<Watched> allocates through the pool of its block, if it has one
+template<>
+void vec<Watched>::capacity(int32_t min_cap)
+{
+    if ((int32_t)cap >= min_cap) {
+        return;
+    }
+
+    // NOTE: grow by approximately 3/2
+    uint32_t add = imax((min_cap - cap + 1) & ~1, ((cap >> 1) + 2) & ~1);
+    if (add > std::numeric_limits<uint32_t>::max() - cap - 1) {
+        throw std::bad_alloc();
+    }
+    uint32_t new_cap = cap + add;
+
+    WatchPool* pool = (data == NULL) ? NULL : WatchPool::pool_of(data);
+    if (pool != NULL) {
+        Watched* new_data = pool->alloc(new_cap);
+        if (sz > 0) {
+            memcpy((void*)new_data, (void*)data, sz*sizeof(Watched));
+        }
+        pool->release(data, cap);
+        data = new_data;
+        cap = new_cap;
+        return;
+    }
+
+    Watched* block = (data == NULL) ? NULL : data - 1;
+    block = (Watched*)::realloc((void*)block, ((size_t)new_cap + 1)*sizeof(Watched));
+    if (block == NULL) {
+        throw std::bad_alloc();
+    }
+    data = block + 1;
+    WatchPool::set_pool_of(data, NULL);
+    cap = new_cap;
+}
+
+template<>
+void vec<Watched>::free_mem()
+{
+    WatchPool* pool = WatchPool::pool_of(data);
+    if (pool != NULL) {
+        pool->release(data, cap);
+        data = pool->empty();
+    } else {
+        free((void*)(data - 1));
+        data = NULL;
+    }
+    cap = 0;
+}
+
+template<>
+void vec<Watched>::shrink_to_fit()
+{
+    if (data == NULL) {
+        return;
+    }
+    WatchPool* pool = WatchPool::pool_of(data);
+    if (sz == 0) {
+        free_mem();
+        return;
+    }
+
+    if (pool != NULL) {
+        uint32_t new_cap = sz;
+        Watched* new_data = pool->alloc(new_cap);
+        if (new_cap >= cap) {
+            pool->release(new_data, new_cap);
+            return;
+        }
+        memcpy((void*)new_data, (void*)data, sz*sizeof(Watched));
+        pool->release(data, cap);
+        data = new_data;
+        cap = new_cap;
+        return;
+    }
+
+    Watched* block = (Watched*)realloc((void*)(data - 1), ((size_t)sz + 1)*sizeof(Watched));
+    if (block == NULL) {
+        //We just keep the size then
+        return;
+    }
+    data = block + 1;
+    cap = sz;
+}
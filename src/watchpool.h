@@ -0,0 +1,93 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef __WATCHPOOL_H__
+#define __WATCHPOOL_H__
+
+#include <cstdint>
+#include "watched.h"
+#include "bigmem.h"
+#include <vector>
+#include <utility>
+#include <string.h>
+
+namespace CMSat {
+
+/**
+@brief Slab allocator for watch lists
+
+Blocks are 2^k Watched large, carved out of big slabs, and recycled through one
+free list per size. Larger lists are malloc()-ed. The memory of a solver's
+watch lists is thus packed together, and can be put on huge pages.
+
+Every vec<Watched> block, pooled or not, is preceded by one Watched-sized
+header that holds its pool (or NULL), so the block can always be released to
+where it came from.
+*/
+class WatchPool
+{
+public:
+    explicit WatchPool(const BigMem backing);
+    ~WatchPool();
+
+    ///Data pointer of zero-capacity lists that should allocate from this pool
+    Watched* empty()
+    {
+        return empty_block + 1;
+    }
+
+    ///Rounds 'cap' up to the capacity of the block returned
+    Watched* alloc(uint32_t& cap);
+    void release(Watched* data, const uint32_t cap);
+    size_t mem_used() const;
+
+    static WatchPool* pool_of(const Watched* data)
+    {
+        WatchPool* pool;
+        memcpy(&pool, (const void*)(data - 1), sizeof(WatchPool*));
+        return pool;
+    }
+    static void set_pool_of(Watched* data, WatchPool* pool)
+    {
+        memcpy((void*)(data - 1), &pool, sizeof(WatchPool*));
+    }
+
+private:
+    static_assert(sizeof(WatchPool*) <= sizeof(Watched), "header must fit into one Watched");
+
+    //Class k holds blocks of 2^(k+1) Watched, header included
+    static const uint32_t num_classes = 13;
+    static const size_t slab_bytes = 2ULL*1024ULL*1024ULL;
+
+    Watched* free_list[num_classes];
+    std::vector<std::pair<void*, size_t> > slabs;
+    Watched* slab_at = NULL;
+    size_t slab_left = 0; ///<In Watched units
+    size_t large_bytes = 0;
+    const BigMem backing;
+    Watched empty_block[1];
+};
+
+}
+
+#endif //__WATCHPOOL_H__
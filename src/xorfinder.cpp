@@ -375,7 +375,7 @@ void XorFinder::findXorMatch(watch_subarray_const occ, const Lit wlit)
         !poss_xor.foundAll()
     ) {
         const TransCache& cache1 = solver->implCache[wlit];
-        for (const LitExtra litExtra: cache1.lits) {
+        for (const LitExtra litExtra: cache1) {
             const Lit otherlit = litExtra.getLit();
             if (!occcnt[otherlit.var()]) {
                 continue;
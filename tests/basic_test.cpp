@@ -23,6 +23,9 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <fstream>
+#include <set>
+#include <thread>
+#include <cmath>
 
 #include "cryptominisat5/cryptominisat.h"
 #include "src/solverconf.h"
@@ -110,6 +113,793 @@ TEST(normal_interface, solve_multi_thread)
     EXPECT_EQ(s.get_model()[1], l_True);
 }
 
+TEST(normal_interface, add_clauses_flat)
+{
+    SATSolver s;
+    s.new_vars(3);
+    vector<Lit> lits;
+    vector<uint32_t> offsets = {0};
+    for(const string cl: {"1", "-2", "-1, 2, 3"}) {
+        const vector<Lit> c = str_to_cl(cl);
+        lits.insert(lits.end(), c.begin(), c.end());
+        offsets.push_back(lits.size());
+    }
+    EXPECT_TRUE(s.add_clauses(lits.data(), offsets.data(), 3));
+    lbool ret = s.solve();
+    EXPECT_EQ( ret, l_True);
+    EXPECT_EQ(s.get_model()[0], l_True);
+    EXPECT_EQ(s.get_model()[1], l_False);
+    EXPECT_EQ(s.get_model()[2], l_True);
+}
+
+TEST(normal_interface, add_clauses_flat_multi_thread)
+{
+    SATSolver s;
+    s.set_num_threads(3);
+    s.new_vars(3);
+    s.add_clause(str_to_cl("1"));
+    vector<Lit> lits;
+    vector<uint32_t> offsets = {0};
+    for(const string cl: {"-2", "-1, 2, 3"}) {
+        const vector<Lit> c = str_to_cl(cl);
+        lits.insert(lits.end(), c.begin(), c.end());
+        offsets.push_back(lits.size());
+    }
+    EXPECT_TRUE(s.add_clauses(lits.data(), offsets.data(), 2));
+    lbool ret = s.solve();
+    EXPECT_EQ( ret, l_True);
+    EXPECT_EQ(s.get_model()[0], l_True);
+    EXPECT_EQ(s.get_model()[1], l_False);
+    EXPECT_EQ(s.get_model()[2], l_True);
+
+    const vector<Lit> lits2 = str_to_cl("-3");
+    const vector<uint32_t> offsets2 = {0, 1};
+    s.add_clauses(lits2.data(), offsets2.data(), 1);
+    ret = s.solve();
+    EXPECT_EQ( ret, l_False);
+}
+
+TEST(normal_interface, freeze_melt)
+{
+    SATSolver s;
+    s.new_vars(3);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-1, 3"));
+    s.freeze(0);
+    s.freeze(0);
+    EXPECT_TRUE(s.is_frozen(0));
+    EXPECT_FALSE(s.is_frozen(1));
+
+    lbool ret = s.simplify();
+    EXPECT_EQ( ret, l_Undef);
+    s.melt(0);
+    EXPECT_TRUE(s.is_frozen(0));
+    s.melt(0);
+    EXPECT_FALSE(s.is_frozen(0));
+
+    vector<Lit> assumps = str_to_cl("-2, -3");
+    ret = s.solve(&assumps);
+    EXPECT_EQ( ret, l_False);
+    assumps = str_to_cl("1");
+    ret = s.solve(&assumps);
+    EXPECT_EQ( ret, l_True);
+    EXPECT_EQ(s.get_model()[2], l_True);
+}
+
+TEST(normal_interface, freeze_melt_unknown_var)
+{
+    SATSolver s;
+    s.new_vars(3);
+    EXPECT_EXIT(s.freeze(3), ::testing::ExitedWithCode(255), "freeze\\(\\) called on variable 4");
+    EXPECT_EXIT(s.melt(3), ::testing::ExitedWithCode(255), "melt\\(\\) called on variable 4");
+    EXPECT_EXIT(s.is_frozen(3), ::testing::ExitedWithCode(255), "is_frozen\\(\\) called on variable 4");
+}
+
+struct EnumCollect
+{
+    explicit EnumCollect(const vector<uint32_t>& _vars) :
+        vars(_vars)
+    {}
+
+    bool operator()(const vector<lbool>& model)
+    {
+        string sol;
+        for(const uint32_t var: vars) {
+            sol += (model[var] == l_True) ? '1' : '0';
+        }
+        found.insert(sol);
+        num++;
+        return true;
+    }
+
+    vector<uint32_t> vars;
+    std::set<string> found;
+    uint64_t num = 0;
+};
+
+TEST(enumerate, all)
+{
+    SATSolver s;
+    s.new_vars(4);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-3, 4"));
+    EnumCollect c({0, 1, 2, 3});
+    lbool ret = s.enumerate_solutions(std::ref(c));
+    EXPECT_EQ( ret, l_False);
+    EXPECT_EQ(c.num, 9U);
+    EXPECT_EQ(c.found.size(), 9U);
+}
+
+TEST(enumerate, all_decision_blocking)
+{
+    SATSolver s;
+    s.new_vars(4);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-3, 4"));
+    EnumCollect c({0, 1, 2, 3});
+    lbool ret = s.enumerate_solutions(std::ref(c), 100, NULL, NULL, false, true);
+    EXPECT_EQ( ret, l_False);
+    EXPECT_EQ(c.num, 9U);
+    EXPECT_EQ(c.found.size(), 9U);
+}
+
+TEST(enumerate, projected)
+{
+    SATSolver s;
+    s.new_vars(4);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-3, 4"));
+    const vector<unsigned> proj = {2, 3};
+    EnumCollect c({2, 3});
+    lbool ret = s.enumerate_solutions(std::ref(c), 100, NULL, &proj);
+    EXPECT_EQ( ret, l_False);
+    EXPECT_EQ(c.num, 3U);
+    EXPECT_EQ(c.found.size(), 3U);
+}
+
+TEST(enumerate, max_and_stop)
+{
+    SATSolver s;
+    s.new_vars(4);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-3, 4"));
+    EnumCollect c({0, 1, 2, 3});
+    lbool ret = s.enumerate_solutions(std::ref(c), 4);
+    EXPECT_EQ( ret, l_True);
+    EXPECT_EQ(c.num, 4U);
+
+    uint64_t num = 0;
+    ret = s.enumerate_solutions([&](const vector<lbool>&) {
+        num++;
+        return num < 2;
+    });
+    EXPECT_EQ( ret, l_True);
+    EXPECT_EQ(num, 2U);
+}
+
+TEST(enumerate, assumps_and_threads)
+{
+    SATSolver s;
+    s.set_num_threads(2);
+    s.new_vars(4);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-3, 4"));
+    const vector<Lit> assumps = str_to_cl("-1");
+    EnumCollect c({0, 1, 2, 3});
+    lbool ret = s.enumerate_solutions(std::ref(c), 100, &assumps);
+    EXPECT_EQ( ret, l_False);
+    EXPECT_EQ(c.num, 3U);
+    EXPECT_EQ(c.found.size(), 3U);
+}
+
+TEST(enumerate, threads_projected_outside_indep)
+{
+    //Var 4 is eliminated and not independent, so only_indep_solution
+    //doesn't extend it
+    SATSolver s;
+    s.set_num_threads(2);
+    s.new_vars(4);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("3, 4"));
+    s.add_clause(str_to_cl("-3, -4"));
+    vector<uint32_t> indep = {0};
+    s.set_independent_vars(&indep);
+    EXPECT_EQ(s.simplify(), l_Undef);
+    const vector<uint32_t> proj = {0, 3};
+    EnumCollect c(proj);
+    lbool ret = s.enumerate_solutions(std::ref(c), 100, NULL, &proj, true);
+    EXPECT_EQ( ret, l_False);
+    EXPECT_EQ(c.num, 4U);
+    EXPECT_EQ(c.found.size(), 4U);
+    EXPECT_FALSE(s.is_frozen(3));
+}
+
+//Random 3-CNF with a planted solution, hard enough to need some search
+static void add_planted_3cnf(SATSolver& s, uint32_t num_vars, uint32_t num_cls)
+{
+    s.new_vars(num_vars);
+    uint64_t rnd = 42;
+    auto next = [&](uint32_t mod) -> uint32_t {
+        rnd = rnd*6364136223846793005ULL + 1442695040888963407ULL;
+        return (rnd >> 33) % mod;
+    };
+    vector<bool> planted;
+    for(uint32_t i = 0; i < num_vars; i++) {
+        planted.push_back(next(2));
+    }
+    vector<Lit> cl;
+    while(num_cls > 0) {
+        cl.clear();
+        bool sat = false;
+        for(uint32_t i = 0; i < 3; i++) {
+            const Lit l(next(num_vars), next(2));
+            sat |= planted[l.var()] ^ l.sign();
+            cl.push_back(l);
+        }
+        if (sat) {
+            s.add_clause(cl);
+            num_cls--;
+        }
+    }
+}
+
+TEST(stream, learnt_and_progress)
+{
+    SATSolver s;
+    add_planted_3cnf(s, 250, 1060);
+
+    vector<vector<Lit> > learnts;
+    s.set_learnt_callback([&](const vector<Lit>& cl) {
+        learnts.push_back(cl);
+    }, 3, 3);
+    vector<SearchProgress> progress;
+    s.set_progress_callback([&](const SearchProgress& p) {
+        progress.push_back(p);
+    }, 100);
+
+    lbool ret = s.solve();
+    EXPECT_EQ( ret, l_True);
+    EXPECT_GT(learnts.size(), 0U);
+    for(const vector<Lit>& cl: learnts) {
+        EXPECT_LE(cl.size(), 3U);
+        bool sat = false;
+        for(const Lit l: cl) {
+            EXPECT_LT(l.var(), s.nVars());
+            sat |= s.get_model()[l.var()] == (l.sign() ? l_False : l_True);
+        }
+        EXPECT_TRUE(sat);
+    }
+
+    EXPECT_GT(progress.size(), 0U);
+    for(size_t i = 1; i < progress.size(); i++) {
+        EXPECT_GE(progress[i].conflicts, progress[i-1].conflicts + 100);
+        EXPECT_GE(progress[i].propagations, progress[i-1].propagations);
+        EXPECT_GE(progress[i].decisions, progress[i-1].decisions);
+    }
+}
+
+TEST(stream, units_and_stop)
+{
+    SATSolver s;
+    s.new_vars(3);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("1, -2"));
+
+    vector<vector<Lit> > learnts;
+    s.set_learnt_callback([&](const vector<Lit>& cl) {
+        learnts.push_back(cl);
+    });
+    lbool ret = s.solve();
+    EXPECT_EQ( ret, l_True);
+    ASSERT_EQ(learnts.size(), 1U);
+    EXPECT_EQ(learnts[0], str_to_cl("1"));
+
+    s.set_learnt_callback(std::function<void(const vector<Lit>&)>());
+    s.add_clause(str_to_cl("-3"));
+    ret = s.solve();
+    EXPECT_EQ( ret, l_True);
+    EXPECT_EQ(learnts.size(), 1U);
+}
+
+//Enforces odd parity over the observed vars, lazily
+struct ParityPropagator: public ExternalPropagator
+{
+    ParityPropagator(const uint32_t num_vars, const bool _do_prop) :
+        val(num_vars, l_Undef)
+        , do_prop(_do_prop)
+    {}
+
+    void notify_assignment(const vector<Lit>& lits) override
+    {
+        for(const Lit l: lits) {
+            EXPECT_EQ(val[l.var()], l_Undef);
+            val[l.var()] = boolToLBool(!l.sign());
+            trail.push_back(l.var());
+        }
+    }
+
+    void notify_new_decision_level() override
+    {
+        trail_lim.push_back(trail.size());
+    }
+
+    void notify_backtrack(size_t new_level) override
+    {
+        ASSERT_LT(new_level, trail_lim.size()+1);
+        while(trail.size() > trail_lim[new_level]) {
+            val[trail.back()] = l_Undef;
+            trail.pop_back();
+        }
+        trail_lim.resize(new_level);
+    }
+
+    bool cb_check_found_model(const vector<lbool>& model) override
+    {
+        bool odd = false;
+        for(const uint32_t v: vars) {
+            EXPECT_EQ(model[v], val[v]);
+            odd ^= model[v] == l_True;
+        }
+        if (odd) {
+            return true;
+        }
+
+        rejected++;
+        vector<Lit> cl;
+        for(const uint32_t v: vars) {
+            cl.push_back(Lit(v, model[v] == l_True));
+        }
+        pending.push_back(cl);
+        return false;
+    }
+
+    void cb_propagate(vector<Lit>& lits) override
+    {
+        if (!do_prop)
+            return;
+
+        uint32_t num_undef = 0;
+        uint32_t undef = 0;
+        bool odd = false;
+        for(const uint32_t v: vars) {
+            if (val[v] == l_Undef) {
+                num_undef++;
+                undef = v;
+            } else {
+                odd ^= val[v] == l_True;
+            }
+        }
+        if (num_undef == 1) {
+            lits.push_back(Lit(undef, odd));
+            propagated++;
+        }
+    }
+
+    void cb_add_reason_clause(Lit propagated_lit, vector<Lit>& cl) override
+    {
+        cl.push_back(propagated_lit);
+        for(const uint32_t v: vars) {
+            if (v != propagated_lit.var()) {
+                cl.push_back(Lit(v, val[v] == l_True));
+            }
+        }
+    }
+
+    bool cb_has_external_clause(vector<Lit>& cl) override
+    {
+        if (pending.empty())
+            return false;
+
+        cl = pending.back();
+        pending.pop_back();
+        return true;
+    }
+
+    vector<uint32_t> vars;
+    vector<lbool> val;
+    vector<uint32_t> trail;
+    vector<size_t> trail_lim;
+    vector<vector<Lit> > pending;
+    bool do_prop;
+    uint32_t rejected = 0;
+    uint32_t propagated = 0;
+};
+
+static uint32_t count_with_parity_propagator(const bool do_prop)
+{
+    SATSolver s;
+    s.new_vars(6);
+    s.add_clause(str_to_cl("5, 6"));
+    s.add_clause(str_to_cl("-5, -6"));
+
+    ParityPropagator p(6, do_prop);
+    p.vars = {0, 1, 2, 3};
+    s.connect_external_propagator(&p);
+    for(const uint32_t v: p.vars) {
+        s.add_observed_var(v);
+    }
+
+    uint32_t num = 0;
+    while(s.solve() == l_True) {
+        num++;
+        vector<Lit> ban;
+        for(uint32_t v = 0; v < 6; v++) {
+            ban.push_back(Lit(v, s.get_model()[v] == l_True));
+        }
+        s.add_clause(ban);
+    }
+    if (do_prop) {
+        EXPECT_GT(p.propagated, 0U);
+    } else {
+        EXPECT_GT(p.rejected, 0U);
+    }
+    s.disconnect_external_propagator();
+    return num;
+}
+
+TEST(ext_prop, parity_by_propagation)
+{
+    EXPECT_EQ(count_with_parity_propagator(true), 16U);
+}
+
+TEST(ext_prop, parity_by_model_check)
+{
+    EXPECT_EQ(count_with_parity_propagator(false), 16U);
+}
+
+TEST(ext_prop, multithread_throws)
+{
+    SATSolver s;
+    s.new_vars(2);
+    ParityPropagator p(2, true);
+    EXPECT_THROW({
+        s.set_num_threads(2);
+        s.connect_external_propagator(&p);
+    }, std::runtime_error);
+}
+
+static void add_pigeonhole(SATSolver& s, uint32_t holes)
+{
+    const uint32_t pigeons = holes + 1;
+    s.new_vars(pigeons*holes);
+    vector<Lit> cl;
+    for(uint32_t p = 0; p < pigeons; p++) {
+        cl.clear();
+        for(uint32_t h = 0; h < holes; h++) {
+            cl.push_back(Lit(p*holes + h, false));
+        }
+        s.add_clause(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p1 = 0; p1 < pigeons; p1++) {
+            for(uint32_t p2 = p1+1; p2 < pigeons; p2++) {
+                s.add_clause(vector<Lit>{Lit(p1*holes + h, true), Lit(p2*holes + h, true)});
+            }
+        }
+    }
+}
+
+TEST(solve_async, result_and_callback)
+{
+    SATSolver s;
+    s.set_num_threads(2);
+    add_planted_3cnf(s, 100, 400);
+
+    std::atomic<int> called(0);
+    lbool cb_ret = l_Undef;
+    s.solve_async(NULL, false, [&](lbool ret) {
+        cb_ret = ret;
+        called++;
+    });
+    EXPECT_TRUE(s.solve_async_wait_for(100));
+    EXPECT_TRUE(s.solve_async_poll());
+    EXPECT_EQ(s.solve_async_result(), l_True);
+    EXPECT_EQ(called, 1);
+    EXPECT_EQ(cb_ret, l_True);
+    EXPECT_EQ(s.get_model().size(), 100U);
+
+    vector<Lit> assumps = str_to_cl("1, -1");
+    s.solve_async(&assumps);
+    assumps.clear();
+    EXPECT_EQ(s.solve_async_result(), l_False);
+    EXPECT_EQ(s.solve(), l_True);
+}
+
+TEST(solve_async, cancel)
+{
+    SATSolver s;
+    add_pigeonhole(s, 10);
+    s.solve_async();
+    EXPECT_FALSE(s.solve_async_wait_for(0.2));
+    EXPECT_THROW(s.add_clause(str_to_cl("1")), std::runtime_error);
+    EXPECT_THROW(s.solve(), std::runtime_error);
+    EXPECT_GT(s.get_live_progress().conflicts, 0U);
+
+    s.solve_async_cancel();
+    EXPECT_EQ(s.solve_async_result(), l_Undef);
+
+    //The next call isn't cancelled
+    s.add_clause(str_to_cl("1"));
+    s.set_max_confl(100);
+    s.solve_async();
+    EXPECT_EQ(s.solve_async_result(), l_Undef);
+    EXPECT_GE(s.get_last_conflicts(), 100U);
+}
+
+TEST(solve_async, destroy_while_running)
+{
+    SATSolver* s = new SATSolver;
+    add_pigeonhole(*s, 10);
+    s->solve_async();
+    delete s;
+}
+
+TEST(solve_async, destroy_after_finished)
+{
+    //Another solver could be using the same flag
+    std::atomic<bool> interrupt(false);
+    SATSolver* s = new SATSolver(NULL, &interrupt);
+    s->new_vars(2);
+    s->add_clause(str_to_cl("1, 2"));
+    s->solve_async();
+    EXPECT_TRUE(s->solve_async_wait_for(100));
+    delete s;
+    EXPECT_FALSE(interrupt.load());
+}
+
+TEST(clone, same_solutions)
+{
+    SATSolver s;
+    s.new_vars(6);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-1, 3"));
+    s.add_clause(str_to_cl("-2, 3"));
+    s.add_clause(str_to_cl("4, -5"));
+    s.add_clause(str_to_cl("-4, 5"));
+    s.add_clause(str_to_cl("6"));
+    s.freeze(0);
+    s.simplify();
+
+    SATSolver* c = s.clone();
+    EXPECT_EQ(c->nVars(), 6U);
+    EXPECT_TRUE(c->is_frozen(0));
+    EXPECT_FALSE(c->is_frozen(1));
+
+    vector<unsigned> all = {0, 1, 2, 3, 4, 5};
+    uint64_t num = 0;
+    c->enumerate_solutions([&](const vector<lbool>& model) {
+        EXPECT_EQ(model[2], l_True);
+        EXPECT_EQ(model[3], model[4]);
+        EXPECT_EQ(model[5], l_True);
+        num++;
+        return true;
+    }, 100, NULL, &all);
+    EXPECT_EQ(num, 6U);
+
+    //The original is untouched
+    vector<Lit> assumps = str_to_cl("-1, -2");
+    EXPECT_EQ(s.solve(&assumps), l_False);
+    EXPECT_EQ(s.solve(), l_True);
+    delete c;
+}
+
+TEST(clone, unsat)
+{
+    SATSolver s;
+    s.new_vars(1);
+    s.add_clause(str_to_cl("1"));
+    s.add_clause(str_to_cl("-1"));
+    SATSolver* c = s.clone();
+    EXPECT_EQ(c->solve(), l_False);
+    delete c;
+}
+
+TEST(clone, pool)
+{
+    SATSolver s;
+    s.new_vars(4);
+    s.add_clause(str_to_cl("1, 2, 3"));
+    s.add_clause(str_to_cl("-1, 4"));
+
+    SolverPool pool(s, 1);
+    vector<lbool> model;
+    vector<vector<Lit> > cls = {str_to_cl("-2"), str_to_cl("-3")};
+    EXPECT_EQ(pool.solve(cls, NULL, &model), l_True);
+    ASSERT_EQ(model.size(), 4U);
+    EXPECT_EQ(model[0], l_True);
+    EXPECT_EQ(model[3], l_True);
+
+    //The clauses of the previous query are gone
+    vector<Lit> conflict;
+    vector<Lit> assumps = str_to_cl("-4");
+    EXPECT_EQ(pool.solve(cls, &assumps, NULL, &conflict), l_False);
+    EXPECT_EQ(conflict, str_to_cl("4"));
+    EXPECT_EQ(pool.solve({}, &assumps, &model), l_True);
+    EXPECT_EQ(model[0], l_False);
+
+    EXPECT_THROW(pool.solve({str_to_cl("5")}), std::runtime_error);
+    EXPECT_EQ(pool.num_instances(), 1U);
+}
+
+TEST(clone, pool_replaces_clones)
+{
+    SATSolver s;
+    s.new_vars(4);
+    s.add_clause(str_to_cl("1, 2, 3"));
+    s.add_clause(str_to_cl("-1, 4"));
+
+    //Every second query with clauses uses up a clone
+    SolverPool pool(s, 1, 2);
+    vector<lbool> model;
+    for(uint32_t i = 0; i < 5; i++) {
+        vector<vector<Lit> > cls = {str_to_cl("-2"), str_to_cl("-3")};
+        EXPECT_EQ(pool.solve(cls, NULL, &model), l_True);
+        ASSERT_EQ(model.size(), 4U);
+        EXPECT_EQ(model[0], l_True);
+
+        //Doesn't need a selector, so doesn't count
+        EXPECT_EQ(pool.solve({}), l_True);
+    }
+    EXPECT_EQ(pool.num_instances(), 3U);
+    EXPECT_THROW(SolverPool(s, 1, 0), std::runtime_error);
+}
+
+TEST(clone, pool_threads)
+{
+    SATSolver s;
+    add_planted_3cnf(s, 60, 240);
+    SolverPool pool(s, 0);
+
+    std::atomic<int> num_sat(0);
+    vector<std::thread> threads;
+    for(int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&pool, &num_sat, t]() {
+            for(uint32_t v = 0; v < 5; v++) {
+                vector<vector<Lit> > cls = {{Lit(v*4 + t, false)}};
+                if (pool.solve(cls) != l_Undef) {
+                    num_sat++;
+                }
+            }
+        }));
+    }
+    for(std::thread& t: threads) {
+        t.join();
+    }
+    EXPECT_EQ(num_sat, 20);
+    EXPECT_GE(pool.num_instances(), 1U);
+    EXPECT_LE(pool.num_instances(), 4U);
+}
+
+TEST(clone, pool_threads_clone_each_query)
+{
+    //Clones are made while other queries run and hand theirs back
+    SATSolver s;
+    add_planted_3cnf(s, 60, 240);
+    SolverPool pool(s, 0, 1);
+
+    std::atomic<int> num_sat(0);
+    vector<std::thread> threads;
+    for(int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&pool, &num_sat, t]() {
+            for(uint32_t v = 0; v < 5; v++) {
+                vector<vector<Lit> > cls = {{Lit(v*4 + t, false)}};
+                if (pool.solve(cls) != l_Undef) {
+                    num_sat++;
+                }
+            }
+        }));
+    }
+    for(std::thread& t: threads) {
+        t.join();
+    }
+    EXPECT_EQ(num_sat, 20);
+    EXPECT_EQ(pool.num_instances(), 20U);
+}
+
+TEST(approx_count, exact_when_few)
+{
+    SATSolver s;
+    s.new_vars(4);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-3, 4"));
+    ApproxCount count;
+    lbool ret = s.approx_count(count);
+    EXPECT_EQ(ret, l_True);
+    EXPECT_EQ(count.hash_count, 0U);
+    EXPECT_EQ(count.cell_count, 9U);
+
+    //Counting doesn't change the problem
+    EXPECT_EQ(s.nVars(), 4U);
+    EnumCollect c({0, 1, 2, 3});
+    ret = s.enumerate_solutions(std::ref(c));
+    EXPECT_EQ(ret, l_False);
+    EXPECT_EQ(c.num, 9U);
+}
+
+TEST(approx_count, unsat)
+{
+    SATSolver s;
+    s.new_vars(2);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-1"));
+    s.add_clause(str_to_cl("-2"));
+    ApproxCount count;
+    EXPECT_EQ(s.approx_count(count), l_False);
+}
+
+static double approx_count_value(const ApproxCount& count)
+{
+    return std::ldexp((double)count.cell_count, count.hash_count);
+}
+
+TEST(approx_count, hashed)
+{
+    //3*2^10 solutions
+    SATSolver s;
+    s.new_vars(12);
+    s.add_clause(str_to_cl("1, 2"));
+    ApproxCount count;
+    lbool ret = s.approx_count(count, 0.8, 0.2, 3);
+    EXPECT_EQ(ret, l_True);
+    EXPECT_GT(count.hash_count, 0U);
+    EXPECT_GE(approx_count_value(count), 3072.0/1.8);
+    EXPECT_LE(approx_count_value(count), 3072.0*1.8);
+}
+
+TEST(approx_count, projected)
+{
+    //3*2^8 solutions on the first 10 vars, the rest is free
+    SATSolver s;
+    s.new_vars(14);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("11, 12, 13"));
+    vector<uint32_t> proj;
+    for(uint32_t i = 0; i < 10; i++) {
+        proj.push_back(i);
+    }
+    ApproxCount count;
+    lbool ret = s.approx_count(count, 0.8, 0.2, 1, &proj);
+    EXPECT_EQ(ret, l_True);
+    EXPECT_GE(approx_count_value(count), 768.0/1.8);
+    EXPECT_LE(approx_count_value(count), 768.0*1.8);
+
+    //The independent vars are the default projection
+    s.set_independent_vars(&proj);
+    ApproxCount count2;
+    ret = s.approx_count(count2, 0.8, 0.2, 1);
+    EXPECT_EQ(ret, l_True);
+    EXPECT_EQ(count2.cell_count, count.cell_count);
+    EXPECT_EQ(count2.hash_count, count.hash_count);
+}
+
+TEST(approx_count, interrupt)
+{
+    SATSolver s;
+    add_pigeonhole(s, 11);
+    std::atomic<bool> done(false);
+    std::thread t([&]() {
+        while(!done) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            s.interrupt_asap();
+        }
+    });
+    ApproxCount count;
+    EXPECT_EQ(s.approx_count(count), l_Undef);
+    done = true;
+    t.join();
+}
+
+TEST(approx_count, bad_params)
+{
+    SATSolver s;
+    s.new_vars(2);
+    ApproxCount count;
+    EXPECT_THROW(s.approx_count(count, 0), std::runtime_error);
+    EXPECT_THROW(s.approx_count(count, 0.8, 1), std::runtime_error);
+    const vector<uint32_t> proj = {2};
+    EXPECT_THROW(s.approx_count(count, 0.8, 0.2, 1, &proj), std::runtime_error);
+}
+
 TEST(normal_interface, logfile)
 {
     SATSolver* s = new SATSolver();
@@ -0,0 +1,230 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <fstream>
+#include <cstdio>
+
+#include "src/solver.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+struct checkpoint : public ::testing::Test {
+    checkpoint()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+    }
+    ~checkpoint()
+    {
+        std::remove(fname.c_str());
+        std::remove((fname + ".tmp").c_str());
+    }
+
+    void rnd_cnf(const uint32_t seed, const uint32_t _num_vars, const double ratio)
+    {
+        std::mt19937 rnd(seed);
+        num_vars = _num_vars;
+        cls.clear();
+        for(uint32_t i = 0; i < num_vars*ratio; i++) {
+            vector<Lit> cl;
+            for(uint32_t at = 0; at < 3; at++) {
+                cl.push_back(Lit(rnd() % num_vars, rnd() % 2));
+            }
+            cls.push_back(cl);
+        }
+    }
+
+    //Stops after "max_confl" conflicts, which leaves a checkpoint
+    lbool solve_until(const long max_confl)
+    {
+        SolverConf conf;
+        conf.checkpoint_file = fname;
+        conf.max_confl = max_confl;
+        Solver s(&conf, &must_inter);
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause_outer(cl);
+        }
+        const lbool ret = s.solve_with_assumptions(NULL, false);
+        saved_confl = s.sumConflicts;
+        saved_red = s.longRedCls[0].size() + s.longRedCls[1].size() + s.longRedCls[2].size();
+        return ret;
+    }
+
+    lbool solve_fresh()
+    {
+        SolverConf conf;
+        Solver s(&conf, &must_inter);
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause_outer(cl);
+        }
+        return s.solve_with_assumptions(NULL, false);
+    }
+
+    lbool resume(Solver& s)
+    {
+        return s.solve_with_assumptions(NULL, false);
+    }
+
+    void check_model(const Solver& s) const
+    {
+        for(const auto& cl: cls) {
+            bool sat = false;
+            for(const Lit l: cl) {
+                sat |= s.model_value(l) == l_True;
+            }
+            EXPECT_TRUE(sat);
+        }
+    }
+
+    //Resuming from "fname" is expected to exit with this message
+    void resume_must_fail(const string& msg)
+    {
+        SolverConf conf;
+        conf.resume_file = fname;
+        EXPECT_EXIT({
+                //Errors are printed to stdout
+                std::cout.rdbuf(std::cerr.rdbuf());
+                Solver s(&conf, &must_inter);
+                s.solve_with_assumptions(NULL, false);
+            }
+            , ::testing::ExitedWithCode(255)
+            , msg);
+    }
+
+    string read_file() const
+    {
+        std::ifstream in(fname, std::ios::binary);
+        return string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void write_file(const string& data) const
+    {
+        std::ofstream out(fname, std::ios::binary | std::ios::trunc);
+        out << data;
+    }
+
+    const string fname = "checkpoint_test.state";
+    uint32_t num_vars;
+    vector<vector<Lit> > cls;
+    uint64_t saved_confl = 0;
+    size_t saved_red = 0;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(checkpoint, round_trip)
+{
+    uint32_t num_sat = 0;
+    uint32_t num_resumed = 0;
+    for(uint32_t seed = 0; seed < 10; seed++) {
+        rnd_cnf(seed, 150, 4.26);
+        const lbool expected = solve_fresh();
+        if (solve_until(100) != l_Undef) {
+            continue;
+        }
+        EXPECT_GE(saved_confl, 100U);
+        num_resumed++;
+
+        //Search state came back
+        SolverConf conf;
+        conf.resume_file = fname;
+        Solver s(&conf, &must_inter);
+        const lbool ret = resume(s);
+        EXPECT_EQ(s.nVarsOuter(), num_vars);
+        EXPECT_GT(s.sumConflicts, saved_confl);
+        EXPECT_EQ(ret, expected);
+        if (ret == l_True) {
+            check_model(s);
+            num_sat++;
+        }
+    }
+    EXPECT_GT(num_sat, 0U);
+    EXPECT_GT(num_resumed, 5U);
+}
+
+TEST_F(checkpoint, learnts_come_back)
+{
+    rnd_cnf(1, 200, 4.26);
+    ASSERT_EQ(solve_until(300), l_Undef);
+    EXPECT_GT(saved_red, 0U);
+
+    SolverConf conf;
+    conf.resume_file = fname;
+    conf.max_confl = 0;
+    Solver s(&conf, &must_inter);
+    EXPECT_EQ(resume(s), l_Undef);
+    EXPECT_EQ(s.sumConflicts, saved_confl);
+    EXPECT_EQ(s.longRedCls[0].size() + s.longRedCls[1].size() + s.longRedCls[2].size(), saved_red);
+}
+
+TEST_F(checkpoint, round_trip_unsat)
+{
+    rnd_cnf(5, 150, 5);
+    ASSERT_EQ(solve_fresh(), l_False);
+    ASSERT_EQ(solve_until(100), l_Undef);
+
+    SolverConf conf;
+    conf.resume_file = fname;
+    Solver s(&conf, &must_inter);
+    EXPECT_EQ(resume(s), l_False);
+}
+
+TEST_F(checkpoint, truncated)
+{
+    rnd_cnf(1, 200, 4.26);
+    ASSERT_EQ(solve_until(300), l_Undef);
+    const string data = read_file();
+    ASSERT_GT(data.size(), 100U);
+
+    write_file(data.substr(0, data.size()/2));
+    resume_must_fail("file is truncated");
+
+    write_file(data.substr(0, 6));
+    resume_must_fail("file is truncated");
+}
+
+TEST_F(checkpoint, version_mismatch)
+{
+    rnd_cnf(1, 200, 4.26);
+    ASSERT_EQ(solve_until(300), l_Undef);
+    string data = read_file();
+
+    //Version follows the magic
+    data[4]++;
+    write_file(data);
+    resume_must_fail("not a solver state file");
+
+    //Not a state file at all
+    data[4]--;
+    data[0]++;
+    write_file(data);
+    resume_must_fail("not a solver state file");
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
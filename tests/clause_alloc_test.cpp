@@ -22,8 +22,8 @@ THE SOFTWARE.
 
 #include "gtest/gtest.h"
 
-#include <fstream>
-#include <stdlib.h>
+#include <random>
+#include <algorithm>
 
 #include "src/solver.h"
 #include "src/clauseallocator.h"
@@ -31,48 +31,215 @@ THE SOFTWARE.
 using namespace CMSat;
 #include "test_helper.h"
 
+namespace CMSat {
 struct clause_allocator : public ::testing::Test {
     clause_allocator()
     {
         must_inter.store(false, std::memory_order_relaxed);
         SolverConf conf;
-        conf.verbosity = 1;
         s = new Solver(&conf, &must_inter);
-        s->new_vars(50000);
+        s->new_vars(num_vars);
+        rnd.seed(1);
     }
     ~clause_allocator()
     {
         delete s;
     }
+
+    vector<Lit> rnd_lits(const uint32_t sz)
+    {
+        vector<Lit> lits;
+        for(uint32_t i = 0; i < sz; i++) {
+            lits.push_back(Lit((rnd() % (num_vars/sz)) + i*(num_vars/sz), rnd() % 2));
+        }
+        return lits;
+    }
+
+    //Attached, and in the clause list of its tier, like in search
+    ClOffset add_cl(const vector<Lit>& lits, const ClRegion region)
+    {
+        Clause* cl = s->cl_alloc.Clause_new(lits, 0, region);
+        if (region != ClRegion::irred) {
+            cl->makeRed(3);
+            cl->stats.which_red_array = (uint32_t)region - (uint32_t)ClRegion::red_tier0;
+        }
+        const ClOffset offs = s->cl_alloc.get_offset(cl);
+        s->attachClause(*cl);
+        if (cl->red()) {
+            s->longRedCls[cl->stats.which_red_array].push_back(offs);
+        } else {
+            s->longIrredCls.push_back(offs);
+        }
+        return offs;
+    }
+
+    //Lits of all the clauses, in the order of the clause lists
+    vector<vector<Lit> > all_cls() const
+    {
+        vector<vector<Lit> > ret;
+        for(const ClOffset offs: s->longIrredCls) {
+            const Clause* cl = s->cl_alloc.ptr(offs);
+            EXPECT_EQ(s->cl_alloc.get_offset(cl), offs);
+            ret.push_back(vector<Lit>(cl->begin(), cl->end()));
+        }
+        for(const auto& lredcls: s->longRedCls) {
+            for(const ClOffset offs: lredcls) {
+                const Clause* cl = s->cl_alloc.ptr(offs);
+                EXPECT_EQ(s->cl_alloc.get_offset(cl), offs);
+                ret.push_back(vector<Lit>(cl->begin(), cl->end()));
+            }
+        }
+        return ret;
+    }
+
+    //Removes every n-th clause of the list
+    void free_every(vector<ClOffset>& offsets, const uint32_t n)
+    {
+        size_t j = 0;
+        for(size_t i = 0; i < offsets.size(); i++) {
+            if (i % n == 0) {
+                s->detachClause(offsets[i], false);
+                s->cl_alloc.clauseFree(offsets[i]);
+            } else {
+                offsets[j++] = offsets[i];
+            }
+        }
+        offsets.resize(j);
+    }
+
+    const uint32_t num_vars = 2000;
     Solver* s = NULL;
+    std::mt19937 rnd;
     std::atomic<bool> must_inter;
 };
 
-TEST_F(clause_allocator, add_1)
+TEST_F(clause_allocator, round_trip_all_tiers)
 {
-    vector<Lit> cl;
-    srand(0);
-    double t = cpuTime();
-
-    uint64_t num = 10ULL*1000ULL*1000ULL;
-    for(size_t i = 0; i < num; i++) {
-        int size = 100 + rand()%10;
-        int start = rand() % 50000/size;
-        cl.resize(size);
-        for(int i2 = 0; i2 < size; i2++) {
-            int sign = rand() % 2;
-            cl[i2] = Lit(start, sign);
-            start += rand() % (50000/size);
-        }
-        s->add_clause_outer(cl);
-        if (i % (300ULL*1000ULL) == 0) {
-            cout << "Added " << i/(3000LL*1000ULL) << "M" << " T:" << (cpuTime()-t) << endl;
-            s->cl_alloc.consolidate(s, true);
+    for(uint32_t i = 0; i < 4000; i++) {
+        add_cl(rnd_lits(3 + rnd() % 50), (ClRegion)(i % ClauseAllocator::num_regions));
+    }
+    const vector<vector<Lit> > cls = all_cls();
+    EXPECT_EQ(cls.size(), 4000U);
+
+    //Offsets in different regions are different
+    vector<ClOffset> offsets = s->longIrredCls;
+    for(const auto& lredcls: s->longRedCls) {
+        offsets.insert(offsets.end(), lredcls.begin(), lredcls.end());
+    }
+    std::sort(offsets.begin(), offsets.end());
+    EXPECT_TRUE(std::unique(offsets.begin(), offsets.end()) == offsets.end());
+}
+
+TEST_F(clause_allocator, consolidate_round_trip)
+{
+    for(uint32_t i = 0; i < 4000; i++) {
+        add_cl(rnd_lits(3 + rnd() % 50), (ClRegion)(i % ClauseAllocator::num_regions));
+    }
+    free_every(s->longIrredCls, 3);
+    for(auto& lredcls: s->longRedCls) {
+        free_every(lredcls, 2);
+    }
+    const vector<vector<Lit> > before = all_cls();
+    const size_t mem_before = s->cl_alloc.mem_used();
+
+    s->cl_alloc.consolidate(s, true);
+    EXPECT_EQ(all_cls(), before);
+    EXPECT_LT(s->cl_alloc.mem_used(), mem_before);
+    s->test_all_clause_attached();
+
+    //Still usable: new clauses, again
+    for(uint32_t i = 0; i < 1000; i++) {
+        add_cl(rnd_lits(3 + rnd() % 50), (ClRegion)(i % ClauseAllocator::num_regions));
+    }
+    s->cl_alloc.consolidate(s, true);
+    EXPECT_EQ(all_cls().size(), before.size() + 1000);
+    EXPECT_EQ(s->solve_with_assumptions(NULL, false), l_True);
+}
+
+TEST_F(clause_allocator, tier_change)
+{
+    for(uint32_t i = 0; i < 1000; i++) {
+        add_cl(rnd_lits(3 + rnd() % 10), ClRegion::red_tier2);
+    }
+
+    //Half of them become tier 0
+    vector<ClOffset>& tier2 = s->longRedCls[2];
+    size_t j = 0;
+    for(size_t i = 0; i < tier2.size(); i++) {
+        Clause* cl = s->cl_alloc.ptr(tier2[i]);
+        EXPECT_EQ(s->cl_alloc.region_of(cl), (uint32_t)ClRegion::red_tier2);
+        if (i % 2) {
+            cl->stats.which_red_array = 0;
+            s->longRedCls[0].push_back(tier2[i]);
+        } else {
+            tier2[j++] = tier2[i];
         }
     }
+    tier2.resize(j);
+    const vector<vector<Lit> > before = all_cls();
+
+    //They are moved to the region of their tier
     s->cl_alloc.consolidate(s, true);
-    lbool ret = s->solve_with_assumptions(NULL);
-    EXPECT_EQ(ret, l_True);
+    EXPECT_EQ(all_cls(), before);
+    for(uint32_t tier = 0; tier < 3; tier++) {
+        for(const ClOffset offs: s->longRedCls[tier]) {
+            const Clause* cl = s->cl_alloc.ptr(offs);
+            EXPECT_EQ(s->cl_alloc.region_of(cl), s->cl_alloc.proper_region(cl));
+            EXPECT_EQ(s->cl_alloc.region_of(offs), s->cl_alloc.proper_region(cl));
+        }
+    }
+    EXPECT_EQ(s->cl_alloc.regions[(uint32_t)ClRegion::red_tier0].moved_in, 500U);
+}
+
+TEST_F(clause_allocator, fill_and_release_slots)
+{
+    //Only feasible where slots are small
+    const uint64_t slot_bytes = (1ULL << ClauseAllocator::slot_bits)*sizeof(BASE_DATA_TYPE);
+    if (slot_bytes > 256ULL*1024ULL*1024ULL) {
+        return;
+    }
+
+    //One region can take all the slots there are
+    ClauseAllocator& alloc = s->cl_alloc;
+    alloc.testing_limit_slots(2);
+    bool full = false;
+    while(!full) {
+        try {
+            add_cl(rnd_lits(num_vars), ClRegion::red_tier2);
+        } catch (std::bad_alloc&) {
+            full = true;
+        }
+    }
+    EXPECT_EQ(alloc.regions[(uint32_t)ClRegion::red_tier2].num_owned, 2U);
+    EXPECT_EQ(alloc.num_free_slots, 0U);
+    EXPECT_GT(s->longRedCls[2].size()*num_vars*sizeof(Lit), slot_bytes);
+
+    //Nothing else fits, and nothing was put into another region
+    EXPECT_THROW(add_cl(rnd_lits(10), ClRegion::irred), std::bad_alloc);
+    EXPECT_EQ(s->longIrredCls.size(), 0U);
+    for(const ClOffset offs: s->longRedCls[2]) {
+        EXPECT_EQ(alloc.region_of(offs), (uint32_t)ClRegion::red_tier2);
+    }
+
+    //Freed space is only reclaimed by compaction, which gives back a slot
+    //that other regions can then use
+    vector<ClOffset>& tier2 = s->longRedCls[2];
+    const ClOffset last = tier2.back();
+    tier2.pop_back();
+    free_every(tier2, 1);
+    tier2.push_back(last);
+    EXPECT_THROW(add_cl(rnd_lits(10), ClRegion::irred), std::bad_alloc);
+    alloc.consolidate(s, true);
+    EXPECT_EQ(alloc.regions[(uint32_t)ClRegion::red_tier2].num_owned, 1U);
+    EXPECT_EQ(alloc.num_free_slots, 1U);
+    EXPECT_EQ(all_cls().size(), 1U);
+
+    add_cl(rnd_lits(10), ClRegion::irred);
+    EXPECT_EQ(alloc.regions[(uint32_t)ClRegion::irred].num_owned, 1U);
+    EXPECT_EQ(alloc.num_free_slots, 0U);
+    EXPECT_EQ(all_cls().size(), 2U);
+}
+
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,220 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+#include "src/clsignature.h"
+#include "src/clabstraction.h"
+using namespace CMSat;
+using std::vector;
+
+static vector<Lit> rnd_cl(std::mt19937& rnd, uint32_t num_vars, uint32_t sz)
+{
+    vector<Lit> cl;
+    while(cl.size() < sz) {
+        const Lit l(rnd() % num_vars, rnd() % 2);
+        if (std::find(cl.begin(), cl.end(), l) == cl.end()
+            && std::find(cl.begin(), cl.end(), ~l) == cl.end()
+        ) {
+            cl.push_back(l);
+        }
+    }
+    std::sort(cl.begin(), cl.end());
+    return cl;
+}
+
+static bool subset_slow(const vector<Lit>& A, const vector<Lit>& B)
+{
+    for(const Lit l: A) {
+        if (std::find(B.begin(), B.end(), l) == B.end())
+            return false;
+    }
+    return true;
+}
+
+TEST(sig_filter, matches_scalar)
+{
+    std::mt19937 rnd(1);
+    //All the sizes, so the vectorised part and the tail are both exercised
+    for(size_t num = 0; num < 40; num++) {
+        vector<cl_sig_type> sigs;
+        for(size_t i = 0; i < num; i++) {
+            sigs.push_back(((uint64_t)rnd() << 32) | rnd());
+        }
+        for(uint32_t k = 0; k < 20; k++) {
+            cl_sig_type sig = ((uint64_t)rnd() << 32) | rnd();
+            sig &= ((uint64_t)rnd() << 32) | rnd();
+            sig &= ((uint64_t)rnd() << 32) | rnd();
+            if (num > 0 && k % 2 == 0) {
+                sig &= sigs[rnd() % num];
+            }
+
+            vector<uint32_t> out(num);
+            const size_t n = filter_sig_supersets(sigs.data(), num, sig, out.data());
+            vector<uint32_t> expected;
+            for(uint32_t i = 0; i < num; i++) {
+                if ((sig & ~sigs[i]) == 0)
+                    expected.push_back(i);
+            }
+            out.resize(n);
+            EXPECT_EQ(out, expected);
+        }
+    }
+}
+
+TEST(sig_filter, no_false_negatives)
+{
+    std::mt19937 rnd(2);
+    for(uint32_t k = 0; k < 2000; k++) {
+        vector<Lit> B = rnd_cl(rnd, 40, 2 + rnd() % 10);
+        vector<Lit> A;
+        for(const Lit l: B) {
+            if (rnd() % 2)
+                A.push_back(l);
+        }
+        if (A.empty())
+            A.push_back(B[0]);
+
+        const cl_sig_type sigB = calc_sig(B);
+        uint32_t out;
+        EXPECT_EQ(filter_sig_supersets(&sigB, 1, calc_sig(A), &out), 1U);
+    }
+}
+
+TEST(sorted_subset, matches_slow)
+{
+    std::mt19937 rnd(3);
+    for(uint32_t k = 0; k < 5000; k++) {
+        const vector<Lit> A = rnd_cl(rnd, 12, 1 + rnd() % 4);
+        const vector<Lit> B = rnd_cl(rnd, 12, 1 + rnd() % 8);
+        uint32_t i;
+        uint32_t i2;
+        EXPECT_EQ(sorted_subset(A, B, i, i2), subset_slow(A, B));
+    }
+}
+
+/*
+Microbenchmark, run with --gtest_also_run_disabled_tests
+
+Backward-subsumption queries over occurrence lists of a random instance: the
+old way walks the list, filters on the 32-bit abstraction stored with the
+clause and checks the survivors with a 'seen' array, like
+OccSimplifier::subsetReverse. The new way filters the contiguous 64-bit
+signatures and checks the survivors with a sorted merge.
+*/
+TEST(sig_filter, DISABLED_bench_vs_seen)
+{
+    const uint32_t num_vars = 500;
+    std::mt19937 rnd(4);
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < 60000; i++) {
+        cls.push_back(rnd_cl(rnd, num_vars, 3 + rnd() % 6));
+    }
+    vector<cl_abst_type> absts;
+    for(const auto& cl: cls) {
+        absts.push_back(calcAbstraction(cl));
+    }
+
+    //Occurrence lists, both plain and with contiguous signatures
+    vector<vector<uint32_t> > occ(num_vars*2);
+    for(uint32_t i = 0; i < cls.size(); i++) {
+        for(const Lit l: cls[i]) {
+            occ[l.toInt()].push_back(i);
+        }
+    }
+    vector<vector<cl_sig_type> > occ_sig(num_vars*2);
+    for(uint32_t l = 0; l < num_vars*2; l++) {
+        for(const uint32_t at: occ[l]) {
+            occ_sig[l].push_back(calc_sig(cls[at]));
+        }
+    }
+
+    const uint32_t rounds = 20;
+    vector<uint16_t> seen(num_vars*2, 0);
+    uint64_t found_old = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t r = 0; r < rounds; r++) {
+        for(uint32_t i = 0; i < cls.size(); i++) {
+            const vector<Lit>& A = cls[i];
+            const auto& o = occ[A[0].toInt()];
+            for(const uint32_t at: o) {
+                if (at == i || (absts[i] & ~absts[at]) != 0)
+                    continue;
+
+                for(const Lit l: cls[at]) seen[l.toInt()] = 1;
+                bool sub = true;
+                for(const Lit l: A) {
+                    if (!seen[l.toInt()]) {
+                        sub = false;
+                        break;
+                    }
+                }
+                for(const Lit l: cls[at]) seen[l.toInt()] = 0;
+                found_old += sub;
+            }
+        }
+    }
+    const double time_old = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    uint64_t found_new = 0;
+    vector<uint32_t> cands(cls.size());
+    start = std::chrono::steady_clock::now();
+    for(uint32_t r = 0; r < rounds; r++) {
+        for(uint32_t i = 0; i < cls.size(); i++) {
+            const vector<Lit>& A = cls[i];
+            const auto& o = occ[A[0].toInt()];
+            const auto& os = occ_sig[A[0].toInt()];
+            const size_t n = filter_sig_supersets(
+                os.data(), os.size(), calc_sig(A), cands.data());
+            for(size_t k = 0; k < n; k++) {
+                const uint32_t at = o[cands[k]];
+                if (at == i)
+                    continue;
+                uint32_t x;
+                uint32_t y;
+                found_new += sorted_subset(A, cls[at], x, y);
+            }
+        }
+    }
+    const double time_new = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(found_old, found_new);
+    std::cout
+    << "seen+abst32: " << time_old << " s"
+    << "  sig64+merge: " << time_new << " s"
+    << "  speedup: " << time_old/time_new
+    << std::endl;
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
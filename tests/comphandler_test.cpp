@@ -23,10 +23,13 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <set>
+#include <random>
+#include <chrono>
 using std::set;
 
 #include "src/solver.h"
 #include "src/comphandler.h"
+#include "src/compfinder.h"
 #include "src/solverconf.h"
 using namespace CMSat;
 #include "test_helper.h"
@@ -75,6 +78,19 @@ TEST_F(comp_handle, handle_2_comps)
     EXPECT_EQ(chandle->get_num_components_solved(), 1u);
 }
 
+TEST_F(comp_handle, handle_2_comps_frozen)
+{
+    s->add_clause_outer(str_to_cl("1, -2, 3"));
+
+    s->add_clause_outer(str_to_cl("9, 4, 5"));
+    s->add_clause_outer(str_to_cl("5, 6, 7"));
+    s->freeze_var(0);
+
+    chandle->handle();
+    EXPECT_TRUE(s->okay());
+    EXPECT_EQ(chandle->get_num_vars_removed(), 0u);
+}
+
 TEST_F(comp_handle, handle_3_comps)
 {
     s->add_clause_outer(str_to_cl("1, -2, 3"));
@@ -168,6 +184,246 @@ TEST_F(comp_handle, check_unsat)
     EXPECT_EQ(chandle->get_num_components_solved(), 1u);
 }
 
+TEST_F(comp_handle, check_solution_threaded)
+{
+    s->conf.comp_threads = 3;
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("-1, 2"));
+
+    s->add_clause_outer(str_to_cl("11, 12"));
+    s->add_clause_outer(str_to_cl("-11, 12"));
+
+    s->add_clause_outer(str_to_cl("20, 22"));
+    s->add_clause_outer(str_to_cl("-24, 22"));
+
+    s->add_clause_outer(str_to_cl("19, 14, 15"));
+    s->add_clause_outer(str_to_cl("15, 16, 17"));
+    s->add_clause_outer(str_to_cl("17, 16, 18, 14"));
+    s->add_clause_outer(str_to_cl("17, 18, 13"));
+
+    chandle->handle();
+    EXPECT_TRUE(s->okay());
+    EXPECT_EQ(chandle->get_num_components_solved(), 3u);
+    EXPECT_EQ(chandle->get_num_vars_removed(), 7u);
+    vector<lbool> solution(s->nVarsOuter(), l_Undef);
+    vector<Lit> decisions;
+    chandle->addSavedState(solution, decisions);
+    EXPECT_TRUE(clause_satisfied("1, 2", solution));
+    EXPECT_TRUE(clause_satisfied("-1, 2", solution));
+    EXPECT_TRUE(clause_satisfied("11, 12", solution));
+    EXPECT_TRUE(clause_satisfied("-11, 12", solution));
+    EXPECT_TRUE(clause_satisfied("20, 22", solution));
+    EXPECT_TRUE(clause_satisfied("-24, 22", solution));
+}
+
+TEST_F(comp_handle, check_unsat_threaded)
+{
+    s->conf.comp_threads = 3;
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("-1, 2"));
+    s->add_clause_outer(str_to_cl("1, -2"));
+    s->add_clause_outer(str_to_cl("-1, -2"));
+
+    s->add_clause_outer(str_to_cl("11, 12"));
+    s->add_clause_outer(str_to_cl("-11, 12"));
+
+    s->add_clause_outer(str_to_cl("19, 14, 15"));
+    s->add_clause_outer(str_to_cl("15, 16, 17"));
+    s->add_clause_outer(str_to_cl("17, 16, 18, 14"));
+    s->add_clause_outer(str_to_cl("17, 18, 13"));
+
+    bool ret = chandle->handle();
+    EXPECT_FALSE(ret);
+    EXPECT_FALSE(s->okay());
+}
+
+//Pigeonhole with "holes+1" pigeons: UNSAT, and takes the solver a long time
+static void add_php(Solver* s, const uint32_t start, const uint32_t holes)
+{
+    const uint32_t pigeons = holes+1;
+    for(uint32_t p = 0; p < pigeons; p++) {
+        vector<Lit> cl;
+        for(uint32_t h = 0; h < holes; h++) {
+            cl.push_back(Lit(start + p*holes + h, false));
+        }
+        s->add_clause_outer(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p = 0; p < pigeons; p++) {
+            for(uint32_t p2 = p+1; p2 < pigeons; p2++) {
+                s->add_clause_outer(vector<Lit>{
+                    Lit(start + p*holes + h, true)
+                    , Lit(start + p2*holes + h, true)});
+            }
+        }
+    }
+}
+
+//Easy component, larger than the pigeonhole so it stays in the solver
+static void add_chain(Solver* s, const uint32_t start, const uint32_t len)
+{
+    for(uint32_t i = start; i+1 < start+len; i++) {
+        s->add_clause_outer(vector<Lit>{Lit(i, false), Lit(i+1, false)});
+    }
+}
+
+TEST_F(comp_handle, unsat_threaded_interrupts_running)
+{
+    s->conf.comp_threads = 2;
+    s->new_vars(400);
+    s->testing_fill_assumptions_set();
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("-1, 2"));
+    s->add_clause_outer(str_to_cl("1, -2"));
+    s->add_clause_outer(str_to_cl("-1, -2"));
+    add_php(s, 30, 10);
+    add_chain(s, 200, 200);
+
+    const auto start = std::chrono::steady_clock::now();
+    bool ret = chandle->handle();
+    const double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    EXPECT_FALSE(ret);
+    EXPECT_FALSE(s->okay());
+    EXPECT_LT(secs, 5.0);
+}
+
+TEST_F(comp_handle, parent_interrupt_reaches_components)
+{
+    s->new_vars(400);
+    s->testing_fill_assumptions_set();
+    add_php(s, 30, 10);
+    add_chain(s, 200, 200);
+
+    //Raised before the component solver starts, so its solve() would clear
+    //a shared flag
+    must_inter.store(true);
+    const auto start = std::chrono::steady_clock::now();
+    bool ret = chandle->handle();
+    const double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    EXPECT_TRUE(ret);
+    EXPECT_TRUE(s->okay());
+    EXPECT_EQ(chandle->get_num_vars_removed(), 0u);
+    EXPECT_TRUE(must_inter.load());
+    EXPECT_LT(secs, 5.0);
+}
+
+//The handler's finder is kept up-to-date as clauses come in
+namespace CMSat {
+struct comp_handle_incr : public ::testing::Test {
+    comp_handle_incr()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+        SolverConf conf;
+        conf.doCompHandler = true;
+        conf.doCache = false;
+        s = new Solver(&conf, &must_inter);
+        finder = s->compHandler->compFinder;
+    }
+    ~comp_handle_incr()
+    {
+        delete s;
+    }
+
+    bool same_comp(const string& a, const string& b) const
+    {
+        const uint32_t var_a = str_to_cl(a)[0].var();
+        const uint32_t var_b = str_to_cl(b)[0].var();
+        return finder->getVarComp(var_a) == finder->getVarComp(var_b);
+    }
+
+    Solver* s;
+    CompFinder* finder;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(comp_handle_incr, bridge_between_solves)
+{
+    s->new_vars(30);
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("2, 3, 4"));
+    s->add_clause_outer(str_to_cl("5, 6"));
+    s->add_clause_outer(str_to_cl("6, -7, 8"));
+    //Streamed in from the start, no need to go through the clauses
+    finder->find_components();
+    EXPECT_FALSE(finder->rebuilt);
+    EXPECT_EQ(finder->getNumComps(), 2U);
+    EXPECT_FALSE(same_comp("1", "5"));
+
+    EXPECT_EQ(s->solve_with_assumptions(NULL, false), l_True);
+
+    //A new variable in the bridge, too
+    s->new_var();
+    s->add_clause_outer(str_to_cl("4, -31, 7"));
+    finder->find_components();
+    EXPECT_FALSE(finder->rebuilt);
+    EXPECT_EQ(finder->getNumComps(), 1U);
+    EXPECT_TRUE(same_comp("1", "5"));
+    EXPECT_TRUE(same_comp("31", "8"));
+
+    //Same as finding them from scratch
+    CompFinder fresh(s);
+    fresh.find_components();
+    EXPECT_EQ(fresh.getNumComps(), 1U);
+    EXPECT_EQ(s->solve_with_assumptions(NULL, false), l_True);
+}
+
+TEST_F(comp_handle_incr, removal_splits)
+{
+    s->new_vars(30);
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("2, 3, 4"));
+    s->add_clause_outer(str_to_cl("5, 6"));
+    s->add_clause_outer(str_to_cl("6, -7, 8"));
+    s->add_clause_outer(str_to_cl("3, 9, 10"));
+    s->add_clause_outer(str_to_cl("10, 5, 11"));
+    finder->find_components();
+    EXPECT_EQ(finder->getNumComps(), 1U);
+
+    //The bridge is satisfied and goes away: too much is gone, rebuild
+    s->add_clause_outer(str_to_cl("10"));
+    finder->find_components();
+    EXPECT_TRUE(finder->rebuilt);
+    EXPECT_EQ(finder->getNumComps(), 2U);
+    EXPECT_FALSE(same_comp("1", "5"));
+}
+
+TEST_F(comp_handle_incr, same_as_rebuild)
+{
+    const uint32_t num_vars = 2000;
+    std::mt19937 rnd(1);
+    s->new_vars(num_vars);
+    for(uint32_t round = 0; round < 10; round++) {
+        for(uint32_t i = 0; i < 80; i++) {
+            vector<Lit> cl;
+            for(uint32_t at = 0; at < 2 + rnd() % 2; at++) {
+                cl.push_back(Lit(rnd() % num_vars, rnd() % 2));
+            }
+            s->add_clause_outer(cl);
+        }
+        finder->find_components();
+        EXPECT_FALSE(finder->rebuilt);
+
+        //Vars are in the same component iff they are in the fresh one
+        CompFinder fresh(s);
+        fresh.find_components();
+        ASSERT_EQ(finder->getNumComps(), fresh.getNumComps());
+        std::map<uint32_t, uint32_t> comp_map;
+        for(uint32_t var = 0; var < s->nVars(); var++) {
+            const uint32_t c = finder->getTable()[var];
+            const uint32_t c2 = fresh.getTable()[var];
+            ASSERT_EQ(c == std::numeric_limits<uint32_t>::max(), c2 == std::numeric_limits<uint32_t>::max());
+            if (comp_map.count(c)) {
+                EXPECT_EQ(comp_map[c], c2);
+            } else {
+                comp_map[c] = c2;
+            }
+        }
+    }
+}
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <set>
+#include <random>
 using std::set;
 
 #include "src/solver.h"
@@ -126,6 +127,216 @@ TEST_F(distill_test, tri_transitive)
     check_irred_cls_contains(s, "1, 2");
 }
 
+//Vivification of learnt clauses, between restarts
+
+//Long learnt clauses of tiers 0 and 1, lits sorted
+static vector<vector<Lit> > get_red_cls_tier01(const Solver* s)
+{
+    vector<vector<Lit> > ret;
+    for(uint32_t tier = 0; tier < 2; tier++) {
+        for(const ClOffset offs: s->longRedCls[tier]) {
+            const Clause* cl = s->cl_alloc.ptr(offs);
+            vector<Lit> lits(cl->begin(), cl->end());
+            std::sort(lits.begin(), lits.end());
+            ret.push_back(lits);
+        }
+    }
+    return ret;
+}
+
+static bool red_cl_exists(const Solver* s, const string& data)
+{
+    const vector<vector<Lit> > cls = get_red_cls_tier01(s);
+    return std::find(cls.begin(), cls.end(), str_to_cl(data)) != cls.end();
+}
+
+//Learnt clause put into the given tier, unless it didn't stay long
+static bool add_red(Solver* s, const vector<Lit>& lits, const uint32_t tier)
+{
+    size_t sizes[3];
+    for(uint32_t t = 0; t < 3; t++) {
+        sizes[t] = s->longRedCls[t].size();
+    }
+    s->add_clause_outer(lits, true);
+    for(uint32_t t = 0; t < 3; t++) {
+        vector<ClOffset>& cls = s->longRedCls[t];
+        if (cls.size() == sizes[t]) {
+            continue;
+        }
+        const ClOffset offs = cls.back();
+        cls.pop_back();
+        s->cl_alloc.ptr(offs)->stats.which_red_array = tier;
+        s->longRedCls[tier].push_back(offs);
+        return true;
+    }
+    return false;
+}
+
+TEST_F(distill_test, viv_red_by1)
+{
+    s->new_vars(4);
+    s->add_clause_outer(str_to_cl("1, -2"));
+    ASSERT_TRUE(add_red(s, str_to_cl("1, 2, 3, 4"), 0));
+
+    distill_long_cls->vivify_red();
+    EXPECT_TRUE(red_cl_exists(s, "1, 3, 4"));
+    EXPECT_FALSE(red_cl_exists(s, "1, 2, 3, 4"));
+    EXPECT_EQ(distill_long_cls->get_viv_stats().numLitsRem, 1U);
+    s->test_all_clause_attached();
+}
+
+TEST_F(distill_test, viv_red_tier1_by1)
+{
+    s->new_vars(5);
+    s->add_clause_outer(str_to_cl("1, -5"));
+    s->add_clause_outer(str_to_cl("5, -2"));
+    ASSERT_TRUE(add_red(s, str_to_cl("1, 2, 3, 4"), 1));
+
+    distill_long_cls->vivify_red();
+    EXPECT_TRUE(red_cl_exists(s, "1, 3, 4"));
+    EXPECT_EQ(s->longRedCls[1].size(), 1U);
+}
+
+TEST_F(distill_test, viv_red_nodistill)
+{
+    s->new_vars(5);
+    s->add_clause_outer(str_to_cl("-1, 3"));
+    ASSERT_TRUE(add_red(s, str_to_cl("1, 2, 3, 4"), 0));
+
+    distill_long_cls->vivify_red();
+    EXPECT_TRUE(red_cl_exists(s, "1, 2, 3, 4"));
+    EXPECT_EQ(distill_long_cls->get_viv_stats().checkedClauses, 1U);
+    EXPECT_EQ(distill_long_cls->get_viv_stats().numClShorten, 0U);
+    s->test_all_clause_attached();
+
+    //Not checked again
+    distill_long_cls->vivify_red();
+    EXPECT_EQ(distill_long_cls->get_viv_stats().checkedClauses, 1U);
+}
+
+TEST_F(distill_test, viv_red_tier1_untouched)
+{
+    s->new_vars(4);
+    s->add_clause_outer(str_to_cl("1, -2"));
+    ASSERT_TRUE(add_red(s, str_to_cl("1, 2, 3, 4"), 1));
+    s->sumConflicts = s->conf.must_touch_lev1_within + 1;
+
+    distill_long_cls->vivify_red();
+    EXPECT_TRUE(red_cl_exists(s, "1, 2, 3, 4"));
+    EXPECT_EQ(distill_long_cls->get_viv_stats().potentialClauses, 0U);
+}
+
+TEST_F(distill_test, viv_red_shared_prefix)
+{
+    //The decisions on 1 and 2 are shared between all three
+    s->new_vars(10);
+    s->add_clause_outer(str_to_cl("6, -7"));
+    ASSERT_TRUE(add_red(s, str_to_cl("1, 2, 3, 4"), 0));
+    ASSERT_TRUE(add_red(s, str_to_cl("1, 2, 3, 5"), 0));
+    ASSERT_TRUE(add_red(s, str_to_cl("1, 2, 6, 7"), 0));
+
+    distill_long_cls->vivify_red();
+    EXPECT_TRUE(red_cl_exists(s, "1, 2, 3, 4"));
+    EXPECT_TRUE(red_cl_exists(s, "1, 2, 3, 5"));
+    EXPECT_TRUE(red_cl_exists(s, "1, 2, 6"));
+    EXPECT_EQ(distill_long_cls->get_viv_stats().checkedClauses, 3U);
+    EXPECT_GT(distill_long_cls->get_viv_stats().levelsReused, 0U);
+    s->test_all_clause_attached();
+}
+
+static vector<vector<Lit> > rnd_cnf_viv(std::mt19937& rnd, const uint32_t num_vars, const uint32_t num_cls)
+{
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < num_cls; i++) {
+        vector<Lit> cl;
+        for(uint32_t at = 0; at < 3; at++) {
+            cl.push_back(Lit(rnd() % num_vars, rnd() % 2));
+        }
+        cls.push_back(cl);
+    }
+    return cls;
+}
+
+static bool implied(const vector<vector<Lit> >& cls, const uint32_t num_vars, const vector<Lit>& cl)
+{
+    std::atomic<bool> must_inter(false);
+    SolverConf conf;
+    Solver s(&conf, &must_inter);
+    s.new_vars(num_vars);
+    for(const auto& c: cls) {
+        s.add_clause_outer(c);
+    }
+    for(const Lit l: cl) {
+        s.add_clause_outer(vector<Lit>{~l});
+    }
+    return s.solve_with_assumptions(NULL, false) == l_False;
+}
+
+TEST(vivify_red, random)
+{
+    const uint32_t num_vars = 60;
+    uint64_t lits_rem = 0;
+    for(uint32_t seed = 0; seed < 20; seed++) {
+        std::mt19937 rnd(seed);
+        const vector<vector<Lit> > cls = rnd_cnf_viv(rnd, num_vars, 200);
+
+        std::atomic<bool> must_inter(false);
+        SolverConf conf;
+        Solver s(&conf, &must_inter);
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause_outer(cl);
+        }
+        if (!s.okay()) {
+            continue;
+        }
+
+        //Weakened irred clauses, so they are implied
+        for(uint32_t i = 0; i < 100; i++) {
+            vector<Lit> cl = cls[rnd() % cls.size()];
+            while(cl.size() < 6) {
+                const Lit l = Lit(rnd() % num_vars, rnd() % 2);
+                if (std::find(cl.begin(), cl.end(), l) == cl.end()
+                    && std::find(cl.begin(), cl.end(), ~l) == cl.end()
+                ) {
+                    cl.push_back(l);
+                }
+            }
+            add_red(&s, cl, rnd() % 2);
+        }
+
+        if (!s.distill_long_cls->vivify_red()) {
+            EXPECT_TRUE(implied(cls, num_vars, vector<Lit>()));
+            continue;
+        }
+        s.test_all_clause_attached();
+        lits_rem += s.distill_long_cls->get_viv_stats().numLitsRem;
+
+        for(const auto& cl: get_red_cls_tier01(&s)) {
+            EXPECT_TRUE(implied(cls, num_vars, cl));
+        }
+
+        //Same answer as without
+        const lbool ret = s.solve_with_assumptions(NULL, false);
+        Solver s2(&conf, &must_inter);
+        s2.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s2.add_clause_outer(cl);
+        }
+        EXPECT_EQ(ret, s2.solve_with_assumptions(NULL, false));
+        if (ret == l_True) {
+            for(const auto& cl: cls) {
+                bool sat = false;
+                for(const Lit l: cl) {
+                    sat |= s.model_value(l) == l_True;
+                }
+                EXPECT_TRUE(sat);
+            }
+        }
+    }
+    EXPECT_GT(lits_rem, 100U);
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
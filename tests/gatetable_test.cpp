@@ -0,0 +1,362 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include "src/solver.h"
+#include "src/gatetable.h"
+#include "src/solverconf.h"
+#include "src/occsimplifier.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+struct gate_table : public ::testing::Test {
+    gate_table()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+        SolverConf conf;
+        conf.doCache = false;
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(30);
+        occsimp = s->occsimplifier;
+        gt = new GateTable(s);
+        seen.resize(s->nVars()*2, 0);
+    }
+    ~gate_table()
+    {
+        delete gt;
+        delete s;
+    }
+
+    bool find(const uint32_t var)
+    {
+        int64_t limit = 1000LL*1000LL;
+        return gt->find_def(var-1, def, scratch, seen, &limit);
+    }
+
+    vector<std::pair<Lit, Lit> > build()
+    {
+        int64_t limit = 1000LL*1000LL;
+        gt->build(seen, &limit);
+        vector<std::pair<Lit, Lit> > eqs = gt->get_equivs();
+
+        //Either polarity of the pair, the smaller var first
+        for(auto& eq: eqs) {
+            if (eq.first.var() > eq.second.var()) {
+                std::swap(eq.first, eq.second);
+            }
+            if (eq.first.sign()) {
+                eq.first = ~eq.first;
+                eq.second = ~eq.second;
+            }
+        }
+        return eqs;
+    }
+
+    Solver* s = NULL;
+    OccSimplifier* occsimp = NULL;
+    GateTable* gt = NULL;
+    GateDef def;
+    GateTable::Scratch scratch;
+    vector<uint16_t> seen;
+    std::atomic<bool> must_inter;
+};
+
+//AND
+
+TEST_F(gate_table, find_and)
+{
+    //1 = 2 & 3 & 4
+    s->add_clause_outer(str_to_cl("-1, 2"));
+    s->add_clause_outer(str_to_cl("-1, 3"));
+    s->add_clause_outer(str_to_cl("-1, 4"));
+    s->add_clause_outer(str_to_cl("1, -2, -3, -4"));
+    occsimp->setup();
+
+    EXPECT_TRUE(find(1));
+    EXPECT_EQ(def.type, GateType::and_gate);
+    EXPECT_EQ(def.out, str_to_cl("1")[0]);
+    EXPECT_EQ(def.inputs, str_to_cl("2, 3, 4"));
+    EXPECT_EQ(def.cls.size(), 1U);
+    EXPECT_EQ(def.bins.size(), 3U);
+    EXPECT_NE(std::find(def.bins.begin(), def.bins.end()
+        , std::make_pair(str_to_cl("-1")[0], str_to_cl("3")[0])), def.bins.end());
+}
+
+TEST_F(gate_table, find_or)
+{
+    //-1 = -2 & 3, i.e. 1 = 2 | -3
+    s->add_clause_outer(str_to_cl("1, -2"));
+    s->add_clause_outer(str_to_cl("1, 3"));
+    s->add_clause_outer(str_to_cl("-1, 2, -3"));
+    occsimp->setup();
+
+    EXPECT_TRUE(find(1));
+    EXPECT_EQ(def.type, GateType::and_gate);
+    EXPECT_EQ(def.out, str_to_cl("-1")[0]);
+    EXPECT_EQ(def.inputs, str_to_cl("-2, 3"));
+}
+
+TEST_F(gate_table, find_and_equiv)
+{
+    s->add_clause_outer(str_to_cl("-1, 2"));
+    s->add_clause_outer(str_to_cl("1, -2"));
+    occsimp->setup();
+
+    EXPECT_TRUE(find(1));
+    EXPECT_EQ(def.type, GateType::and_gate);
+    EXPECT_EQ(def.inputs, str_to_cl("2"));
+    EXPECT_EQ(def.cls.size(), 0U);
+    EXPECT_EQ(def.bins.size(), 2U);
+}
+
+TEST_F(gate_table, find_and_missing_bin)
+{
+    //No (-1, 4), so 1 is not defined
+    s->add_clause_outer(str_to_cl("-1, 2"));
+    s->add_clause_outer(str_to_cl("-1, 3"));
+    s->add_clause_outer(str_to_cl("1, -2, -3, -4"));
+    occsimp->setup();
+
+    EXPECT_FALSE(find(1));
+    EXPECT_EQ(def.type, GateType::none);
+}
+
+TEST_F(gate_table, find_and_redundant_not_used)
+{
+    s->add_clause_outer(str_to_cl("-1, 2"));
+    s->add_clause_outer(str_to_cl("-1, 3"));
+    s->add_clause_outer(str_to_cl("1, -2, -3"), true);
+    occsimp->setup();
+
+    EXPECT_FALSE(find(1));
+}
+
+//XOR
+
+TEST_F(gate_table, find_xor_3)
+{
+    //1 = 2 ^ 3
+    s->add_clause_outer(str_to_cl("-1, 2, 3"));
+    s->add_clause_outer(str_to_cl("-1, -2, -3"));
+    s->add_clause_outer(str_to_cl("1, -2, 3"));
+    s->add_clause_outer(str_to_cl("1, 2, -3"));
+    occsimp->setup();
+
+    EXPECT_TRUE(find(1));
+    EXPECT_EQ(def.type, GateType::xor_gate);
+    EXPECT_EQ(def.out, str_to_cl("1")[0]);
+    EXPECT_EQ(def.inputs, str_to_cl("2, 3"));
+    EXPECT_EQ(def.cls.size(), 4U);
+}
+
+TEST_F(gate_table, find_xor_4)
+{
+    //1 = 2 ^ 3 ^ 4
+    s->add_clause_outer(str_to_cl("-1, 2, 3, 4"));
+    s->add_clause_outer(str_to_cl("1, -2, 3, 4"));
+    s->add_clause_outer(str_to_cl("1, 2, -3, 4"));
+    s->add_clause_outer(str_to_cl("1, 2, 3, -4"));
+    s->add_clause_outer(str_to_cl("-1, -2, -3, 4"));
+    s->add_clause_outer(str_to_cl("-1, -2, 3, -4"));
+    s->add_clause_outer(str_to_cl("-1, 2, -3, -4"));
+    s->add_clause_outer(str_to_cl("1, -2, -3, -4"));
+    occsimp->setup();
+
+    EXPECT_TRUE(find(1));
+    EXPECT_EQ(def.type, GateType::xor_gate);
+    EXPECT_EQ(def.out, str_to_cl("1")[0]);
+    EXPECT_EQ(def.inputs, str_to_cl("2, 3, 4"));
+    EXPECT_EQ(def.cls.size(), 8U);
+}
+
+TEST_F(gate_table, find_xor_negated)
+{
+    //1 = !(2 ^ 3)
+    s->add_clause_outer(str_to_cl("1, 2, 3"));
+    s->add_clause_outer(str_to_cl("1, -2, -3"));
+    s->add_clause_outer(str_to_cl("-1, -2, 3"));
+    s->add_clause_outer(str_to_cl("-1, 2, -3"));
+    occsimp->setup();
+
+    EXPECT_TRUE(find(1));
+    EXPECT_EQ(def.type, GateType::xor_gate);
+    EXPECT_EQ(def.out, str_to_cl("-1")[0]);
+    EXPECT_EQ(def.inputs, str_to_cl("2, 3"));
+}
+
+TEST_F(gate_table, find_xor_missing_cl)
+{
+    //Near-XOR: one of the four clauses is missing
+    s->add_clause_outer(str_to_cl("-1, 2, 3"));
+    s->add_clause_outer(str_to_cl("-1, -2, -3"));
+    s->add_clause_outer(str_to_cl("1, -2, 3"));
+    occsimp->setup();
+
+    EXPECT_FALSE(find(1));
+}
+
+TEST_F(gate_table, find_xor_wrong_parity)
+{
+    //Four clauses, but not all of the same parity
+    s->add_clause_outer(str_to_cl("-1, 2, 3"));
+    s->add_clause_outer(str_to_cl("-1, -2, -3"));
+    s->add_clause_outer(str_to_cl("1, -2, 3"));
+    s->add_clause_outer(str_to_cl("1, -2, -3"));
+    occsimp->setup();
+
+    EXPECT_FALSE(find(1));
+}
+
+//ITE
+
+TEST_F(gate_table, find_ite)
+{
+    //1 = 2 ? 3 : 4
+    s->add_clause_outer(str_to_cl("-1, -2, 3"));
+    s->add_clause_outer(str_to_cl("1, -2, -3"));
+    s->add_clause_outer(str_to_cl("-1, 2, 4"));
+    s->add_clause_outer(str_to_cl("1, 2, -4"));
+    occsimp->setup();
+
+    EXPECT_TRUE(find(1));
+    EXPECT_EQ(def.type, GateType::ite_gate);
+    EXPECT_EQ(def.out, str_to_cl("1")[0]);
+    ASSERT_EQ(def.inputs.size(), 3U);
+    EXPECT_EQ(def.inputs[0], str_to_cl("2")[0]);
+    EXPECT_EQ(def.inputs[1], str_to_cl("3")[0]);
+    EXPECT_EQ(def.inputs[2], str_to_cl("4")[0]);
+    EXPECT_EQ(def.cls.size(), 4U);
+}
+
+TEST_F(gate_table, find_ite_canonical)
+{
+    //1 = 2 ? -4 : 3, stored as -1 = 2 ? 4 : -3
+    s->add_clause_outer(str_to_cl("-1, -2, -4"));
+    s->add_clause_outer(str_to_cl("1, -2, 4"));
+    s->add_clause_outer(str_to_cl("-1, 2, 3"));
+    s->add_clause_outer(str_to_cl("1, 2, -3"));
+    occsimp->setup();
+
+    EXPECT_TRUE(find(1));
+    EXPECT_EQ(def.type, GateType::ite_gate);
+    EXPECT_EQ(def.out, str_to_cl("-1")[0]);
+    ASSERT_EQ(def.inputs.size(), 3U);
+    EXPECT_EQ(def.inputs[0], str_to_cl("2")[0]);
+    EXPECT_EQ(def.inputs[1], str_to_cl("4")[0]);
+    EXPECT_EQ(def.inputs[2], str_to_cl("-3")[0]);
+}
+
+TEST_F(gate_table, find_ite_missing_cl)
+{
+    s->add_clause_outer(str_to_cl("-1, -2, 3"));
+    s->add_clause_outer(str_to_cl("1, -2, -3"));
+    s->add_clause_outer(str_to_cl("-1, 2, 4"));
+    occsimp->setup();
+
+    EXPECT_FALSE(find(1));
+}
+
+//Hash-consing
+
+TEST_F(gate_table, build_same_and)
+{
+    //1 = 3 & 4, 2 = 3 & 4
+    s->add_clause_outer(str_to_cl("-1, 3"));
+    s->add_clause_outer(str_to_cl("-1, 4"));
+    s->add_clause_outer(str_to_cl("1, -3, -4"));
+    s->add_clause_outer(str_to_cl("-2, 3"));
+    s->add_clause_outer(str_to_cl("-2, 4"));
+    s->add_clause_outer(str_to_cl("2, -3, -4"));
+    occsimp->setup();
+
+    const auto eqs = build();
+    ASSERT_EQ(eqs.size(), 1U);
+    EXPECT_EQ(eqs[0], std::make_pair(str_to_cl("1")[0], str_to_cl("2")[0]));
+    EXPECT_EQ(gt->get_stats().dups, 1U);
+}
+
+TEST_F(gate_table, build_same_xor_negated)
+{
+    //1 = 3 ^ 4, 2 = !(3 ^ 4)
+    s->add_clause_outer(str_to_cl("-1, 3, 4"));
+    s->add_clause_outer(str_to_cl("-1, -3, -4"));
+    s->add_clause_outer(str_to_cl("1, -3, 4"));
+    s->add_clause_outer(str_to_cl("1, 3, -4"));
+    s->add_clause_outer(str_to_cl("2, 3, 4"));
+    s->add_clause_outer(str_to_cl("2, -3, -4"));
+    s->add_clause_outer(str_to_cl("-2, -3, 4"));
+    s->add_clause_outer(str_to_cl("-2, 3, -4"));
+    occsimp->setup();
+
+    const auto eqs = build();
+    ASSERT_EQ(eqs.size(), 1U);
+    EXPECT_EQ(eqs[0], std::make_pair(str_to_cl("1")[0], str_to_cl("-2")[0]));
+}
+
+TEST_F(gate_table, build_different_not_equiv)
+{
+    //1 = 3 & 4, 2 = 3 & -4, 5 = 3 ^ 4
+    s->add_clause_outer(str_to_cl("-1, 3"));
+    s->add_clause_outer(str_to_cl("-1, 4"));
+    s->add_clause_outer(str_to_cl("1, -3, -4"));
+    s->add_clause_outer(str_to_cl("-2, 3"));
+    s->add_clause_outer(str_to_cl("-2, -4"));
+    s->add_clause_outer(str_to_cl("2, -3, 4"));
+    s->add_clause_outer(str_to_cl("-5, 3, 4"));
+    s->add_clause_outer(str_to_cl("-5, -3, -4"));
+    s->add_clause_outer(str_to_cl("5, -3, 4"));
+    s->add_clause_outer(str_to_cl("5, 3, -4"));
+    occsimp->setup();
+
+    EXPECT_EQ(build().size(), 0U);
+}
+
+TEST_F(gate_table, build_through_equiv_inputs)
+{
+    //1 = 3 & 4, 5 = 3 & 4, then 2 = 1 & 6 and 7 = 5 & 6 are also the same
+    s->add_clause_outer(str_to_cl("-1, 3"));
+    s->add_clause_outer(str_to_cl("-1, 4"));
+    s->add_clause_outer(str_to_cl("1, -3, -4"));
+    s->add_clause_outer(str_to_cl("-5, 3"));
+    s->add_clause_outer(str_to_cl("-5, 4"));
+    s->add_clause_outer(str_to_cl("5, -3, -4"));
+    s->add_clause_outer(str_to_cl("-2, 1"));
+    s->add_clause_outer(str_to_cl("-2, 6"));
+    s->add_clause_outer(str_to_cl("2, -1, -6"));
+    s->add_clause_outer(str_to_cl("-7, 5"));
+    s->add_clause_outer(str_to_cl("-7, 6"));
+    s->add_clause_outer(str_to_cl("7, -5, -6"));
+    occsimp->setup();
+
+    const auto eqs = build();
+    ASSERT_EQ(eqs.size(), 2U);
+    EXPECT_NE(std::find(eqs.begin(), eqs.end()
+        , std::make_pair(str_to_cl("1")[0], str_to_cl("5")[0])), eqs.end());
+    EXPECT_NE(std::find(eqs.begin(), eqs.end()
+        , std::make_pair(str_to_cl("2")[0], str_to_cl("7")[0])), eqs.end());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
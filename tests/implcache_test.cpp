@@ -0,0 +1,283 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <algorithm>
+#include <set>
+
+#include "src/solver.h"
+#include "src/implcache.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+struct impl_cache : public ::testing::Test {
+    impl_cache()
+    {
+        cache.new_vars(num_vars);
+        seen.resize(num_vars*2, 0);
+        rnd.seed(1);
+    }
+
+    vector<LitExtra> decoded(const Lit lit) const
+    {
+        vector<LitExtra> ret;
+        for(const LitExtra le: cache[lit]) {
+            ret.push_back(le);
+        }
+        EXPECT_EQ(ret.size(), cache[lit].size());
+        return ret;
+    }
+
+    vector<Lit> rnd_lits(const uint32_t num)
+    {
+        std::set<uint32_t> vars;
+        while(vars.size() < num) {
+            vars.insert(rnd() % num_vars);
+        }
+        vector<Lit> ret;
+        for(const uint32_t v: vars) {
+            ret.push_back(Lit(v, rnd() % 2));
+        }
+        std::shuffle(ret.begin(), ret.end(), rnd);
+        return ret;
+    }
+
+    size_t bytes_used() const
+    {
+        size_t ret = 0;
+        for(const TransCache& tc: cache) {
+            ret += tc.mem_used();
+        }
+        return ret;
+    }
+
+    void check_accounting() const
+    {
+        EXPECT_EQ(cache.mem_used(), bytes_used() + cache.implCache.capacity()*sizeof(TransCache));
+        for(const uint16_t x: seen) {
+            EXPECT_EQ(x, 0);
+        }
+    }
+
+    const uint32_t num_vars = 1U << 17;
+    ImplCache cache;
+    vector<uint16_t> seen;
+    std::mt19937 rnd;
+};
+
+TEST_F(impl_cache, round_trip)
+{
+    //Deltas of all sizes, from 1 byte up to 3
+    for(const uint32_t num: {1, 2, 10, 100, 5000, 100000}) {
+        const Lit at = Lit(num, false);
+        const vector<Lit> lits = rnd_lits(num);
+        cache.merge(at, lits, lit_Undef, true, var_Undef, seen);
+
+        vector<LitExtra> expected;
+        for(const Lit l: lits) {
+            expected.push_back(LitExtra(l, false));
+        }
+        std::sort(expected.begin(), expected.end(), LitExtraRawSorter());
+        EXPECT_EQ(decoded(at), expected);
+    }
+    check_accounting();
+}
+
+TEST_F(impl_cache, compact)
+{
+    //Dense lists take about a byte per element
+    vector<Lit> lits;
+    for(uint32_t i = 0; i < 10000; i++) {
+        lits.push_back(Lit(i, false));
+    }
+    cache.merge(Lit(20000, false), lits, lit_Undef, true, var_Undef, seen);
+    EXPECT_EQ(cache[Lit(20000, false)].size(), 10000U);
+    EXPECT_LT(cache[Lit(20000, false)].mem_used(), 10000U*3/2);
+}
+
+TEST_F(impl_cache, merge_incrementally)
+{
+    const Lit at = Lit(0, false);
+    std::set<uint32_t> all;
+    for(uint32_t round = 0; round < 50; round++) {
+        const vector<Lit> lits = rnd_lits(100);
+        cache.merge(at, lits, lit_Undef, true, var_Undef, seen);
+        for(const Lit l: lits) {
+            if (!all.count((~l).toInt())) {
+                all.insert(l.toInt());
+            }
+        }
+        check_accounting();
+    }
+
+    //Sorted, every literal once
+    vector<LitExtra> got = decoded(at);
+    EXPECT_TRUE(std::is_sorted(got.begin(), got.end(), LitExtraRawSorter()));
+    std::set<uint32_t> got_lits;
+    for(const LitExtra le: got) {
+        got_lits.insert(le.getLit().toInt());
+    }
+    EXPECT_EQ(got_lits.size(), got.size());
+    for(const uint32_t l: all) {
+        EXPECT_TRUE(got_lits.count(l));
+    }
+}
+
+TEST_F(impl_cache, irred_flag)
+{
+    const Lit at = Lit(0, false);
+    const Lit a = Lit(5, false);
+    const Lit b = Lit(6, true);
+    cache.merge(at, vector<Lit>{b}, a, true, var_Undef, seen);
+    for(const LitExtra le: cache[at]) {
+        EXPECT_FALSE(le.getOnlyIrredBin());
+    }
+
+    //Irred step upgrades the flag, the order is kept
+    cache.merge(at, vector<Lit>(), a, false, var_Undef, seen);
+    vector<LitExtra> got = decoded(at);
+    ASSERT_EQ(got.size(), 2U);
+    EXPECT_EQ(got[0], LitExtra(a, true));
+    EXPECT_EQ(got[1], LitExtra(b, false));
+
+    //From another cache, with the flags
+    cache.merge(Lit(1, false), Lit(0, false), lit_Undef, false, var_Undef, seen);
+    EXPECT_EQ(decoded(Lit(1, false)), got);
+
+    cache.makeAllRed();
+    got = decoded(at);
+    EXPECT_EQ(got[0], LitExtra(a, false));
+    EXPECT_EQ(got[1], LitExtra(b, false));
+    check_accounting();
+}
+
+TEST_F(impl_cache, leave_out_and_taut)
+{
+    const Lit at = Lit(0, false);
+    const bool taut = cache.merge(at, str_to_cl("2, 3, 4"), lit_Undef, true, 3, seen);
+    EXPECT_FALSE(taut);
+    EXPECT_EQ(cache[at].size(), 2U);
+
+    //-3 together with 3 is a tautology
+    EXPECT_TRUE(cache.merge(at, str_to_cl("-3"), lit_Undef, true, var_Undef, seen));
+    check_accounting();
+}
+
+TEST_F(impl_cache, evict_lru)
+{
+    cache.set_max_bytes(100*1000);
+    for(uint32_t i = 0; i < 200; i++) {
+        cache.merge(Lit(i, false), rnd_lits(1000), lit_Undef, true, var_Undef, seen);
+        EXPECT_LE(bytes_used(), 100U*1000U);
+
+        //Keep using the first one
+        cache[Lit(0, false)];
+    }
+    check_accounting();
+    EXPECT_GT(cache.get_evict_stats().rounds, 0U);
+    EXPECT_GT(cache.get_evict_stats().caches, 100U);
+
+    //The most recently used survive, the old ones are gone
+    EXPECT_EQ(cache[Lit(0, false)].size(), 1000U);
+    EXPECT_EQ(cache[Lit(199, false)].size(), 1000U);
+    EXPECT_EQ(cache[Lit(1, false)].size(), 0U);
+    EXPECT_EQ(cache[Lit(100, false)].size(), 0U);
+
+    //Evicting down to nothing
+    cache.evict_lru(0);
+    EXPECT_EQ(bytes_used(), 0U);
+    check_accounting();
+}
+
+//Binaries give long implication chains to cache
+static vector<vector<Lit> > rnd_cnf_cache(
+    std::mt19937& rnd
+    , const uint32_t num_vars
+    , const uint32_t num_bins
+    , const uint32_t num_cls
+) {
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < num_cls; i++) {
+        vector<Lit> cl;
+        const uint32_t sz = i < num_bins ? 2 : 3;
+        for(uint32_t at = 0; at < sz; at++) {
+            cl.push_back(Lit(rnd() % num_vars, rnd() % 2));
+        }
+        cls.push_back(cl);
+    }
+    return cls;
+}
+
+TEST(impl_cache_solver, small_cachesize)
+{
+    //Probing fills the cache, which is kept under --cachesize
+    std::mt19937 rnd(3);
+    const uint32_t num_vars = 20000;
+    const vector<vector<Lit> > cls = rnd_cnf_cache(rnd, num_vars, 20000, 30000);
+
+    std::atomic<bool> must_inter(false);
+    SolverConf conf;
+    conf.doCache = true;
+    conf.maxCacheSizeMB = 1;
+    conf.doProbe = true;
+    conf.simplify_schedule_startup = "";
+    conf.simplify_schedule_nonstartup = "cache-clean,probe,cache-tryboth";
+    Solver s(&conf, &must_inter);
+    s.new_vars(num_vars);
+    for(const auto& cl: cls) {
+        s.add_clause_outer(cl);
+    }
+    s.simplify_with_assumptions();
+    size_t bytes = 0;
+    for(const TransCache& tc: s.implCache) {
+        bytes += tc.mem_used();
+    }
+    EXPECT_LE(bytes, 1024U*1024U);
+    EXPECT_GT(s.implCache.get_evict_stats().caches, 0U);
+
+    //Same answer as without the cache
+    const lbool ret = s.solve_with_assumptions(NULL, false);
+    SolverConf conf2;
+    Solver s2(&conf2, &must_inter);
+    s2.new_vars(num_vars);
+    for(const auto& cl: cls) {
+        s2.add_clause_outer(cl);
+    }
+    EXPECT_EQ(ret, s2.solve_with_assumptions(NULL, false));
+    if (ret == l_True) {
+        for(const auto& cl: cls) {
+            bool sat = false;
+            for(const Lit l: cl) {
+                sat |= s.model_value(l) == l_True;
+            }
+            EXPECT_TRUE(sat);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,210 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+#include "src/solver.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+struct incremental : public ::testing::Test {
+    incremental()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+        rnd.seed(1);
+    }
+    ~incremental()
+    {
+        delete s;
+    }
+
+    void make_solver(const uint64_t every_confl, const double max_time = 0.05)
+    {
+        conf.simplify_every_confl_incremental = every_confl;
+        conf.simplify_incremental_max_time = max_time;
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(num_vars);
+    }
+
+    void add_rnd_clauses(const uint32_t num)
+    {
+        for(uint32_t i = 0; i < num; i++) {
+            vector<Lit> cl;
+            for(uint32_t at = 0; at < 3; at++) {
+                cl.push_back(Lit(rnd() % num_vars, rnd() % 2));
+            }
+            s->add_clause_outer(cl);
+            cls.push_back(cl);
+        }
+    }
+
+    void add_equivalence()
+    {
+        const Lit a = Lit(rnd() % num_vars, rnd() % 2);
+        const Lit b = Lit(rnd() % num_vars, false);
+        if (a.var() == b.var()) {
+            return;
+        }
+        cls.push_back(vector<Lit>{a, ~b});
+        cls.push_back(vector<Lit>{~a, b});
+        s->add_clause_outer(cls[cls.size()-2]);
+        s->add_clause_outer(cls.back());
+    }
+
+    vector<Lit> rnd_assumps(const uint32_t num)
+    {
+        vector<Lit> assumps;
+        for(uint32_t i = 0; i < num; i++) {
+            assumps.push_back(Lit(rnd() % num_vars, rnd() % 2));
+        }
+        return assumps;
+    }
+
+    //What a solver that never saw an earlier call says
+    lbool fresh_answer(const vector<Lit>& assumps)
+    {
+        SolverConf conf2;
+        Solver s2(&conf2, &must_inter);
+        s2.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s2.add_clause_outer(cl);
+        }
+        return s2.solve_with_assumptions(&assumps, false);
+    }
+
+    //Model satisfies everything, or the conflict is made of the assumptions
+    void check_result(const lbool ret, const vector<Lit>& assumps)
+    {
+        if (ret == l_True) {
+            for(const auto& cl: cls) {
+                bool sat = false;
+                for(const Lit l: cl) {
+                    sat |= s->model_value(l) == l_True;
+                }
+                EXPECT_TRUE(sat);
+            }
+            for(const Lit l: assumps) {
+                EXPECT_EQ(s->model_value(l), l_True);
+            }
+        } else if (ret == l_False) {
+            for(const Lit l: s->get_final_conflict()) {
+                EXPECT_NE(std::find(assumps.begin(), assumps.end(), ~l), assumps.end());
+            }
+        }
+    }
+
+    static const uint32_t num_vars = 150;
+    SolverConf conf;
+    Solver* s = NULL;
+    vector<vector<Lit> > cls;
+    std::mt19937 rnd;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(incremental, off_by_default)
+{
+    EXPECT_EQ(conf.simplify_every_confl_incremental, 0U);
+    make_solver(conf.simplify_every_confl_incremental);
+    add_rnd_clauses(num_vars*4);
+    for(uint32_t i = 0; i < 300; i++) {
+        const vector<Lit> assumps = rnd_assumps(6);
+        check_result(s->solve_with_assumptions(&assumps, false), assumps);
+    }
+    EXPECT_EQ(s->get_solve_stats().numSimplify, 0U);
+}
+
+TEST_F(incremental, on_same_answers)
+{
+    make_solver(200);
+    add_rnd_clauses(num_vars*4);
+    SolverConf conf_off;
+    Solver s_off(&conf_off, &must_inter);
+    s_off.new_vars(num_vars);
+    for(const auto& cl: cls) {
+        s_off.add_clause_outer(cl);
+    }
+
+    for(uint32_t i = 0; i < 300; i++) {
+        const vector<Lit> assumps = rnd_assumps(6);
+        const lbool ret = s->solve_with_assumptions(&assumps, false);
+        check_result(ret, assumps);
+        EXPECT_EQ(ret, s_off.solve_with_assumptions(&assumps, false));
+    }
+    EXPECT_GT(s->get_solve_stats().numSimplify, 0U);
+    EXPECT_EQ(s_off.get_solve_stats().numSimplify, 0U);
+}
+
+TEST_F(incremental, no_time_left)
+{
+    //Stops before its first step, which must be harmless
+    make_solver(200, 0);
+    add_rnd_clauses(num_vars*4);
+    for(uint32_t i = 0; i < 300; i++) {
+        const vector<Lit> assumps = rnd_assumps(6);
+        check_result(s->solve_with_assumptions(&assumps, false), assumps);
+    }
+    EXPECT_GT(s->get_solve_stats().numSimplify, 0U);
+}
+
+TEST_F(incremental, assumption_prefix_kept)
+{
+    //Simplifying in between renumbers and replaces the assumed vars, too
+    make_solver(50);
+    add_rnd_clauses(num_vars*4);
+    vector<Lit> assumps;
+    for(uint32_t i = 0; i < 200; i++) {
+        //Mostly grow or shrink the last assumptions by one
+        switch(rnd() % 5) {
+            case 0:
+            case 1:
+                assumps.push_back(Lit(rnd() % num_vars, rnd() % 2));
+                break;
+            case 2:
+                if (!assumps.empty()) {
+                    assumps.pop_back();
+                }
+                break;
+            case 3:
+                assumps = rnd_assumps(rnd() % 6);
+                break;
+            case 4:
+                //Can eliminate, replace and renumber the assumed vars
+                add_equivalence();
+                s->simplify_with_assumptions();
+                break;
+        }
+        if (!s->okay()) {
+            break;
+        }
+        const lbool ret = s->solve_with_assumptions(&assumps, false);
+        check_result(ret, assumps);
+        EXPECT_EQ(ret, fresh_answer(assumps));
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,239 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+#include "src/solver.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+struct mem_budget : public ::testing::Test {
+    mem_budget()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+        rnd.seed(1);
+    }
+    ~mem_budget()
+    {
+        delete s;
+    }
+
+    void make_solver(const uint64_t budget_MB, const uint32_t vars = num_vars)
+    {
+        conf.mem_budget_MB = budget_MB;
+        conf.doCache = true;
+        conf.doStamp = true;
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(vars);
+    }
+
+    //Attached learnt clauses in the given tier, like in search
+    void add_red(const uint32_t tier, const uint32_t num, const uint32_t sz)
+    {
+        for(uint32_t i = 0; i < num; i++) {
+            vector<Lit> lits;
+            for(uint32_t at = 0; at < sz; at++) {
+                lits.push_back(Lit((rnd() % (num_vars/sz)) + at*(num_vars/sz), rnd() % 2));
+            }
+            Clause* cl = s->cl_alloc.Clause_new(lits, 0, (ClRegion)((uint32_t)ClRegion::red_tier0 + tier));
+            cl->makeRed(3);
+            cl->stats.which_red_array = tier;
+            s->attachClause(*cl);
+            s->longRedCls[tier].push_back(s->cl_alloc.get_offset(cl));
+        }
+    }
+
+    uint64_t num_shed(const MemShed what) const
+    {
+        return s->get_mem_budget_stats().numShed[(int)what];
+    }
+
+    const uint64_t MB = 1024ULL*1024ULL;
+    static const uint32_t num_vars = 100000;
+    SolverConf conf;
+    Solver* s = NULL;
+    std::mt19937 rnd;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(mem_budget, off)
+{
+    make_solver(0);
+    add_red(2, 100, 10);
+    s->check_mem_budget(true);
+    EXPECT_EQ(s->get_mem_budget_stats().numChecks, 0U);
+    EXPECT_EQ(s->longRedCls[2].size(), 100U);
+    EXPECT_TRUE(s->conf.doCache);
+}
+
+TEST_F(mem_budget, under_budget)
+{
+    make_solver(100000);
+    add_red(1, 100, 10);
+    add_red(2, 100, 10);
+    s->check_mem_budget(true);
+    EXPECT_EQ(s->get_mem_budget_stats().numChecks, 1U);
+    EXPECT_EQ(s->get_mem_budget_stats().numOver, 0U);
+    EXPECT_EQ(s->longRedCls[1].size(), 100U);
+    EXPECT_EQ(s->longRedCls[2].size(), 100U);
+    EXPECT_TRUE(s->conf.doCache);
+    EXPECT_TRUE(s->conf.doStamp);
+}
+
+TEST_F(mem_budget, tier2_before_tier1)
+{
+    make_solver(0);
+    add_red(0, 100, 10);
+    add_red(1, 100, 10);
+    const uint64_t base = s->mem_used_total();
+    add_red(2, 2000, 2500);
+    EXPECT_GT(s->mem_used_total(), base + 15*MB);
+
+    //Dropping tier 2 is enough
+    s->conf.mem_budget_MB = base/MB + 2;
+    s->check_mem_budget(false);
+    EXPECT_EQ(num_shed(MemShed::red_tier2), 1U);
+    EXPECT_EQ(num_shed(MemShed::red_tier1), 0U);
+    EXPECT_EQ(s->longRedCls[0].size(), 100U);
+    EXPECT_EQ(s->longRedCls[1].size(), 100U);
+    EXPECT_EQ(s->longRedCls[2].size(), 0U);
+    EXPECT_EQ(s->get_mem_budget_stats().redClsShed, 2000U);
+    EXPECT_LE(s->mem_used_total(), s->conf.mem_budget_MB*MB);
+    s->test_all_clause_attached();
+}
+
+TEST_F(mem_budget, search_only_sheds_learnts)
+{
+    make_solver(1);
+    add_red(0, 100, 10);
+    add_red(1, 100, 10);
+    add_red(2, 100, 10);
+    s->check_mem_budget(false);
+
+    //Tier 1 is demoted and removed, tier 0 is kept
+    EXPECT_EQ(num_shed(MemShed::red_tier2), 1U);
+    EXPECT_EQ(num_shed(MemShed::red_tier1), 1U);
+    EXPECT_EQ(s->longRedCls[0].size(), 100U);
+    EXPECT_EQ(s->longRedCls[1].size(), 0U);
+    EXPECT_EQ(s->longRedCls[2].size(), 0U);
+    EXPECT_EQ(s->get_mem_budget_stats().redClsShed, 200U);
+
+    //Still over budget, but nothing else may go away during search
+    EXPECT_GT(s->mem_used_total(), MB);
+    EXPECT_EQ(num_shed(MemShed::impl_cache), 0U);
+    EXPECT_EQ(num_shed(MemShed::stamps), 0U);
+    EXPECT_EQ(num_shed(MemShed::occur_limits), 0U);
+    EXPECT_TRUE(s->conf.doCache);
+    EXPECT_TRUE(s->conf.doStamp);
+    s->test_all_clause_attached();
+}
+
+TEST_F(mem_budget, cache_before_stamps)
+{
+    make_solver(0);
+    const uint64_t cache = s->implCache.mem_used();
+    const uint64_t stamps = s->mem_used_stamp();
+    ASSERT_GT(stamps, 2*MB);
+
+    //Dropping the cache is enough
+    s->conf.mem_budget_MB = (s->mem_used_total() - cache)/MB + 1;
+    ASSERT_GT(s->mem_used_total(), s->conf.mem_budget_MB*MB);
+    s->check_mem_budget(true);
+    EXPECT_EQ(num_shed(MemShed::impl_cache), 1U);
+    EXPECT_EQ(num_shed(MemShed::stamps), 0U);
+    EXPECT_FALSE(s->conf.doCache);
+    EXPECT_TRUE(s->conf.doStamp);
+}
+
+TEST_F(mem_budget, toplevel_order)
+{
+    make_solver(1);
+    add_red(1, 100, 10);
+    add_red(2, 100, 10);
+    const double irred_MB = s->conf.maxOccurIrredMB;
+    s->check_mem_budget(true);
+
+    //Everything that can be given up is, once
+    EXPECT_EQ(num_shed(MemShed::red_tier2), 1U);
+    EXPECT_EQ(num_shed(MemShed::red_tier1), 1U);
+    EXPECT_EQ(num_shed(MemShed::impl_cache), 1U);
+    EXPECT_EQ(num_shed(MemShed::stamps), 1U);
+    EXPECT_EQ(num_shed(MemShed::occur_limits), 1U);
+    EXPECT_FALSE(s->conf.doCache);
+    EXPECT_FALSE(s->conf.doStamp);
+    EXPECT_EQ(s->conf.maxOccurRedMB, 0);
+    EXPECT_LT(s->conf.maxOccurIrredMB, irred_MB);
+    EXPECT_EQ(s->implCache.mem_used(), 0U);
+
+    //Nothing left to give up, the next check is a no-op
+    s->check_mem_budget(true);
+    EXPECT_EQ(num_shed(MemShed::impl_cache), 1U);
+    EXPECT_EQ(num_shed(MemShed::stamps), 1U);
+    EXPECT_EQ(num_shed(MemShed::occur_limits), 1U);
+    EXPECT_EQ(s->get_mem_budget_stats().numOver, 2U);
+}
+
+TEST_F(mem_budget, solve_with_tiny_budget)
+{
+    const uint32_t vars = 200;
+    make_solver(1, vars);
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < vars*4.2; i++) {
+        vector<Lit> cl;
+        for(uint32_t at = 0; at < 3; at++) {
+            cl.push_back(Lit(rnd() % vars, rnd() % 2));
+        }
+        s->add_clause_outer(cl);
+        cls.push_back(cl);
+    }
+    s->simplify_with_assumptions();
+    EXPECT_NE(s->get_mem_budget_stats().numOver, 0U);
+    EXPECT_EQ(num_shed(MemShed::impl_cache), 1U);
+    EXPECT_FALSE(s->conf.doCache);
+    const lbool ret = s->solve_with_assumptions(NULL, false);
+
+    //Same answer as without a budget, and the model is fine
+    SolverConf conf2;
+    Solver s2(&conf2, &must_inter);
+    s2.new_vars(vars);
+    for(const auto& cl: cls) {
+        s2.add_clause_outer(cl);
+    }
+    EXPECT_EQ(ret, s2.solve_with_assumptions(NULL, false));
+    if (ret == l_True) {
+        for(const auto& cl: cls) {
+            bool sat = false;
+            for(const Lit l: cl) {
+                sat |= s->model_value(l) == l_True;
+            }
+            EXPECT_TRUE(sat);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,513 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <algorithm>
+
+#include "src/solver.h"
+#include "src/occsimplifier.h"
+#include "src/subsumestrengthen.h"
+#include "src/gatetable.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+static vector<Lit> rnd_cl(std::mt19937& rnd, uint32_t num_vars, uint32_t sz)
+{
+    vector<Lit> cl;
+    while(cl.size() < sz) {
+        const Lit l(rnd() % num_vars, rnd() % 2);
+        if (std::find(cl.begin(), cl.end(), l) == cl.end()
+            && std::find(cl.begin(), cl.end(), ~l) == cl.end()
+        ) {
+            cl.push_back(l);
+        }
+    }
+    return cl;
+}
+
+//Random clauses plus AND gates, so there are definitions for BVE to find
+static vector<vector<Lit> > rnd_cnf(
+    const uint32_t seed
+    , const uint32_t num_vars
+    , const uint32_t num_cls
+    , const uint32_t min_sz
+    , const uint32_t max_sz
+) {
+    std::mt19937 rnd(seed);
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < num_cls; i++) {
+        cls.push_back(rnd_cl(rnd, num_vars, min_sz + rnd() % (max_sz-min_sz+1)));
+    }
+    for(uint32_t i = 0; i < num_vars/8; i++) {
+        const vector<Lit> in = rnd_cl(rnd, num_vars, 3);
+        cls.push_back(vector<Lit>{~in[0], in[1]});
+        cls.push_back(vector<Lit>{~in[0], in[2]});
+        cls.push_back(vector<Lit>{in[0], ~in[1], ~in[2]});
+    }
+    return cls;
+}
+
+struct SimpResult {
+    lbool ret = l_Undef;
+    lbool ret_after_simp = l_Undef;
+    vector<uint32_t> elimed;
+    vector<vector<Lit> > irred;
+    vector<lbool> model;
+    uint64_t gate_equivs = 0;
+};
+
+static SimpResult simp_and_solve(
+    const vector<vector<Lit> >& cls
+    , const uint32_t num_vars
+    , SolverConf conf
+    , const string& schedule
+) {
+    std::atomic<bool> must_inter;
+    must_inter.store(false, std::memory_order_relaxed);
+    conf.simplify_schedule_nonstartup = schedule;
+    Solver s(&conf, &must_inter);
+    s.new_vars(num_vars);
+    for(const vector<Lit>& cl: cls) {
+        s.add_clause_outer(cl);
+    }
+
+    SimpResult r;
+    r.ret_after_simp = s.simplify_with_assumptions();
+    for(uint32_t v = 0; v < num_vars; v++) {
+        if (s.varData[s.map_outer_to_inter(v)].removed == Removed::elimed) {
+            r.elimed.push_back(v);
+        }
+    }
+    r.irred = get_irred_cls(&s);
+    std::sort(r.irred.begin(), r.irred.end(), VecVecSorter());
+    r.gate_equivs = s.occsimplifier->getGateTable()->get_stats().equivs;
+
+    r.ret = s.solve_with_assumptions(NULL, false);
+    if (r.ret == l_True) {
+        r.model = s.get_model();
+    }
+    return r;
+}
+
+static void check_model(
+    const vector<vector<Lit> >& cls
+    , const vector<lbool>& model
+) {
+    for(const vector<Lit>& cl: cls) {
+        bool sat = false;
+        for(const Lit l: cl) {
+            sat |= (model[l.var()] ^ l.sign()) == l_True;
+        }
+        EXPECT_TRUE(sat);
+    }
+}
+
+//Parallel BVE
+
+TEST(occsimp, bve_threads_same_elimed)
+{
+    size_t num_elimed = 0;
+    size_t num_unsat = 0;
+    for(uint32_t seed = 0; seed < 40; seed++) {
+        const uint32_t num_vars = 60;
+        const vector<vector<Lit> > cls = rnd_cnf(seed, num_vars, 200 + seed*5, 3, 4);
+
+        SolverConf conf;
+        conf.varelim_threads = 1;
+        const SimpResult single = simp_and_solve(cls, num_vars, conf, "occ-bve");
+        num_elimed += single.elimed.size();
+        num_unsat += single.ret == l_False;
+        if (single.ret == l_True) {
+            check_model(cls, single.model);
+        }
+
+        for(unsigned threads: {2U, 4U}) {
+            conf.varelim_threads = threads;
+            const SimpResult par = simp_and_solve(cls, num_vars, conf, "occ-bve");
+            EXPECT_EQ(par.ret, single.ret);
+            EXPECT_EQ(par.elimed, single.elimed);
+            EXPECT_EQ(par.irred, single.irred);
+            if (par.ret == l_True) {
+                check_model(cls, par.model);
+            }
+        }
+    }
+
+    //Otherwise the above checks nothing
+    EXPECT_GT(num_elimed, 150U);
+    EXPECT_GT(num_unsat, 0U);
+    EXPECT_LT(num_unsat, 40U);
+}
+
+TEST(occsimp, bve_threads_same_elimed_no_gates)
+{
+    for(uint32_t seed = 100; seed < 110; seed++) {
+        const uint32_t num_vars = 80;
+        const vector<vector<Lit> > cls = rnd_cnf(seed, num_vars, 260, 3, 3);
+
+        SolverConf conf;
+        conf.skip_some_bve_resolvents = false;
+        conf.varelim_threads = 1;
+        const SimpResult single = simp_and_solve(cls, num_vars, conf, "occ-bve");
+
+        conf.varelim_threads = 3;
+        const SimpResult par = simp_and_solve(cls, num_vars, conf, "occ-bve");
+        EXPECT_EQ(par.ret, single.ret);
+        EXPECT_EQ(par.elimed, single.elimed);
+        if (par.ret == l_True) {
+            check_model(cls, par.model);
+        }
+    }
+}
+
+//Parallel subsumption and strengthening
+
+//Some clauses, their supersets, and maybe copies with one literal flipped
+static vector<vector<Lit> > rnd_cnf_sub_str(
+    const uint32_t seed
+    , const uint32_t num_vars
+    , const bool flipped = true
+) {
+    std::mt19937 rnd(seed);
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < 150; i++) {
+        vector<Lit> cl = rnd_cl(rnd, num_vars, 3 + rnd() % 3);
+        cls.push_back(cl);
+        if (rnd() % 2) {
+            vector<Lit> sup = rnd_cl(rnd, num_vars, 2);
+            if (std::find(cl.begin(), cl.end(), ~sup[0]) == cl.end()
+                && std::find(cl.begin(), cl.end(), sup[0]) == cl.end()
+            ) {
+                sup.resize(1);
+                sup.insert(sup.end(), cl.begin(), cl.end());
+                cls.push_back(sup);
+            }
+        }
+        if (rnd() % 2 && flipped) {
+            cl[rnd() % cl.size()] ^= true;
+            cls.push_back(cl);
+        }
+    }
+    return cls;
+}
+
+TEST(occsimp, sub_str_threads_simple)
+{
+    //One group of these for every thread to have some
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < 8; i++) {
+        const auto l = [&](int x) {
+            return Lit(i*5 + std::abs(x) - 1, x < 0);
+        };
+        cls.push_back(vector<Lit>{l(1), l(2), l(3)});
+        cls.push_back(vector<Lit>{l(1), l(2), l(3), l(4)});
+        cls.push_back(vector<Lit>{l(-1), l(2), l(3), l(5)});
+    }
+
+    for(unsigned threads: {1U, 2U, 4U}) {
+        SolverConf conf;
+        conf.sub_str_threads = threads;
+        const SimpResult r = simp_and_solve(cls, 40, conf, "occ-backw-sub-str");
+        EXPECT_EQ(r.ret, l_True);
+        check_model(cls, r.model);
+
+        //Subsumed, and strengthened to (2, 3, 5)
+        EXPECT_EQ(r.irred.size(), 16U);
+        for(uint32_t i = 0; i < 8; i++) {
+            const auto l = [&](int x) {
+                return Lit(i*5 + std::abs(x) - 1, x < 0);
+            };
+            EXPECT_TRUE(cl_exists(r.irred, vector<Lit>{l(1), l(2), l(3)}));
+            EXPECT_TRUE(cl_exists(r.irred, vector<Lit>{l(2), l(3), l(5)}));
+        }
+    }
+}
+
+TEST(occsimp, sub_str_threads_random)
+{
+    for(uint32_t seed = 0; seed < 20; seed++) {
+        const uint32_t num_vars = 40;
+        const vector<vector<Lit> > cls = rnd_cnf_sub_str(seed, num_vars);
+
+        SolverConf conf;
+        conf.sub_str_threads = 1;
+        const SimpResult single = simp_and_solve(cls, num_vars, conf, "occ-backw-sub-str");
+        EXPECT_LT(single.irred.size(), cls.size());
+        if (single.ret == l_True) {
+            check_model(cls, single.model);
+        }
+
+        //The candidates are applied in clause order, whatever the threads
+        conf.sub_str_threads = 2;
+        const SimpResult par = simp_and_solve(cls, num_vars, conf, "occ-backw-sub-str");
+        EXPECT_EQ(par.ret, single.ret);
+        EXPECT_LT(par.irred.size(), cls.size());
+        if (par.ret == l_True) {
+            check_model(cls, par.model);
+        }
+
+        for(unsigned threads: {3U, 4U}) {
+            conf.sub_str_threads = threads;
+            const SimpResult par2 = simp_and_solve(cls, num_vars, conf, "occ-backw-sub-str");
+            EXPECT_EQ(par2.ret, single.ret);
+            EXPECT_EQ(par2.irred, par.irred);
+        }
+    }
+}
+
+//Incremental subsumption and strengthening over many calls
+
+TEST(occsimp, sub_str_incremental_simple)
+{
+    std::atomic<bool> must_inter;
+    must_inter.store(false, std::memory_order_relaxed);
+    SolverConf conf;
+    conf.occ_sub_str_incremental = true;
+    conf.simplify_schedule_nonstartup = "occ-backw-sub-str";
+    Solver s(&conf, &must_inter);
+    s.new_vars(20);
+
+    s.add_clause_outer(str_to_cl("1, 2, 3, 7"));
+    s.add_clause_outer(str_to_cl("4, 5, 6"));
+    s.simplify_with_assumptions();
+    check_irred_cls_eq(&s, "1, 2, 3, 7; 4, 5, 6");
+
+    //Subsumed by a done clause, strengthened by one, and subsumes one
+    s.add_clause_outer(str_to_cl("4, 5, 6, 8"));
+    s.add_clause_outer(str_to_cl("-4, 5, 6, 9"));
+    s.add_clause_outer(str_to_cl("1, 2, 3"));
+    s.simplify_with_assumptions();
+    check_irred_cls_eq(&s, "1, 2, 3; 4, 5, 6; 5, 6, 9");
+    EXPECT_GT(s.occsimplifier->getSubsumeStrengthen()->get_stats().skippedAsDone, 0U);
+}
+
+static vector<vector<Lit> > sub_str_in_rounds(
+    const vector<vector<Lit> >& cls
+    , const uint32_t num_vars
+    , const bool incremental
+    , const size_t rounds
+    , vector<lbool>* model
+) {
+    std::atomic<bool> must_inter;
+    must_inter.store(false, std::memory_order_relaxed);
+    SolverConf conf;
+    conf.occ_sub_str_incremental = incremental;
+    conf.simplify_schedule_nonstartup = "occ-backw-sub-str";
+    Solver s(&conf, &must_inter);
+    s.new_vars(num_vars);
+
+    //Clauses come in rounds, as they would over incremental calls
+    for(size_t i = 0; i < cls.size(); i++) {
+        s.add_clause_outer(cls[i]);
+        if ((i+1) % (cls.size()/rounds) == 0) {
+            s.simplify_with_assumptions();
+        }
+    }
+    s.simplify_with_assumptions();
+    vector<vector<Lit> > irred = get_irred_cls(&s);
+    std::sort(irred.begin(), irred.end(), VecVecSorter());
+
+    if (model) {
+        EXPECT_EQ(s.solve_with_assumptions(NULL, false), l_True);
+        *model = s.get_model();
+    }
+    return irred;
+}
+
+//With subsumption only, the clauses left do not depend on the order they
+//are looked at. So incremental calls must end where one full call does
+TEST(occsimp, sub_str_incremental_same_as_full)
+{
+    size_t num_removed = 0;
+    for(uint32_t seed = 0; seed < 20; seed++) {
+        const uint32_t num_vars = 40;
+        const vector<vector<Lit> > cls = rnd_cnf_sub_str(seed, num_vars, false);
+
+        const vector<vector<Lit> > full = sub_str_in_rounds(cls, num_vars, false, 1, NULL);
+        const vector<vector<Lit> > incr = sub_str_in_rounds(cls, num_vars, true, 4, NULL);
+        EXPECT_EQ(incr, full);
+        num_removed += cls.size() - incr.size();
+    }
+    EXPECT_GT(num_removed, 100U);
+}
+
+TEST(occsimp, sub_str_incremental_random)
+{
+    for(uint32_t seed = 0; seed < 20; seed++) {
+        const uint32_t num_vars = 40;
+        const vector<vector<Lit> > cls = rnd_cnf_sub_str(seed, num_vars);
+
+        vector<lbool> model;
+        const vector<vector<Lit> > incr = sub_str_in_rounds(cls, num_vars, true, 4, &model);
+        check_model(cls, model);
+        EXPECT_LT(incr.size(), cls.size());
+    }
+}
+
+//Gate table
+
+//Random clauses over AND, XOR and ITE gates, every gate defined twice
+static vector<vector<Lit> > rnd_cnf_dup_gates(
+    const uint32_t seed
+    , const uint32_t num_vars
+    , vector<std::pair<uint32_t, uint32_t> >& dups
+) {
+    std::mt19937 rnd(seed);
+    vector<vector<Lit> > cls;
+    dups.clear();
+    uint32_t out = num_vars/2;
+    for(uint32_t i = 0; i < num_vars/8; i++) {
+        const vector<Lit> in = rnd_cl(rnd, num_vars/2, 3);
+        const Lit a = Lit(out, false);
+        const Lit b = Lit(out+1, false);
+        dups.push_back(std::make_pair(a.var(), b.var()));
+        out += 2;
+        for(const Lit o: {a, b}) {
+            switch(i % 3) {
+                case 0:
+                    cls.push_back(vector<Lit>{~o, in[0]});
+                    cls.push_back(vector<Lit>{~o, in[1]});
+                    cls.push_back(vector<Lit>{o, ~in[0], ~in[1]});
+                    break;
+                case 1:
+                    cls.push_back(vector<Lit>{~o, in[0], in[1]});
+                    cls.push_back(vector<Lit>{~o, ~in[0], ~in[1]});
+                    cls.push_back(vector<Lit>{o, ~in[0], in[1]});
+                    cls.push_back(vector<Lit>{o, in[0], ~in[1]});
+                    break;
+                case 2:
+                    cls.push_back(vector<Lit>{~o, ~in[0], in[1]});
+                    cls.push_back(vector<Lit>{o, ~in[0], ~in[1]});
+                    cls.push_back(vector<Lit>{~o, in[0], in[2]});
+                    cls.push_back(vector<Lit>{o, in[0], ~in[2]});
+                    break;
+            }
+        }
+    }
+    for(uint32_t i = 0; i < num_vars*2; i++) {
+        cls.push_back(rnd_cl(rnd, num_vars, 3 + rnd() % 2));
+    }
+    return cls;
+}
+
+TEST(occsimp, bve_gate_table_on_off)
+{
+    size_t equivs = 0;
+    size_t num_unsat = 0;
+    for(uint32_t seed = 0; seed < 30; seed++) {
+        const uint32_t num_vars = 64;
+        vector<std::pair<uint32_t, uint32_t> > dups;
+        const vector<vector<Lit> > cls = rnd_cnf_dup_gates(seed, num_vars, dups);
+
+        SolverConf conf;
+        conf.varelim_gate_table = false;
+        const SimpResult off = simp_and_solve(cls, num_vars, conf, "occ-bve");
+        EXPECT_EQ(off.gate_equivs, 0U);
+        if (off.ret == l_True) {
+            check_model(cls, off.model);
+        }
+        num_unsat += off.ret == l_False;
+
+        conf.varelim_gate_table = true;
+        const SimpResult on = simp_and_solve(cls, num_vars, conf, "occ-bve");
+        EXPECT_EQ(on.ret, off.ret);
+        if (on.ret == l_True) {
+            check_model(cls, on.model);
+        }
+        equivs += on.gate_equivs;
+    }
+
+    //Most duplicates must be found, unless their vars are already set
+    EXPECT_GT(equivs, 30U*(64U/8U)/2);
+    EXPECT_LT(num_unsat, 30U);
+}
+
+//Resolvents calculated ahead of time must only be used if the occurrence
+//lists of the var did not change since
+namespace CMSat {
+TEST(occsimp, bve_speculation_checks_occurrences)
+{
+    std::atomic<bool> must_inter;
+    must_inter.store(false, std::memory_order_relaxed);
+    SolverConf conf;
+    Solver s(&conf, &must_inter);
+    s.new_vars(30);
+    for(uint32_t i = 0; i < 6; i++) {
+        s.add_clause_outer(vector<Lit>{Lit(0, false), Lit(1+2*i, false), Lit(2+2*i, false)});
+        s.add_clause_outer(vector<Lit>{Lit(0, true), Lit(13+2*i, false), Lit(14+2*i, false)});
+    }
+
+    OccSimplifier* occ = s.occsimplifier;
+    ASSERT_TRUE(occ->setup());
+    occ->setup_velim_scratch(2);
+    const uint32_t var = s.map_outer_to_inter(0);
+    ASSERT_TRUE(occ->velim_worth_speculating(var));
+    const auto speculate = [&]() {
+        occ->velim_batch.clear();
+        occ->add_to_velim_batch(var);
+        occ->test_elim_batch_parallel();
+    };
+    const auto first_long = [&](const Lit lit) {
+        for(const Watched& w: s.watches[lit]) {
+            if (w.isClause()) {
+                return w.get_offset();
+            }
+        }
+        assert(false);
+        return ClOffset(0);
+    };
+
+    int ret = 0;
+    speculate();
+    EXPECT_TRUE(occ->get_speculated_resolvents(var, ret) != NULL);
+    EXPECT_EQ(occ->bvestats.parUsed, 1U);
+
+    //Strengthened in place, as subsumption would: same offset, other lits
+    speculate();
+    const ClOffset offs = first_long(Lit(var, false));
+    Clause& cl = *s.cl_alloc.ptr(offs);
+    const Lit rem = cl[0] == Lit(var, false) ? cl[1] : cl[0];
+    cl.strengthen(rem);
+    removeWCl(s.watches[rem], offs);
+    occ->n_occurs[rem.toInt()]--;
+    EXPECT_TRUE(occ->get_speculated_resolvents(var, ret) == NULL);
+
+    //One occurrence fewer
+    speculate();
+    occ->unlink_clause(first_long(Lit(var, true)), false);
+    EXPECT_TRUE(occ->get_speculated_resolvents(var, ret) == NULL);
+    EXPECT_EQ(occ->bvestats.parUsed, 1U);
+
+    //Unchanged since, so it is used again
+    speculate();
+    EXPECT_TRUE(occ->get_speculated_resolvents(var, ret) != NULL);
+    EXPECT_EQ(occ->bvestats.parUsed, 2U);
+}
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <set>
+#include <random>
 using std::set;
 
 #include "src/solver.h"
@@ -359,6 +360,149 @@ TEST_F(probe, imp_cache_longer)
     check_impl_cache_contains(s, "5, 1");
 }
 
+//Multi-threaded probing
+
+TEST_F(probe, par_uip_fail)
+{
+    s->add_clause_outer(str_to_cl("1, -2"));
+    s->add_clause_outer(str_to_cl("1, -3"));
+    s->add_clause_outer(str_to_cl("1, -4"));
+    s->add_clause_outer(str_to_cl("1, -5"));
+    s->add_clause_outer(str_to_cl("2, 3, 4, 5, 6"));
+    s->add_clause_outer(str_to_cl("2, 3, 4, 5, -6"));
+
+    s->conf.probe_threads = 2;
+    s->conf.doBothProp = false;
+    s->conf.doStamp = false;
+    s->conf.otfHyperbin = false;
+    vars = str_to_vars("1, 7, 8, 9");
+    p->probe(&vars);
+
+    //Same as with one thread
+    check_zero_assigned_lits_eq(s, "1");
+}
+
+TEST_F(probe, par_both_prop)
+{
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("-1, 2"));
+
+    s->conf.probe_threads = 2;
+    s->conf.doBothProp = true;
+    s->conf.doStamp = false;
+    s->conf.otfHyperbin = false;
+    vars = str_to_vars("1, 3, 4, 5");
+    p->probe(&vars);
+
+    check_zero_assigned_lits_eq(s, "2");
+}
+
+TEST_F(probe, par_hyper_bin)
+{
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("1, 3"));
+    s->add_clause_outer(str_to_cl("-2, -3, 4"));
+
+    s->conf.probe_threads = 2;
+    s->conf.doBothProp = false;
+    s->conf.doStamp = false;
+    s->conf.otfHyperbin = true;
+    vars = str_to_vars("5, 6, 1");
+    p->probe(&vars);
+    check_red_cls_contains(s, "1, 4");
+}
+
+//Random 2- and 3-long clauses, there are many failed literals in these
+static vector<vector<Lit> > rnd_probe_cnf(const uint32_t seed, const uint32_t num_vars)
+{
+    std::mt19937 rnd(seed);
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < num_vars*4/3; i++) {
+        vector<Lit> cl;
+        const uint32_t sz = 2 + (rnd() % 3 == 0);
+        while(cl.size() < sz) {
+            const Lit l(rnd() % num_vars, rnd() % 2);
+            if (std::find(cl.begin(), cl.end(), l) == cl.end()
+                && std::find(cl.begin(), cl.end(), ~l) == cl.end()
+            ) {
+                cl.push_back(l);
+            }
+        }
+        cls.push_back(cl);
+    }
+    return cls;
+}
+
+static bool implied(const vector<vector<Lit> >& cls, const uint32_t num_vars, const Lit unit)
+{
+    std::atomic<bool> must_inter;
+    must_inter.store(false, std::memory_order_relaxed);
+    SolverConf conf;
+    Solver s(&conf, &must_inter);
+    s.new_vars(num_vars);
+    for(const vector<Lit>& cl: cls) {
+        s.add_clause_outer(cl);
+    }
+    s.add_clause_outer(vector<Lit>{~unit});
+    return s.solve_with_assumptions(NULL, false) == l_False;
+}
+
+TEST(probe_threads, random)
+{
+    size_t num_units = 0;
+    for(uint32_t seed = 0; seed < 40; seed++) {
+        const uint32_t num_vars = 60;
+        const vector<vector<Lit> > cls = rnd_probe_cnf(seed, num_vars);
+
+        lbool single_ret = l_Undef;
+        for(unsigned threads: {1U, 2U, 4U}) {
+            std::atomic<bool> must_inter;
+            must_inter.store(false, std::memory_order_relaxed);
+            SolverConf conf;
+            conf.doProbe = true;
+            conf.probe_threads = threads;
+            conf.doBothProp = seed % 2;
+            Solver s(&conf, &must_inter);
+            s.new_vars(num_vars);
+            for(const vector<Lit>& cl: cls) {
+                s.add_clause_outer(cl);
+            }
+
+            vector<uint32_t> vars;
+            for(uint32_t v = 0; v < s.nVars(); v++) {
+                vars.push_back(v);
+            }
+            s.prober->probe(&vars);
+
+            //Probing is heuristic, the threads may find more or fewer of
+            //them, but all must be correct
+            if (s.okay()) {
+                for(const Lit unit: s.get_zero_assigned_lits()) {
+                    EXPECT_TRUE(implied(cls, num_vars, unit));
+                    num_units++;
+                }
+            }
+
+            const lbool ret = s.solve_with_assumptions(NULL, false);
+            if (threads == 1) {
+                single_ret = ret;
+            }
+            EXPECT_EQ(ret, single_ret);
+            if (ret == l_True) {
+                const vector<lbool>& model = s.get_model();
+                for(const vector<Lit>& cl: cls) {
+                    bool sat = false;
+                    for(const Lit l: cl) {
+                        sat |= (model[l.var()] ^ l.sign()) == l_True;
+                    }
+                    EXPECT_TRUE(sat);
+                }
+            }
+        }
+    }
+    EXPECT_GT(num_units, 100U);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,201 @@
+/******************************************
+Copyright (c) 2016, Mate Soos
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <algorithm>
+#include <set>
+
+#include "src/solver.h"
+#include "src/reducedb.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+namespace CMSat {
+struct reducedb : public ::testing::Test {
+    reducedb()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(num_vars);
+        rnd.seed(1);
+    }
+    ~reducedb()
+    {
+        delete s;
+    }
+
+    //Tier 2 clauses with all-different glues and activities. Some are
+    //kept anyway, and don't compete.
+    void add_cls(const uint32_t num, const uint32_t num_glues)
+    {
+        vector<uint32_t> glues;
+        vector<float> acts;
+        for(uint32_t i = 0; i < num; i++) {
+            glues.push_back(2 + (i % num_glues));
+            acts.push_back(i + 1);
+        }
+        std::shuffle(glues.begin(), glues.end(), rnd);
+        std::shuffle(acts.begin(), acts.end(), rnd);
+
+        for(uint32_t i = 0; i < num; i++) {
+            vector<Lit> lits;
+            const uint32_t sz = 3 + rnd() % 6;
+            for(uint32_t at = 0; at < sz; at++) {
+                lits.push_back(Lit((rnd() % (num_vars/sz)) + at*(num_vars/sz), rnd() % 2));
+            }
+            Clause* cl = s->cl_alloc.Clause_new(lits, 0, ClRegion::red_tier2);
+            cl->makeRed(glues[i], acts[i]);
+            switch(rnd() % 10) {
+                case 0: cl->stats.ttl = 1; break;
+                case 1: cl->stats.marked_clause = true; break;
+                case 2: cl->set_used_in_xor(true); break;
+                case 3: cl->stats.which_red_array = 1; break;
+                default: break;
+            }
+            s->attachClause(*cl);
+            s->longRedCls[2].push_back(s->cl_alloc.get_offset(cl));
+        }
+    }
+
+    //What sort + mark_top_N_clauses did before partial selection
+    void full_sort_mark(ClauseClean type, const uint64_t keep_num, std::set<ClOffset>& marked)
+    {
+        vector<ClOffset> cls = s->longRedCls[2];
+        ClauseAllocator& alloc = s->cl_alloc;
+        if (type == ClauseClean::glue) {
+            std::sort(cls.begin(), cls.end(), [&](ClOffset a, ClOffset b) {
+                return alloc.ptr(a)->stats.glue < alloc.ptr(b)->stats.glue;});
+        } else {
+            std::sort(cls.begin(), cls.end(), [&](ClOffset a, ClOffset b) {
+                return alloc.ptr(a)->stats.activity > alloc.ptr(b)->stats.activity;});
+        }
+
+        size_t num = 0;
+        for(size_t i = 0; i < cls.size() && num < keep_num; i++) {
+            const Clause* cl = alloc.ptr(cls[i]);
+            if (cl->used_in_xor()
+                || cl->stats.ttl > 0
+                || cl->stats.which_red_array != 2
+            ) {
+                continue;
+            }
+            if (!marked.count(cls[i])) {
+                num++;
+                marked.insert(cls[i]);
+            }
+        }
+    }
+
+    std::set<ClOffset> marked() const
+    {
+        std::set<ClOffset> ret;
+        for(const ClOffset offs: s->longRedCls[2]) {
+            if (s->cl_alloc.ptr(offs)->stats.marked_clause) {
+                ret.insert(offs);
+            }
+        }
+        return ret;
+    }
+
+    const uint32_t num_vars = 1000;
+    SolverConf conf;
+    Solver* s = NULL;
+    std::mt19937 rnd;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(reducedb, same_as_full_sort_glue)
+{
+    add_cls(3000, 100000);
+    const vector<ClOffset> all = s->longRedCls[2];
+    for(const uint64_t keep: {1, 10, 500, 2000, 5000}) {
+        for(const ClOffset offs: all) {
+            s->cl_alloc.ptr(offs)->stats.marked_clause = false;
+        }
+        std::set<ClOffset> expected;
+        full_sort_mark(ClauseClean::glue, keep, expected);
+        s->reduceDB->mark_top_N_clauses(ClauseClean::glue, keep);
+        EXPECT_EQ(marked(), expected);
+    }
+}
+
+TEST_F(reducedb, same_as_full_sort_activity)
+{
+    add_cls(3000, 100000);
+    std::set<ClOffset> expected = marked();
+    EXPECT_GT(expected.size(), 0U);
+    full_sort_mark(ClauseClean::activity, 700, expected);
+    s->reduceDB->mark_top_N_clauses(ClauseClean::activity, 700);
+    EXPECT_EQ(marked(), expected);
+
+    //The list is only reordered
+    EXPECT_EQ(s->longRedCls[2].size(), 3000U);
+}
+
+TEST_F(reducedb, same_as_full_sort_both)
+{
+    //Like handle_lev2(): glue first, then activity among what's left
+    add_cls(5000, 100000);
+    std::set<ClOffset> expected = marked();
+    full_sort_mark(ClauseClean::glue, 1000, expected);
+    full_sort_mark(ClauseClean::activity, 1000, expected);
+    s->reduceDB->mark_top_N_clauses(ClauseClean::glue, 1000);
+    s->reduceDB->mark_top_N_clauses(ClauseClean::activity, 1000);
+    EXPECT_EQ(marked(), expected);
+}
+
+TEST_F(reducedb, ties)
+{
+    //With ties at the cut, which one is marked is arbitrary, both before and
+    //now. The number marked, and that none better is left out, is not.
+    add_cls(3000, 5);
+    const std::set<ClOffset> before = marked();
+    s->reduceDB->mark_top_N_clauses(ClauseClean::glue, 1000);
+    const std::set<ClOffset> after = marked();
+    EXPECT_EQ(after.size(), before.size() + 1000);
+
+    uint32_t worst_marked = 0;
+    uint32_t best_unmarked = std::numeric_limits<uint32_t>::max();
+    for(const ClOffset offs: s->longRedCls[2]) {
+        const Clause* cl = s->cl_alloc.ptr(offs);
+        if (cl->used_in_xor() || cl->stats.ttl > 0
+            || cl->stats.which_red_array != 2 || before.count(offs)
+        ) {
+            continue;
+        }
+        if (after.count(offs)) {
+            worst_marked = std::max<uint32_t>(worst_marked, cl->stats.glue);
+        } else {
+            best_unmarked = std::min<uint32_t>(best_unmarked, cl->stats.glue);
+        }
+    }
+    EXPECT_LE(worst_marked, best_unmarked);
+}
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -446,7 +446,7 @@ void check_xors_contains(const vector<Xor>& got_data, const std::string& expecte
     EXPECT_TRUE(found);
 }
 
-string print_cache(const vector<LitExtra>& c)
+string print_cache(const TransCache& c)
 {
     std::stringstream ss;
     for(LitExtra a: c) {
@@ -460,15 +460,7 @@ void check_impl_cache_contains(const Solver* s, const std::string& data)
     vector<Lit> lits = str_to_cl(data);
     assert(lits.size() == 2);
 
-    const vector<LitExtra>& cache_lits = s->implCache[lits[0]].lits;
-    /*cout << "cache[0]: " << print_cache(s->implCache[Lit(0, false)].lits) << endl;
-    cout << "cache[1]: " << print_cache(s->implCache[Lit(1, false)].lits) << endl;
-    cout << "cache[2]: " << print_cache(s->implCache[Lit(2, false)].lits) << endl;
-
-    cout << "cache[~0]: " << print_cache(s->implCache[Lit(0, true)].lits) << endl;
-    cout << "cache[~1]: " << print_cache(s->implCache[Lit(1, true)].lits) << endl;
-    cout << "cache[~2]: " << print_cache(s->implCache[Lit(2, true)].lits) << endl;
-    */
+    const TransCache& cache_lits = s->implCache[lits[0]];
     bool inside = false;
     for(LitExtra l: cache_lits) {
         if (l.getLit() == lits[1])
@@ -483,8 +475,11 @@ void add_to_cache_irred(Solver* s, const string& data)
     assert(lits.size() == 2);
     assert(s->implCache.size() > lits[0].toInt());
     assert(s->implCache.size() > lits[1].toInt());
-    s->implCache[lits[0]].lits.push_back(LitExtra(lits[1], true));
-    s->implCache[lits[1]].lits.push_back(LitExtra(lits[0], true));
+    vector<uint16_t> seen(s->nVars()*2, 0);
+    const vector<Lit> none;
+    const uint32_t no_leave_out = std::numeric_limits<uint32_t>::max();
+    s->implCache.merge(lits[0], none, lits[1], false, no_leave_out, seen);
+    s->implCache.merge(lits[1], none, lits[0], false, no_leave_out, seen);
 }
 
 void add_to_stamp_irred(Solver* s, const string& data)
@@ -23,6 +23,8 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <fstream>
+#include <random>
+#include <algorithm>
 
 #include "src/solver.h"
 #include "src/varreplacer.h"
@@ -78,6 +80,20 @@ TEST_F(varreplace, find_one_2)
     check_irred_cls_eq(s, "3, 4, 5;  2, 3, 4, 5");
 }
 
+TEST_F(varreplace, find_one_frozen)
+{
+    s->freeze_var(0);
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("-1, -2"));
+
+    s->add_clause_outer(str_to_cl("1, 3, 4, 5"));
+    s->add_clause_outer(str_to_cl("2, 3, 4, 5"));
+
+    repl->replace_if_enough_is_found();
+    EXPECT_EQ(repl->get_num_replaced_vars(), 1);
+    check_irred_cls_eq(s, "1, 3, 4, 5;  -1, 3, 4, 5");
+}
+
 TEST_F(varreplace, remove_lit)
 {
     s->add_clause_outer(str_to_cl("1, -2"));
@@ -170,6 +186,99 @@ TEST_F(varreplace, replace_limit_check_above)
     EXPECT_EQ(repl->get_num_replaced_vars(), 2);
 }
 
+//Multi-threaded search for the clauses to update
+
+struct ReplResult {
+    size_t num_replaced = 0;
+    vector<uint32_t> replaced;
+    vector<vector<Lit> > irred;
+    lbool ret = l_Undef;
+    vector<lbool> model;
+};
+
+static ReplResult replace_and_solve(
+    const vector<vector<Lit> >& cls
+    , const uint32_t num_vars
+    , const unsigned threads
+) {
+    std::atomic<bool> must_inter;
+    must_inter.store(false, std::memory_order_relaxed);
+    SolverConf conf;
+    conf.doCache = false;
+    conf.varreplace_threads = threads;
+    conf.simplify_schedule_nonstartup = "scc-vrepl";
+    Solver s(&conf, &must_inter);
+    s.new_vars(num_vars);
+    for(const vector<Lit>& cl: cls) {
+        s.add_clause_outer(cl);
+    }
+
+    //Threads are only started for over 5000 clauses each
+    EXPECT_GT(s.get_num_long_irred_cls(), 10000U);
+
+    ReplResult r;
+    s.simplify_with_assumptions();
+    r.num_replaced = s.varReplacer->get_num_replaced_vars();
+    for(uint32_t v = 0; v < num_vars; v++) {
+        if (s.varData[s.map_outer_to_inter(v)].removed == Removed::replaced) {
+            r.replaced.push_back(v);
+        }
+    }
+    r.irred = get_irred_cls(&s);
+    std::sort(r.irred.begin(), r.irred.end(), VecVecSorter());
+    r.ret = s.solve_with_assumptions(NULL, false);
+    if (r.ret == l_True) {
+        r.model = s.get_model();
+    }
+    return r;
+}
+
+TEST(varreplace_threads, same_as_single)
+{
+    const uint32_t num_vars = 5000;
+    std::mt19937 rnd(1);
+    vector<vector<Lit> > cls;
+    for(uint32_t i = 0; i < 12000; i++) {
+        vector<Lit> cl;
+        while(cl.size() < 3) {
+            const Lit l(rnd() % num_vars, rnd() % 2);
+            if (std::find(cl.begin(), cl.end(), l) == cl.end()
+                && std::find(cl.begin(), cl.end(), ~l) == cl.end()
+            ) {
+                cl.push_back(l);
+            }
+        }
+        cls.push_back(cl);
+    }
+    for(uint32_t i = 0; i < 200; i++) {
+        const Lit a(rnd() % num_vars, false);
+        const Lit b(rnd() % num_vars, rnd() % 2);
+        if (a.var() != b.var()) {
+            cls.push_back(vector<Lit>{a, ~b});
+            cls.push_back(vector<Lit>{~a, b});
+        }
+    }
+
+    const ReplResult single = replace_and_solve(cls, num_vars, 1);
+    EXPECT_GT(single.num_replaced, 150U);
+    EXPECT_EQ(single.replaced.size(), single.num_replaced);
+    for(unsigned threads: {2U, 3U}) {
+        const ReplResult par = replace_and_solve(cls, num_vars, threads);
+        EXPECT_EQ(par.num_replaced, single.num_replaced);
+        EXPECT_EQ(par.replaced, single.replaced);
+        EXPECT_EQ(par.irred, single.irred);
+        EXPECT_EQ(par.ret, single.ret);
+        EXPECT_EQ(par.ret, l_True);
+        for(const vector<Lit>& cl: cls) {
+            bool sat = false;
+            for(const Lit l: cl) {
+                sat |= (par.model[l.var()] ^ l.sign()) == l_True;
+            }
+            EXPECT_TRUE(sat);
+        }
+    }
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);